@@ -0,0 +1,167 @@
+#include "MappedFile.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#   ifndef _WIN32_WINNT
+#       define _WIN32_WINNT 0x0602     // Windows 8, for PrefetchVirtualMemory
+#   endif
+#   define WIN32_LEAN_AND_MEAN
+#   define NOMINMAX
+#   include <windows.h>
+#else
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <fcntl.h>
+#   include <unistd.h>
+#endif // _WIN32
+
+namespace Engine::Assets {
+
+#   ifdef _WIN32
+
+    MappedFile::MappedFile(const std::string& path) {
+        fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+        if (fileHandle == INVALID_HANDLE_VALUE) {
+            fileHandle = nullptr;
+            throw std::runtime_error("Could not open file " + path);
+        }
+
+        LARGE_INTEGER fileSize{};
+        GetFileSizeEx(fileHandle, &fileSize);
+        size = static_cast<size_t>(fileSize.QuadPart);
+
+        mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mappingHandle == nullptr) {
+            Close();
+            throw std::runtime_error("Could not map file " + path);
+        }
+
+        data = static_cast<const std::byte*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+        if (data == nullptr) {
+            Close();
+            throw std::runtime_error("Could not map file " + path);
+        }
+    }
+
+    void MappedFile::Close() {
+        if (data)           UnmapViewOfFile(data);
+        if (mappingHandle)  CloseHandle(mappingHandle);
+        if (fileHandle)     CloseHandle(fileHandle);
+
+        data            = nullptr;
+        size            = 0;
+        mappingHandle   = nullptr;
+        fileHandle      = nullptr;
+    }
+
+    // Only a hint, like madvise, so a failure is ignored
+    void MappedFile::Prefetch(const uint64_t offset, const uint64_t bytes) const {
+        if (!data || bytes == 0) return;
+
+        WIN32_MEMORY_RANGE_ENTRY range{};
+        range.VirtualAddress    = const_cast<std::byte*>(data + offset);
+        range.NumberOfBytes     = static_cast<SIZE_T>(bytes);
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+
+    // Windows can't drop pages of a file mapping on request, DiscardVirtualMemory
+    // is for private memory only. Clean mapped pages cost nothing to evict, the
+    // working set manager trims them when memory gets tight.
+    void MappedFile::Release(const uint64_t, const uint64_t) const {}
+
+#   else
+
+    MappedFile::MappedFile(const std::string& path) {
+        fileDescriptor = open(path.c_str(), O_RDONLY);
+
+        if (fileDescriptor < 0) {
+            throw std::runtime_error("Could not open file " + path);
+        }
+
+        struct stat fileInfo{};
+        if (fstat(fileDescriptor, &fileInfo) != 0) {
+            Close();
+            throw std::runtime_error("Could not stat file " + path);
+        }
+
+        size = static_cast<size_t>(fileInfo.st_size);
+        if (size == 0) {
+            Close();
+            throw std::runtime_error("Empty file " + path);
+        }
+
+        void* mapping{ mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0) };
+        if (mapping == MAP_FAILED) {
+            Close();
+            throw std::runtime_error("Could not map file " + path);
+        }
+
+        data = static_cast<const std::byte*>(mapping);
+    }
+
+    void MappedFile::Close() {
+        if (data)                   munmap(const_cast<std::byte*>(data), size);
+        if (fileDescriptor >= 0)    close(fileDescriptor);
+
+        data            = nullptr;
+        size            = 0;
+        fileDescriptor  = -1;
+    }
+
+    // madvise wants page aligned ranges
+    static std::pair<uintptr_t, size_t> PageRange(const std::byte* base, const uint64_t offset, const uint64_t bytes) {
+        const auto page     { static_cast<uintptr_t>(sysconf(_SC_PAGESIZE)) };
+        const auto begin    { reinterpret_cast<uintptr_t>(base + offset) & ~(page - 1) };
+        const auto end      { reinterpret_cast<uintptr_t>(base + offset + bytes) };
+        return { begin, static_cast<size_t>(end - begin) };
+    }
+
+    void MappedFile::Prefetch(const uint64_t offset, const uint64_t bytes) const {
+        if (!data || bytes == 0) return;
+        const auto [begin, length] { PageRange(data, offset, bytes) };
+        madvise(reinterpret_cast<void*>(begin), length, MADV_WILLNEED);
+    }
+
+    void MappedFile::Release(const uint64_t offset, const uint64_t bytes) const {
+        if (!data || bytes == 0) return;
+        const auto [begin, length] { PageRange(data, offset, bytes) };
+        madvise(reinterpret_cast<void*>(begin), length, MADV_DONTNEED);
+    }
+
+#   endif // _WIN32
+
+
+    MappedFile::~MappedFile() {
+        Close();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            Close();
+            std::swap(data, other.data);
+            std::swap(size, other.size);
+#           ifdef _WIN32
+            std::swap(fileHandle, other.fileHandle);
+            std::swap(mappingHandle, other.mappingHandle);
+#           else
+            std::swap(fileDescriptor, other.fileDescriptor);
+#           endif // _WIN32
+        }
+        return *this;
+    }
+
+    const std::byte* MappedFile::At(const uint64_t offset, const uint64_t bytes) const {
+        if (offset > size || bytes > size - offset) {
+            throw std::runtime_error("Mapped file read out of bounds");
+        }
+        return data + offset;
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef ASSETS_MAPPED_FILE_HPP
+#define ASSETS_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Engine::Assets {
+
+    // A byte range inside a mapped file
+    struct Blob {
+        const std::byte*    Data    { nullptr };
+        uint64_t            Offset  { 0 };
+        uint64_t            Size    { 0 };
+    };
+
+    // Read-only memory mapping of a whole file. Pages are faulted in by the
+    // OS as they are touched, Prefetch/Release let streaming code tell the
+    // OS what it is about to read and what it is done with.
+    class MappedFile {
+
+    private:
+        const std::byte*    data{ nullptr };
+        size_t              size{ 0 };
+
+#       ifdef _WIN32
+        void*               fileHandle{ nullptr };
+        void*               mappingHandle{ nullptr };
+#       else
+        int                 fileDescriptor{ -1 };
+#       endif // _WIN32
+
+        void Close();
+
+    public:
+        MappedFile() = default;
+        explicit MappedFile(const std::string& path);
+        ~MappedFile();
+
+        // No copies!
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&&) noexcept;
+        MappedFile& operator=(MappedFile&&) noexcept;
+
+        const std::byte*    Data()              const { return data; }
+        const size_t        Size()              const { return size; }
+        const bool          IsOpen()            const { return data != nullptr; }
+
+        // Pointer into the mapping, throws if the range is out of bounds
+        const std::byte*    At(const uint64_t offset, const uint64_t bytes) const;
+
+        void Prefetch(const uint64_t offset, const uint64_t bytes) const;
+        void Release(const uint64_t offset, const uint64_t bytes) const;
+    };
+}
+
+#endif // !ASSETS_MAPPED_FILE_HPP
@@ -0,0 +1,100 @@
+#include "MeshFile.hpp"
+
+#include <stdexcept>
+
+namespace Engine::Assets::Mesh {
+
+    MeshFile::MeshFile(const std::string& path) :
+        file(path) {
+
+        // The mapping is page aligned, so the header is. The table and blobs
+        // are read in place too, their offsets have to keep them aligned.
+        header = reinterpret_cast<const FileHeader*>(file.At(0, sizeof(FileHeader)));
+
+        if (header->MeshTableOffset % alignof(MeshEntry) != 0) {
+            throw std::runtime_error("Misaligned mesh table");
+        }
+        meshes = reinterpret_cast<const MeshEntry*>(file.At(header->MeshTableOffset, uint64_t{ header->MeshCount } * sizeof(MeshEntry)));
+
+        Validate();
+    }
+
+    void MeshFile::CheckBlob(const uint64_t offset, const uint64_t bytes) const {
+        if (offset % BlobAlignment != 0) throw std::runtime_error("Misaligned blob in mesh file");
+        file.At(offset, bytes);
+    }
+
+    // Bounds and alignment check everything up front so the hot accessors don't have to.
+    // Empty meshes are rejected too, their blobs would make zero sized buffers.
+    void MeshFile::Validate() const {
+        if (header->Magic != MeshMagic)             throw std::runtime_error("Not a mesh file");
+        if (header->Version != MeshVersion)         throw std::runtime_error("Unsupported mesh file version");
+        if (header->FileSize != file.Size())        throw std::runtime_error("Truncated mesh file");
+        if (header->Indices != IndexFormat::Uint32) throw std::runtime_error("Unsupported index format");
+
+        for (uint32_t i = 0; i < header->MeshCount; ++i) {
+            const auto& mesh{ meshes[i] };
+
+            if (mesh.LodCount == 0 || mesh.LodCount > MaxLods) {
+                throw std::runtime_error("Bad LOD count in mesh file");
+            }
+            if (mesh.VertexCount == 0) {
+                throw std::runtime_error("Mesh without vertices in mesh file");
+            }
+
+            CheckBlob(mesh.VertexOffset, uint64_t{ mesh.VertexCount } * header->VertexStride);
+
+            for (uint32_t lod = 0; lod < mesh.LodCount; ++lod) {
+                if (mesh.Lods[lod].IndexCount == 0) throw std::runtime_error("LOD without indices in mesh file");
+                CheckBlob(mesh.Lods[lod].IndexOffset, uint64_t{ mesh.Lods[lod].IndexCount } * sizeof(uint32_t));
+            }
+
+            const auto& meshlets{ mesh.Meshlets };
+            if (meshlets.MeshletCount > 0) {
+                if (meshlets.VertexCount == 0 || meshlets.TriangleCount == 0) {
+                    throw std::runtime_error("Empty meshlets in mesh file");
+                }
+                CheckBlob(meshlets.MeshletOffset,  uint64_t{ meshlets.MeshletCount }  * sizeof(Meshlet));
+                CheckBlob(meshlets.VertexOffset,   uint64_t{ meshlets.VertexCount }   * sizeof(uint32_t));
+                CheckBlob(meshlets.TriangleOffset, uint64_t{ meshlets.TriangleCount } * sizeof(uint32_t));
+            }
+        }
+    }
+
+    const MeshEntry& MeshFile::Mesh(const uint32_t mesh) const {
+        if (mesh >= header->MeshCount) throw std::runtime_error("Mesh index out of range");
+        return meshes[mesh];
+    }
+
+    const Blob MeshFile::Vertices(const uint32_t mesh) const {
+        const auto& entry{ Mesh(mesh) };
+        const auto  size { uint64_t{ entry.VertexCount } * header->VertexStride };
+
+        return { file.Data() + entry.VertexOffset, entry.VertexOffset, size };
+    }
+
+    const Blob MeshFile::Indices(const uint32_t mesh, const uint32_t lod) const {
+        const auto& entry{ Mesh(mesh) };
+        if (lod >= entry.LodCount) throw std::runtime_error("LOD index out of range");
+
+        const auto& level{ entry.Lods[lod] };
+        const auto  size { uint64_t{ level.IndexCount } * sizeof(uint32_t) };
+
+        return { file.Data() + level.IndexOffset, level.IndexOffset, size };
+    }
+
+    const Blob MeshFile::Meshlets(const uint32_t mesh) const {
+        const auto& section{ Mesh(mesh).Meshlets };
+        return { file.Data() + section.MeshletOffset, section.MeshletOffset, uint64_t{ section.MeshletCount } * sizeof(Meshlet) };
+    }
+
+    const Blob MeshFile::MeshletVertices(const uint32_t mesh) const {
+        const auto& section{ Mesh(mesh).Meshlets };
+        return { file.Data() + section.VertexOffset, section.VertexOffset, uint64_t{ section.VertexCount } * sizeof(uint32_t) };
+    }
+
+    const Blob MeshFile::MeshletTriangles(const uint32_t mesh) const {
+        const auto& section{ Mesh(mesh).Meshlets };
+        return { file.Data() + section.TriangleOffset, section.TriangleOffset, uint64_t{ section.TriangleCount } * sizeof(uint32_t) };
+    }
+}
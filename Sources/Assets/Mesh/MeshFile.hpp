@@ -0,0 +1,49 @@
+#ifndef ASSETS_MESH_FILE_HPP
+#define ASSETS_MESH_FILE_HPP
+
+#include "MeshFormat.hpp"
+#include "Assets/File/MappedFile.hpp"
+
+#include <string>
+
+namespace Engine::Assets::Mesh {
+
+    using Engine::Assets::Blob;
+
+    // Read-only view over a mapped .vmesh file. The header and mesh table are
+    // validated once on open, after that every accessor is a pointer offset.
+    class MeshFile {
+
+    private:
+        MappedFile          file;
+        const FileHeader*   header{ nullptr };
+        const MeshEntry*    meshes{ nullptr };
+
+        void Validate() const;
+        // In bounds and on BlobAlignment, throws if not
+        void CheckBlob(const uint64_t offset, const uint64_t bytes) const;
+
+    public:
+        MeshFile() = default;
+        explicit MeshFile(const std::string& path);
+
+        // No copies!
+        MeshFile(const MeshFile&) = delete;
+        MeshFile& operator=(const MeshFile&) = delete;
+
+        MeshFile(MeshFile&&) = default;
+        MeshFile& operator=(MeshFile&&) = default;
+
+        const FileHeader&   Header()                                        const { return *header; }
+        const uint32_t      MeshCount()                                     const { return header->MeshCount; }
+        const MeshEntry&    Mesh(const uint32_t mesh)                       const;
+        const Blob          Vertices(const uint32_t mesh)                   const;
+        const Blob          Indices(const uint32_t mesh, const uint32_t lod) const;
+        const Blob          Meshlets(const uint32_t mesh)                   const;
+        const Blob          MeshletVertices(const uint32_t mesh)            const;
+        const Blob          MeshletTriangles(const uint32_t mesh)           const;
+        const MappedFile&   File()                                          const { return file; }
+    };
+}
+
+#endif // !ASSETS_MESH_FILE_HPP
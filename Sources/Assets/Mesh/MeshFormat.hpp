@@ -0,0 +1,121 @@
+#ifndef ASSETS_MESH_FORMAT_HPP
+#define ASSETS_MESH_FORMAT_HPP
+
+#include <cstdint>
+#include <type_traits>
+
+// On-disk layout of a packed mesh file (.vmesh)
+//
+//  [FileHeader]
+//  [MeshEntry] * meshCount          at FileHeader::meshTableOffset
+//  [vertex blob][index blobs...][meshlet blobs]
+//                                   one group per mesh, each blob aligned to BlobAlignment
+//
+// Everything is little-endian and laid out so that the runtime can copy
+// blobs straight out of a mapping, nothing is parsed. All offsets are
+// from the start of the file.
+
+namespace Engine::Assets::Mesh {
+
+    constexpr uint32_t MeshMagic        { 0x464D4556 };     // "VEMF"
+    constexpr uint32_t MeshVersion      { 2 };
+    constexpr uint32_t MaxLods          { 4 };
+    constexpr uint32_t MaxNameLength    { 32 };
+    constexpr uint64_t BlobAlignment    { 16 };
+
+    // Meshlets are small enough for one mesh shader workgroup each
+    constexpr uint32_t MaxMeshletVertices   { 64 };
+    constexpr uint32_t MaxMeshletTriangles  { 124 };
+
+    // Must match the engine side vertex types
+    enum class VertexFormat : uint32_t {
+        Pos2Col3 = 0    // Primitives::Vertex, stored as FileVertex
+    };
+
+    enum class IndexFormat : uint32_t {
+        Uint32 = 0
+    };
+
+    // A Pos2Col3 vertex as it is in the vertex blob. The runtime checks
+    // Primitives::Vertex against it, the converter writes it.
+    struct FileVertex {
+        float Position[2];
+        float Color[3];
+    };
+
+    struct Bounds {
+        float Min[3];
+        float Max[3];
+        float Center[3];
+        float Radius;
+    };
+
+    struct LodEntry {
+        uint64_t IndexOffset;
+        uint32_t IndexCount;
+        float    Error;         // Max object space deviation from LOD 0
+    };
+
+    // A cluster of LOD 0 triangles that is culled as a whole. Vertices are
+    // indices into the mesh's vertices, kept in the meshlet vertex blob.
+    // Triangles are in the triangle blob, one uint32 each with the three
+    // corners as bytes 0 to 2, indexing the meshlet's own vertices.
+    //
+    // The cone bounds the triangle normals. The whole meshlet faces away
+    // from a camera at c once
+    //   dot(Center - c, ConeAxis) >= ConeCutoff * length(Center - c) + Radius
+    // A cutoff of 1 never culls, the normals are spread too wide.
+    struct Meshlet {
+        float       Center[3];
+        float       Radius;
+        float       ConeAxis[3];
+        float       ConeCutoff;
+        uint32_t    VertexOffset;
+        uint32_t    TriangleOffset;
+        uint32_t    VertexCount;
+        uint32_t    TriangleCount;
+    };
+
+    struct MeshletSection {
+        uint64_t    MeshletOffset;
+        uint64_t    VertexOffset;
+        uint64_t    TriangleOffset;
+        uint32_t    MeshletCount;
+        uint32_t    VertexCount;
+        uint32_t    TriangleCount;
+        uint32_t    Pad;
+    };
+
+    struct MeshEntry {
+        char            Name[MaxNameLength];
+        Bounds          Volume;
+        uint64_t        VertexOffset;
+        uint32_t        VertexCount;
+        uint32_t        LodCount;
+        LodEntry        Lods[MaxLods];
+        MeshletSection  Meshlets;       // Of LOD 0, may be empty
+    };
+
+    struct FileHeader {
+        uint32_t        Magic;
+        uint32_t        Version;
+        uint32_t        MeshCount;
+        uint32_t        VertexStride;
+        VertexFormat    Vertices;
+        IndexFormat     Indices;
+        uint64_t        MeshTableOffset;
+        uint64_t        FileSize;
+    };
+
+    static_assert(std::is_trivially_copyable_v<FileHeader>  && sizeof(FileHeader) == 40);
+    static_assert(std::is_trivially_copyable_v<MeshEntry>   && sizeof(MeshEntry)  % 8 == 0);
+    static_assert(std::is_trivially_copyable_v<LodEntry>    && sizeof(LodEntry)   == 16);
+    static_assert(std::is_trivially_copyable_v<Meshlet>     && sizeof(Meshlet)    == 48);
+    static_assert(std::is_trivially_copyable_v<MeshletSection> && sizeof(MeshletSection) == 40);
+
+    constexpr uint64_t AlignBlob(const uint64_t offset) {
+        return (offset + BlobAlignment - 1) & ~(BlobAlignment - 1);
+    }
+}
+
+#endif // !ASSETS_MESH_FORMAT_HPP
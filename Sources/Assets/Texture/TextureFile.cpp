@@ -0,0 +1,96 @@
+#include "TextureFile.hpp"
+
+#include <stdexcept>
+
+namespace Engine::Assets::Texture {
+
+    TextureFile::TextureFile(const std::string& path) :
+        file(path) {
+
+        header = reinterpret_cast<const TextureHeader*>(file.At(0, sizeof(TextureHeader)));
+
+        if (header->Magic != TextureMagic)      throw std::runtime_error("Not a texture file");
+        if (header->Version != TextureVersion)  throw std::runtime_error("Unsupported texture file version");
+        if (header->MipCount == 0 || header->MipCount > MaxMips) {
+            throw std::runtime_error("Bad mip count in texture file");
+        }
+
+        mips = reinterpret_cast<const MipEntry*>(file.At(header->MipTableOffset, uint64_t{ header->MipCount } * sizeof(MipEntry)));
+
+        const auto& last{ mips[header->MipCount - 1] };
+        tileCount = last.FirstTile + last.TilesX * last.TilesY;
+        tiles = reinterpret_cast<const TileEntry*>(file.At(header->TileTableOffset, uint64_t{ tileCount } * sizeof(TileEntry)));
+
+        Validate();
+    }
+
+    // Bounds check everything up front so the hot accessors don't have to
+    void TextureFile::Validate() const {
+        if (header->FileSize != file.Size())    throw std::runtime_error("Truncated texture file");
+        if (header->TileWidth == 0 || header->TileHeight == 0) {
+            throw std::runtime_error("Bad tile size in texture file");
+        }
+
+        const auto texelSize{ BytesPerTexel(header->Format) };
+        uint32_t firstTile{ 0 };
+
+        for (uint32_t m = 0; m < header->MipCount; ++m) {
+            const auto& mip{ mips[m] };
+
+            if (mip.Width  != MipExtent(header->Width, m)   ||
+                mip.Height != MipExtent(header->Height, m)  ||
+                mip.TilesX != TileCount(mip.Width, header->TileWidth) ||
+                mip.TilesY != TileCount(mip.Height, header->TileHeight) ||
+                mip.FirstTile != firstTile) {
+                throw std::runtime_error("Bad mip table in texture file");
+            }
+
+            for (uint32_t y = 0; y < mip.TilesY; ++y) {
+                for (uint32_t x = 0; x < mip.TilesX; ++x) {
+                    const auto  region{ Region(m, x, y) };
+                    const auto& tile  { tiles[mip.FirstTile + y * mip.TilesX + x] };
+
+                    if (tile.Size != uint64_t{ region.Width } * region.Height * texelSize) {
+                        throw std::runtime_error("Bad tile size in texture file");
+                    }
+                    file.At(tile.Offset, tile.Size);
+                }
+            }
+
+            firstTile += mip.TilesX * mip.TilesY;
+        }
+    }
+
+    const MipEntry& TextureFile::Mip(const uint32_t mip) const {
+        if (mip >= header->MipCount) throw std::runtime_error("Mip index out of range");
+        return mips[mip];
+    }
+
+    const TileRegion TextureFile::Region(const uint32_t mip, const uint32_t x, const uint32_t y) const {
+        const auto& entry{ Mip(mip) };
+        if (x >= entry.TilesX || y >= entry.TilesY) throw std::runtime_error("Tile index out of range");
+
+        const auto left{ x * header->TileWidth };
+        const auto top { y * header->TileHeight };
+
+        return {
+            left,
+            top,
+            std::min(header->TileWidth,  entry.Width  - left),
+            std::min(header->TileHeight, entry.Height - top)
+        };
+    }
+
+    const Blob TextureFile::Tile(const uint32_t mip, const uint32_t x, const uint32_t y) const {
+        const auto& entry{ Mip(mip) };
+        if (x >= entry.TilesX || y >= entry.TilesY) throw std::runtime_error("Tile index out of range");
+
+        const auto& tile{ tiles[entry.FirstTile + y * entry.TilesX + x] };
+        return { file.Data() + tile.Offset, tile.Offset, tile.Size };
+    }
+
+    const uint64_t TextureFile::MipBytes(const uint32_t mip) const {
+        const auto& entry{ Mip(mip) };
+        return uint64_t{ entry.Width } * entry.Height * BytesPerTexel(header->Format);
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef ASSETS_TEXTURE_FILE_HPP
+#define ASSETS_TEXTURE_FILE_HPP
+
+#include "TextureFormat.hpp"
+#include "Assets/File/MappedFile.hpp"
+
+#include <string>
+
+namespace Engine::Assets::Texture {
+
+    // Pixel rectangle a tile covers inside its mip
+    struct TileRegion {
+        uint32_t X      { 0 };
+        uint32_t Y      { 0 };
+        uint32_t Width  { 0 };
+        uint32_t Height { 0 };
+    };
+
+    // Read-only view over a mapped .vtex file. Validated once on open,
+    // after that tile lookups are a table index and a pointer offset.
+    class TextureFile {
+
+    private:
+        MappedFile              file;
+        const TextureHeader*    header{ nullptr };
+        const MipEntry*         mips{ nullptr };
+        const TileEntry*        tiles{ nullptr };
+        uint32_t                tileCount{ 0 };
+
+        void Validate() const;
+
+    public:
+        TextureFile() = default;
+        explicit TextureFile(const std::string& path);
+
+        // No copies!
+        TextureFile(const TextureFile&) = delete;
+        TextureFile& operator=(const TextureFile&) = delete;
+
+        TextureFile(TextureFile&&) = default;
+        TextureFile& operator=(TextureFile&&) = default;
+
+        const TextureHeader&    Header()                                                        const { return *header; }
+        const uint32_t          MipCount()                                                      const { return header->MipCount; }
+        const MipEntry&         Mip(const uint32_t mip)                                         const;
+        const TileRegion        Region(const uint32_t mip, const uint32_t x, const uint32_t y)  const;
+        const Blob              Tile(const uint32_t mip, const uint32_t x, const uint32_t y)    const;
+        const uint64_t          MipBytes(const uint32_t mip)                                    const;
+        const MappedFile&       File()                                                          const { return file; }
+    };
+}
+
+#endif // !ASSETS_TEXTURE_FILE_HPP
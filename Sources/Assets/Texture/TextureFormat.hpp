@@ -0,0 +1,84 @@
+#ifndef ASSETS_TEXTURE_FORMAT_HPP
+#define ASSETS_TEXTURE_FORMAT_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+
+// On-disk layout of a tiled texture file (.vtex)
+//
+//  [TextureHeader]
+//  [MipEntry]  * mipCount           at TextureHeader::MipTableOffset
+//  [TileEntry] * sum of mip tiles   at TextureHeader::TileTableOffset, mip 0 first, rows top to bottom
+//  [tile blobs...]                  each aligned to TileAlignment
+//
+// Every mip is cut into TileWidth x TileHeight tiles, edge tiles and mips
+// smaller than a tile are cropped. A tile's texels are tightly packed rows,
+// so it can be copied from the mapping to a staging buffer and on to the
+// image without reformatting. The tile size is picked to match the sparse
+// block shape of the format (128x128 for 32 bit texels, one 64 KiB page).
+
+namespace Engine::Assets::Texture {
+
+    constexpr uint32_t TextureMagic     { 0x58544556 };     // "VETX"
+    constexpr uint32_t TextureVersion   { 1 };
+    constexpr uint32_t MaxMips          { 16 };
+    constexpr uint32_t DefaultTileSize  { 128 };
+    constexpr uint64_t TileAlignment    { 16 };
+
+    enum class TexelFormat : uint32_t {
+        Rgba8Unorm  = 0,
+        Rgba8Srgb   = 1
+    };
+
+    struct MipEntry {
+        uint32_t Width;
+        uint32_t Height;
+        uint32_t TilesX;
+        uint32_t TilesY;
+        uint32_t FirstTile;     // Index into the tile table
+        uint32_t Reserved;
+    };
+
+    struct TileEntry {
+        uint64_t Offset;
+        uint32_t Size;
+        uint32_t Reserved;
+    };
+
+    struct TextureHeader {
+        uint32_t    Magic;
+        uint32_t    Version;
+        uint32_t    Width;
+        uint32_t    Height;
+        uint32_t    MipCount;
+        uint32_t    TileWidth;
+        uint32_t    TileHeight;
+        TexelFormat Format;
+        uint64_t    MipTableOffset;
+        uint64_t    TileTableOffset;
+        uint64_t    FileSize;
+    };
+
+    static_assert(std::is_trivially_copyable_v<TextureHeader>   && sizeof(TextureHeader) == 56);
+    static_assert(std::is_trivially_copyable_v<MipEntry>        && sizeof(MipEntry)      == 24);
+    static_assert(std::is_trivially_copyable_v<TileEntry>       && sizeof(TileEntry)     == 16);
+
+    constexpr uint32_t BytesPerTexel(const TexelFormat) {
+        return 4;
+    }
+
+    constexpr uint32_t MipExtent(const uint32_t extent, const uint32_t mip) {
+        return std::max(extent >> mip, 1u);
+    }
+
+    constexpr uint32_t TileCount(const uint32_t extent, const uint32_t tile) {
+        return (extent + tile - 1) / tile;
+    }
+
+    constexpr uint64_t AlignTile(const uint64_t offset) {
+        return (offset + TileAlignment - 1) & ~(TileAlignment - 1);
+    }
+}
+
+#endif // !ASSETS_TEXTURE_FORMAT_HPP
@@ -0,0 +1,87 @@
+#include "Jobs/Scheduler.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// Measures what a job costs to spawn and run, and how a compute bound
+// ParallelFor scales from one thread up to every hardware thread.
+
+using namespace Engine::Jobs;
+using Clock = std::chrono::high_resolution_clock;
+
+namespace {
+
+    constexpr uint32_t SpawnJobs        { 200000 };
+    constexpr uint32_t ForItems         { 1u << 22 };
+    constexpr uint32_t ForGrain         { 4096 };
+    constexpr int      Repeats          { 5 };
+
+    double Seconds(const Clock::time_point& start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    // Empty jobs, so this is pure scheduler overhead
+    double SpawnOverheadNs(Scheduler& scheduler) {
+        double best{ 1e30 };
+
+        for (int r = 0; r < Repeats; ++r) {
+            Counter counter{};
+            const auto start{ Clock::now() };
+
+            for (uint32_t i = 0; i < SpawnJobs; ++i) {
+                scheduler.Run([]() {}, &counter);
+            }
+            scheduler.Wait(counter);
+
+            best = std::min(best, Seconds(start) * 1e9 / SpawnJobs);
+        }
+        return best;
+    }
+
+    double ParallelForSeconds(Scheduler& scheduler, std::vector<float>& data) {
+        double best{ 1e30 };
+
+        for (int r = 0; r < Repeats; ++r) {
+            const auto start{ Clock::now() };
+
+            scheduler.ParallelFor(0, ForItems, ForGrain, [&data](const uint32_t begin, const uint32_t end) {
+                for (uint32_t i = begin; i < end; ++i) {
+                    data[i] = std::sqrt(std::sin(data[i]) * std::sin(data[i]) + 1.0f);
+                }
+            });
+
+            best = std::min(best, Seconds(start));
+        }
+        return best;
+    }
+}
+
+int main() {
+
+    const auto hardwareThreads{ std::max(1u, std::thread::hardware_concurrency()) };
+    std::vector<float> data(ForItems, 1.0f);
+
+    std::cout << "Hardware threads: " << hardwareThreads << "\n\n";
+    std::cout << std::setw(8) << "Threads" << std::setw(16) << "Spawn (ns/job)" << std::setw(18) << "ParallelFor (ms)" << std::setw(10) << "Speedup" << '\n';
+
+    double singleThread{ 0.0 };
+
+    for (uint32_t threads = 1; threads <= hardwareThreads; threads = threads < hardwareThreads ? std::min(threads * 2, hardwareThreads) : threads + 1) {
+        Scheduler scheduler(threads - 1);
+
+        const auto spawn{ SpawnOverheadNs(scheduler) };
+        const auto loop { ParallelForSeconds(scheduler, data) };
+
+        if (threads == 1) singleThread = loop;
+
+        std::cout << std::setw(8)  << threads
+                  << std::setw(16) << std::fixed << std::setprecision(1) << spawn
+                  << std::setw(18) << std::setprecision(2) << loop * 1e3
+                  << std::setw(10) << std::setprecision(2) << singleThread / loop << '\n';
+    }
+
+    return EXIT_SUCCESS;
+}
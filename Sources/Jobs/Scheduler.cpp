@@ -0,0 +1,216 @@
+#include "Scheduler.hpp"
+
+namespace Engine::Jobs {
+
+    namespace {
+        // Which scheduler this thread works for and which deque it owns
+        thread_local const Scheduler*   currentScheduler    { nullptr };
+        thread_local uint32_t           currentQueue        { 0 };
+    }
+
+    void Counter::Fail(std::exception_ptr exception) {
+        std::lock_guard<std::mutex> lock(errorLock);
+        if (!error) {
+            error = std::move(exception);
+        }
+    }
+
+    Scheduler::Scheduler(const uint32_t workerCount) :
+        mainThread(std::this_thread::get_id()) {
+
+        for (uint32_t i = 0; i < workerCount + 1; ++i) {
+            queues.emplace_back(std::make_unique<WorkQueue>());
+        }
+
+        outerScheduler      = currentScheduler;
+        outerQueue          = currentQueue;
+        currentScheduler    = this;
+        currentQueue        = 0;
+
+        for (uint32_t i = 1; i <= workerCount; ++i) {
+            workers.emplace_back(&Scheduler::WorkerLoop, this, i);
+        }
+    }
+
+    Scheduler::~Scheduler() {
+        {
+            std::lock_guard<std::mutex> lock(sleepLock);
+            running = false;
+        }
+        wake.notify_all();
+
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        if (currentScheduler == this) {
+            currentScheduler    = outerScheduler;
+            currentQueue        = outerQueue;
+        }
+    }
+
+    void Scheduler::WorkerLoop(const uint32_t index) {
+        currentScheduler    = this;
+        currentQueue        = index;
+
+        while (running.load(std::memory_order_relaxed)) {
+            if (TryRunOne(index)) continue;
+
+            std::unique_lock<std::mutex> lock(sleepLock);
+            wake.wait(lock, [this]() { return !running || queued.load(std::memory_order_relaxed) > 0; });
+        }
+    }
+
+    // Threads that don't belong to the scheduler spread their jobs around
+    uint32_t Scheduler::QueueIndex() const {
+        if (currentScheduler == this) {
+            return currentQueue;
+        }
+        return nextQueue.fetch_add(1, std::memory_order_relaxed) % ThreadCount();
+    }
+
+    void Scheduler::Push(Task&& task) {
+        auto& queue{ *queues[QueueIndex()] };
+        {
+            std::lock_guard<std::mutex> lock(queue.lock);
+            queue.tasks.emplace_back(std::move(task));
+        }
+
+        queued.fetch_add(1, std::memory_order_release);
+
+        // Take the lock so a worker between its check and its wait can't miss this
+        { std::lock_guard<std::mutex> lock(sleepLock); }
+        wake.notify_one();
+    }
+
+    bool Scheduler::Pop(const uint32_t index, Task& task) {
+        auto& queue{ *queues[index] };
+        std::lock_guard<std::mutex> lock(queue.lock);
+
+        if (queue.tasks.empty()) return false;
+
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        return true;
+    }
+
+    bool Scheduler::Steal(const uint32_t thief, Task& task) {
+        const auto count{ ThreadCount() };
+
+        for (uint32_t i = 1; i < count; ++i) {
+            auto& queue{ *queues[(thief + i) % count] };
+            std::lock_guard<std::mutex> lock(queue.lock);
+
+            if (!queue.tasks.empty()) {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool Scheduler::TryRunOne(const uint32_t index) {
+        Task task{};
+
+        if (!Pop(index, task) && !Steal(index, task)) {
+            return false;
+        }
+
+        queued.fetch_sub(1, std::memory_order_relaxed);
+        Execute(task);
+        return true;
+    }
+
+    // Never throws, a worker thread would terminate. The exception goes to
+    // the counter, the job still counts as done so waiters don't spin forever.
+    void Scheduler::Execute(Task& task) {
+        try {
+            task.Work();
+        }
+        catch (...) {
+            if (task.Done) {
+                task.Done->Fail(std::current_exception());
+            }
+            else {
+                std::lock_guard<std::mutex> lock(mainLock);
+                if (!unclaimed) {
+                    unclaimed = std::current_exception();
+                }
+            }
+        }
+
+        if (task.Done) {
+            task.Done->pending.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    void Scheduler::Run(Job job, Counter* counter) {
+        if (counter) {
+            counter->pending.fetch_add(1, std::memory_order_relaxed);
+        }
+        Push({ std::move(job), counter });
+    }
+
+    void Scheduler::RunOnMainThread(Job job, Counter* counter) {
+        if (counter) {
+            counter->pending.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        std::lock_guard<std::mutex> lock(mainLock);
+        mainTasks.push_back({ std::move(job), counter });
+    }
+
+    void Scheduler::RunMainTasks() {
+        std::deque<Task> tasks{};
+        {
+            std::lock_guard<std::mutex> lock(mainLock);
+            std::swap(tasks, mainTasks);
+        }
+
+        for (auto& task : tasks) {
+            Execute(task);
+        }
+    }
+
+    void Scheduler::PumpMainThread() {
+        RunMainTasks();
+
+        std::exception_ptr failed{};
+        {
+            std::lock_guard<std::mutex> lock(mainLock);
+            std::swap(failed, unclaimed);
+        }
+
+        if (failed) {
+            std::rethrow_exception(failed);
+        }
+    }
+
+    void Scheduler::Wait(Counter& counter) {
+        const auto index    { QueueIndex() };
+        const auto onMain   { IsMainThread() };
+
+        while (!counter.Done()) {
+            // Not PumpMainThread, nothing but the counter's own jobs may throw out of here
+            if (onMain) {
+                RunMainTasks();
+            }
+
+            if (!TryRunOne(index)) {
+                std::this_thread::yield();
+            }
+        }
+
+        // Only now, nothing of the counter's jobs runs anymore
+        std::exception_ptr failed{};
+        {
+            std::lock_guard<std::mutex> lock(counter.errorLock);
+            std::swap(failed, counter.error);
+        }
+
+        if (failed) {
+            std::rethrow_exception(failed);
+        }
+    }
+}
@@ -0,0 +1,148 @@
+#ifndef ENGINE_JOBS_SCHEDULER_HPP
+#define ENGINE_JOBS_SCHEDULER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Engine::Jobs {
+
+    using Job = std::function<void()>;
+
+    // Counts jobs that haven't finished yet. Hand one to Run and Wait on it
+    // to join, or have a job Wait on another job's counter to depend on it.
+    // The first exception one of its jobs throws is kept for Wait.
+    class Counter {
+
+    private:
+        friend class Scheduler;
+        std::atomic<uint32_t> pending{ 0 };
+        std::mutex            errorLock;
+        std::exception_ptr    error;
+
+        // Keeps the first, later ones are dropped
+        void Fail(std::exception_ptr exception);
+
+    public:
+        Counter() = default;
+
+        // No copies, jobs hold on to it by pointer
+        Counter(const Counter&) = delete;
+        Counter& operator=(const Counter&) = delete;
+
+        const bool Done() const { return pending.load(std::memory_order_acquire) == 0; }
+    };
+
+    // Work stealing scheduler. Every thread that runs jobs, the main thread
+    // included, owns a deque: it pushes and pops the back of its own and
+    // steals from the front of the others when it runs dry. Jobs queued
+    // with RunOnMainThread only ever run on the thread that created the
+    // scheduler, for APIs like GLFW that must stay on the main thread.
+    class Scheduler {
+
+    private:
+        struct Task {
+            Job         Work;
+            Counter*    Done{ nullptr };
+        };
+
+        struct WorkQueue {
+            std::mutex          lock;
+            std::deque<Task>    tasks;
+        };
+
+        std::vector<std::unique_ptr<WorkQueue>> queues;     // [0] is the main thread's
+        std::vector<std::thread>                workers;
+        std::thread::id                         mainThread;
+
+        // What the creating thread worked for before, put back on destruction
+        const Scheduler*                        outerScheduler{ nullptr };
+        uint32_t                                outerQueue{ 0 };
+
+        std::mutex                  mainLock;
+        std::deque<Task>            mainTasks;
+        std::exception_ptr          unclaimed;      // From a job without a counter, under mainLock
+
+        std::atomic<bool>           running{ true };
+        std::atomic<uint32_t>       queued{ 0 };
+        mutable std::atomic<uint32_t> nextQueue{ 0 };
+        std::mutex                  sleepLock;
+        std::condition_variable     wake;
+
+        void WorkerLoop(const uint32_t index);
+        void Push(Task&& task);
+        bool Pop(const uint32_t index, Task& task);
+        bool Steal(const uint32_t thief, Task& task);
+        bool TryRunOne(const uint32_t index);
+        void Execute(Task& task);
+        void RunMainTasks();
+        uint32_t QueueIndex() const;
+
+    public:
+        // Defaults to one worker per hardware thread, minus the main thread
+        explicit Scheduler(const uint32_t workerCount = std::max(1u, std::thread::hardware_concurrency()) - 1);
+        ~Scheduler();
+
+        // No copies!
+        Scheduler(const Scheduler&) = delete;
+        Scheduler& operator=(const Scheduler&) = delete;
+
+        void Run(Job job, Counter* counter = nullptr);
+        void RunOnMainThread(Job job, Counter* counter = nullptr);
+
+        // Runs other jobs until the counter reaches zero. On the main thread
+        // this also drains main thread jobs, so waiting on them can't deadlock.
+        // Then rethrows the first exception of the counter's jobs, if any.
+        void Wait(Counter& counter);
+
+        // Runs queued main thread jobs, call once per frame from the main thread.
+        // Rethrows the first exception of a job that was run without a counter.
+        void PumpMainThread();
+
+        // Calls body(begin, end) for chunks of at most grainSize items
+        // across all threads and returns once every chunk is done
+        template <typename Body>
+        void ParallelFor(const uint32_t begin, const uint32_t end, const uint32_t grainSize, Body&& body);
+
+        const uint32_t ThreadCount()    const { return static_cast<uint32_t>(queues.size()); }
+        const bool     IsMainThread()   const { return std::this_thread::get_id() == mainThread; }
+    };
+
+
+    // Definitions
+
+    template <typename Body>
+    void Scheduler::ParallelFor(const uint32_t begin, const uint32_t end, const uint32_t grainSize, Body&& body) {
+        if (begin >= end) return;
+
+        const auto grain{ std::max(1u, grainSize) };
+        Counter counter{};
+
+        // Keep the first chunk for ourselves, the rest is up for grabs
+        for (uint32_t chunk = begin + grain; chunk < end; chunk += grain) {
+            const auto chunkEnd{ std::min(end, chunk + grain) };
+            Run([&body, chunk, chunkEnd]() { body(chunk, chunkEnd); }, &counter);
+        }
+
+        // The other chunks hold on to body and counter, Wait lets them
+        // finish before it rethrows
+        try {
+            body(begin, std::min(end, begin + grain));
+        }
+        catch (...) {
+            counter.Fail(std::current_exception());
+        }
+
+        Wait(counter);
+    }
+}
+
+#endif // !ENGINE_JOBS_SCHEDULER_HPP
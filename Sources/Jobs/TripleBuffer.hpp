@@ -0,0 +1,52 @@
+#ifndef ENGINE_JOBS_TRIPLE_BUFFER_HPP
+#define ENGINE_JOBS_TRIPLE_BUFFER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace Engine::Jobs {
+
+    // Hands the latest value from one producer thread to one consumer thread,
+    // neither ever waits. The writer fills Back() and publishes it, the reader
+    // picks up whatever was published last and skips anything in between.
+    // Three slots: one each side owns and one in the middle that gets swapped.
+    template <typename T>
+    class TripleBuffer {
+
+    private:
+        static constexpr uint8_t IndexMask  { 0x3 };
+        static constexpr uint8_t Fresh      { 0x4 };    // Middle holds a value the reader hasn't seen
+
+        std::array<T, 3>        slots{};
+        std::atomic<uint8_t>    middle{ 1 };
+        uint8_t                 back{ 0 };              // Writer's
+        uint8_t                 front{ 2 };             // Reader's
+
+    public:
+        TripleBuffer() = default;
+
+        // No copies, both threads hold on to it
+        TripleBuffer(const TripleBuffer&) = delete;
+        TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+        // Writer side
+        T& Back() { return slots[back]; }
+
+        void Publish() {
+            back = middle.exchange(back | Fresh, std::memory_order_acq_rel) & IndexMask;
+        }
+
+        // Reader side. True if a newer value was picked up.
+        bool Update() {
+            if (!(middle.load(std::memory_order_relaxed) & Fresh)) return false;
+
+            front = middle.exchange(front, std::memory_order_acq_rel) & IndexMask;
+            return true;
+        }
+
+        const T& Front() const { return slots[front]; }
+    };
+}
+
+#endif // !ENGINE_JOBS_TRIPLE_BUFFER_HPP
@@ -1,5 +1,7 @@
 #include "Vertex.hpp"
 
+#include <glm/gtc/packing.hpp>
+
 namespace Engine::Primitives {
 
     const uint64_t Vertex::Size(uint64_t numberOfVertices) {
@@ -7,35 +9,34 @@ namespace Engine::Primitives {
     }
 
     const vk::VertexInputBindingDescription* Vertex::Binding() {
-        static const vk::VertexInputBindingDescription vb{
-            0,                  // Binding
-            sizeof(Vertex),     // Stride
-            vk::VertexInputRate::eVertex
-        };
+        return &Layout::Binding;
+    }
 
-        return &vb;
+    const std::array<vk::VertexInputAttributeDescription, Vertex::Layout::Count>& Vertex::Attributes() {
+        return Layout::Attributes;
     }
 
-    const std::array<const vk::VertexInputAttributeDescription, 2>& Vertex::Attributes() {
-
-        static const std::array<const vk::VertexInputAttributeDescription, 2> vat{
-            // For position
-            vk::VertexInputAttributeDescription{
-                0,                          // location
-                0,                          // binding
-                vk::Format::eR32G32Sfloat,  // format
-                offsetof(Vertex, pos)       // offset
-            },
-            // For color
-            vk::VertexInputAttributeDescription{
-                1,                            // location
-                0,                            // binding
-                vk::Format::eR32G32B32Sfloat, // format
-                offsetof(Vertex, col)         // offset
-            }
-        };
 
-        return vat;
+    const uint64_t PackedVertex::Size(uint64_t numberOfVertices) {
+        return sizeof(PackedVertex) * numberOfVertices;
     }
 
+    PackedVertex PackedVertex::Pack(const glm::vec3& position, const glm::vec3& normal, const glm::vec4& color, const glm::vec2& uv) {
+        PackedVertex v{};
+
+        v.pos = {
+            glm::packHalf1x16(position.x),
+            glm::packHalf1x16(position.y),
+            glm::packHalf1x16(position.z),
+            glm::packHalf1x16(1.0f)
+        };
+
+        // x lands in the low bits, which is R in A2B10G10R10
+        v.normal    = glm::packSnorm3x10_1x2(glm::vec4(normal, 0.0f));
+        // x lands in the low byte, which is R in R8G8B8A8 on little endian
+        v.col       = glm::packUnorm4x8(color);
+        v.uv        = { glm::packHalf1x16(uv.x), glm::packHalf1x16(uv.y) };
+
+        return v;
+    }
 }
@@ -2,9 +2,11 @@
 #define ENGINE_MESH_PRIMITIVES_HPP
 
 #include "Render/VKinclude/VKinclude.hpp"
+#include "VertexLayout.hpp"
 
 #include <glm/glm.hpp>
 #include <array>
+#include <cstddef>
 
 namespace Engine::Primitives {
 
@@ -12,11 +14,32 @@ namespace Engine::Primitives {
         glm::vec2 pos;
         glm::vec3 col;
 
+        using Layout = VertexLayout<Float2, Float3>;
+
         static const vk::VertexInputBindingDescription* Binding();
         static const uint64_t Size(uint64_t vertices);
-        static const std::array<const vk::VertexInputAttributeDescription, 2>& Attributes();
+        static const std::array<vk::VertexInputAttributeDescription, Layout::Count>& Attributes();
+        static constexpr VertexInputDescription Input() { return Layout::Input(); }
+    };
+
+    // 20 bytes instead of the 48 a float position, normal, color and UV take.
+    // Nothing draws with it yet, and a pipeline that does has to check the
+    // device first: A2B10G10R10 snorm isn't a required vertex buffer format.
+    struct PackedVertex {
+        std::array<uint16_t, 4> pos;    // half xyz, w = 1
+        uint32_t                normal; // snorm 10:10:10:2
+        uint32_t                col;    // rgba8 unorm
+        std::array<uint16_t, 2> uv;     // half
+
+        using Layout = VertexLayout<Half4, Snorm10x3, Unorm8x4, Half2>;
+
+        static PackedVertex Pack(const glm::vec3& position, const glm::vec3& normal, const glm::vec4& color, const glm::vec2& uv);
+        static const uint64_t Size(uint64_t vertices);
+        static constexpr VertexInputDescription Input() { return Layout::Input(); }
     };
 
+    static_assert(MatchesLayout<Vertex>()           && offsetof(Vertex, col)           == Vertex::Layout::Offsets[1]);
+    static_assert(MatchesLayout<PackedVertex>()     && offsetof(PackedVertex, uv)      == PackedVertex::Layout::Offsets[3]);
 }
 
 
@@ -0,0 +1,101 @@
+#ifndef ENGINE_PRIMITIVES_VERTEX_LAYOUT_HPP
+#define ENGINE_PRIMITIVES_VERTEX_LAYOUT_HPP
+
+#include "Render/VKinclude/VKinclude.hpp"
+
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <utility>
+
+namespace Engine::Primitives {
+
+    // One vertex attribute: the format Vulkan reads and the type it is stored as
+    template <vk::Format F, typename Storage>
+    struct AttributeFormat {
+        static constexpr vk::Format Format  { F };
+        static constexpr uint32_t   Size    { sizeof(Storage) };
+        using Type = Storage;
+    };
+
+    using Float2            = AttributeFormat<vk::Format::eR32G32Sfloat,            glm::vec2>;
+    using Float3            = AttributeFormat<vk::Format::eR32G32B32Sfloat,         glm::vec3>;
+    using Float4            = AttributeFormat<vk::Format::eR32G32B32A32Sfloat,      glm::vec4>;
+    // 3 component 16 bit formats are rarely supported for vertex fetch, so xyz + padding
+    using Half4             = AttributeFormat<vk::Format::eR16G16B16A16Sfloat,      std::array<uint16_t, 4>>;
+    using Half2             = AttributeFormat<vk::Format::eR16G16Sfloat,            std::array<uint16_t, 2>>;
+    using Unorm16x2         = AttributeFormat<vk::Format::eR16G16Unorm,             std::array<uint16_t, 2>>;
+    using Snorm10x3         = AttributeFormat<vk::Format::eA2B10G10R10SnormPack32,  uint32_t>;
+    using Unorm8x4          = AttributeFormat<vk::Format::eR8G8B8A8Unorm,           uint32_t>;
+
+    // Everything a pipeline needs to know about vertex input
+    struct VertexInputDescription {
+        const vk::VertexInputBindingDescription*    Binding         { nullptr };
+        const vk::VertexInputAttributeDescription*  Attributes      { nullptr };
+        uint32_t                                    AttributeCount  { 0 };
+    };
+
+    namespace Detail {
+
+        template <size_t N>
+        constexpr std::array<uint32_t, N> PrefixOffsets(const std::array<uint32_t, N>& sizes) {
+            std::array<uint32_t, N> offsets{};
+
+            uint32_t offset{ 0 };
+            for (size_t i = 0; i < N; ++i) {
+                offsets[i] = offset;
+                offset += sizes[i];
+            }
+            return offsets;
+        }
+
+        // Built by pack expansion, vk:: structs aren't constexpr assignable
+        template <size_t N, size_t... I>
+        constexpr std::array<vk::VertexInputAttributeDescription, N> MakeAttributes(const std::array<vk::Format, N>& formats, const std::array<uint32_t, N>& offsets, std::index_sequence<I...>) {
+            return { {
+                vk::VertexInputAttributeDescription{
+                    static_cast<uint32_t>(I),   // location
+                    0,                          // binding
+                    formats[I],                 // format
+                    offsets[I]                  // offset
+                }...
+            } };
+        }
+    }
+
+    // Attributes are tightly packed in declaration order and get
+    // locations 0..N-1, all on binding 0. Everything is computed
+    // at compile time, the descriptions live in static storage.
+    template <typename... Formats>
+    struct VertexLayout {
+
+        static constexpr uint32_t Count     { sizeof...(Formats) };
+        static constexpr uint32_t Stride    { (Formats::Size + ...) };
+
+        static constexpr std::array<uint32_t, Count> Offsets{
+            Detail::PrefixOffsets<Count>({ Formats::Size... })
+        };
+
+        static constexpr vk::VertexInputBindingDescription Binding{
+            0,                          // Binding
+            Stride,                     // Stride
+            vk::VertexInputRate::eVertex
+        };
+
+        static constexpr std::array<vk::VertexInputAttributeDescription, Count> Attributes{
+            Detail::MakeAttributes<Count>({ Formats::Format... }, Offsets, std::make_index_sequence<Count>{})
+        };
+
+        static constexpr VertexInputDescription Input() {
+            return { &Binding, Attributes.data(), Count };
+        }
+    };
+
+    // Check a vertex struct against its layout
+    template <typename Vertex>
+    constexpr bool MatchesLayout() {
+        return sizeof(Vertex) == Vertex::Layout::Stride;
+    }
+}
+
+#endif // !ENGINE_PRIMITIVES_VERTEX_LAYOUT_HPP
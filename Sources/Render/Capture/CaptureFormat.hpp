@@ -0,0 +1,66 @@
+#ifndef RENDER_CAPTURE_CAPTURE_FORMAT_HPP
+#define RENDER_CAPTURE_CAPTURE_FORMAT_HPP
+
+#include <cstdint>
+
+// Layout of a renderer capture file (.ecap)
+//
+//  [FileHeader]
+//  [Op : uint8][size : uint32][payload : size bytes] * records
+//
+// Records follow in the order the renderer was called. Everything is
+// little-endian and plain structs are written as they are in memory,
+// captures are replayed on the kind of machine that made them.
+//
+// Payloads:
+//  Frame           FrameView
+//  Vertices        Primitives::Vertex[]
+//  DrawObjects     Culling::DrawObject[]
+//  Transforms      TransformRange, then Changed glm::mat4
+//  Lights          Lighting::PointLight[]
+//  LoadMesh        MeshRequest, then the path without terminator
+//  LoadTexture     the path without terminator
+//  CommandReuse    uint8_t
+//  Resolution      Resolution::ResolutionSettings
+//  ShaderFeatures  Shader::FeatureKey
+//  ReloadPipeline, SurfaceResized  nothing
+
+namespace Engine::Render::Capture {
+
+    constexpr uint32_t CaptureMagic     { 0x50414345 };     // "ECAP"
+    constexpr uint32_t CaptureVersion   { 1 };
+
+    enum class Op : uint8_t {
+        Frame,
+        Vertices,
+        DrawObjects,
+        Transforms,
+        Lights,
+        LoadMesh,
+        LoadTexture,
+        CommandReuse,
+        Resolution,
+        ReloadPipeline,
+        SurfaceResized,
+        ShaderFeatures,
+        Count
+    };
+
+    struct FileHeader {
+        uint32_t    Magic   { CaptureMagic };
+        uint32_t    Version { CaptureVersion };
+    };
+
+    struct TransformRange {
+        uint32_t    Count   { 0 };
+        uint32_t    First   { 0 };
+        uint32_t    Changed { 0 };
+    };
+
+    struct MeshRequest {
+        uint32_t    Mesh    { 0 };
+        uint32_t    Lod     { 0 };
+    };
+}
+
+#endif // !RENDER_CAPTURE_CAPTURE_FORMAT_HPP
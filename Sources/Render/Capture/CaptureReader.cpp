@@ -0,0 +1,76 @@
+#include "CaptureReader.hpp"
+
+#include <fstream>
+#include <iterator>
+
+namespace Engine::Render::Capture {
+
+    namespace {
+        constexpr size_t RecordHeaderSize{ sizeof(uint8_t) + sizeof(uint32_t) };
+    }
+
+    std::string Record::Text(const uint32_t offset) const {
+        if (offset > Size) {
+            throw std::runtime_error("Capture record of the wrong size");
+        }
+        return std::string(reinterpret_cast<const char*>(Data) + offset, Size - offset);
+    }
+
+    CaptureReader::CaptureReader(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Couldn't open capture " + path);
+        }
+        data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+        FileHeader header{};
+        if (data.size() < sizeof(header)) {
+            throw std::runtime_error(path + " is not a capture");
+        }
+        std::memcpy(&header, data.data(), sizeof(header));
+
+        if (header.Magic != CaptureMagic) {
+            throw std::runtime_error(path + " is not a capture");
+        }
+        if (header.Version != CaptureVersion) {
+            throw std::runtime_error(path + " is capture version " + std::to_string(header.Version) + ", expected " + std::to_string(CaptureVersion));
+        }
+
+        // Counted once so replays can report progress against it
+        Rewind();
+        for (Record record{}; Next(record);) {
+            frames += record.Operation == Op::Frame ? 1 : 0;
+        }
+        Rewind();
+    }
+
+    bool CaptureReader::Next(Record& record) {
+        if (position == data.size()) return false;
+
+        if (data.size() - position < RecordHeaderSize) {
+            throw std::runtime_error("Capture ends in the middle of a record");
+        }
+
+        const auto operation{ data[position] };
+        uint32_t size{ 0 };
+        std::memcpy(&size, data.data() + position + sizeof(uint8_t), sizeof(size));
+        position += RecordHeaderSize;
+
+        if (operation >= static_cast<uint8_t>(Op::Count)) {
+            throw std::runtime_error("Unknown capture record " + std::to_string(operation));
+        }
+        if (data.size() - position < size) {
+            throw std::runtime_error("Capture ends in the middle of a record");
+        }
+
+        record.Operation = static_cast<Op>(operation);
+        record.Data      = data.data() + position;
+        record.Size      = size;
+        position += size;
+        return true;
+    }
+
+    void CaptureReader::Rewind() {
+        position = sizeof(FileHeader);
+    }
+}
@@ -0,0 +1,106 @@
+#ifndef RENDER_CAPTURE_CAPTURE_READER_HPP
+#define RENDER_CAPTURE_CAPTURE_READER_HPP
+
+#include "CaptureFormat.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Engine::Render::Capture {
+
+    // One call out of a capture. Data points into the reader's copy of
+    // the file and stays valid as long as the reader.
+    struct Record {
+        Op              Operation   { Op::Count };
+        const uint8_t*  Data        { nullptr };
+        uint32_t        Size        { 0 };
+
+        // Payload as one T, throws if the sizes differ
+        template <typename T>
+        T Value() const;
+        // The T the payload starts with, throws if it's shorter
+        template <typename T>
+        T Head() const;
+        // T[] starting offset bytes in, throws unless the rest is whole Ts
+        template <typename T>
+        std::vector<T> Array(const uint32_t offset = 0) const;
+        // Everything from offset bytes on
+        std::string Text(const uint32_t offset = 0) const;
+    };
+
+    // Reads a whole capture into memory up front, so replaying it doesn't
+    // wait on the disk, and walks its records in order
+    class CaptureReader {
+
+    private:
+        std::vector<uint8_t>    data;
+        size_t                  position{ 0 };
+        uint64_t                frames  { 0 };
+
+    public:
+        explicit CaptureReader(const std::string& path);
+
+        // No copies!
+        CaptureReader(const CaptureReader&) = delete;
+        CaptureReader& operator=(const CaptureReader&) = delete;
+
+        CaptureReader(CaptureReader&&) = default;
+        CaptureReader& operator=(CaptureReader&&) = default;
+
+        // False at the end of the file, throws on a cut off record
+        bool Next(Record& record);
+        // Back to the first record
+        void Rewind();
+
+        // Frame records in the whole file
+        const uint64_t Frames() const { return frames; }
+        const size_t   Bytes()  const { return data.size(); }
+    };
+
+
+    // Definitions
+
+    template <typename T>
+    T Record::Value() const {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        if (Size != sizeof(T)) {
+            throw std::runtime_error("Capture record of the wrong size");
+        }
+        T value{};
+        std::memcpy(&value, Data, sizeof(T));
+        return value;
+    }
+
+    template <typename T>
+    T Record::Head() const {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        if (Size < sizeof(T)) {
+            throw std::runtime_error("Capture record of the wrong size");
+        }
+        T value{};
+        std::memcpy(&value, Data, sizeof(T));
+        return value;
+    }
+
+    template <typename T>
+    std::vector<T> Record::Array(const uint32_t offset) const {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        if (offset > Size || (Size - offset) % sizeof(T) != 0) {
+            throw std::runtime_error("Capture record of the wrong size");
+        }
+        std::vector<T> values((Size - offset) / sizeof(T));
+        if (!values.empty()) {
+            std::memcpy(values.data(), Data + offset, Size - offset);
+        }
+        return values;
+    }
+}
+
+#endif // !RENDER_CAPTURE_CAPTURE_READER_HPP
@@ -0,0 +1,119 @@
+#include "CaptureWriter.hpp"
+
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+namespace Engine::Render::Capture {
+
+    namespace EP = Engine::Primitives;
+
+    static_assert(std::is_trivially_copyable_v<FrameView>);
+    static_assert(std::is_trivially_copyable_v<EP::Vertex>);
+    static_assert(std::is_trivially_copyable_v<Culling::DrawObject>);
+    static_assert(std::is_trivially_copyable_v<Lighting::PointLight>);
+    static_assert(std::is_trivially_copyable_v<Resolution::ResolutionSettings>);
+
+    CaptureWriter::CaptureWriter(const std::string& path) :
+        file(path, std::ios::binary | std::ios::trunc),
+        path(path)
+    {
+        const FileHeader header{};
+        Append(&header, sizeof(header));
+    }
+
+    void CaptureWriter::Begin(const Op operation, const uint64_t size) {
+        if (size > std::numeric_limits<uint32_t>::max()) {
+            throw std::runtime_error("Capture record too large for " + path);
+        }
+
+        const auto op    { static_cast<uint8_t>(operation) };
+        const auto size32{ static_cast<uint32_t>(size) };
+        Append(&op, sizeof(op));
+        Append(&size32, sizeof(size32));
+    }
+
+    void CaptureWriter::Append(const void* data, const uint64_t size) {
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        bytes += size;
+        Check();
+    }
+
+    void CaptureWriter::Check() {
+        if (!file) {
+            throw std::runtime_error("Couldn't write the capture to " + path);
+        }
+    }
+
+    void CaptureWriter::DrawFrame(const FrameView& view) {
+        Begin(Op::Frame, sizeof(view));
+        Append(&view, sizeof(view));
+        ++frames;
+    }
+
+    void CaptureWriter::UpdateVertices(const std::vector<EP::Vertex>& vertices) {
+        Begin(Op::Vertices, vertices.size() * sizeof(EP::Vertex));
+        Append(vertices.data(), vertices.size() * sizeof(EP::Vertex));
+    }
+
+    void CaptureWriter::SetDrawObjects(const std::vector<Culling::DrawObject>& objects) {
+        Begin(Op::DrawObjects, objects.size() * sizeof(Culling::DrawObject));
+        Append(objects.data(), objects.size() * sizeof(Culling::DrawObject));
+    }
+
+    void CaptureWriter::SetTransforms(const glm::mat4* worlds, const uint32_t count, const uint32_t first, const uint32_t changed) {
+        const TransformRange range{ count, first, changed };
+        const auto matrices{ uint64_t{ changed } * sizeof(glm::mat4) };
+
+        Begin(Op::Transforms, sizeof(range) + matrices);
+        Append(&range, sizeof(range));
+        Append(worlds + first, matrices);
+    }
+
+    void CaptureWriter::SetLights(const std::vector<Lighting::PointLight>& lights) {
+        Begin(Op::Lights, lights.size() * sizeof(Lighting::PointLight));
+        Append(lights.data(), lights.size() * sizeof(Lighting::PointLight));
+    }
+
+    void CaptureWriter::LoadMesh(const std::string& meshPath, const uint32_t mesh, const uint32_t lod) {
+        const MeshRequest request{ mesh, lod };
+
+        Begin(Op::LoadMesh, sizeof(request) + meshPath.size());
+        Append(&request, sizeof(request));
+        Append(meshPath.data(), meshPath.size());
+    }
+
+    void CaptureWriter::LoadTexture(const std::string& texturePath) {
+        Begin(Op::LoadTexture, texturePath.size());
+        Append(texturePath.data(), texturePath.size());
+    }
+
+    void CaptureWriter::SetCommandReuse(const bool enabled) {
+        const uint8_t value{ enabled ? uint8_t{ 1 } : uint8_t{ 0 } };
+        Begin(Op::CommandReuse, sizeof(value));
+        Append(&value, sizeof(value));
+    }
+
+    void CaptureWriter::SetResolution(const Resolution::ResolutionSettings& settings) {
+        Begin(Op::Resolution, sizeof(settings));
+        Append(&settings, sizeof(settings));
+    }
+
+    void CaptureWriter::ReloadPipeline() {
+        Begin(Op::ReloadPipeline, 0);
+    }
+
+    void CaptureWriter::SurfaceResized() {
+        Begin(Op::SurfaceResized, 0);
+    }
+
+    void CaptureWriter::SetShaderFeatures(const Shader::FeatureKey features) {
+        Begin(Op::ShaderFeatures, sizeof(features));
+        Append(&features, sizeof(features));
+    }
+
+    void CaptureWriter::Flush() {
+        file.flush();
+        Check();
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef RENDER_CAPTURE_CAPTURE_WRITER_HPP
+#define RENDER_CAPTURE_CAPTURE_WRITER_HPP
+
+#include "CaptureFormat.hpp"
+#include "Culling/OcclusionCuller.hpp"
+#include "Lighting/ClusteredLighting.hpp"
+#include "Resolution/ResolutionController.hpp"
+#include "Shader/ShaderVariant.hpp"
+#include "Primitives/Vertex.hpp"
+#include "FrameView.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace Engine::Render::Capture {
+
+    // Appends the renderer's calls to a capture file, see CaptureFormat.hpp.
+    // Writes go through the stream's buffer, nothing is flushed per frame.
+    class CaptureWriter {
+
+    private:
+        std::ofstream   file;
+        std::string     path;
+        uint64_t        frames  { 0 };
+        uint64_t        bytes   { 0 };
+
+        void Begin(const Op operation, const uint64_t size);
+        void Append(const void* data, const uint64_t size);
+        void Check();
+
+    public:
+        explicit CaptureWriter(const std::string& path);
+
+        // No copies!
+        CaptureWriter(const CaptureWriter&) = delete;
+        CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+        CaptureWriter(CaptureWriter&&) = default;
+        CaptureWriter& operator=(CaptureWriter&&) = default;
+
+        void DrawFrame(const FrameView& view);
+        void UpdateVertices(const std::vector<Engine::Primitives::Vertex>& vertices);
+        void SetDrawObjects(const std::vector<Culling::DrawObject>& objects);
+        // Only the changed range goes in, as SetTransforms uploads it
+        void SetTransforms(const glm::mat4* worlds, const uint32_t count, const uint32_t first, const uint32_t changed);
+        void SetLights(const std::vector<Lighting::PointLight>& lights);
+        void LoadMesh(const std::string& meshPath, const uint32_t mesh, const uint32_t lod);
+        void LoadTexture(const std::string& texturePath);
+        void SetCommandReuse(const bool enabled);
+        void SetResolution(const Resolution::ResolutionSettings& settings);
+        void ReloadPipeline();
+        void SurfaceResized();
+        void SetShaderFeatures(const Shader::FeatureKey features);
+
+        // Writes out what is buffered, the file stays open
+        void Flush();
+
+        const std::string&  Path()      const { return path; }
+        const uint64_t      Frames()    const { return frames; }
+        const uint64_t      Bytes()     const { return bytes; }
+    };
+}
+
+#endif // !RENDER_CAPTURE_CAPTURE_WRITER_HPP
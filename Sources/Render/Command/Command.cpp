@@ -6,33 +6,310 @@ namespace Engine::Render::Command {
 
     namespace ERQU = Engine::Render::Queue;
 
-    std::map<ERQU::QueueType, vk::UniqueCommandPool> CreateQueueCommandPool(const vk::Device& renderDevice, const ERQU::QueueManager& qmg) {
-        std::map<Engine::Render::Queue::QueueType, vk::UniqueCommandPool> cmdPools{};
+    CommandPools CreateQueueCommandPool(const vk::Device& renderDevice, const ERQU::QueueManager& qmg, const vk::CommandPoolCreateFlags& flags) {
+        CommandPools cmdPools{};
 
-        for (const auto& i : qmg.RequestedQueues()) {
-            if (i.second.Used > 0) {
-                cmdPools.emplace(i.first, renderDevice.createCommandPoolUnique(vk::CommandPoolCreateInfo()
-                    .setQueueFamilyIndex(i.second.Index))
+        for (const auto qt : ERQU::QueueTypes) {
+            const auto& queueFam{ qmg.RequestedQueues()[qt] };
+            if (queueFam.Used > 0) {
+                cmdPools[qt] = renderDevice.createCommandPoolUnique(vk::CommandPoolCreateInfo()
+                    .setQueueFamilyIndex(queueFam.Index)
+                    .setFlags(flags)
                 );
             }
         }
         return cmdPools;
     }
 
-    std::map<ERQU::QueueType, std::vector<vk::UniqueCommandBuffer>> CreateCommandBuffers(const vk::Device& renderDevice, const std::map<ERQU::QueueType, vk::UniqueCommandPool>& cmdPools, const uint32_t numBuffers) {
-        std::map<ERQU::QueueType, std::vector<vk::UniqueCommandBuffer>> ret{};
+    CommandBuffers CreateCommandBuffers(const vk::Device& renderDevice, const CommandPools& cmdPools, const uint32_t numBuffers) {
+        CommandBuffers ret{};
 
-        for (const auto& cmdPool : cmdPools) {
-            ret.emplace(cmdPool.first, renderDevice.allocateCommandBuffersUnique(vk::CommandBufferAllocateInfo()
-                .setCommandPool(cmdPool.second.get())
+        for (const auto qt : ERQU::QueueTypes) {
+            if (!cmdPools[qt]) continue;
+
+            ret[qt] = renderDevice.allocateCommandBuffersUnique(vk::CommandBufferAllocateInfo()
+                .setCommandPool(cmdPools[qt].get())
                 .setCommandBufferCount(numBuffers)
                 .setLevel(vk::CommandBufferLevel::ePrimary)
-            ));
+            );
         }
 
         return ret;
     }
 
+    void SubmitOnce(const vk::Device& renderDevice, const vk::Queue& queue, const vk::CommandPool& pool, const std::function<void(const vk::CommandBuffer&)>& record) {
+        auto cmdBuffers{ renderDevice.allocateCommandBuffersUnique(vk::CommandBufferAllocateInfo()
+            .setCommandPool(pool)
+            .setCommandBufferCount(1)
+            .setLevel(vk::CommandBufferLevel::ePrimary)
+        ) };
+
+        const auto& cmdBuffer{ cmdBuffers.front().get() };
+
+        cmdBuffer.begin(vk::CommandBufferBeginInfo()
+            .setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
+        );
+        record(cmdBuffer);
+        cmdBuffer.end();
+
+        const auto fence{ renderDevice.createFenceUnique({}) };
+
+        queue.submit(vk::SubmitInfo()
+            .setCommandBufferCount(1)
+            .setPCommandBuffers(&cmdBuffer),
+            fence.get()
+        );
+
+        renderDevice.waitForFences(1, &fence.get(), true, UINT64_MAX);
+    }
+
+    namespace {
+        const auto colorRange{ vk::ImageSubresourceRange()
+            .setAspectMask(vk::ImageAspectFlagBits::eColor)
+            .setBaseMipLevel(0)
+            .setLevelCount(1)
+            .setBaseArrayLayer(0)
+            .setLayerCount(1)
+        };
+    }
+
+    // Contents are cleared anyway, so the old layout can be thrown away. The
+    // acquire semaphore is waited on at color attachment output, sync there.
+    // A render target may still be read by the previous frame's blit, so
+    // transfers are waited on too.
+    void TransitionForRendering(const vk::CommandBuffer& cmdBuffer, const Engine::Render::Device::DeviceDispatch& d, const vk::Image& image) {
+        const auto barrier{ vk::ImageMemoryBarrier()
+            .setSrcAccessMask({})
+            .setDstAccessMask(vk::AccessFlagBits::eColorAttachmentWrite)
+            .setOldLayout(vk::ImageLayout::eUndefined)
+            .setNewLayout(vk::ImageLayout::eColorAttachmentOptimal)
+            .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+            .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+            .setImage(image)
+            .setSubresourceRange(colorRange)
+        };
+
+        cmdBuffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eColorAttachmentOutput | vk::PipelineStageFlagBits::eTransfer,
+            vk::PipelineStageFlagBits::eColorAttachmentOutput,
+            {}, nullptr, nullptr, barrier, d);
+    }
+
+    void TransitionForPresent(const vk::CommandBuffer& cmdBuffer, const Engine::Render::Device::DeviceDispatch& d, const vk::Image& image) {
+        const auto barrier{ vk::ImageMemoryBarrier()
+            .setSrcAccessMask(vk::AccessFlagBits::eColorAttachmentWrite)
+            .setDstAccessMask({})
+            .setOldLayout(vk::ImageLayout::eColorAttachmentOptimal)
+            .setNewLayout(vk::ImageLayout::ePresentSrcKHR)
+            .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+            .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+            .setImage(image)
+            .setSubresourceRange(colorRange)
+        };
+
+        cmdBuffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eColorAttachmentOutput,
+            vk::PipelineStageFlagBits::eBottomOfPipe,
+            {}, nullptr, nullptr, barrier, d);
+    }
+
+    void TransitionForBlit(const vk::CommandBuffer& cmdBuffer, const Engine::Render::Device::DeviceDispatch& d, const vk::Image& image) {
+        const auto barrier{ vk::ImageMemoryBarrier()
+            .setSrcAccessMask(vk::AccessFlagBits::eColorAttachmentWrite)
+            .setDstAccessMask(vk::AccessFlagBits::eTransferRead)
+            .setOldLayout(vk::ImageLayout::eColorAttachmentOptimal)
+            .setNewLayout(vk::ImageLayout::eTransferSrcOptimal)
+            .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+            .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+            .setImage(image)
+            .setSubresourceRange(colorRange)
+        };
+
+        cmdBuffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eColorAttachmentOutput,
+            vk::PipelineStageFlagBits::eTransfer,
+            {}, nullptr, nullptr, barrier, d);
+    }
+
+    void TransitionDepthForRendering(const vk::CommandBuffer& cmdBuffer, const Engine::Render::Device::DeviceDispatch& d, const vk::Image& image) {
+        const auto barrier{ vk::ImageMemoryBarrier()
+            .setSrcAccessMask(vk::AccessFlagBits::eDepthStencilAttachmentWrite)
+            .setDstAccessMask(vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eDepthStencilAttachmentWrite)
+            .setOldLayout(vk::ImageLayout::eUndefined)
+            .setNewLayout(vk::ImageLayout::eDepthStencilAttachmentOptimal)
+            .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+            .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+            .setImage(image)
+            .setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eDepth, 0, 1, 0, 1))
+        };
+
+        cmdBuffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eLateFragmentTests | vk::PipelineStageFlagBits::eComputeShader,
+            vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests,
+            {}, nullptr, nullptr, barrier, d);
+    }
+
+    void SetViewport(const vk::CommandBuffer& cmdBuffer, const Engine::Render::Device::DeviceDispatch& d, const vk::Extent2D& area) {
+        const auto viewport{ vk::Viewport()
+            .setX(0)
+            .setY(0)
+            .setWidth(static_cast<float>(area.width))
+            .setHeight(static_cast<float>(area.height))
+            .setMinDepth(0.0f)
+            .setMaxDepth(1.0f)
+        };
+
+        cmdBuffer.setViewport(0, viewport, d);
+        cmdBuffer.setScissor(0, vk::Rect2D({ 0, 0 }, area), d);
+    }
+
+    void BeginScene(const vk::CommandBuffer& cmdBuffer, const Engine::Render::Device::DeviceDispatch& d, const FrameTarget& target, const bool load, const bool secondary) {
+
+        const auto renderArea{ vk::Rect2D()
+            .setExtent(target.Area)
+            .setOffset({0, 0})
+        };
+
+        const auto clearValues{ vk::ClearValue()
+            .setColor(vk::ClearColorValue(std::array<float, 4>{0.0f, 0.0f, 0.0f, 0.0f}))
+        };
+
+        const auto depthClear{ vk::ClearValue()
+            .setDepthStencil(vk::ClearDepthStencilValue(1.0f, 0))
+        };
+
+        if (target.RenderPass) {
+            const auto renderPassBeginInfo{ vk::RenderPassBeginInfo()
+                .setRenderPass(target.RenderPass)
+                .setClearValueCount(1)
+                .setPClearValues(&clearValues)
+                .setFramebuffer(target.Framebuffer)
+                .setRenderArea(renderArea)
+            };
+
+            cmdBuffer.beginRenderPass(renderPassBeginInfo, secondary ? vk::SubpassContents::eSecondaryCommandBuffers : vk::SubpassContents::eInline, d);
+        }
+        else {
+            const auto loadOp{ load ? vk::AttachmentLoadOp::eLoad : vk::AttachmentLoadOp::eClear };
+
+            const auto colorAttachment{ vk::RenderingAttachmentInfoKHR()
+                .setImageView(target.View)
+                .setImageLayout(vk::ImageLayout::eColorAttachmentOptimal)
+                .setLoadOp(loadOp)
+                .setStoreOp(vk::AttachmentStoreOp::eStore)
+                .setClearValue(clearValues)
+            };
+
+            const auto depthAttachment{ vk::RenderingAttachmentInfoKHR()
+                .setImageView(target.DepthView)
+                .setImageLayout(vk::ImageLayout::eDepthStencilAttachmentOptimal)
+                .setLoadOp(loadOp)
+                .setStoreOp(vk::AttachmentStoreOp::eStore)
+                .setClearValue(depthClear)
+            };
+
+            const auto renderingInfo{ vk::RenderingInfoKHR()
+                .setFlags(secondary ? vk::RenderingFlagBitsKHR::eContentsSecondaryCommandBuffers : vk::RenderingFlagsKHR())
+                .setRenderArea(renderArea)
+                .setLayerCount(1)
+                .setColorAttachmentCount(1)
+                .setPColorAttachments(&colorAttachment)
+                .setPDepthAttachment(target.DepthView ? &depthAttachment : nullptr)
+            };
+
+            if (load) {
+                // Compute ran in between, the color written so far has to land first
+                cmdBuffer.pipelineBarrier(
+                    vk::PipelineStageFlagBits::eColorAttachmentOutput,
+                    vk::PipelineStageFlagBits::eColorAttachmentOutput,
+                    {},
+                    vk::MemoryBarrier()
+                        .setSrcAccessMask(vk::AccessFlagBits::eColorAttachmentWrite)
+                        .setDstAccessMask(vk::AccessFlagBits::eColorAttachmentRead | vk::AccessFlagBits::eColorAttachmentWrite),
+                    nullptr, nullptr, d);
+            }
+            else {
+                TransitionForRendering(cmdBuffer, d, target.Image);
+                if (target.DepthImage) {
+                    TransitionDepthForRendering(cmdBuffer, d, target.DepthImage);
+                }
+            }
+            cmdBuffer.beginRenderingKHR(renderingInfo, d);
+        }
+
+        // Only vkCmdExecuteCommands may follow, the secondaries set their own
+        if (!secondary) {
+            SetViewport(cmdBuffer, d, target.Area);
+        }
+    }
+
+    void BindPipeline(const vk::CommandBuffer& cmdBuffer, const Engine::Render::Device::DeviceDispatch& d, const vk::ArrayProxy<const vk::DescriptorSet>& descriptorSets, Pipeline& pipeline) {
+        cmdBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline.GetPipeline(), d);
+        cmdBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipeline.GetPipelineLayout(), 0, descriptorSets, nullptr, d);
+    }
+
+    void EndScene(const vk::CommandBuffer& cmdBuffer, const Engine::Render::Device::DeviceDispatch& d, const FrameTarget& target, const bool finish) {
+        if (target.RenderPass) {
+            cmdBuffer.endRenderPass(d);
+            return;
+        }
+
+        cmdBuffer.endRenderingKHR(d);
+        if (!finish) return;
+
+        if (target.FinalLayout == vk::ImageLayout::eTransferSrcOptimal) {
+            TransitionForBlit(cmdBuffer, d, target.Image);
+        }
+        else {
+            TransitionForPresent(cmdBuffer, d, target.Image);
+        }
+    }
+
+    // Linear filtering, the source is at most as large as the swapchain
+    void BlitToSwapchain(const vk::CommandBuffer& cmdBuffer, const Engine::Render::Device::DeviceDispatch& d, const vk::Image& source, const vk::Extent2D& sourceArea, const vk::Image& swapImage, const vk::Extent2D& swapExtent) {
+        const auto toTransfer{ vk::ImageMemoryBarrier()
+            .setSrcAccessMask({})
+            .setDstAccessMask(vk::AccessFlagBits::eTransferWrite)
+            .setOldLayout(vk::ImageLayout::eUndefined)
+            .setNewLayout(vk::ImageLayout::eTransferDstOptimal)
+            .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+            .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+            .setImage(swapImage)
+            .setSubresourceRange(colorRange)
+        };
+
+        cmdBuffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTransfer,
+            vk::PipelineStageFlagBits::eTransfer,
+            {}, nullptr, nullptr, toTransfer, d);
+
+        const auto layers{ vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, 1) };
+        const auto region{ vk::ImageBlit()
+            .setSrcSubresource(layers)
+            .setSrcOffsets({ vk::Offset3D(0, 0, 0), vk::Offset3D(static_cast<int32_t>(sourceArea.width), static_cast<int32_t>(sourceArea.height), 1) })
+            .setDstSubresource(layers)
+            .setDstOffsets({ vk::Offset3D(0, 0, 0), vk::Offset3D(static_cast<int32_t>(swapExtent.width), static_cast<int32_t>(swapExtent.height), 1) })
+        };
+
+        cmdBuffer.blitImage(source, vk::ImageLayout::eTransferSrcOptimal, swapImage, vk::ImageLayout::eTransferDstOptimal, region, vk::Filter::eLinear, d);
+
+        const auto toPresent{ vk::ImageMemoryBarrier()
+            .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+            .setDstAccessMask({})
+            .setOldLayout(vk::ImageLayout::eTransferDstOptimal)
+            .setNewLayout(vk::ImageLayout::ePresentSrcKHR)
+            .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+            .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+            .setImage(swapImage)
+            .setSubresourceRange(colorRange)
+        };
+
+        cmdBuffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTransfer,
+            vk::PipelineStageFlagBits::eBottomOfPipe,
+            {}, nullptr, nullptr, toPresent, d);
+    }
+
     void RecordCommands(const ERQU::QueueType qt, std::vector<vk::UniqueCommandBuffer>& cmdBuffers, const std::vector<vk::UniqueFramebuffer>& framebuffer, const vk::RenderPass& renderPass, Pipeline& pipeline, const vk::Extent2D& extents) {
         // TODO: Maybe use std::functional?
  
@@ -4,6 +4,9 @@
 #include "VKinclude/VKinclude.hpp"
 #include "Queue/Queue.hpp"
 #include "Memory/Buffers.hpp"
+#include "Device/Dispatch.hpp"
+
+#include <functional>
 
 namespace Engine::Render {
     class Pipeline;
@@ -13,48 +16,92 @@ namespace Engine::Render::Command {
 
     namespace ERQU = Engine::Render::Queue;
 
-    std::map<ERQU::QueueType, vk::UniqueCommandPool> CreateQueueCommandPool (const vk::Device& phyDev, const ERQU::QueueManager& qmg);
-    std::map<ERQU::QueueType, std::vector<vk::UniqueCommandBuffer>> CreateCommandBuffers(const vk::Device& renderDevice, const std::map<ERQU::QueueType, vk::UniqueCommandPool>& cmdPools, const uint32_t numBuffers);
+    // Where one frame draws. A null RenderPass selects dynamic rendering,
+    // Framebuffer goes unused then. Area is drawn from the top left corner
+    // and may be smaller than the image. FinalLayout is ePresentSrcKHR for
+    // swapchain images and eTransferSrcOptimal for the scaled render target.
+    // The depth buffer is optional and dynamic rendering only.
+    struct FrameTarget {
+        vk::Image           Image;
+        vk::ImageView       View;
+        vk::Framebuffer     Framebuffer;
+        vk::RenderPass      RenderPass;
+        vk::Extent2D        Area;
+        vk::ImageLayout     FinalLayout{ vk::ImageLayout::ePresentSrcKHR };
+        vk::Image           DepthImage;
+        vk::ImageView       DepthView;
+    };
+
+    using CommandPools      = ERQU::QueueTable<vk::UniqueCommandPool>;
+    using CommandBuffers    = ERQU::QueueTable<std::vector<vk::UniqueCommandBuffer>>;
 
+    // Types without queues get a null pool and no buffers
+    CommandPools    CreateQueueCommandPool (const vk::Device& phyDev, const ERQU::QueueManager& qmg, const vk::CommandPoolCreateFlags& flags = {});
+    CommandBuffers  CreateCommandBuffers(const vk::Device& renderDevice, const CommandPools& cmdPools, const uint32_t numBuffers);
+
+    // Starts drawing into target inside an already begun command buffer.
+    // With load the color and depth drawn by an earlier BeginScene/EndScene
+    // pair are kept, dynamic rendering only. Sets viewport and scissor,
+    // unless secondary: the pass is then only drawn by executing secondary
+    // command buffers, see SecondaryCache.hpp.
+    void BeginScene(const vk::CommandBuffer& cmdBuffer, const Engine::Render::Device::DeviceDispatch& d, const FrameTarget& target, const bool load = false, const bool secondary = false);
+    // Full area viewport and scissor from the top left corner
+    void SetViewport(const vk::CommandBuffer& cmdBuffer, const Engine::Render::Device::DeviceDispatch& d, const vk::Extent2D& area);
+    // Without finish the color attachment stays as it is for another pass
+    void EndScene(const vk::CommandBuffer& cmdBuffer, const Engine::Render::Device::DeviceDispatch& d, const FrameTarget& target, const bool finish = true);
+    // Pipeline and sets from set 0 on, for geometry bound separately
+    void BindPipeline(const vk::CommandBuffer& cmdBuffer, const Engine::Render::Device::DeviceDispatch& d, const vk::ArrayProxy<const vk::DescriptorSet>& descriptorSets, Pipeline& pipeline);
+    // Pipeline, sets from set 0 on, vertices and indices if there are any
+    template <typename T>
+    void BindScene(const vk::CommandBuffer& cmdBuffer, const Engine::Render::Device::DeviceDispatch& d, const vk::ArrayProxy<const vk::DescriptorSet>& descriptorSets, Pipeline& pipeline, const Engine::Render::Memory::DeviceMemory<T>& v, const Engine::Render::Memory::DeviceMemory<uint32_t>& indices);
+    // Records the draws of one frame into an already begun command buffer,
+    // descriptorSets are bound from set 0 on
     template <typename T>
-    void RecordGraphicsCommandBuffers(std::vector<vk::UniqueCommandBuffer>& cmdBuffers, const std::vector<vk::UniqueFramebuffer>& framebuffer, const vk::RenderPass& renderPass, Pipeline& pipeline, const vk::Extent2D& extents, const Engine::Render::Memory::DeviceMemory<T>& buffer);
+    void RecordScene(const vk::CommandBuffer& cmdBuffer, const Engine::Render::Device::DeviceDispatch& d, const FrameTarget& target, const vk::ArrayProxy<const vk::DescriptorSet>& descriptorSets, Pipeline& pipeline, const Engine::Render::Memory::DeviceMemory<T>& buffer, const Engine::Render::Memory::DeviceMemory<uint32_t>& indices);
+    // Records into a throwaway command buffer, submits it and waits. Load time only.
+    void SubmitOnce(const vk::Device& renderDevice, const vk::Queue& queue, const vk::CommandPool& pool, const std::function<void(const vk::CommandBuffer&)>& record);
+
     void RecordCommands(const ERQU::QueueType, std::vector<vk::UniqueCommandBuffer>& cmdBuffers, const std::vector<vk::UniqueFramebuffer>& framebuffer, const vk::RenderPass& renderPass, Engine::Render::Pipeline& pipeline, const vk::Extent2D& extents);
 
+    // Swapchain image layout changes around a dynamic rendering pass, what the
+    // render pass' initial/final layouts and external dependency did before
+    void TransitionForRendering(const vk::CommandBuffer& cmdBuffer, const Engine::Render::Device::DeviceDispatch& d, const vk::Image& image);
+    void TransitionForPresent(const vk::CommandBuffer& cmdBuffer, const Engine::Render::Device::DeviceDispatch& d, const vk::Image& image);
+    void TransitionForBlit(const vk::CommandBuffer& cmdBuffer, const Engine::Render::Device::DeviceDispatch& d, const vk::Image& image);
+    // Depth is cleared every frame, the previous frame's tests and reads are waited on
+    void TransitionDepthForRendering(const vk::CommandBuffer& cmdBuffer, const Engine::Render::Device::DeviceDispatch& d, const vk::Image& image);
+
+    // Stretches the top left sourceArea of a render target in eTransferSrcOptimal
+    // over the whole swapchain image, and leaves that ready to present.
+    // The acquire semaphore has to be waited on at the transfer stage.
+    void BlitToSwapchain(const vk::CommandBuffer& cmdBuffer, const Engine::Render::Device::DeviceDispatch& d, const vk::Image& source, const vk::Extent2D& sourceArea, const vk::Image& swapImage, const vk::Extent2D& swapExtent);
+
     template <typename T>
-    void RecordGraphicsCommandBuffers(std::vector<vk::UniqueCommandBuffer>& cmdBuffers, const std::vector<vk::UniqueFramebuffer>& framebuffer, const vk::RenderPass& renderPass, Pipeline& pipeline, const vk::Extent2D& extents, const Engine::Render::Memory::DeviceMemory<T>& v) {
-
-        int index{ -1 };
-        // Record commands for each framebuffer and pick the right one at runtime
-        for (const auto& cmdBuffer : cmdBuffers) {
-            ++index;
-            const auto commandBufferBeginInfo{ vk::CommandBufferBeginInfo() };
-
-            const auto clearValues{ vk::ClearValue()
-                .setColor(vk::ClearColorValue(std::array<float, 4>{0.0f, 0.0f, 0.0f, 0.0f}))
-            };
-
-            const auto renderPassBeginInfo{ vk::RenderPassBeginInfo()
-                .setRenderPass(renderPass)
-                .setClearValueCount(1)
-                .setPClearValues(&clearValues)
-                .setFramebuffer(framebuffer[index].get())
-                .setRenderArea(vk::Rect2D()
-                    .setExtent(extents)
-                    .setOffset({0, 0})
-                )
-            };
-
-            cmdBuffer.get().begin(commandBufferBeginInfo);
-            cmdBuffer.get().beginRenderPass(renderPassBeginInfo, vk::SubpassContents::eInline);
-            cmdBuffer.get().bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline.GetPipeline());
-            vk::DeviceSize offsets{};
-            cmdBuffer.get().bindVertexBuffers(0, 1, v.Buffer(), &offsets);
-            cmdBuffer.get().draw(v.Size(), 1, 0, 0);
-            cmdBuffer.get().endRenderPass();
-            cmdBuffer.get().end();
+    void BindScene(const vk::CommandBuffer& cmdBuffer, const Engine::Render::Device::DeviceDispatch& d, const vk::ArrayProxy<const vk::DescriptorSet>& descriptorSets, Pipeline& pipeline, const Engine::Render::Memory::DeviceMemory<T>& v, const Engine::Render::Memory::DeviceMemory<uint32_t>& indices) {
+        BindPipeline(cmdBuffer, d, descriptorSets, pipeline);
+        vk::DeviceSize offsets{};
+        cmdBuffer.bindVertexBuffers(0, 1, v.Buffer(), &offsets, d);
+
+        if (indices.Size() > 0) {
+            cmdBuffer.bindIndexBuffer(*indices.Buffer(), 0, vk::IndexType::eUint32, d);
         }
     }
 
+    template <typename T>
+    void RecordScene(const vk::CommandBuffer& cmdBuffer, const Engine::Render::Device::DeviceDispatch& d, const FrameTarget& target, const vk::ArrayProxy<const vk::DescriptorSet>& descriptorSets, Pipeline& pipeline, const Engine::Render::Memory::DeviceMemory<T>& v, const Engine::Render::Memory::DeviceMemory<uint32_t>& indices) {
+        BeginScene(cmdBuffer, d, target);
+        BindScene(cmdBuffer, d, descriptorSets, pipeline, v, indices);
+
+        if (indices.Size() > 0) {
+            cmdBuffer.drawIndexed(indices.Size(), 1, 0, 0, 0, d);
+        }
+        else {
+            cmdBuffer.draw(v.Size(), 1, 0, 0, d);
+        }
+
+        EndScene(cmdBuffer, d, target);
+    }
+
 }
 
 
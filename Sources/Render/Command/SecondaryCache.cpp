@@ -0,0 +1,81 @@
+#include "SecondaryCache.hpp"
+#include "Command.hpp"
+
+namespace Engine::Render::Command {
+
+    namespace ERD = Engine::Render::Device;
+
+    SecondaryCache::SecondaryCache(const vk::Device& renderDevice, const uint32_t queueFamily, const uint32_t buckets, const uint32_t slotCount) :
+        pool(renderDevice.createCommandPoolUnique(vk::CommandPoolCreateInfo()
+            .setQueueFamilyIndex(queueFamily)
+            .setFlags(vk::CommandPoolCreateFlagBits::eResetCommandBuffer)
+        )),
+        slots(slotCount),
+        entries(buckets * slotCount)
+    {
+        auto buffers{ renderDevice.allocateCommandBuffersUnique(vk::CommandBufferAllocateInfo()
+            .setCommandPool(pool.get())
+            .setCommandBufferCount(buckets * slotCount)
+            .setLevel(vk::CommandBufferLevel::eSecondary)
+        ) };
+
+        for (size_t i = 0; i < entries.size(); ++i) {
+            entries[i].Buffer = std::move(buffers[i]);
+        }
+    }
+
+    const Secondary SecondaryCache::Acquire(const ERD::DeviceDispatch& d, const uint32_t bucket, const uint32_t slot, const uint64_t frameNumber,
+        const uint64_t key, const AttachmentLayout& layout, const vk::Extent2D& area) {
+
+        auto& entry{ entries[bucket * slots + slot] };
+
+        auto fullKey{ CombineKey(key, HandleKey(layout.RenderPass)) };
+        fullKey = CombineKey(fullKey, static_cast<uint64_t>(layout.Color));
+        fullKey = CombineKey(fullKey, static_cast<uint64_t>(layout.Depth));
+        fullKey = CombineKey(fullKey, (uint64_t{ area.width } << 32) | area.height);
+
+        const bool fresh{ entry.Recorded && entry.LastFrame + slots == frameNumber };
+        entry.LastFrame = frameNumber;
+
+        if (fresh && entry.Key == fullKey) {
+            ++reused;
+            return { entry.Buffer.get(), false };
+        }
+
+        // The framebuffer is optional and left out, so swapchain rebuilds
+        // don't show up in the key
+        const auto rendering{ vk::CommandBufferInheritanceRenderingInfoKHR()
+            .setColorAttachmentCount(1)
+            .setPColorAttachmentFormats(&layout.Color)
+            .setDepthAttachmentFormat(layout.Depth)
+            .setRasterizationSamples(vk::SampleCountFlagBits::e1)
+        };
+
+        auto inheritance{ vk::CommandBufferInheritanceInfo()
+            .setRenderPass(layout.RenderPass)
+            .setSubpass(0)
+        };
+        if (!layout.RenderPass) {
+            inheritance.setPNext(&rendering);
+        }
+
+        const auto& cmdBuffer{ entry.Buffer.get() };
+        cmdBuffer.begin(vk::CommandBufferBeginInfo()
+            .setFlags(vk::CommandBufferUsageFlagBits::eRenderPassContinue)
+            .setPInheritanceInfo(&inheritance),
+            d
+        );
+        SetViewport(cmdBuffer, d, area);
+
+        entry.Key      = fullKey;
+        entry.Recorded = true;
+        ++recorded;
+        return { cmdBuffer, true };
+    }
+
+    void SecondaryCache::Invalidate() {
+        for (auto& entry : entries) {
+            entry.Recorded = false;
+        }
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef RENDER_COMMAND_SECONDARY_CACHE_HPP
+#define RENDER_COMMAND_SECONDARY_CACHE_HPP
+
+#include "VKinclude/VKinclude.hpp"
+#include "Device/Dispatch.hpp"
+#include "Pipeline/Pipeline.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace Engine::Render::Command {
+
+    // Folds value into key, order matters
+    inline uint64_t CombineKey(const uint64_t key, const uint64_t value) {
+        return key ^ (value + 0x9e3779b97f4a7c15ull + (key << 6) + (key >> 2));
+    }
+
+    // FNV-1a over a block of plain data, push constants and the like
+    inline uint64_t HashBytes(const void* data, const size_t size) {
+        uint64_t hash{ 0xcbf29ce484222325ull };
+        const auto* bytes{ static_cast<const uint8_t*>(data) };
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    // Raw bits of a Vulkan handle, a pointer or a 64 bit integer
+    // depending on the platform
+    template <typename Handle>
+    uint64_t HandleKey(const Handle& handle) {
+        const auto raw{ static_cast<typename Handle::CType>(handle) };
+        uint64_t bits{ 0 };
+        std::memcpy(&bits, &raw, sizeof(raw));
+        return bits;
+    }
+
+    // What SecondaryCache::Acquire hands out
+    struct Secondary {
+        vk::CommandBuffer   Buffer;
+        bool                Record{ false };
+    };
+
+    // Secondary command buffers for the parts of a frame that rarely
+    // change, one per bucket and frame slot. Each is recorded again only
+    // when the key the caller builds from the bucket's inputs (generation
+    // counters, handles, constants) differs from the one it was recorded
+    // with, otherwise the last recording is executed as it is.
+    //
+    // A slot's buffer is reused only if it was executed in the slot's
+    // previous frame: a bucket left alone for longer may reference objects
+    // destroyed since, whose handles could have been handed out again.
+    class SecondaryCache {
+
+    private:
+        struct Entry {
+            vk::UniqueCommandBuffer Buffer;
+            uint64_t                Key         { 0 };
+            uint64_t                LastFrame   { 0 };
+            bool                    Recorded    { false };
+        };
+
+        vk::UniqueCommandPool   pool;
+        uint32_t                slots       { 0 };
+        std::vector<Entry>      entries;                // Bucket major
+        uint64_t                recorded    { 0 };
+        uint64_t                reused      { 0 };
+
+    public:
+        SecondaryCache() = default;
+        SecondaryCache(const vk::Device&, const uint32_t queueFamily, const uint32_t buckets, const uint32_t slots);
+
+        // No copies!
+        SecondaryCache(const SecondaryCache&) = delete;
+        SecondaryCache& operator=(const SecondaryCache&) = delete;
+
+        SecondaryCache(SecondaryCache&&) = default;
+        SecondaryCache& operator=(SecondaryCache&&) = default;
+
+        // The bucket's buffer for slot, to execute inside a pass begun for
+        // secondaries into attachments of layout. Unless key, layout and
+        // area match its last recording it comes back begun, viewport and
+        // scissor set, with Record on: record the pass and end it.
+        // The slot's previous frame has to have finished.
+        const Secondary Acquire(const Engine::Render::Device::DeviceDispatch&, const uint32_t bucket, const uint32_t slot, const uint64_t frameNumber,
+            const uint64_t key, const AttachmentLayout& layout, const vk::Extent2D& area);
+
+        // Everything is recorded again on next use
+        void Invalidate();
+
+        // Totals since creation
+        const uint64_t Recorded()   const { return recorded; }
+        const uint64_t Reused()     const { return reused; }
+    };
+}
+
+#endif // !RENDER_COMMAND_SECONDARY_CACHE_HPP
@@ -0,0 +1,425 @@
+#include "OcclusionCuller.hpp"
+#include "Device/Physical.hpp"
+#include "Shader/Shader.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace Engine::Render::Culling {
+
+    namespace ERD = Engine::Render::Device;
+    namespace ERM = Engine::Render::Memory;
+
+    namespace {
+        // Match local_size in GLSL/occlusion_cull.comp and GLSL/hiz_downsample.comp
+        constexpr uint32_t CullGroupSize        { 64 };
+        constexpr uint32_t DownsampleGroupSize  { 8 };
+
+        constexpr vk::Format PyramidFormat{ vk::Format::eR32Sfloat };
+
+        // Same as Cull in GLSL/occlusion_cull.comp
+        struct CullConstants {
+            glm::mat4   Transform;
+            glm::vec4   Pyramid;
+            glm::uvec4  Objects;
+        };
+
+        // Same as Sizes in GLSL/hiz_downsample.comp
+        struct DownsampleConstants {
+            glm::uvec2  Source;
+            glm::uvec2  Destination;
+        };
+
+        const auto depthRange{ vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eDepth, 0, 1, 0, 1) };
+
+        // Every pyramid level is the previous one halved, rounding up
+        vk::Extent2D Half(const vk::Extent2D& extent) {
+            return { std::max(1u, (extent.width + 1) / 2), std::max(1u, (extent.height + 1) / 2) };
+        }
+
+        uint32_t LevelCount(const vk::Extent2D& extent) {
+            uint32_t levels{ 1 };
+            for (auto size{ std::max(extent.width, extent.height) }; size > 1; size = (size + 1) / 2) {
+                ++levels;
+            }
+            return levels;
+        }
+
+        // Sampled depth is needed for the pyramid, D16 always has it
+        vk::Format PickDepthFormat(const ERD::PhysicalDevice& deviceInfo) {
+            const auto needed{ vk::FormatFeatureFlagBits::eDepthStencilAttachment | vk::FormatFeatureFlagBits::eSampledImage };
+
+            for (const auto format : { vk::Format::eD32Sfloat, vk::Format::eD16Unorm }) {
+                const auto features{ deviceInfo.Get().getFormatProperties(format).optimalTilingFeatures };
+                if ((features & needed) == needed) return format;
+            }
+            throw std::runtime_error("No sampled depth format");
+        }
+
+        vk::UniqueDescriptorSetLayout CreateSetLayout(const vk::Device& renderDevice, const std::vector<vk::DescriptorType>& types) {
+            std::vector<vk::DescriptorSetLayoutBinding> bindings{};
+            for (uint32_t b = 0; b < types.size(); ++b) {
+                bindings.emplace_back(b, types[b], 1, vk::ShaderStageFlagBits::eCompute);
+            }
+
+            return renderDevice.createDescriptorSetLayoutUnique(vk::DescriptorSetLayoutCreateInfo()
+                .setBindingCount(static_cast<uint32_t>(bindings.size()))
+                .setPBindings(bindings.data())
+            );
+        }
+
+        vk::UniquePipelineLayout CreateComputeLayout(const vk::Device& renderDevice, const std::vector<vk::DescriptorSetLayout>& setLayouts, const uint32_t constantsSize) {
+            const auto range{ vk::PushConstantRange(vk::ShaderStageFlagBits::eCompute, 0, constantsSize) };
+
+            return renderDevice.createPipelineLayoutUnique(vk::PipelineLayoutCreateInfo()
+                .setSetLayoutCount(static_cast<uint32_t>(setLayouts.size()))
+                .setPSetLayouts(setLayouts.data())
+                .setPushConstantRangeCount(1)
+                .setPPushConstantRanges(&range)
+            );
+        }
+
+        vk::UniquePipeline CreateComputePipeline(const vk::Device& renderDevice, const vk::PipelineLayout& layout, const std::string& shader) {
+            const auto code{ Engine::Render::Shader::CreateShaderModule(renderDevice, shader) };
+
+            return renderDevice.createComputePipelineUnique(nullptr, vk::ComputePipelineCreateInfo()
+                .setStage(vk::PipelineShaderStageCreateInfo()
+                    .setStage(vk::ShaderStageFlagBits::eCompute)
+                    .setModule(code.get())
+                    .setPName("main"))
+                .setLayout(layout)
+            );
+        }
+
+        template <typename T>
+        ERM::DeviceMemory<T> CreateBuffer(const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo, const vk::DeviceSize size, const vk::BufferUsageFlags& usage, const vk::MemoryPropertyFlags& properties) {
+            return ERM::DeviceMemory<T>(renderDevice, deviceInfo, vk::BufferCreateInfo()
+                .setSharingMode(vk::SharingMode::eExclusive)
+                .setSize(size)
+                .setUsage(usage),
+                properties
+            );
+        }
+    }
+
+    OcclusionCuller::OcclusionCuller(const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo) :
+        depthFormat(PickDepthFormat(deviceInfo))
+    {
+        const auto features{ deviceInfo.Get().getFeatures() };
+        multiDraw    = features.multiDrawIndirect;
+        maxDrawCount = multiDraw ? std::max(1u, deviceInfo.Get().getProperties().limits.maxDrawIndirectCount) : 1u;
+
+        // Pyramid texels are fetched, never filtered
+        sampler = renderDevice.createSamplerUnique(vk::SamplerCreateInfo()
+            .setMagFilter(vk::Filter::eNearest)
+            .setMinFilter(vk::Filter::eNearest)
+            .setMipmapMode(vk::SamplerMipmapMode::eNearest)
+            .setAddressModeU(vk::SamplerAddressMode::eClampToEdge)
+            .setAddressModeV(vk::SamplerAddressMode::eClampToEdge)
+            .setAddressModeW(vk::SamplerAddressMode::eClampToEdge)
+            .setMaxLod(VK_LOD_CLAMP_NONE)
+        );
+
+        objectLayout  = CreateSetLayout(renderDevice, { vk::DescriptorType::eStorageBuffer, vk::DescriptorType::eStorageBuffer, vk::DescriptorType::eStorageBuffer });
+        pyramidLayout = CreateSetLayout(renderDevice, { vk::DescriptorType::eCombinedImageSampler });
+        levelLayout   = CreateSetLayout(renderDevice, { vk::DescriptorType::eCombinedImageSampler, vk::DescriptorType::eStorageImage });
+
+        cullLayout          = CreateComputeLayout(renderDevice, { objectLayout.get(), pyramidLayout.get() }, sizeof(CullConstants));
+        cullPipeline        = CreateComputePipeline(renderDevice, cullLayout.get(), "occlusion_cull.spv");
+        downsampleLayout    = CreateComputeLayout(renderDevice, { levelLayout.get() }, sizeof(DownsampleConstants));
+        downsamplePipeline  = CreateComputePipeline(renderDevice, downsampleLayout.get(), "hiz_downsample.spv");
+    }
+
+    OcclusionCuller::Image OcclusionCuller::CreateImage(const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo, const vk::ImageCreateInfo& createInfo, const vk::ImageAspectFlags& aspect) {
+        Image image{};
+        image.Handle = renderDevice.createImageUnique(createInfo);
+
+        const auto requirements{ renderDevice.getImageMemoryRequirements(image.Handle.get()) };
+        const auto memoryProperties{ deviceInfo.Get().getMemoryProperties() };
+        const auto memoryType{ ERM::FindMemoryType(memoryProperties, requirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal) };
+
+        image.Memory = renderDevice.allocateMemoryUnique(vk::MemoryAllocateInfo()
+            .setAllocationSize(requirements.size)
+            .setMemoryTypeIndex(memoryType)
+        );
+        image.Tracked = ERM::TrackedAllocation(renderDevice, ERM::HeapOfType(memoryProperties, memoryType), ERM::MemoryCategory::RenderTargets, requirements.size);
+
+        renderDevice.bindImageMemory(image.Handle.get(), image.Memory.get(), 0u);
+
+        image.View = renderDevice.createImageViewUnique(vk::ImageViewCreateInfo()
+            .setImage(image.Handle.get())
+            .setViewType(vk::ImageViewType::e2D)
+            .setFormat(createInfo.format)
+            .setSubresourceRange(vk::ImageSubresourceRange(aspect, 0, createInfo.mipLevels, 0, 1))
+        );
+
+        return image;
+    }
+
+    // Level 0 is half the depth buffer, down to 1x1
+    void OcclusionCuller::Resize(const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo, const vk::Extent2D& extent, ERM::DeletionQueue& deletionQueue, const uint64_t frameNumber) {
+        deletionQueue.Retire(std::move(targets), frameNumber);
+        targets = Targets{};
+        targets.Extent = extent;
+
+        const auto baseInfo{ vk::ImageCreateInfo()
+            .setImageType(vk::ImageType::e2D)
+            .setArrayLayers(1)
+            .setSamples(vk::SampleCountFlagBits::e1)
+            .setTiling(vk::ImageTiling::eOptimal)
+            .setSharingMode(vk::SharingMode::eExclusive)
+            .setInitialLayout(vk::ImageLayout::eUndefined)
+        };
+
+        targets.Depth = CreateImage(renderDevice, deviceInfo, vk::ImageCreateInfo(baseInfo)
+            .setFormat(depthFormat)
+            .setExtent(vk::Extent3D(extent.width, extent.height, 1))
+            .setMipLevels(1)
+            .setUsage(vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eSampled),
+            vk::ImageAspectFlagBits::eDepth
+        );
+
+        const auto base{ Half(extent) };
+        const auto levels{ LevelCount(base) };
+
+        targets.Pyramid = CreateImage(renderDevice, deviceInfo, vk::ImageCreateInfo(baseInfo)
+            .setFormat(PyramidFormat)
+            .setExtent(vk::Extent3D(base.width, base.height, 1))
+            .setMipLevels(levels)
+            .setUsage(vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eSampled),
+            vk::ImageAspectFlagBits::eColor
+        );
+
+        for (uint32_t level = 0; level < levels; ++level) {
+            targets.Levels.emplace_back(renderDevice.createImageViewUnique(vk::ImageViewCreateInfo()
+                .setImage(targets.Pyramid.Handle.get())
+                .setViewType(vk::ImageViewType::e2D)
+                .setFormat(PyramidFormat)
+                .setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, level, 1, 0, 1))
+            ));
+        }
+
+        // Fresh sets too, the old ones may still be bound by frames in flight
+        const std::array<vk::DescriptorPoolSize, 2> poolSizes{
+            vk::DescriptorPoolSize(vk::DescriptorType::eCombinedImageSampler, levels + 1),
+            vk::DescriptorPoolSize(vk::DescriptorType::eStorageImage, levels)
+        };
+
+        targets.Pool = renderDevice.createDescriptorPoolUnique(vk::DescriptorPoolCreateInfo()
+            .setMaxSets(levels + 1)
+            .setPoolSizeCount(static_cast<uint32_t>(poolSizes.size()))
+            .setPPoolSizes(poolSizes.data())
+        );
+
+        std::vector<vk::DescriptorSetLayout> layouts(levels, levelLayout.get());
+        layouts.push_back(pyramidLayout.get());
+
+        auto sets{ renderDevice.allocateDescriptorSets(vk::DescriptorSetAllocateInfo()
+            .setDescriptorPool(targets.Pool.get())
+            .setDescriptorSetCount(static_cast<uint32_t>(layouts.size()))
+            .setPSetLayouts(layouts.data())
+        ) };
+
+        targets.PyramidSet = sets.back();
+        sets.pop_back();
+        targets.LevelSets = std::move(sets);
+
+        const auto pyramidInfo{ vk::DescriptorImageInfo(sampler.get(), targets.Pyramid.View.get(), vk::ImageLayout::eGeneral) };
+        renderDevice.updateDescriptorSets(vk::WriteDescriptorSet()
+            .setDstSet(targets.PyramidSet)
+            .setDstBinding(0)
+            .setDescriptorCount(1)
+            .setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
+            .setPImageInfo(&pyramidInfo),
+            nullptr
+        );
+
+        for (uint32_t level = 0; level < levels; ++level) {
+            const auto source{ level == 0
+                ? vk::DescriptorImageInfo(sampler.get(), targets.Depth.View.get(), vk::ImageLayout::eShaderReadOnlyOptimal)
+                : vk::DescriptorImageInfo(sampler.get(), targets.Levels[level - 1].get(), vk::ImageLayout::eGeneral) };
+            const auto destination{ vk::DescriptorImageInfo(nullptr, targets.Levels[level].get(), vk::ImageLayout::eGeneral) };
+
+            const std::array<vk::WriteDescriptorSet, 2> writes{
+                vk::WriteDescriptorSet()
+                    .setDstSet(targets.LevelSets[level])
+                    .setDstBinding(0)
+                    .setDescriptorCount(1)
+                    .setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
+                    .setPImageInfo(&source),
+                vk::WriteDescriptorSet()
+                    .setDstSet(targets.LevelSets[level])
+                    .setDstBinding(1)
+                    .setDescriptorCount(1)
+                    .setDescriptorType(vk::DescriptorType::eStorageImage)
+                    .setPImageInfo(&destination)
+            };
+            renderDevice.updateDescriptorSets(writes, nullptr);
+        }
+
+        pyramidFresh    = true;
+        pyramidHistory  = false;
+    }
+
+    void OcclusionCuller::SetObjects(const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo, const std::vector<DrawObject>& list, ERM::DeletionQueue& deletionQueue, const uint64_t frameNumber) {
+        deletionQueue.Retire(std::move(objects), frameNumber);
+        objects = Objects{};
+
+        if (list.empty()) return;
+
+        const auto count{ static_cast<uint32_t>(list.size()) };
+        const auto deviceLocal{ vk::MemoryPropertyFlags(vk::MemoryPropertyFlagBits::eDeviceLocal) };
+
+        objects.List = CreateBuffer<DrawObject>(renderDevice, deviceInfo, sizeof(DrawObject) * count, vk::BufferUsageFlagBits::eStorageBuffer,
+            vk::MemoryPropertyFlagBits::eHostCoherent | vk::MemoryPropertyFlagBits::eHostVisible);
+        objects.Visibility = CreateBuffer<uint32_t>(renderDevice, deviceInfo, sizeof(uint32_t) * count, vk::BufferUsageFlagBits::eStorageBuffer, deviceLocal);
+        objects.Draws = CreateBuffer<vk::DrawIndexedIndirectCommand>(renderDevice, deviceInfo, sizeof(vk::DrawIndexedIndirectCommand) * 2 * count,
+            vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer, deviceLocal);
+
+        objects.List.Upload(renderDevice, list.data(), 0, count);
+        objects.List.Unmap(renderDevice);
+
+        const auto poolSize{ vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, 3) };
+        objects.Pool = renderDevice.createDescriptorPoolUnique(vk::DescriptorPoolCreateInfo()
+            .setMaxSets(1)
+            .setPoolSizeCount(1)
+            .setPPoolSizes(&poolSize)
+        );
+
+        objects.Set = renderDevice.allocateDescriptorSets(vk::DescriptorSetAllocateInfo()
+            .setDescriptorPool(objects.Pool.get())
+            .setDescriptorSetCount(1)
+            .setPSetLayouts(&objectLayout.get())
+        ).front();
+
+        const std::array<vk::DescriptorBufferInfo, 3> infos{
+            vk::DescriptorBufferInfo(*objects.List.Buffer(),       0, VK_WHOLE_SIZE),
+            vk::DescriptorBufferInfo(*objects.Visibility.Buffer(), 0, VK_WHOLE_SIZE),
+            vk::DescriptorBufferInfo(*objects.Draws.Buffer(),      0, VK_WHOLE_SIZE)
+        };
+
+        std::array<vk::WriteDescriptorSet, 3> writes{};
+        for (uint32_t b = 0; b < writes.size(); ++b) {
+            writes[b] = vk::WriteDescriptorSet()
+                .setDstSet(objects.Set)
+                .setDstBinding(b)
+                .setDescriptorCount(1)
+                .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+                .setPBufferInfo(&infos[b]);
+        }
+        renderDevice.updateDescriptorSets(writes, nullptr);
+
+        objects.Count = count;
+    }
+
+    // Phase 0 waits for the previous frame's draws and culling to be done
+    // with the lists. Either phase leaves its draws for indirect reads.
+    void OcclusionCuller::RecordCull(const vk::CommandBuffer& cmdBuffer, const ERD::DeviceDispatch& d, const uint32_t phase, const glm::mat4& transform, const vk::Extent2D& area) {
+        if (phase == 0) {
+            if (pyramidFresh) {
+                cmdBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eComputeShader, {}, nullptr, nullptr,
+                    vk::ImageMemoryBarrier()
+                        .setSrcAccessMask({})
+                        .setDstAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite)
+                        .setOldLayout(vk::ImageLayout::eUndefined)
+                        .setNewLayout(vk::ImageLayout::eGeneral)
+                        .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+                        .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+                        .setImage(targets.Pyramid.Handle.get())
+                        .setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, VK_REMAINING_MIP_LEVELS, 0, 1)),
+                    d);
+                pyramidFresh = false;
+            }
+
+            cmdBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eComputeShader, {},
+                vk::MemoryBarrier()
+                    .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+                    .setDstAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite),
+                nullptr, nullptr, d);
+        }
+
+        const CullConstants constants{
+            transform,
+            glm::vec4(pyramidArea.width, pyramidArea.height, static_cast<float>(targets.Levels.size()), pyramidHistory ? 1.0f : 0.0f),
+            glm::uvec4(objects.Count, phase, 0, 0)
+        };
+        const std::array<vk::DescriptorSet, 2> sets{ objects.Set, targets.PyramidSet };
+
+        cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, cullPipeline.get(), d);
+        cmdBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, cullLayout.get(), 0, sets, nullptr, d);
+        cmdBuffer.pushConstants(cullLayout.get(), vk::ShaderStageFlagBits::eCompute, 0, sizeof(CullConstants), &constants, d);
+        cmdBuffer.dispatch((objects.Count + CullGroupSize - 1) / CullGroupSize, 1, 1, d);
+
+        cmdBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eComputeShader, {},
+            vk::MemoryBarrier()
+                .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+                .setDstAccessMask(vk::AccessFlagBits::eIndirectCommandRead | vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite),
+            nullptr, nullptr, d);
+    }
+
+    // Rejected objects still cost an indirect draw with no instances.
+    // Without multiDrawIndirect every object is its own indirect draw.
+    void OcclusionCuller::RecordDraws(const vk::CommandBuffer& cmdBuffer, const ERD::DeviceDispatch& d, const uint32_t phase) const {
+        const auto stride{ static_cast<uint32_t>(sizeof(vk::DrawIndexedIndirectCommand)) };
+        const vk::DeviceSize first{ vk::DeviceSize{ phase } * objects.Count * stride };
+
+        for (uint32_t done = 0; done < objects.Count;) {
+            const auto batch{ std::min(maxDrawCount, objects.Count - done) };
+            cmdBuffer.drawIndexedIndirect(*objects.Draws.Buffer(), first + vk::DeviceSize{ done } * stride, batch, stride, d);
+            done += batch;
+        }
+    }
+
+    void OcclusionCuller::RecordPyramid(const vk::CommandBuffer& cmdBuffer, const ERD::DeviceDispatch& d, const vk::Extent2D& area) {
+        cmdBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eLateFragmentTests, vk::PipelineStageFlagBits::eComputeShader, {}, nullptr, nullptr,
+            vk::ImageMemoryBarrier()
+                .setSrcAccessMask(vk::AccessFlagBits::eDepthStencilAttachmentWrite)
+                .setDstAccessMask(vk::AccessFlagBits::eShaderRead)
+                .setOldLayout(vk::ImageLayout::eDepthStencilAttachmentOptimal)
+                .setNewLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
+                .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+                .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+                .setImage(targets.Depth.Handle.get())
+                .setSubresourceRange(depthRange),
+            d);
+
+        cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, downsamplePipeline.get(), d);
+
+        // Only the rendered top left part of each level is reduced
+        auto source{ area };
+        for (uint32_t level = 0; level < targets.LevelSets.size(); ++level) {
+            const auto destination{ Half(source) };
+            const DownsampleConstants constants{ glm::uvec2(source.width, source.height), glm::uvec2(destination.width, destination.height) };
+
+            cmdBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, downsampleLayout.get(), 0, targets.LevelSets[level], nullptr, d);
+            cmdBuffer.pushConstants(downsampleLayout.get(), vk::ShaderStageFlagBits::eCompute, 0, sizeof(DownsampleConstants), &constants, d);
+            cmdBuffer.dispatch(
+                (destination.width  + DownsampleGroupSize - 1) / DownsampleGroupSize,
+                (destination.height + DownsampleGroupSize - 1) / DownsampleGroupSize,
+                1, d);
+
+            cmdBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eComputeShader, {},
+                vk::MemoryBarrier()
+                    .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+                    .setDstAccessMask(vk::AccessFlagBits::eShaderRead),
+                nullptr, nullptr, d);
+
+            source = destination;
+        }
+
+        cmdBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests, {}, nullptr, nullptr,
+            vk::ImageMemoryBarrier()
+                .setSrcAccessMask({})
+                .setDstAccessMask(vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eDepthStencilAttachmentWrite)
+                .setOldLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
+                .setNewLayout(vk::ImageLayout::eDepthStencilAttachmentOptimal)
+                .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+                .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+                .setImage(targets.Depth.Handle.get())
+                .setSubresourceRange(depthRange),
+            d);
+
+        pyramidArea     = area;
+        pyramidHistory  = true;
+    }
+}
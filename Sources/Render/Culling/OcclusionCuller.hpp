@@ -0,0 +1,131 @@
+#ifndef RENDER_CULLING_OCCLUSION_CULLER_HPP
+#define RENDER_CULLING_OCCLUSION_CULLER_HPP
+
+#include "VKinclude/VKinclude.hpp"
+#include "Memory/Buffers.hpp"
+#include "Memory/DeletionQueue.hpp"
+#include "Memory/Tracking.hpp"
+#include "Device/Dispatch.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace Engine::Render::Culling {
+
+    // One draw of the scene, an index range of the bound geometry and its
+    // object space bounds. Same layout as DrawObject in GLSL/occlusion_cull.comp.
+    struct DrawObject {
+        glm::vec3   Min         { 0.0f };
+        uint32_t    FirstIndex  { 0 };
+        glm::vec3   Max         { 0.0f };
+        uint32_t    IndexCount  { 0 };
+        int32_t     VertexOffset{ 0 };
+        uint32_t    Pad[3]      {};
+    };
+
+    static_assert(sizeof(DrawObject) == 48);
+
+    // Hierarchical-Z occlusion culling in two phases. Owns the scene depth
+    // buffer, since the depth pyramid is built from it.
+    //
+    //  - Phase 0 culls every object against the frustum and the pyramid
+    //    left by the previous frame, and draws what passed.
+    //  - The pyramid is rebuilt from that depth, a max reduction per level.
+    //  - Phase 1 retests only what phase 0 rejected against the new pyramid
+    //    and draws what was revealed this frame.
+    //
+    // The pyramid built in phase 1 is what the next frame starts from.
+    // Culling writes a visibility flag and an indexed indirect draw per
+    // object and phase, the draw list is never read back. Depth, pyramid and
+    // draw buffers are shared by all frames in flight, barriers order each
+    // frame's use after the previous one's.
+    class OcclusionCuller {
+
+    private:
+        struct Image {
+            vk::UniqueImage         Handle;
+            vk::UniqueDeviceMemory  Memory;
+            vk::UniqueImageView     View;
+            Engine::Render::Memory::TrackedAllocation Tracked;
+        };
+
+        // Recreated with the swapchain
+        struct Targets {
+            Image                               Depth;
+            Image                               Pyramid;
+            std::vector<vk::UniqueImageView>    Levels;
+            vk::UniqueDescriptorPool            Pool;
+            std::vector<vk::DescriptorSet>      LevelSets;      // Previous level (or depth) in, this one out
+            vk::DescriptorSet                   PyramidSet;
+            vk::Extent2D                        Extent;
+        };
+
+        // Recreated with every new draw list
+        struct Objects {
+            Engine::Render::Memory::DeviceMemory<DrawObject>    List;
+            Engine::Render::Memory::DeviceMemory<uint32_t>      Visibility;
+            Engine::Render::Memory::DeviceMemory<vk::DrawIndexedIndirectCommand> Draws;
+            vk::UniqueDescriptorPool                            Pool;
+            vk::DescriptorSet                                   Set;
+            uint32_t                                            Count{ 0 };
+        };
+
+        vk::Format                      depthFormat     { vk::Format::eUndefined };
+        bool                            multiDraw       { false };
+        uint32_t                        maxDrawCount    { 1 };
+        vk::UniqueSampler               sampler;
+        vk::UniqueDescriptorSetLayout   objectLayout;
+        vk::UniqueDescriptorSetLayout   pyramidLayout;
+        vk::UniqueDescriptorSetLayout   levelLayout;
+        vk::UniquePipelineLayout        cullLayout;
+        vk::UniquePipeline              cullPipeline;
+        vk::UniquePipelineLayout        downsampleLayout;
+        vk::UniquePipeline              downsamplePipeline;
+        Targets                         targets;
+        Objects                         objects;
+        bool                            pyramidFresh    { true };   // Still in eUndefined
+        bool                            pyramidHistory  { false };  // Holds an earlier frame's depth
+        vk::Extent2D                    pyramidArea;
+
+        static Image CreateImage(const vk::Device&, const Engine::Render::Device::PhysicalDevice&, const vk::ImageCreateInfo&, const vk::ImageAspectFlags&);
+
+    public:
+        OcclusionCuller() = default;
+        OcclusionCuller(const vk::Device&, const Engine::Render::Device::PhysicalDevice&);
+
+        // No copies!
+        OcclusionCuller(const OcclusionCuller&) = delete;
+        OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+
+        OcclusionCuller(OcclusionCuller&&) = default;
+        OcclusionCuller& operator=(OcclusionCuller&&) = default;
+
+        // New depth buffer and pyramid for frames up to extent, the old ones
+        // are retired. The pyramid starts out empty, so the next frame's
+        // phase 0 only frustum culls.
+        void Resize(const vk::Device&, const Engine::Render::Device::PhysicalDevice&, const vk::Extent2D& extent, Engine::Render::Memory::DeletionQueue&, const uint64_t frameNumber);
+
+        // Objects drawn from the next frame on. An empty list turns culling off.
+        void SetObjects(const vk::Device&, const Engine::Render::Device::PhysicalDevice&, const std::vector<DrawObject>&, Engine::Render::Memory::DeletionQueue&, const uint64_t frameNumber);
+
+        // Call outside of rendering. Leaves phase's draws ready for RecordDraws.
+        void RecordCull(const vk::CommandBuffer&, const Engine::Render::Device::DeviceDispatch&, const uint32_t phase, const glm::mat4& transform, const vk::Extent2D& area);
+        // Inside rendering, with the geometry the objects index into bound
+        void RecordDraws(const vk::CommandBuffer&, const Engine::Render::Device::DeviceDispatch&, const uint32_t phase) const;
+        // Between the phases. Expects the depth buffer in eDepthAttachmentOptimal
+        // and leaves it there, with the depth drawn so far loadable.
+        void RecordPyramid(const vk::CommandBuffer&, const Engine::Render::Device::DeviceDispatch&, const vk::Extent2D& area);
+
+        // Whether frames should draw through the culler
+        const bool Active() const { return objects.Count > 0 && static_cast<bool>(targets.Depth.Handle); }
+
+        const vk::Format    DepthFormat()   const { return depthFormat; }
+        const vk::Image     DepthImage()    const { return targets.Depth.Handle.get(); }
+        const vk::ImageView DepthView()     const { return targets.Depth.View.get(); }
+        const uint32_t      ObjectCount()   const { return objects.Count; }
+    };
+}
+
+#endif // !RENDER_CULLING_OCCLUSION_CULLER_HPP
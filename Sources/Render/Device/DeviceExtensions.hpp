@@ -10,6 +10,15 @@ namespace Engine::Render::Device {
         VK_KHR_SWAPCHAIN_EXTENSION_NAME
     };
 
+    // Each group is enabled only if the device has all of it, dependencies
+    // first. Features check PhysicalDevice::ExtensionEnabled.
+    const std::vector<std::vector<const char*>> optionalDeviceExtensions {
+        { VK_EXT_MEMORY_BUDGET_EXTENSION_NAME },
+        { VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME, VK_KHR_DEPTH_STENCIL_RESOLVE_EXTENSION_NAME, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME },
+        { VK_KHR_SHADER_FLOAT_CONTROLS_EXTENSION_NAME, VK_KHR_SPIRV_1_4_EXTENSION_NAME, VK_EXT_MESH_SHADER_EXTENSION_NAME },
+        { VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME, VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME }
+    };
+
 }
 
 #endif // !RENDER_REQUIRED_DEVICE_EXTENSIONS
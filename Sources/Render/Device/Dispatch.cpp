@@ -0,0 +1,11 @@
+#include "Dispatch.hpp"
+
+namespace Engine::Render::Device {
+
+    DeviceDispatch LoadDeviceDispatch(const vk::Instance& instance, const vk::Device& device) {
+        const auto getInstanceProcAddr{ Loader().getProcAddress<PFN_vkGetInstanceProcAddr>("vkGetInstanceProcAddr") };
+        const auto getDeviceProcAddr{ reinterpret_cast<PFN_vkGetDeviceProcAddr>(getInstanceProcAddr(instance, "vkGetDeviceProcAddr")) };
+
+        return DeviceDispatch(instance, getInstanceProcAddr, device, getDeviceProcAddr);
+    }
+}
@@ -0,0 +1,17 @@
+#ifndef RENDER_DEVICE_DISPATCH_HPP
+#define RENDER_DEVICE_DISPATCH_HPP
+
+#include "VKinclude/VKinclude.hpp"
+
+namespace Engine::Render::Device {
+
+    // Device level entry points fetched with vkGetDeviceProcAddr, calls made
+    // through it go straight to the driver instead of the loader trampolines.
+    // VULKAN_HPP_DEFAULT_DISPATCHER only knows the instance, so it works with
+    // any device, pass one of these on the per frame paths.
+    using DeviceDispatch = vk::DispatchLoaderDynamic;
+
+    DeviceDispatch LoadDeviceDispatch(const vk::Instance& instance, const vk::Device& device);
+}
+
+#endif // !RENDER_DEVICE_DISPATCH_HPP
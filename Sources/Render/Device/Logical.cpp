@@ -16,29 +16,67 @@ namespace Engine::Render::Device::Logical {
 
         std::vector<vk::DeviceQueueCreateInfo> queuesCreateInfos{};
 
-        for (const auto& queueFam : qmg.RequestedQueues()) {
-            if (queueFam.second.Used > 0) {
+        for (const auto& queueFam : qmg.RequestedQueues().Items) {
+            if (queueFam.Used > 0) {
                 const auto qCreateInfo{ vk::DeviceQueueCreateInfo()
-                    .setQueueFamilyIndex(queueFam.second.Index)
-                    .setQueueCount(queueFam.second.Used)
+                    .setQueueFamilyIndex(queueFam.Index)
+                    .setQueueCount(queueFam.Used)
                     .setPQueuePriorities(&priority)
                 };
                 queuesCreateInfos.emplace_back(qCreateInfo);
             }
         }
 
+        // Only what streamed textures need, and only where it exists.
+        // Feedback writes from fragment shaders need stores and atomics.
+        // Occlusion culled draws go out in one indirect call where possible.
+        const auto supported{ phyDev.Get().getFeatures() };
+        const auto features{ vk::PhysicalDeviceFeatures()
+            .setSparseBinding(supported.sparseBinding)
+            .setSparseResidencyImage2D(supported.sparseResidencyImage2D)
+            .setFragmentStoresAndAtomics(supported.fragmentStoresAndAtomics)
+            .setMultiDrawIndirect(supported.multiDrawIndirect)
+        };
+
+        // Optional features chain up in front of each other
+        void* next{ nullptr };
+
+        auto meshShaders{ vk::PhysicalDeviceMeshShaderFeaturesEXT()
+            .setTaskShader(true)
+            .setMeshShader(true)
+        };
+        if (phyDev.SupportsMeshShaders()) {
+            next = &meshShaders;
+        }
+
+        auto pipelineLibraries{ vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT()
+            .setGraphicsPipelineLibrary(true)
+            .setPNext(next)
+        };
+        if (phyDev.SupportsPipelineLibraries()) {
+            next = &pipelineLibraries;
+        }
+
+        auto dynamicRendering{ vk::PhysicalDeviceDynamicRenderingFeaturesKHR()
+            .setDynamicRendering(true)
+            .setPNext(next)
+        };
+        if (phyDev.SupportsDynamicRendering()) {
+            next = &dynamicRendering;
+        }
+
         const auto logicalDeviceCreateInfo{ vk::DeviceCreateInfo()
-            // TODO: Hmmmm featuressss....
-            .setPEnabledFeatures({})
+            .setPNext(next)
+            .setPEnabledFeatures(&features)
             .setQueueCreateInfoCount(static_cast<uint32_t>(queuesCreateInfos.size()))
             .setPQueueCreateInfos(queuesCreateInfos.data())
-            .setEnabledExtensionCount(static_cast<uint32_t>(requiredDeviceExtensions.size()))
-            .setPpEnabledExtensionNames(requiredDeviceExtensions.data())
+            .setEnabledExtensionCount(static_cast<uint32_t>(phyDev.EnabledExtensions().size()))
+            .setPpEnabledExtensionNames(phyDev.EnabledExtensions().data())
         };
 
-        // Create logical device and get device speficic pointers
+        // Device specific pointers live in a DeviceDispatch (Dispatch.hpp), the
+        // default dispatcher stays on the loader so it is valid for any device
         auto renderDevice{ phyDev.Get().createDeviceUnique(logicalDeviceCreateInfo) };
-        VULKAN_HPP_DEFAULT_DISPATCHER.init(renderDevice.get());
 
         qmg.PopulateQueues(renderDevice.get());
         return renderDevice;
@@ -3,6 +3,8 @@
 #include "Queue/Queue.hpp"
 #include "Logger.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <map>
 
@@ -19,26 +21,47 @@ namespace VULKAN_HPP_NAMESPACE {
 namespace Engine::Render::Device {
 
     PhysicalDevice::PhysicalDevice(int index, const vk::PhysicalDevice& phyDev, const vk::SurfaceKHR& surf) :
-        index(index), hardwareDevice(phyDev), score(ScoreDevice(surf)), allSurfaceFormats(hardwareDevice.getSurfaceFormatsKHR(surf)),
-        allPresentModes(hardwareDevice.getSurfacePresentModesKHR(surf))
+        index(index), hardwareDevice(phyDev), score(ScoreDevice(surf)),
+        allSurfaceFormats(surf ? hardwareDevice.getSurfaceFormatsKHR(surf) : std::vector<vk::SurfaceFormatKHR>{}),
+        allPresentModes(surf ? hardwareDevice.getSurfacePresentModesKHR(surf) : std::vector<vk::PresentModeKHR>{})
     {
         auto const dev_extns{ hardwareDevice.enumerateDeviceExtensionProperties() };
 
+        for (const auto& i : dev_extns) {
+            extensions.emplace(i.extensionName);
+        }
+
         bool allFound{ true };
 
         for (const auto& req_ext : requiredDeviceExtensions) {
-            bool foundThis{ false };
+            allFound &= SupportsExtension(req_ext);
+            enabledExtensions.emplace_back(req_ext);
+        }
 
-            for (const auto& i : dev_extns) {
-                if (strncmp(i.extensionName, req_ext, 255) == 0) {
-                    foundThis = true;
-                    break;
-                }
+        for (const auto& group : optionalDeviceExtensions) {
+            if (std::all_of(group.cbegin(), group.cend(), [&](const char* ext) { return SupportsExtension(ext); })) {
+                enabledExtensions.insert(enabledExtensions.end(), group.cbegin(), group.cend());
             }
-            allFound &= foundThis;
         }
 
-        const auto surfaceCapabs{ hardwareDevice.getSurfaceCapabilitiesKHR(surf) };
+        if (ExtensionEnabled(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME)) {
+            const auto features{ hardwareDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceDynamicRenderingFeaturesKHR>() };
+            dynamicRendering = features.get<vk::PhysicalDeviceDynamicRenderingFeaturesKHR>().dynamicRendering;
+        }
+
+        if (ExtensionEnabled(VK_EXT_MESH_SHADER_EXTENSION_NAME)) {
+            const auto features{ hardwareDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceMeshShaderFeaturesEXT>() };
+            const auto& mesh{ features.get<vk::PhysicalDeviceMeshShaderFeaturesEXT>() };
+            meshShaders = mesh.taskShader && mesh.meshShader;
+        }
+
+        if (ExtensionEnabled(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME)) {
+            const auto features{ hardwareDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT>() };
+            const auto properties{ hardwareDevice.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceGraphicsPipelineLibraryPropertiesEXT>() };
+            pipelineLibraries = features.get<vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT>().graphicsPipelineLibrary;
+            fastLinking = pipelineLibraries && properties.get<vk::PhysicalDeviceGraphicsPipelineLibraryPropertiesEXT>().graphicsPipelineLibraryFastLinking;
+        }
+
 
         // Pick the present modes and formats we require.
         // TODO: Settle with what is supported
@@ -61,7 +84,20 @@ namespace Engine::Render::Device {
         if (mailbox) presentMode = vk::PresentModeKHR::eMailbox;
         else presentMode = vk::PresentModeKHR::eFifo;
 
+        // Headless, frames only go into images of our own
+        if (!surf) {
+            const auto needed{ vk::FormatFeatureFlagBits::eColorAttachment | vk::FormatFeatureFlagBits::eTransferSrc };
+            const auto features{ hardwareDevice.getFormatProperties(vk::Format::eB8G8R8A8Unorm).optimalTilingFeatures };
+
+            surfaceFormat   = vk::SurfaceFormatKHR(vk::Format::eB8G8R8A8Unorm, vk::ColorSpaceKHR::eSrgbNonlinear);
+            renderSupport   = allFound && (features & needed) == needed;
+            return;
+        }
+
+        const auto surfaceCapabs{ hardwareDevice.getSurfaceCapabilitiesKHR(surf) };
+
         presentSupport = allFound & !allPresentModes.empty() & surfSupport & (surfaceCapabs.minImageCount > 1);
+        renderSupport  = presentSupport;
     }
 
 
@@ -119,7 +155,7 @@ namespace Engine::Render::Device {
         }
 
         for (auto i{ devices.rbegin() }; i != devices.crend(); ++i) {
-            if (i->second.SupportsPresent()) {
+            if (surface ? i->second.SupportsPresent() : i->second.SupportsRendering()) {
                 LOGGER << "Picked Device: \"" << i->second.Name() << "\"\n";
                 return std::move(i->second);
             }
@@ -153,6 +189,40 @@ namespace Engine::Render::Device {
         return presentSupport;
     }
 
+    const bool PhysicalDevice::SupportsRendering() const {
+        return renderSupport;
+    }
+
+    const bool PhysicalDevice::SupportsExtension(const char* name) const {
+        return extensions.count(name) > 0;
+    }
+
+    const bool PhysicalDevice::ExtensionEnabled(const char* name) const {
+        return std::any_of(enabledExtensions.cbegin(), enabledExtensions.cend(), [&](const char* ext) {
+            return strncmp(ext, name, VK_MAX_EXTENSION_NAME_SIZE) == 0;
+        });
+    }
+
+    const bool PhysicalDevice::SupportsDynamicRendering() const {
+        return dynamicRendering;
+    }
+
+    const bool PhysicalDevice::SupportsMeshShaders() const {
+        return meshShaders;
+    }
+
+    const bool PhysicalDevice::SupportsPipelineLibraries() const {
+        return pipelineLibraries;
+    }
+
+    const bool PhysicalDevice::SupportsFastLinking() const {
+        return fastLinking;
+    }
+
+    const std::vector<const char*>& PhysicalDevice::EnabledExtensions() const {
+        return enabledExtensions;
+    }
+
     const vk::PhysicalDevice PhysicalDevice::Get() const {
         return hardwareDevice;
     }
@@ -5,6 +5,8 @@
 #include "VKinclude/VKinclude.hpp"
 
 #include <optional>
+#include <set>
+#include <string>
 
 namespace Engine::Render::Device {
 
@@ -21,6 +23,14 @@ namespace Engine::Render::Device {
         std::vector<vk::PresentModeKHR>     allPresentModes;
 
         bool    presentSupport{ false };
+        bool    renderSupport{ false };
+
+        std::set<std::string>       extensions;
+        std::vector<const char*>    enabledExtensions;
+        bool                        dynamicRendering{ false };
+        bool                        meshShaders{ false };
+        bool                        pipelineLibraries{ false };
+        bool                        fastLinking{ false };
 
         vk::SurfaceFormatKHR    surfaceFormat{};
         vk::PresentModeKHR      presentMode{};
@@ -43,9 +53,25 @@ namespace Engine::Render::Device {
         const int                   Index()             const;
         const int                   GetScore()          const;
         const bool                  SupportsPresent()   const;
+        // Can draw into SurfaceFormat images, without a surface that is all it needs
+        const bool                  SupportsRendering() const;
+        const bool                  SupportsExtension(const char* name) const;
+        const bool                  ExtensionEnabled(const char* name)  const;
+        const bool                  SupportsDynamicRendering()          const;
+        // Task and mesh shaders, VK_EXT_mesh_shader
+        const bool                  SupportsMeshShaders()               const;
+        // Pipelines built in parts and linked, VK_EXT_graphics_pipeline_library
+        const bool                  SupportsPipelineLibraries()         const;
+        // Linking those parts without optimization is cheap enough to do mid frame
+        const bool                  SupportsFastLinking()               const;
+
+        // Required extensions plus the optional ones this device has
+        const std::vector<const char*>& EnabledExtensions() const;
     };
 
 
+    // A null surface picks a device for headless rendering, SurfaceFormat
+    // is then what offscreen color images use
     PhysicalDevice PickDevice(const vk::Instance& instance, const vk::SurfaceKHR& surface);
 }
 
@@ -0,0 +1,18 @@
+#ifndef RENDER_FRAME_VIEW_HPP
+#define RENDER_FRAME_VIEW_HPP
+
+#include <glm/glm.hpp>
+
+namespace Engine::Render {
+
+    // What the simulation hands over each frame. Same layout as the
+    // uniform block at set 0, binding 0. Transform takes geometry to clip
+    // space, View and Projection are what lights are binned with.
+    struct FrameView {
+        glm::mat4 Transform { 1.0f };
+        glm::mat4 View      { 1.0f };
+        glm::mat4 Projection{ 1.0f };
+    };
+}
+
+#endif // !RENDER_FRAME_VIEW_HPP
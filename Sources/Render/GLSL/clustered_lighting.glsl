@@ -0,0 +1,86 @@
+// Clustered forward lighting, see Render/Lighting/ClusteredLighting.hpp
+//
+// LIGHTING_SET picks the descriptor set, 1 for graphics pipelines. The
+// culling pass defines LIGHT_LISTS_WRITABLE, everything else only reads
+// the lists and gets ShadeClustered(albedo, viewPos, normal) and
+// ClusterLightCount(viewPos).
+//
+// Clusters are ordered x fastest, then y, then the depth slice. Slices
+// are spaced exponentially between Area.z and Area.w (near and far).
+
+#ifndef LIGHTING_SET
+#define LIGHTING_SET 1
+#endif
+
+#ifdef LIGHT_LISTS_WRITABLE
+#define LIGHT_LISTS_ACCESS
+#else
+#define LIGHT_LISTS_ACCESS readonly
+#endif
+
+struct Light {
+    vec4 PositionRadius;    // View space
+    vec4 ColorIntensity;
+};
+
+layout(set = LIGHTING_SET, binding = 0) uniform Clusters {
+    mat4  InverseProjection;
+    uvec4 Grid;             // Clusters per axis, light count
+    vec4  Area;             // Render area width and height, near, far
+    uvec4 Capacity;         // Index list length
+} clusters;
+
+layout(set = LIGHTING_SET, binding = 1, std430) readonly buffer LightBlock {
+    Light lights[];
+};
+
+layout(set = LIGHTING_SET, binding = 2, std430) LIGHT_LISTS_ACCESS buffer LightGridBlock {
+    uvec2 lightGrid[];      // Offset into lightIndices, count
+};
+
+layout(set = LIGHTING_SET, binding = 3, std430) LIGHT_LISTS_ACCESS buffer LightIndexBlock {
+    uint lightIndexCount;
+    uint lightIndices[];
+};
+
+float SliceDepth(uint slice) {
+    return clusters.Area.z * pow(clusters.Area.w / clusters.Area.z, float(slice) / float(clusters.Grid.z));
+}
+
+uint DepthSlice(float depth) {
+    float slice = log(max(depth, clusters.Area.z) / clusters.Area.z) / log(clusters.Area.w / clusters.Area.z);
+    return min(uint(slice * float(clusters.Grid.z)), clusters.Grid.z - 1u);
+}
+
+#ifndef LIGHT_LISTS_WRITABLE
+
+uint ClusterIndex(vec2 fragCoord, float depth) {
+    uvec2 tile = min(uvec2(fragCoord / clusters.Area.xy * vec2(clusters.Grid.xy)), clusters.Grid.xy - 1u);
+    return (DepthSlice(depth) * clusters.Grid.y + tile.y) * clusters.Grid.x + tile.x;
+}
+
+// Lights binned into this fragment's cluster, viewPos in view space
+uint ClusterLightCount(vec3 viewPos) {
+    return lightGrid[ClusterIndex(gl_FragCoord.xy, -viewPos.z)].y;
+}
+
+// Diffuse light from every light binned into this fragment's cluster,
+// viewPos and normal in view space
+vec3 ShadeClustered(vec3 albedo, vec3 viewPos, vec3 normal) {
+    uvec2 list = lightGrid[ClusterIndex(gl_FragCoord.xy, -viewPos.z)];
+    vec3  lit  = vec3(0.0);
+
+    for (uint i = 0u; i < list.y; ++i) {
+        Light light   = lights[lightIndices[list.x + i]];
+        vec3  toLight = light.PositionRadius.xyz - viewPos;
+        float dist    = length(toLight);
+        float falloff = clamp(1.0 - dist / light.PositionRadius.w, 0.0, 1.0);
+        float lambert = max(dot(normal, toLight / max(dist, 1e-4)), 0.0);
+
+        lit += light.ColorIntensity.rgb * light.ColorIntensity.w * lambert * falloff * falloff;
+    }
+
+    return albedo * lit;
+}
+
+#endif
@@ -0,0 +1,83 @@
+// Meshlet culling, see Render/Meshlet/ClusterCuller.hpp
+//
+// MESHLET_SET picks the descriptor set, 3 for the mesh shading pipeline:
+// after the frame, lighting and streamed texture sets.
+// The compaction pass defines MESHLET_COMPACTION and gets the index list
+// and the indirect draw it fills.
+//
+// Everything is in object space: the frustum planes come straight out of
+// the object to clip transform and the camera is moved into object space.
+
+#ifndef MESHLET_SET
+#define MESHLET_SET 3
+#endif
+
+// Same as Assets::Mesh::Meshlet
+struct Meshlet {
+    vec4  Sphere;           // Center, radius
+    vec4  Cone;             // Axis, cutoff
+    uvec4 Ranges;           // Vertex offset, triangle offset, vertex count, triangle count
+};
+
+layout(std430, set = MESHLET_SET, binding = 0) readonly buffer Meshlets {
+    Meshlet meshlets[];
+};
+
+layout(std430, set = MESHLET_SET, binding = 1) readonly buffer MeshletVertices {
+    uint meshletVertices[];
+};
+
+// Three 8 bit corners per triangle
+layout(std430, set = MESHLET_SET, binding = 2) readonly buffer MeshletTriangles {
+    uint meshletTriangles[];
+};
+
+// Primitives::Vertex, two floats of position and three of color. The
+// whole geometry pool, the mesh starts at Counts.y.
+layout(std430, set = MESHLET_SET, binding = 3) readonly buffer Vertices {
+    float vertices[];
+};
+
+#ifdef MESHLET_COMPACTION
+layout(std430, set = MESHLET_SET, binding = 4) writeonly buffer Indices {
+    uint indices[];
+};
+
+// VkDrawIndexedIndirectCommand, the index count doubles as the counter
+layout(std430, set = MESHLET_SET, binding = 5) buffer Draw {
+    uint IndexCount;
+    uint InstanceCount;
+    uint FirstIndex;
+    int  VertexOffset;
+    uint FirstInstance;
+} draw;
+#endif
+
+layout(push_constant) uniform Cull {
+    vec4  Planes[6];        // Inward facing, normalized
+    vec4  Camera;           // Object space position, w = 0 turns the cone test off
+    uvec4 Counts;           // Meshlet count, first vertex of the mesh
+} cull;
+
+const uint VertexStride = 5u;
+
+bool MeshletVisible(Meshlet meshlet) {
+    vec3  center = meshlet.Sphere.xyz;
+    float radius = meshlet.Sphere.w;
+
+    for (int i = 0; i < 6; ++i) {
+        if (dot(cull.Planes[i].xyz, center) + cull.Planes[i].w < -radius) return false;
+    }
+
+    // Every triangle faces away from the camera
+    if (cull.Camera.w > 0.0) {
+        vec3 away = center - cull.Camera.xyz;
+        if (dot(away, meshlet.Cone.xyz) >= meshlet.Cone.w * length(away) + radius) return false;
+    }
+
+    return true;
+}
+
+uvec3 MeshletTriangle(uint packed) {
+    return uvec3(packed & 0xFFu, (packed >> 8) & 0xFFu, (packed >> 16) & 0xFFu);
+}
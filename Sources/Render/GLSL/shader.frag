@@ -1,9 +1,61 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
+#extension GL_GOOGLE_include_directive : require
+
+// Variants, see Render/Shader/ShaderVariant.hpp. The toggles are
+// specialization constants, constant_id is the feature's bit. UNLIT is
+// compiled separately, it drops the lighting set altogether. TEXTURED is
+// too, it takes the base colour from the streamed texture in set 2.
+layout(constant_id = 0) const bool LightHeatmap = false;
+layout(constant_id = 1) const bool ShowNormals  = false;
+
+#ifndef UNLIT
+#include "clustered_lighting.glsl"
+#endif
+
+#ifdef TEXTURED
+#include "streamed_texture.glsl"
+STREAMED_TEXTURE(Scene, 2, 0)
+#endif
+
+// Lets unlit geometry still show
+const float Ambient = 0.15;
+
+// Blue for no lights to red for HeatmapLights and up
+const uint HeatmapLights = 16u;
 
 layout(location = 0) in vec3 fragColor;
+layout(location = 1) in vec3 fragViewPos;
+layout(location = 2) in vec2 fragUV;
 layout(location = 0) out vec4 outColor;
 
 void main() {
-    outColor = vec4(fragColor, 1.0);
+    // Flat normal from the screen space derivatives, facing the camera
+    vec3 normal = normalize(cross(dFdx(fragViewPos), dFdy(fragViewPos)));
+    if (dot(normal, fragViewPos) > 0.0) {
+        normal = -normal;
+    }
+
+    if (ShowNormals) {
+        outColor = vec4(normal * 0.5 + 0.5, 1.0);
+        return;
+    }
+
+#ifdef TEXTURED
+    vec3 baseColor = fragColor * SampleScene(fragUV).rgb;
+#else
+    vec3 baseColor = fragColor;
+#endif
+
+#ifdef UNLIT
+    outColor = vec4(baseColor, 1.0);
+#else
+    if (LightHeatmap) {
+        float heat = min(float(ClusterLightCount(fragViewPos)) / float(HeatmapLights), 1.0);
+        outColor = vec4(mix(vec3(0.0, 0.0, 1.0), vec3(1.0, 0.0, 0.0), heat), 1.0);
+        return;
+    }
+
+    outColor = vec4(baseColor * Ambient + ShadeClustered(baseColor, fragViewPos, normal), 1.0);
+#endif
 }
@@ -1,12 +1,23 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 
+layout(set = 0, binding = 0) uniform Frame {
+    mat4 Transform;
+    mat4 View;
+    mat4 Projection;
+} frame;
+
 layout(location = 0) in vec2 vertPos;
 layout(location = 1) in vec3 vertCol;
 
 layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec3 fragViewPos;
+// Vertices carry no UVs, planar from the object's xy
+layout(location = 2) out vec2 fragUV;
 
 void main() {
-    gl_Position = vec4(vertPos, 0.0, 1.0);
+    gl_Position = frame.Transform * vec4(vertPos, 0.0, 1.0);
     fragColor = vertCol;
+    fragViewPos = (frame.View * vec4(vertPos, 0.0, 1.0)).xyz;
+    fragUV = vertPos * 0.5 + 0.5;
 }
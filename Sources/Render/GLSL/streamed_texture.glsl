@@ -0,0 +1,36 @@
+// Sampling a streamed texture, see Render/Texture/StreamedTexture.hpp
+//
+// STREAMED_TEXTURE(Name, Set, Binding) declares three bindings starting at
+// Binding: the texture, this frame's feedback region and the residency
+// table, plus vec4 SampleName(vec2 uv). Needs fragmentStoresAndAtomics.
+//
+// Feedback is written for one pixel in 16, that's plenty to find the mips
+// in use and keeps the atomics off the critical path.
+
+#define STREAMED_TEXTURE(Name, Set, Binding)                                                    \
+    layout(set = Set, binding = Binding) uniform sampler2D Name##Image;                         \
+                                                                                                \
+    layout(set = Set, binding = Binding + 1, std430) buffer Name##FeedbackBlock {               \
+        uint Name##Feedback[];                                                                  \
+    };                                                                                          \
+                                                                                                \
+    layout(set = Set, binding = Binding + 2, std430) readonly buffer Name##ResidencyBlock {     \
+        uvec4 Name##Header;     /* BaseMip, TilesX, TilesY, MipCount */                         \
+        uint  Name##MinMip[];                                                                   \
+    };                                                                                          \
+                                                                                                \
+    vec4 Sample##Name(vec2 uv) {                                                                \
+        uint  baseMip = Name##Header.x;                                                         \
+        uvec2 tiles   = Name##Header.yz;                                                        \
+        uvec2 tile    = min(uvec2(fract(uv) * vec2(tiles)), tiles - 1u);                        \
+        uint  index   = tile.y * tiles.x + tile.x;                                              \
+                                                                                                \
+        float lod = max(textureQueryLod(Name##Image, uv).y, 0.0) + float(baseMip);             \
+                                                                                                \
+        if (((uint(gl_FragCoord.x) | uint(gl_FragCoord.y)) & 3u) == 0u) {                       \
+            atomicMin(Name##Feedback[index], uint(lod));                                        \
+        }                                                                                       \
+                                                                                                \
+        float resident = float(Name##MinMip[index]);                                            \
+        return textureLod(Name##Image, uv, max(lod, resident) - float(baseMip));                \
+    }
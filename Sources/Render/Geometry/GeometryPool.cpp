@@ -0,0 +1,239 @@
+#include "GeometryPool.hpp"
+#include "Device/Physical.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Engine::Render::Geometry {
+
+    namespace ERD = Engine::Render::Device;
+    namespace ERM = Engine::Render::Memory;
+    namespace EP  = Engine::Primitives;
+
+    namespace {
+        // Compaction copies every live mesh, not worth it for a few holes
+        constexpr uint32_t MinCompactVertices   { 64 * 1024 };
+        constexpr uint32_t MinCompactIndices    { 256 * 1024 };
+
+        const auto hostMemory{ vk::MemoryPropertyFlagBits::eHostCoherent | vk::MemoryPropertyFlagBits::eHostVisible };
+
+        // Doubles until needed fits
+        uint32_t GrownCapacity(const uint32_t capacity, const uint32_t needed) {
+            uint64_t grown{ std::max(capacity, 1u) };
+            while (grown < needed) grown *= 2;
+            return static_cast<uint32_t>(std::min<uint64_t>(grown, std::numeric_limits<uint32_t>::max()));
+        }
+
+        bool WorthCompacting(const uint32_t top, const uint32_t holes, const uint32_t minimum) {
+            return holes >= minimum && holes > top / 2;
+        }
+
+        // Mesh shaders fetch vertices as a storage buffer, both buffers
+        // are copied out of when compacting
+        template <typename T>
+        ERM::DeviceMemory<T> CreatePoolBuffer(const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo, const vk::DeviceSize bytes, const vk::BufferUsageFlags& usage) {
+            return ERM::DeviceMemory<T>(renderDevice, deviceInfo, vk::BufferCreateInfo()
+                .setSharingMode(vk::SharingMode::eExclusive)
+                .setSize(std::max<vk::DeviceSize>(bytes, 4))
+                .setUsage(usage | vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eTransferSrc),
+                vk::MemoryPropertyFlagBits::eDeviceLocal
+            );
+        }
+
+        template <typename T>
+        ERM::DeviceMemory<T> CreateStaging(const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo, const std::vector<T>& data) {
+            if (data.empty()) return {};
+
+            auto buffer{ ERM::DeviceMemory<T>(renderDevice, deviceInfo, vk::BufferCreateInfo()
+                .setSharingMode(vk::SharingMode::eExclusive)
+                .setSize(sizeof(T) * data.size())
+                .setUsage(vk::BufferUsageFlagBits::eTransferSrc),
+                hostMemory)
+            };
+
+            buffer.Upload(renderDevice, data.data(), 0, static_cast<uint32_t>(data.size()));
+            buffer.Unmap(renderDevice);
+            return buffer;
+        }
+
+        // Copies sharing a source go in one call
+        void AddCopy(std::vector<std::pair<vk::Buffer, std::vector<vk::BufferCopy>>>& copies, const vk::Buffer& source, const vk::BufferCopy& region) {
+            if (region.size == 0) return;
+
+            const auto found{ std::find_if(copies.begin(), copies.end(), [&source](const auto& copy) { return copy.first == source; }) };
+            if (found != copies.end()) {
+                found->second.push_back(region);
+            }
+            else {
+                copies.push_back({ source, { region } });
+            }
+        }
+    }
+
+    GeometryPool::GeometryPool(const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo, const uint32_t vertexCapacity, const uint32_t indexCapacity) {
+        Relocate(renderDevice, deviceInfo, vertexCapacity, indexCapacity);
+        generation = 0;
+    }
+
+    const GeometryPool::Entry& GeometryPool::EntryOf(const MeshHandle mesh) const {
+        if (mesh >= meshes.size() || !meshes[mesh].Live) {
+            throw std::runtime_error("No such pooled mesh");
+        }
+        return meshes[mesh];
+    }
+
+    // Live meshes go back to back in handle order. A mesh whose data hasn't
+    // been copied in yet keeps its source, the copy just lands elsewhere.
+    void GeometryPool::Relocate(const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo, const uint32_t newVertexCapacity, const uint32_t newIndexCapacity) {
+        const auto oldVertices{ VertexBuffer() };
+        const auto oldIndices { IndexBuffer() };
+
+        if (oldVertices) vertexSources.push_back(std::move(vertices));
+        if (oldIndices)  indexSources.push_back(std::move(indices));
+
+        vertexCapacity  = newVertexCapacity;
+        indexCapacity   = newIndexCapacity;
+        vertices        = CreatePoolBuffer<EP::Vertex>(renderDevice, deviceInfo, EP::Vertex::Size(vertexCapacity), vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eStorageBuffer);
+        indices         = CreatePoolBuffer<uint32_t>(renderDevice, deviceInfo, sizeof(uint32_t) * vk::DeviceSize{ indexCapacity }, vk::BufferUsageFlagBits::eIndexBuffer);
+
+        vertexTop = indexTop = 0;
+        freeVertices = freeIndices = 0;
+
+        for (auto& entry : meshes) {
+            if (!entry.Live) continue;
+
+            if (!entry.Moving) {
+                entry.Pending = { oldVertices, oldIndices, entry.Range.FirstVertex, entry.Range.FirstIndex };
+                entry.Moving  = true;
+            }
+
+            entry.Range.FirstVertex = vertexTop;
+            entry.Range.FirstIndex  = indexTop;
+            vertexTop += entry.Range.VertexCount;
+            indexTop  += entry.Range.IndexCount;
+        }
+
+        ++generation;
+    }
+
+    MeshHandle GeometryPool::Add(const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo, ERM::DeviceMemory<EP::Vertex>&& meshVertices, ERM::DeviceMemory<uint32_t>&& meshIndices) {
+        const auto vertexCount{ meshVertices.Size() };
+        const auto indexCount { meshIndices.Size() };
+
+        const bool vertexRoom{ uint64_t{ vertexTop } + vertexCount <= vertexCapacity };
+        const bool indexRoom { uint64_t{ indexTop }  + indexCount  <= indexCapacity };
+
+        if (!vertexRoom || !indexRoom) {
+            const auto vertexNeed{ VertexCount() + vertexCount };
+            const auto indexNeed { IndexCount()  + indexCount };
+            Relocate(renderDevice, deviceInfo, GrownCapacity(vertexCapacity, vertexNeed), GrownCapacity(indexCapacity, indexNeed));
+        }
+
+        MeshHandle mesh{ static_cast<MeshHandle>(meshes.size()) };
+        if (!freeHandles.empty()) {
+            mesh = freeHandles.back();
+            freeHandles.pop_back();
+        }
+        else {
+            meshes.emplace_back();
+        }
+
+        auto& entry{ meshes[mesh] };
+        entry.Range   = { vertexTop, vertexCount, indexTop, indexCount };
+        entry.Pending = { *meshVertices.Buffer(), *meshIndices.Buffer(), 0, 0 };
+        entry.Live    = true;
+        entry.Moving  = true;
+
+        vertexTop += vertexCount;
+        indexTop  += indexCount;
+
+        if (vertexCount > 0) vertexSources.push_back(std::move(meshVertices));
+        if (indexCount > 0)  indexSources.push_back(std::move(meshIndices));
+
+        return mesh;
+    }
+
+    MeshHandle GeometryPool::Add(const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo, const std::vector<EP::Vertex>& meshVertices, const std::vector<uint32_t>& meshIndices) {
+        return Add(renderDevice, deviceInfo, CreateStaging(renderDevice, deviceInfo, meshVertices), CreateStaging(renderDevice, deviceInfo, meshIndices));
+    }
+
+    void GeometryPool::Remove(const MeshHandle mesh) {
+        if (mesh >= meshes.size() || !meshes[mesh].Live) return;
+
+        auto& entry{ meshes[mesh] };
+        freeVertices += entry.Range.VertexCount;
+        freeIndices  += entry.Range.IndexCount;
+        entry = Entry{};
+
+        freeHandles.push_back(mesh);
+    }
+
+    void GeometryPool::Prepare(const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo) {
+        if (WorthCompacting(vertexTop, freeVertices, MinCompactVertices) || WorthCompacting(indexTop, freeIndices, MinCompactIndices)) {
+            Relocate(renderDevice, deviceInfo, vertexCapacity, indexCapacity);
+        }
+    }
+
+    // Ranges are only ever written while nothing has drawn from them, new
+    // ranges sit above everything earlier frames used and compaction writes
+    // fresh buffers. Only the reads after the copies need waiting on.
+    void GeometryPool::RecordUploads(const vk::CommandBuffer& cmdBuffer, const ERD::DeviceDispatch& d, ERM::DeletionQueue& deletionQueue, const uint64_t frameNumber) {
+        std::vector<std::pair<vk::Buffer, std::vector<vk::BufferCopy>>> vertexCopies{};
+        std::vector<std::pair<vk::Buffer, std::vector<vk::BufferCopy>>> indexCopies{};
+
+        for (auto& entry : meshes) {
+            if (!entry.Live || !entry.Moving) continue;
+
+            const auto& range{ entry.Range };
+            const auto& source{ entry.Pending };
+
+            AddCopy(vertexCopies, source.Vertices, vk::BufferCopy(EP::Vertex::Size(source.FirstVertex), EP::Vertex::Size(range.FirstVertex), EP::Vertex::Size(range.VertexCount)));
+            AddCopy(indexCopies,  source.Indices,  vk::BufferCopy(sizeof(uint32_t) * vk::DeviceSize{ source.FirstIndex }, sizeof(uint32_t) * vk::DeviceSize{ range.FirstIndex }, sizeof(uint32_t) * vk::DeviceSize{ range.IndexCount }));
+
+            entry.Pending = Source{};
+            entry.Moving  = false;
+        }
+
+        for (const auto& [source, regions] : vertexCopies) {
+            cmdBuffer.copyBuffer(source, VertexBuffer(), regions, d);
+        }
+        for (const auto& [source, regions] : indexCopies) {
+            cmdBuffer.copyBuffer(source, IndexBuffer(), regions, d);
+        }
+
+        // Relocate copies out of and over the same ranges later on
+        if (!vertexCopies.empty() || !indexCopies.empty()) {
+            cmdBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                vk::PipelineStageFlagBits::eAllGraphics | vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eTransfer, {},
+                vk::MemoryBarrier()
+                    .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+                    .setDstAccessMask(vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eIndexRead | vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eTransferRead | vk::AccessFlagBits::eTransferWrite),
+                nullptr, nullptr, d);
+        }
+
+        // Sources of removed meshes go too, nothing was copied out of them
+        if (!vertexSources.empty() || !indexSources.empty()) {
+            deletionQueue.Retire(std::move(vertexSources), frameNumber);
+            deletionQueue.Retire(std::move(indexSources), frameNumber);
+            vertexSources.clear();
+            indexSources.clear();
+        }
+    }
+
+    void GeometryPool::Bind(const vk::CommandBuffer& cmdBuffer, const ERD::DeviceDispatch& d) const {
+        const vk::DeviceSize offset{ 0 };
+        cmdBuffer.bindVertexBuffers(0, 1, vertices.Buffer(), &offset, d);
+        cmdBuffer.bindIndexBuffer(IndexBuffer(), 0, vk::IndexType::eUint32, d);
+    }
+
+    void GeometryPool::Draw(const vk::CommandBuffer& cmdBuffer, const ERD::DeviceDispatch& d, const MeshHandle mesh) const {
+        const auto range{ Range(mesh) };
+
+        if (range.IndexCount > 0) {
+            cmdBuffer.drawIndexed(range.IndexCount, 1, range.FirstIndex, static_cast<int32_t>(range.FirstVertex), 0, d);
+        }
+        else {
+            cmdBuffer.draw(range.VertexCount, 1, range.FirstVertex, 0, d);
+        }
+    }
+}
@@ -0,0 +1,123 @@
+#ifndef RENDER_GEOMETRY_GEOMETRY_POOL_HPP
+#define RENDER_GEOMETRY_GEOMETRY_POOL_HPP
+
+#include "VKinclude/VKinclude.hpp"
+#include "Memory/Buffers.hpp"
+#include "Memory/DeletionQueue.hpp"
+#include "Device/Dispatch.hpp"
+#include "Primitives/Vertex.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Engine::Render::Geometry {
+
+    using MeshHandle = uint32_t;
+    constexpr MeshHandle NoMesh{ std::numeric_limits<uint32_t>::max() };
+
+    // Where a mesh sits in the pool. Indices stay relative to the mesh's
+    // first vertex, draws pass FirstVertex as vertexOffset.
+    struct MeshRange {
+        uint32_t FirstVertex{ 0 };
+        uint32_t VertexCount{ 0 };
+        uint32_t FirstIndex { 0 };
+        uint32_t IndexCount { 0 };
+    };
+
+    // Every static mesh in one device local vertex buffer and one index
+    // buffer, so a frame binds geometry once and draws meshes by range.
+    //
+    // Ranges are handed out from the top of each buffer, removed meshes
+    // leave holes behind. Once holes make up half of a buffer, or a mesh
+    // doesn't fit above the top, the live meshes are copied into fresh
+    // buffers back to back, grown if needed, and the old ones are retired.
+    // That moves every range, Generation counts the moves so callers know
+    // to fetch ranges and buffers again.
+    //
+    // Data comes in through buffers with transfer source usage, a streamed
+    // mesh's own or staging filled from host memory. Nothing is copied
+    // before RecordUploads, sources are kept until then.
+    class GeometryPool {
+
+    private:
+        // Where a mesh's data sits until RecordUploads copies it into its range
+        struct Source {
+            vk::Buffer  Vertices;
+            vk::Buffer  Indices;
+            uint32_t    FirstVertex{ 0 };
+            uint32_t    FirstIndex { 0 };
+        };
+
+        struct Entry {
+            MeshRange   Range;
+            Source      Pending;
+            bool        Live    { false };
+            bool        Moving  { false };      // Pending holds something to copy
+        };
+
+        Engine::Render::Memory::DeviceMemory<Engine::Primitives::Vertex>    vertices;
+        Engine::Render::Memory::DeviceMemory<uint32_t>                      indices;
+        uint32_t                vertexCapacity  { 0 };
+        uint32_t                indexCapacity   { 0 };
+        uint32_t                vertexTop       { 0 };
+        uint32_t                indexTop        { 0 };
+        uint32_t                freeVertices    { 0 };      // In holes below the top
+        uint32_t                freeIndices     { 0 };
+        uint64_t                generation      { 0 };
+
+        std::vector<Entry>      meshes;                     // By handle
+        std::vector<MeshHandle> freeHandles;
+
+        // Staging and replaced pool buffers, retired once copied out of
+        std::vector<Engine::Render::Memory::DeviceMemory<Engine::Primitives::Vertex>>  vertexSources;
+        std::vector<Engine::Render::Memory::DeviceMemory<uint32_t>>                    indexSources;
+
+        void Relocate(const vk::Device&, const Engine::Render::Device::PhysicalDevice&, const uint32_t newVertexCapacity, const uint32_t newIndexCapacity);
+        const Entry& EntryOf(const MeshHandle mesh) const;
+
+    public:
+        GeometryPool() = default;
+        GeometryPool(const vk::Device&, const Engine::Render::Device::PhysicalDevice&, const uint32_t vertexCapacity, const uint32_t indexCapacity);
+
+        // No copies!
+        GeometryPool(const GeometryPool&) = delete;
+        GeometryPool& operator=(const GeometryPool&) = delete;
+
+        GeometryPool(GeometryPool&&) = default;
+        GeometryPool& operator=(GeometryPool&&) = default;
+
+        // Takes the buffers, their Size() is what gets copied. They need
+        // transfer source usage. May move every other mesh.
+        MeshHandle Add(const vk::Device&, const Engine::Render::Device::PhysicalDevice&, Engine::Render::Memory::DeviceMemory<Engine::Primitives::Vertex>&& meshVertices, Engine::Render::Memory::DeviceMemory<uint32_t>&& meshIndices);
+        // Stages host data first. No indices draws the vertices in order.
+        MeshHandle Add(const vk::Device&, const Engine::Render::Device::PhysicalDevice&, const std::vector<Engine::Primitives::Vertex>& meshVertices, const std::vector<uint32_t>& meshIndices = {});
+        // Frames in flight may still draw the range, it is only reused
+        // after compaction copied everything else into new buffers
+        void Remove(const MeshHandle mesh);
+
+        // Compacts if holes have piled up. Call once a frame before recording.
+        void Prepare(const vk::Device&, const Engine::Render::Device::PhysicalDevice&);
+        // Call outside of rendering. Copies what was added or moved since
+        // the last call and leaves it ready for vertex input and shaders.
+        void RecordUploads(const vk::CommandBuffer&, const Engine::Render::Device::DeviceDispatch&, Engine::Render::Memory::DeletionQueue&, const uint64_t frameNumber);
+
+        // Vertex buffer at binding 0 and the index buffer, once per frame
+        void Bind(const vk::CommandBuffer&, const Engine::Render::Device::DeviceDispatch&) const;
+        // One instance of the whole mesh, indexed when it has indices
+        void Draw(const vk::CommandBuffer&, const Engine::Render::Device::DeviceDispatch&, const MeshHandle mesh) const;
+
+        // Valid until Generation changes
+        const MeshRange     Range(const MeshHandle mesh) const { return EntryOf(mesh).Range; }
+        const vk::Buffer    VertexBuffer()  const { return *vertices.Buffer(); }
+        const vk::Buffer    IndexBuffer()   const { return *indices.Buffer(); }
+        const uint64_t      Generation()    const { return generation; }
+
+        const uint32_t      VertexCount()       const { return vertexTop - freeVertices; }
+        const uint32_t      IndexCount()        const { return indexTop - freeIndices; }
+        const uint32_t      VertexCapacity()    const { return vertexCapacity; }
+        const uint32_t      IndexCapacity()     const { return indexCapacity; }
+    };
+}
+
+#endif // !RENDER_GEOMETRY_GEOMETRY_POOL_HPP
@@ -20,7 +20,7 @@ namespace Engine::Render::Instance {
 
         // Initialize the dynamic loader
         VULKAN_HPP_DEFAULT_DISPATCHER.init(
-            dynamicLoader.getProcAddress<PFN_vkGetInstanceProcAddr>("vkGetInstanceProcAddr")
+            Loader().getProcAddress<PFN_vkGetInstanceProcAddr>("vkGetInstanceProcAddr")
         );
 
         // Debug/Validation layers
@@ -0,0 +1,166 @@
+#include "ClusteredLighting.hpp"
+#include "Shader/Shader.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace Engine::Render::Lighting {
+
+    namespace ERD = Engine::Render::Device;
+    namespace ERM = Engine::Render::Memory;
+
+    namespace {
+        // Matches local_size_x in GLSL/light_cull.comp
+        constexpr uint32_t CullGroupSize{ 64 };
+
+        vk::UniqueDescriptorSetLayout CreateSetLayout(const vk::Device& renderDevice) {
+            const auto stages{ vk::ShaderStageFlagBits::eCompute | vk::ShaderStageFlagBits::eFragment };
+
+            const std::array<vk::DescriptorSetLayoutBinding, 4> bindings{
+                vk::DescriptorSetLayoutBinding(0, vk::DescriptorType::eUniformBuffer, 1, stages),
+                vk::DescriptorSetLayoutBinding(1, vk::DescriptorType::eStorageBuffer, 1, stages),
+                vk::DescriptorSetLayoutBinding(2, vk::DescriptorType::eStorageBuffer, 1, stages),
+                vk::DescriptorSetLayoutBinding(3, vk::DescriptorType::eStorageBuffer, 1, stages)
+            };
+
+            return renderDevice.createDescriptorSetLayoutUnique(vk::DescriptorSetLayoutCreateInfo()
+                .setBindingCount(static_cast<uint32_t>(bindings.size()))
+                .setPBindings(bindings.data())
+            );
+        }
+
+        template <typename T>
+        ERM::DeviceMemory<T> CreateBuffer(const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo, const vk::DeviceSize size, const vk::BufferUsageFlags& usage, const vk::MemoryPropertyFlags& properties) {
+            return ERM::DeviceMemory<T>(renderDevice, deviceInfo, vk::BufferCreateInfo()
+                .setSharingMode(vk::SharingMode::eExclusive)
+                .setSize(size)
+                .setUsage(usage),
+                properties
+            );
+        }
+    }
+
+    ClusteredLighting::ClusteredLighting(const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo, const uint32_t framesInFlight, const LightingSettings& settings) :
+        settings(settings),
+        indexCapacity(ClusterCount * std::max(1u, settings.IndicesPerCluster)),
+        setLayout(CreateSetLayout(renderDevice))
+    {
+        const std::array<vk::DescriptorPoolSize, 2> poolSizes{
+            vk::DescriptorPoolSize(vk::DescriptorType::eUniformBuffer, framesInFlight),
+            vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, 3 * framesInFlight)
+        };
+
+        pool = renderDevice.createDescriptorPoolUnique(vk::DescriptorPoolCreateInfo()
+            .setMaxSets(framesInFlight)
+            .setPoolSizeCount(static_cast<uint32_t>(poolSizes.size()))
+            .setPPoolSizes(poolSizes.data())
+        );
+
+        cullLayout = renderDevice.createPipelineLayoutUnique(vk::PipelineLayoutCreateInfo()
+            .setSetLayoutCount(1)
+            .setPSetLayouts(&setLayout.get())
+        );
+
+        const auto cullCode{ Engine::Render::Shader::CreateShaderModule(renderDevice, "light_cull.spv") };
+
+        cullPipeline = renderDevice.createComputePipelineUnique(nullptr, vk::ComputePipelineCreateInfo()
+            .setStage(vk::PipelineShaderStageCreateInfo()
+                .setStage(vk::ShaderStageFlagBits::eCompute)
+                .setModule(cullCode.get())
+                .setPName("main"))
+            .setLayout(cullLayout.get())
+        );
+
+        const auto hostVisible{ vk::MemoryPropertyFlagBits::eHostCoherent | vk::MemoryPropertyFlagBits::eHostVisible };
+        const auto maxLights{ std::max(1u, settings.MaxLights) };
+
+        const std::vector<vk::DescriptorSetLayout> layouts(framesInFlight, setLayout.get());
+        const auto sets{ renderDevice.allocateDescriptorSets(vk::DescriptorSetAllocateInfo()
+            .setDescriptorPool(pool.get())
+            .setDescriptorSetCount(framesInFlight)
+            .setPSetLayouts(layouts.data())
+        ) };
+
+        lights.reserve(maxLights);
+
+        for (uint32_t i = 0; i < framesInFlight; ++i) {
+            Slot slot{};
+            slot.Lights  = CreateBuffer<PointLight>(renderDevice, deviceInfo, sizeof(PointLight) * maxLights, vk::BufferUsageFlagBits::eStorageBuffer, hostVisible);
+            slot.Params  = CreateBuffer<ClusterParams>(renderDevice, deviceInfo, sizeof(ClusterParams), vk::BufferUsageFlagBits::eUniformBuffer, hostVisible);
+            slot.Grid    = CreateBuffer<uint32_t>(renderDevice, deviceInfo, sizeof(uint32_t) * 2 * ClusterCount, vk::BufferUsageFlagBits::eStorageBuffer, vk::MemoryPropertyFlagBits::eDeviceLocal);
+            slot.Indices = CreateBuffer<uint32_t>(renderDevice, deviceInfo, sizeof(uint32_t) * (1 + indexCapacity),
+                vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst, vk::MemoryPropertyFlagBits::eDeviceLocal);
+            slot.Set     = sets[i];
+
+            const std::array<vk::DescriptorBufferInfo, 4> infos{
+                vk::DescriptorBufferInfo(*slot.Params.Buffer(),  0, VK_WHOLE_SIZE),
+                vk::DescriptorBufferInfo(*slot.Lights.Buffer(),  0, VK_WHOLE_SIZE),
+                vk::DescriptorBufferInfo(*slot.Grid.Buffer(),    0, VK_WHOLE_SIZE),
+                vk::DescriptorBufferInfo(*slot.Indices.Buffer(), 0, VK_WHOLE_SIZE)
+            };
+
+            std::array<vk::WriteDescriptorSet, 4> writes{};
+            for (uint32_t b = 0; b < writes.size(); ++b) {
+                writes[b] = vk::WriteDescriptorSet()
+                    .setDstSet(slot.Set)
+                    .setDstBinding(b)
+                    .setDescriptorCount(1)
+                    .setDescriptorType(b == 0 ? vk::DescriptorType::eUniformBuffer : vk::DescriptorType::eStorageBuffer)
+                    .setPBufferInfo(&infos[b]);
+            }
+            renderDevice.updateDescriptorSets(writes, nullptr);
+
+            // Mapped for good, rewritten every frame
+            slot.Lights.Mapped(renderDevice);
+            *slot.Params.Mapped(renderDevice) = ClusterParams{};
+
+            slots.push_back(std::move(slot));
+        }
+    }
+
+    void ClusteredLighting::SetLights(const std::vector<PointLight>& newLights) {
+        const auto count{ std::min(newLights.size(), size_t{ settings.MaxLights }) };
+        lights.assign(newLights.begin(), newLights.begin() + count);
+    }
+
+    void ClusteredLighting::Prepare(const vk::Device& renderDevice, const uint32_t slot, const glm::mat4& view, const glm::mat4& projection, const vk::Extent2D& area) {
+        auto& current{ slots[slot] };
+        auto* mapped{ current.Lights.Mapped(renderDevice) };
+
+        lightCount = static_cast<uint32_t>(lights.size());
+        for (uint32_t i = 0; i < lightCount; ++i) {
+            mapped[i]           = lights[i];
+            mapped[i].Position  = glm::vec3(view * glm::vec4(lights[i].Position, 1.0f));
+        }
+
+        auto& params{ *current.Params.Mapped(renderDevice) };
+        params.InverseProjection    = glm::inverse(projection);
+        params.Grid                 = glm::uvec4(ClustersX, ClustersY, ClustersZ, lightCount);
+        params.Area                 = glm::vec4(area.width, area.height, settings.Near, settings.Far);
+        params.Capacity             = glm::uvec4(indexCapacity, 0, 0, 0);
+    }
+
+    // The counter is cleared by a transfer, the lists are only read by
+    // fragment shaders of the same frame
+    void ClusteredLighting::RecordCulling(const vk::CommandBuffer& cmdBuffer, const ERD::DeviceDispatch& d, const uint32_t slot) const {
+        const auto& current{ slots[slot] };
+
+        cmdBuffer.fillBuffer(*current.Indices.Buffer(), 0, sizeof(uint32_t), 0u, d);
+
+        cmdBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eComputeShader, {},
+            vk::MemoryBarrier()
+                .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+                .setDstAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite),
+            nullptr, nullptr, d);
+
+        cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, cullPipeline.get(), d);
+        cmdBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, cullLayout.get(), 0, current.Set, nullptr, d);
+        cmdBuffer.dispatch((ClusterCount + CullGroupSize - 1) / CullGroupSize, 1, 1, d);
+
+        cmdBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eFragmentShader, {},
+            vk::MemoryBarrier()
+                .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+                .setDstAccessMask(vk::AccessFlagBits::eShaderRead),
+            nullptr, nullptr, d);
+    }
+}
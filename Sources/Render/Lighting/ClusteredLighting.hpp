@@ -0,0 +1,102 @@
+#ifndef RENDER_LIGHTING_CLUSTERED_LIGHTING_HPP
+#define RENDER_LIGHTING_CLUSTERED_LIGHTING_HPP
+
+#include "VKinclude/VKinclude.hpp"
+#include "Memory/Buffers.hpp"
+#include "Device/Dispatch.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace Engine::Render::Lighting {
+
+    // Same layout as Light in GLSL/clustered_lighting.glsl. Positions are
+    // world space here, they are moved to view space on upload.
+    struct PointLight {
+        glm::vec3   Position    { 0.0f };
+        float       Radius      { 1.0f };
+        glm::vec3   Color       { 1.0f };
+        float       Intensity   { 1.0f };
+    };
+
+    // Clusters per axis, slices are spaced exponentially between Near and Far
+    constexpr uint32_t ClustersX{ 16 };
+    constexpr uint32_t ClustersY{ 9 };
+    constexpr uint32_t ClustersZ{ 24 };
+    constexpr uint32_t ClusterCount{ ClustersX * ClustersY * ClustersZ };
+
+    struct LightingSettings {
+        uint32_t    MaxLights           { 4096 };
+        uint32_t    IndicesPerCluster   { 64 };     // Average, lists of busy clusters can be longer
+        float       Near                { 0.1f };
+        float       Far                 { 100.0f };
+    };
+
+    // Clustered forward lighting. Every frame a compute pass bins the
+    // lights into a ClustersX x ClustersY x ClustersZ grid over the view
+    // frustum, writing a compact index list per cluster. Fragments then
+    // loop only over the lights of their own cluster.
+    //
+    // All buffers are per frame in flight, the lights and parameters are
+    // written by the host right before the frame is recorded. Graphics
+    // pipelines bind Set() at set 1, see GLSL/clustered_lighting.glsl.
+    class ClusteredLighting {
+
+    private:
+        // std140, same as Clusters in GLSL/clustered_lighting.glsl
+        struct ClusterParams {
+            glm::mat4   InverseProjection   { 1.0f };
+            glm::uvec4  Grid                { 0 };  // Clusters per axis, light count
+            glm::vec4   Area                { 0.0f }; // Render area width and height, near, far
+            glm::uvec4  Capacity            { 0 };  // Index list length
+        };
+
+        struct Slot {
+            Engine::Render::Memory::DeviceMemory<PointLight>    Lights;
+            Engine::Render::Memory::DeviceMemory<ClusterParams> Params;
+            Engine::Render::Memory::DeviceMemory<uint32_t>      Grid;       // Offset and count per cluster
+            Engine::Render::Memory::DeviceMemory<uint32_t>      Indices;    // Counter, then the lists
+            vk::DescriptorSet                                   Set;
+        };
+
+        LightingSettings                settings;
+        uint32_t                        indexCapacity{ 0 };
+        vk::UniqueDescriptorSetLayout   setLayout;
+        vk::UniqueDescriptorPool        pool;
+        vk::UniquePipelineLayout        cullLayout;
+        vk::UniquePipeline              cullPipeline;
+        std::vector<Slot>               slots;
+        std::vector<PointLight>         lights;
+        uint32_t                        lightCount{ 0 };
+
+    public:
+        ClusteredLighting(const vk::Device&, const Engine::Render::Device::PhysicalDevice&, const uint32_t framesInFlight, const LightingSettings& settings = {});
+
+        // No copies!
+        ClusteredLighting(const ClusteredLighting&) = delete;
+        ClusteredLighting& operator=(const ClusteredLighting&) = delete;
+
+        ClusteredLighting(ClusteredLighting&&) = default;
+        ClusteredLighting& operator=(ClusteredLighting&&) = default;
+
+        // Lights for the following frames. Anything past MaxLights is dropped.
+        void SetLights(const std::vector<PointLight>& newLights);
+
+        // Writes slot's lights in view space and the grid parameters. The
+        // slot's previous frame must have finished.
+        void Prepare(const vk::Device&, const uint32_t slot, const glm::mat4& view, const glm::mat4& projection, const vk::Extent2D& area);
+
+        // Bins the lights, call outside of rendering. Leaves the lists ready
+        // for fragment shaders.
+        void RecordCulling(const vk::CommandBuffer&, const Engine::Render::Device::DeviceDispatch&, const uint32_t slot) const;
+
+        const vk::DescriptorSetLayout   SetLayout()             const { return setLayout.get(); }
+        const vk::DescriptorSet         Set(const uint32_t slot) const { return slots[slot].Set; }
+        const uint32_t                  LightCount()            const { return lightCount; }
+        const LightingSettings&         Settings()              const { return settings; }
+    };
+}
+
+#endif // !RENDER_LIGHTING_CLUSTERED_LIGHTING_HPP
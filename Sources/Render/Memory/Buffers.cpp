@@ -0,0 +1,31 @@
+#include "Buffers.hpp"
+
+namespace Engine::Render::Memory {
+
+    uint32_t FindMemoryType(const vk::PhysicalDeviceMemoryProperties& deviceMemProps, const uint32_t bitFlags, const vk::MemoryPropertyFlags& usageFlags) {
+
+        // Pick the first suitable type
+        for (uint32_t i = 0; i < deviceMemProps.memoryTypeCount; ++i) {
+            /*
+            * Why? Quoting from the spec, at
+            * https://www.khronos.org/registry/vulkan/specs/1.1-extensions/html/vkspec.html#resources-association
+            *
+            * Under 'VkMemoryRequirements'
+            *
+            * "memoryTypeBits is a bitmask and contains one bit set for every supported memory
+            * type for the resource. Bit i is set if and only if the memory type i in the
+            * VkPhysicalDeviceMemoryProperties structure for the physical device is supported
+            * for the resource."
+            *
+            * So we just check if bit i is set in bitFlags, starting from LSB.
+            * Higher bits are 'less ideal' for performance reasons.
+            */
+            if ((bitFlags & (1 << i)) && ((deviceMemProps.memoryTypes[i].propertyFlags & usageFlags) == usageFlags)) {
+                return i;
+            }
+        }
+
+        // None available
+        throw std::runtime_error("No type memory found");
+    }
+}
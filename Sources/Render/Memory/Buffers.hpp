@@ -3,9 +3,15 @@
 
 #include "VKinclude/VKinclude.hpp"
 #include "Device/Physical.hpp"
+#include "Tracking.hpp"
+
+#include <algorithm>
+#include <cstring>
 
 namespace Engine::Render::Memory {
 
+    uint32_t FindMemoryType(const vk::PhysicalDeviceMemoryProperties& deviceMemProps, const uint32_t bitFlags, const vk::MemoryPropertyFlags& usageFlags);
+
     template <typename T>
     class DeviceMemory {
     private:
@@ -14,8 +20,10 @@ namespace Engine::Render::Memory {
         vk::MemoryRequirements  info;
         std::vector<T>          stagingBuffer;
         vk::UniqueDeviceMemory  memory;
+        TrackedAllocation       tracked;
 
         T* mappedPointer{ nullptr };
+        uint32_t count{ 0 };
 
         uint32_t FindSuitable(const vk::PhysicalDeviceMemoryProperties& deviceMemProps, const uint32_t bitFlags);
 
@@ -31,13 +39,23 @@ namespace Engine::Render::Memory {
         DeviceMemory(DeviceMemory&&) = default;
         DeviceMemory& operator=(DeviceMemory&&) = default;
 
-        const uint32_t Size() const { return stagingBuffer.size(); }
+        const uint32_t Size() const { return count; }
+        const vk::DeviceSize Capacity() const { return info.size; }
         const vk::Buffer* Buffer() const { return &(buffer.get()); }
         std::vector<T>& StagingBuffer();
 
         void Map(const vk::Device&);
         void Unmap(const vk::Device&);
         void Flush(const vk::Device&);
+        // Makes device writes visible through the mapping, a no-op on coherent memory
+        void Invalidate(const vk::Device&);
+
+        // Copies straight into the mapped buffer, skipping the staging vector.
+        // The buffer stays mapped until Unmap so repeated chunks are cheap.
+        void Upload(const vk::Device&, const T* source, const uint32_t firstElement, const uint32_t elementCount);
+
+        // Persistently maps the whole buffer, for memory the host reads back or rewrites in place
+        T* Mapped(const vk::Device&);
     };
 
 
@@ -51,15 +69,14 @@ namespace Engine::Render::Memory {
         info(renderDevice.getBufferMemoryRequirements(buffer.get())),
         stagingBuffer(0) {
 
-        const auto memoryIndex{ FindSuitable(
-                phyDev.Get().getMemoryProperties2().memoryProperties,
-                info.memoryTypeBits)
-        };
+        const auto memoryProperties{ phyDev.Get().getMemoryProperties2().memoryProperties };
+        const auto memoryIndex{ FindSuitable(memoryProperties, info.memoryTypeBits) };
 
         memory = renderDevice.allocateMemoryUnique(vk::MemoryAllocateInfo()
             .setAllocationSize(info.size)
             .setMemoryTypeIndex(memoryIndex)
         );
+        tracked = TrackedAllocation(renderDevice, HeapOfType(memoryProperties, memoryIndex), CategoryOf(createInfo.usage), info.size);
 
         renderDevice.bindBufferMemory(buffer.get(), memory.get(), 0u);
     }
@@ -73,15 +90,38 @@ namespace Engine::Render::Memory {
     void DeviceMemory<T>::Map(const vk::Device& renderDevice) {
         void* data;
         renderDevice.mapMemory(memory.get(), 0u, info.size, {}, &data);
-        std::memcpy(data, stagingBuffer.data(), info.size);
+        std::memcpy(data, stagingBuffer.data(), sizeof(T) * stagingBuffer.size());
+        mappedPointer = static_cast<T*>(data);
+        count = static_cast<uint32_t>(stagingBuffer.size());
     }
 
     template <typename T>
     void DeviceMemory<T>::Unmap(const vk::Device& renderDevice) {
+        if (mappedPointer == nullptr) return;
         renderDevice.unmapMemory(memory.get());
         mappedPointer = nullptr;
     }
 
+    template <typename T>
+    void DeviceMemory<T>::Upload(const vk::Device& renderDevice, const T* source, const uint32_t firstElement, const uint32_t elementCount) {
+        if (sizeof(T) * (uint64_t{ firstElement } + elementCount) > info.size) {
+            throw std::runtime_error("Upload past the end of the buffer");
+        }
+
+        std::memcpy(Mapped(renderDevice) + firstElement, source, sizeof(T) * elementCount);
+        count = std::max(count, firstElement + elementCount);
+    }
+
+    template <typename T>
+    T* DeviceMemory<T>::Mapped(const vk::Device& renderDevice) {
+        if (mappedPointer == nullptr) {
+            void* data;
+            renderDevice.mapMemory(memory.get(), 0u, info.size, {}, &data);
+            mappedPointer = static_cast<T*>(data);
+        }
+        return mappedPointer;
+    }
+
     template <typename T>
     void DeviceMemory<T>::Flush(const vk::Device& renderDevice) {
         if (usageFlags & vk::MemoryPropertyFlagBits::eHostCoherent) { return; }
@@ -90,32 +130,20 @@ namespace Engine::Render::Memory {
     }
 
     template <typename T>
-    uint32_t DeviceMemory<T>::FindSuitable(const vk::PhysicalDeviceMemoryProperties& deviceMemProps, const uint32_t bitFlags) {
-
-
-        // Pick the first suitable type
-        for (uint32_t i = 0; i < deviceMemProps.memoryTypeCount; ++i) {
-            /*
-            * Why? Quoting from the spec, at
-            * https://www.khronos.org/registry/vulkan/specs/1.1-extensions/html/vkspec.html#resources-association
-            *
-            * Under 'VkMemoryRequirements'
-            *
-            * "memoryTypeBits is a bitmask and contains one bit set for every supported memory
-            * type for the resource. Bit i is set if and only if the memory type i in the
-            * VkPhysicalDeviceMemoryProperties structure for the physical device is supported
-            * for the resource."
-            *
-            * So we just check if bit i is set in bitFlags, starting from LSB.
-            * Higher bits are 'less ideal' for performance reasons.
-            */
-            if ((bitFlags & (1 << i)) && ((deviceMemProps.memoryTypes[i].propertyFlags & usageFlags) == usageFlags)) {
-                return i;
-            }
-        }
+    void DeviceMemory<T>::Invalidate(const vk::Device& renderDevice) {
+        if (usageFlags & vk::MemoryPropertyFlagBits::eHostCoherent) return;
+
+        Mapped(renderDevice);
+        renderDevice.invalidateMappedMemoryRanges(vk::MappedMemoryRange()
+            .setMemory(memory.get())
+            .setOffset(0)
+            .setSize(VK_WHOLE_SIZE)
+        );
+    }
 
-        // None available
-        throw std::runtime_error("No type memory found");
+    template <typename T>
+    uint32_t DeviceMemory<T>::FindSuitable(const vk::PhysicalDeviceMemoryProperties& deviceMemProps, const uint32_t bitFlags) {
+        return FindMemoryType(deviceMemProps, bitFlags, usageFlags);
     }
 }
 
@@ -0,0 +1,16 @@
+#include "DeletionQueue.hpp"
+
+namespace Engine::Render::Memory {
+
+    void DeletionQueue::Collect(const uint64_t completedFrame) {
+        while (!retired.empty() && retired.front().first <= completedFrame) {
+            retired.pop_front();
+        }
+    }
+
+    void DeletionQueue::Flush() {
+        while (!retired.empty()) {
+            retired.pop_front();
+        }
+    }
+}
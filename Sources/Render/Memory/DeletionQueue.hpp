@@ -0,0 +1,67 @@
+#ifndef ENGINE_MEMORY_DELETION_QUEUE_HPP
+#define ENGINE_MEMORY_DELETION_QUEUE_HPP
+
+#include <deque>
+#include <type_traits>
+#include <memory>
+#include <cstdint>
+
+namespace Engine::Render::Memory {
+
+    // Holds on to GPU objects that are no longer referenced by the engine but
+    // may still be referenced by command buffers in flight. Anything that owns
+    // its Vulkan handle (vk::Unique*, DeviceMemory<T>, Pipeline, containers of
+    // these) can be retired. Objects are tagged with the last frame that could
+    // have used them and are freed, oldest first, once that frame completes.
+    class DeletionQueue {
+
+    private:
+        struct Retired {
+            virtual ~Retired() = default;
+        };
+
+        template <typename T>
+        struct RetiredResource : Retired {
+            T resource;
+            explicit RetiredResource(T&& r) : resource(std::move(r)) {}
+        };
+
+        // Frame numbers are pushed in non-decreasing order, so the
+        // front of the queue is always the next thing to free.
+        std::deque<std::pair<uint64_t, std::unique_ptr<Retired>>> retired;
+
+    public:
+        DeletionQueue() = default;
+        ~DeletionQueue() = default;
+
+        // No copies!
+        DeletionQueue(const DeletionQueue&) = delete;
+        DeletionQueue& operator=(const DeletionQueue&) = delete;
+
+        DeletionQueue(DeletionQueue&&) = default;
+        DeletionQueue& operator=(DeletionQueue&&) = default;
+
+        template <typename T>
+        void Retire(T&& resource, const uint64_t lastUsedFrame);
+
+        // Frees everything last used on or before completedFrame
+        void Collect(const uint64_t completedFrame);
+
+        // Frees everything. Only safe once the device is idle.
+        void Flush();
+
+        const size_t Pending() const { return retired.size(); }
+    };
+
+
+    // Definitions
+
+    template <typename T>
+    void DeletionQueue::Retire(T&& resource, const uint64_t lastUsedFrame) {
+        static_assert(!std::is_lvalue_reference_v<T>, "Retire takes ownership, std::move the resource in");
+
+        retired.emplace_back(lastUsedFrame, std::make_unique<RetiredResource<T>>(std::move(resource)));
+    }
+}
+
+#endif // !ENGINE_MEMORY_DELETION_QUEUE_HPP
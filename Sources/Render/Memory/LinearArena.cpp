@@ -0,0 +1,37 @@
+#include "LinearArena.hpp"
+
+#include <algorithm>
+
+namespace Engine::Render::Memory {
+
+    LinearArena::LinearArena(const size_t initialCapacity) :
+        block(std::make_unique<std::byte[]>(initialCapacity)),
+        capacity(initialCapacity) {}
+
+    void* LinearArena::AllocateBytes(const size_t bytes, const size_t alignment) {
+        const auto base     { reinterpret_cast<uintptr_t>(block.get()) };
+        const auto aligned  { (base + used + alignment - 1) & ~(uintptr_t{ alignment } - 1) };
+        const auto end      { aligned - base + bytes };
+
+        if (end <= capacity) {
+            used = end;
+            return reinterpret_cast<void*>(aligned);
+        }
+
+        // Out of room, new[] is aligned for anything fundamental
+        ++growths;
+        overflow.emplace_back(std::make_unique<std::byte[]>(bytes));
+        overflowBytes += bytes + alignment;
+        return overflow.back().get();
+    }
+
+    void LinearArena::Reset() {
+        if (!overflow.empty()) {
+            capacity = std::max(capacity * 2, capacity + overflowBytes);
+            block    = std::make_unique<std::byte[]>(capacity);
+            overflow.clear();
+            overflowBytes = 0;
+        }
+        used = 0;
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef ENGINE_MEMORY_LINEAR_ARENA_HPP
+#define ENGINE_MEMORY_LINEAR_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace Engine::Render::Memory {
+
+    // Bump allocator for CPU data that lives until the end of one frame. Each
+    // frame in flight owns one, it is reset once that frame's fence signals.
+    // Nothing is destroyed on reset, so only trivially destructible types.
+    // Running out chains an overflow block. The next Reset folds everything
+    // into one block big enough for the peak, so a steady state frame never
+    // touches the heap.
+    class LinearArena {
+
+    private:
+        std::unique_ptr<std::byte[]>                block;
+        size_t                                      capacity        { 0 };
+        size_t                                      used            { 0 };
+        std::vector<std::unique_ptr<std::byte[]>>   overflow;
+        size_t                                      overflowBytes   { 0 };
+        uint64_t                                    growths         { 0 };
+
+        void* AllocateBytes(const size_t bytes, const size_t alignment);
+
+    public:
+        explicit LinearArena(const size_t initialCapacity = 64 * 1024);
+        ~LinearArena() = default;
+
+        // No copies!
+        LinearArena(const LinearArena&) = delete;
+        LinearArena& operator=(const LinearArena&) = delete;
+
+        LinearArena(LinearArena&&) = default;
+        LinearArena& operator=(LinearArena&&) = default;
+
+        // count value initialized Ts, valid until the next Reset
+        template <typename T>
+        T* Allocate(const size_t count = 1);
+
+        void Reset();
+
+        const size_t    Capacity()  const { return capacity; }
+        const size_t    Used()      const { return used + overflowBytes; }
+        // Times the arena had to go back to the heap, flat in steady state
+        const uint64_t  Growths()   const { return growths; }
+    };
+
+
+    // Definitions
+
+    template <typename T>
+    T* LinearArena::Allocate(const size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>, "Arena memory is never destroyed");
+
+        auto* items{ static_cast<T*>(AllocateBytes(sizeof(T) * count, alignof(T))) };
+        for (size_t i = 0; i < count; ++i) {
+            new (items + i) T{};
+        }
+        return items;
+    }
+}
+
+#endif // !ENGINE_MEMORY_LINEAR_ARENA_HPP
@@ -0,0 +1,183 @@
+#include "Residency.hpp"
+#include "Device/Physical.hpp"
+#include "Logger.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace Engine::Render::Memory {
+
+    namespace ERD = Engine::Render::Device;
+
+    namespace {
+
+        // Trim above HighWater of the budget, give memory back below LowWater
+        constexpr double HighWater{ 0.90 };
+        constexpr double LowWater { 0.75 };
+
+        // Without the extension, assume this much of a heap is ours to use
+        constexpr double EstimatedBudget{ 0.80 };
+
+        // Trims take a few frames to show up in the driver's numbers
+        constexpr uint64_t TrimCooldown{ 8 };
+    }
+
+    ResidencyManager::ResidencyManager(const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo, const std::string& dumpPath, const uint64_t dumpInterval) :
+        tracker(TrackerOf(renderDevice)), budgetExtension(deviceInfo.ExtensionEnabled(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME)), dumpPath(dumpPath), dumpInterval(dumpInterval) {
+
+        Query(deviceInfo);
+
+        LOGGER << "Residency: " << (budgetExtension ? "VK_EXT_memory_budget" : "estimated budgets") << '\n';
+        for (size_t i = 0; i < stats.Heaps.size(); ++i) {
+            LOGGER << "\t Heap " << i << ": " << (stats.Heaps[i].Size >> 20) << " MiB"
+                   << (stats.Heaps[i].DeviceLocal ? ", device local" : "") << '\n';
+        }
+    }
+
+    void ResidencyManager::Register(Evictable&& evictable) {
+        evictables.emplace_back(std::move(evictable));
+
+        std::stable_sort(evictables.begin(), evictables.end(), [](const Evictable& a, const Evictable& b) {
+            return a.Priority < b.Priority;
+        });
+    }
+
+    void ResidencyManager::Query(const ERD::PhysicalDevice& deviceInfo) {
+        vk::PhysicalDeviceMemoryProperties properties{};
+        vk::PhysicalDeviceMemoryBudgetPropertiesEXT budget{};
+
+        if (budgetExtension) {
+            const auto chain{ deviceInfo.Get().getMemoryProperties2<vk::PhysicalDeviceMemoryProperties2, vk::PhysicalDeviceMemoryBudgetPropertiesEXT>() };
+            properties  = chain.get<vk::PhysicalDeviceMemoryProperties2>().memoryProperties;
+            budget      = chain.get<vk::PhysicalDeviceMemoryBudgetPropertiesEXT>();
+        }
+        else {
+            properties = deviceInfo.Get().getMemoryProperties();
+        }
+
+        stats.DriverBudget = budgetExtension;
+        stats.Heaps.resize(properties.memoryHeapCount);
+
+        for (uint32_t i = 0; i < properties.memoryHeapCount; ++i) {
+            auto& heap{ stats.Heaps[i] };
+
+            heap.Size           = properties.memoryHeaps[i].size;
+            heap.DeviceLocal    = static_cast<bool>(properties.memoryHeaps[i].flags & vk::MemoryHeapFlagBits::eDeviceLocal);
+            heap.EngineBytes    = tracker->Bytes(i);
+
+            for (size_t c = 0; c < CategoryCount; ++c) {
+                heap.Categories[c] = tracker->Bytes(i, static_cast<MemoryCategory>(c));
+            }
+
+            if (budgetExtension) {
+                heap.Budget = budget.heapBudget[i];
+                heap.Usage  = budget.heapUsage[i];
+            }
+            else {
+                heap.Budget = static_cast<vk::DeviceSize>(heap.Size * EstimatedBudget);
+                heap.Usage  = heap.EngineBytes;
+            }
+        }
+    }
+
+    void ResidencyManager::Update(const ERD::PhysicalDevice& deviceInfo, const uint64_t frameNumber) {
+        stats.Frame = frameNumber;
+        Query(deviceInfo);
+
+        // Worst device local heap decides
+        vk::DeviceSize over{ 0 };
+        bool relaxed{ true };
+
+        for (const auto& heap : stats.Heaps) {
+            if (!heap.DeviceLocal) continue;
+
+            const auto high{ static_cast<vk::DeviceSize>(heap.Budget * HighWater) };
+            const auto low { static_cast<vk::DeviceSize>(heap.Budget * LowWater) };
+
+            if (heap.Usage > high)  over = std::max(over, heap.Usage - high);
+            if (heap.Usage > low)   relaxed = false;
+        }
+
+        if (over > 0 && frameNumber >= lastTrimFrame + TrimCooldown) {
+            Trim(over);
+            lastTrimFrame = frameNumber;
+        }
+        else if (relaxed) {
+            for (auto& evictable : evictables) {
+                if (evictable.Relax) evictable.Relax();
+            }
+        }
+
+        if (dumpInterval > 0 && !dumpPath.empty() && frameNumber % dumpInterval == 0) {
+            Dump(dumpPath);
+        }
+    }
+
+    void ResidencyManager::Trim(const vk::DeviceSize bytes) {
+        vk::DeviceSize freed{ 0 };
+
+        for (auto& evictable : evictables) {
+            if (freed >= bytes) break;
+            if (evictable.Trim) freed += evictable.Trim(bytes - freed);
+        }
+
+        ++stats.Trims;
+        stats.TrimmedBytes += freed;
+
+        LOGGER << "Residency: over budget by " << (bytes >> 20) << " MiB, trimmed " << (freed >> 20) << " MiB\n";
+    }
+
+    std::string ResidencyManager::ToJson() const {
+        std::ostringstream json{};
+
+        json << "{\n"
+             << "  \"frame\": "         << stats.Frame << ",\n"
+             << "  \"driverBudget\": "  << (stats.DriverBudget ? "true" : "false") << ",\n"
+             << "  \"trims\": "         << stats.Trims << ",\n"
+             << "  \"trimmedBytes\": "  << stats.TrimmedBytes << ",\n"
+             << "  \"heaps\": [";
+
+        for (size_t i = 0; i < stats.Heaps.size(); ++i) {
+            const auto& heap{ stats.Heaps[i] };
+
+            json << (i == 0 ? "\n" : ",\n")
+                 << "    {\n"
+                 << "      \"index\": "         << i << ",\n"
+                 << "      \"deviceLocal\": "   << (heap.DeviceLocal ? "true" : "false") << ",\n"
+                 << "      \"size\": "          << heap.Size << ",\n"
+                 << "      \"budget\": "        << heap.Budget << ",\n"
+                 << "      \"usage\": "         << heap.Usage << ",\n"
+                 << "      \"engine\": "        << heap.EngineBytes << ",\n"
+                 << "      \"categories\": {";
+
+            for (size_t c = 0; c < CategoryCount; ++c) {
+                json << (c == 0 ? " " : ", ") << '"' << CategoryName(static_cast<MemoryCategory>(c)) << "\": " << heap.Categories[c];
+            }
+
+            json << " }\n    }";
+        }
+
+        json << "\n  ]\n}\n";
+        return json.str();
+    }
+
+    // Written to a temporary first so a reader never sees half a file
+    void ResidencyManager::Dump(const std::string& path) const {
+        const auto temporary{ path + ".tmp" };
+
+        {
+            std::ofstream out(temporary, std::ios::trunc);
+            if (!out.is_open()) {
+                LOGGER << "Residency: could not write " << temporary << '\n';
+                return;
+            }
+            out << ToJson();
+        }
+
+        std::remove(path.c_str());
+        std::rename(temporary.c_str(), path.c_str());
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef ENGINE_MEMORY_RESIDENCY_HPP
+#define ENGINE_MEMORY_RESIDENCY_HPP
+
+#include "VKinclude/VKinclude.hpp"
+#include "Tracking.hpp"
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Engine::Render::Device {
+    class PhysicalDevice;
+}
+
+namespace Engine::Render::Memory {
+
+    struct HeapStats {
+        vk::DeviceSize  Size        { 0 };
+        vk::DeviceSize  Budget      { 0 };      // What the driver says we can use without paging
+        vk::DeviceSize  Usage       { 0 };      // Whole process, as the driver sees it
+        vk::DeviceSize  EngineBytes { 0 };      // What we allocated ourselves
+        bool            DeviceLocal { false };
+        std::array<vk::DeviceSize, CategoryCount> Categories{};
+    };
+
+    struct ResidencyStats {
+        uint64_t                Frame           { 0 };
+        bool                    DriverBudget    { false };  // VK_EXT_memory_budget numbers, estimates otherwise
+        std::vector<HeapStats>  Heaps;
+        uint64_t                Trims           { 0 };
+        vk::DeviceSize          TrimmedBytes    { 0 };
+    };
+
+    // Something that can give memory back when a heap runs hot, lowest
+    // priority is asked first. Trim returns how many bytes it let go of,
+    // Relax is called once there is room again.
+    struct Evictable {
+        std::string                                     Name;
+        MemoryCategory                                  Category    { MemoryCategory::Other };
+        int                                             Priority    { 0 };
+        std::function<vk::DeviceSize(vk::DeviceSize)>   Trim;
+        std::function<void()>                           Relax;
+    };
+
+    // Watches device local heaps against the driver's budget once a frame
+    // and trims registered consumers before the driver starts paging. Without
+    // VK_EXT_memory_budget the budget is a fraction of the heap size and the
+    // usage is whatever the engine tracked itself.
+    class ResidencyManager {
+
+    private:
+        std::shared_ptr<MemoryTracker> tracker;         // The device's, see Tracking.hpp
+        bool                    budgetExtension{ false };
+        ResidencyStats          stats;
+        std::vector<Evictable>  evictables;
+        std::string             dumpPath;
+        uint64_t                dumpInterval{ 0 };
+        uint64_t                lastTrimFrame{ 0 };
+
+        void Query(const Engine::Render::Device::PhysicalDevice&);
+        void Trim(const vk::DeviceSize bytes);
+
+    public:
+        // Engine bytes are those allocated on renderDevice. An empty dumpPath
+        // or zero interval turns the periodic dump off.
+        ResidencyManager(const vk::Device& renderDevice, const Engine::Render::Device::PhysicalDevice&, const std::string& dumpPath = {}, const uint64_t dumpInterval = 0);
+
+        // No copies!
+        ResidencyManager(const ResidencyManager&) = delete;
+        ResidencyManager& operator=(const ResidencyManager&) = delete;
+
+        ResidencyManager(ResidencyManager&&) = default;
+        ResidencyManager& operator=(ResidencyManager&&) = default;
+
+        void Register(Evictable&&);
+
+        void Update(const Engine::Render::Device::PhysicalDevice&, const uint64_t frameNumber);
+
+        const ResidencyStats&   Stats()     const { return stats; }
+        const bool              HasBudget() const { return budgetExtension; }
+        std::string             ToJson()    const;
+        void                    Dump(const std::string& path) const;
+    };
+}
+
+#endif // !ENGINE_MEMORY_RESIDENCY_HPP
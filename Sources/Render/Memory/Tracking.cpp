@@ -0,0 +1,101 @@
+#include "Tracking.hpp"
+
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace Engine::Render::Memory {
+
+    namespace {
+
+        std::mutex trackersLock;
+        std::unordered_map<VkDevice, std::weak_ptr<MemoryTracker>> trackers;
+    }
+
+    const char* CategoryName(const MemoryCategory category) {
+        switch (category) {
+            case MemoryCategory::Geometry:  return "geometry";
+            case MemoryCategory::Textures:  return "textures";
+            case MemoryCategory::Staging:   return "staging";
+            case MemoryCategory::RenderTargets: return "render_targets";
+            default:                        return "other";
+        }
+    }
+
+    MemoryCategory CategoryOf(const vk::BufferUsageFlags& usage) {
+        if (usage & (vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndexBuffer)) {
+            return MemoryCategory::Geometry;
+        }
+        if (usage == vk::BufferUsageFlags(vk::BufferUsageFlagBits::eTransferSrc)) {
+            return MemoryCategory::Staging;
+        }
+        return MemoryCategory::Other;
+    }
+
+    uint32_t HeapOfType(const vk::PhysicalDeviceMemoryProperties& deviceMemProps, const uint32_t memoryType) {
+        return deviceMemProps.memoryTypes[memoryType].heapIndex;
+    }
+
+    void MemoryTracker::Add(const uint32_t heap, const MemoryCategory category, const vk::DeviceSize count) {
+        bytes[heap][static_cast<size_t>(category)].fetch_add(count, std::memory_order_relaxed);
+    }
+
+    void MemoryTracker::Remove(const uint32_t heap, const MemoryCategory category, const vk::DeviceSize count) {
+        bytes[heap][static_cast<size_t>(category)].fetch_sub(count, std::memory_order_relaxed);
+    }
+
+    vk::DeviceSize MemoryTracker::Bytes(const uint32_t heap, const MemoryCategory category) const {
+        return bytes[heap][static_cast<size_t>(category)].load(std::memory_order_relaxed);
+    }
+
+    vk::DeviceSize MemoryTracker::Bytes(const uint32_t heap) const {
+        vk::DeviceSize total{ 0 };
+        for (size_t c = 0; c < CategoryCount; ++c) {
+            total += Bytes(heap, static_cast<MemoryCategory>(c));
+        }
+        return total;
+    }
+
+    // Only taken per allocation, never per frame
+    std::shared_ptr<MemoryTracker> TrackerOf(const vk::Device& device) {
+        std::lock_guard<std::mutex> guard(trackersLock);
+
+        auto& entry{ trackers[static_cast<VkDevice>(device)] };
+        auto tracker{ entry.lock() };
+        if (!tracker) {
+            tracker = std::make_shared<MemoryTracker>();
+            entry   = tracker;
+        }
+        return tracker;
+    }
+
+    TrackedAllocation::TrackedAllocation(const vk::Device& device, const uint32_t heap, const MemoryCategory category, const vk::DeviceSize bytes) :
+        tracker(TrackerOf(device)), heap(heap), category(category), bytes(bytes) {
+        tracker->Add(heap, category, bytes);
+    }
+
+    TrackedAllocation::~TrackedAllocation() {
+        Release();
+    }
+
+    TrackedAllocation::TrackedAllocation(TrackedAllocation&& other) noexcept :
+        tracker(std::move(other.tracker)), heap(other.heap), category(other.category), bytes(std::exchange(other.bytes, 0)) {}
+
+    TrackedAllocation& TrackedAllocation::operator=(TrackedAllocation&& other) noexcept {
+        if (this != &other) {
+            Release();
+            tracker     = std::move(other.tracker);
+            heap        = other.heap;
+            category    = other.category;
+            bytes       = std::exchange(other.bytes, 0);
+        }
+        return *this;
+    }
+
+    void TrackedAllocation::Release() {
+        if (bytes > 0) {
+            tracker->Remove(heap, category, bytes);
+            bytes = 0;
+        }
+    }
+}
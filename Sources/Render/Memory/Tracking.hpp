@@ -0,0 +1,86 @@
+#ifndef ENGINE_MEMORY_TRACKING_HPP
+#define ENGINE_MEMORY_TRACKING_HPP
+
+#include "VKinclude/VKinclude.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace Engine::Render::Memory {
+
+    enum class MemoryCategory : uint8_t {
+        Geometry,
+        Textures,
+        Staging,
+        RenderTargets,
+        Other,
+        Count
+    };
+
+    constexpr size_t CategoryCount{ static_cast<size_t>(MemoryCategory::Count) };
+
+    const char* CategoryName(const MemoryCategory);
+
+    // Best guess for buffers that don't say what they are
+    MemoryCategory CategoryOf(const vk::BufferUsageFlags&);
+
+    uint32_t HeapOfType(const vk::PhysicalDeviceMemoryProperties&, const uint32_t memoryType);
+
+    // Bytes the engine has allocated on one device, per heap and category.
+    // Updated with relaxed atomics from any thread, read once a frame by
+    // that device's ResidencyManager.
+    class MemoryTracker {
+
+    private:
+        std::array<std::array<std::atomic<uint64_t>, CategoryCount>, VK_MAX_MEMORY_HEAPS> bytes{};
+
+    public:
+        MemoryTracker() = default;
+
+        // No copies!
+        MemoryTracker(const MemoryTracker&) = delete;
+        MemoryTracker& operator=(const MemoryTracker&) = delete;
+
+        void Add(const uint32_t heap, const MemoryCategory, const vk::DeviceSize);
+        void Remove(const uint32_t heap, const MemoryCategory, const vk::DeviceSize);
+
+        vk::DeviceSize Bytes(const uint32_t heap, const MemoryCategory) const;
+        vk::DeviceSize Bytes(const uint32_t heap) const;
+    };
+
+    // The device's tracker, made the first time it's asked for. It lives as
+    // long as an allocation or ResidencyManager holds it, a device made
+    // later with the same handle starts from zero.
+    std::shared_ptr<MemoryTracker> TrackerOf(const vk::Device&);
+
+    // Counts an allocation against its device for as long as it lives.
+    // Keep one next to each vk::DeviceMemory the engine owns.
+    class TrackedAllocation {
+
+    private:
+        std::shared_ptr<MemoryTracker> tracker;
+        uint32_t        heap    { 0 };
+        MemoryCategory  category{ MemoryCategory::Other };
+        vk::DeviceSize  bytes   { 0 };
+
+        void Release();
+
+    public:
+        TrackedAllocation() = default;
+        TrackedAllocation(const vk::Device&, const uint32_t heap, const MemoryCategory, const vk::DeviceSize bytes);
+        ~TrackedAllocation();
+
+        // No copies!
+        TrackedAllocation(const TrackedAllocation&) = delete;
+        TrackedAllocation& operator=(const TrackedAllocation&) = delete;
+
+        TrackedAllocation(TrackedAllocation&&) noexcept;
+        TrackedAllocation& operator=(TrackedAllocation&&) noexcept;
+
+        const vk::DeviceSize Bytes() const { return bytes; }
+    };
+}
+
+#endif // !ENGINE_MEMORY_TRACKING_HPP
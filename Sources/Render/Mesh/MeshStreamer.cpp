@@ -0,0 +1,173 @@
+#include "MeshStreamer.hpp"
+#include "Device/Physical.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace Engine::Render::Mesh {
+
+    namespace EAM   = Engine::Assets::Mesh;
+    namespace ERM   = Engine::Render::Memory;
+    namespace EP    = Engine::Primitives;
+
+    static_assert(sizeof(EP::Vertex) == sizeof(EAM::FileVertex)
+        && offsetof(EP::Vertex, pos) == offsetof(EAM::FileVertex, Position)
+        && offsetof(EP::Vertex, col) == offsetof(EAM::FileVertex, Color),
+        "Primitives::Vertex must match the mesh file's vertices");
+
+    namespace {
+
+        // Copy whole elements only, at least one so a tiny budget still makes progress
+        template <typename T>
+        uint64_t CopyChunk(const vk::Device& renderDevice, const Engine::Assets::MappedFile& file, const EAM::Blob& blob, ERM::DeviceMemory<T>& target, uint64_t& done, const uint64_t budget) {
+            const auto remaining{ blob.Size - done };
+            const auto bytes    { std::min(remaining, std::max<uint64_t>(budget / sizeof(T), 1) * sizeof(T)) };
+
+            target.Upload(renderDevice,
+                reinterpret_cast<const T*>(blob.Data + done),
+                static_cast<uint32_t>(done / sizeof(T)),
+                static_cast<uint32_t>(bytes / sizeof(T))
+            );
+
+            // Done with these pages, and let the OS start reading the next chunk
+            file.Release(blob.Offset + done, bytes);
+            done += bytes;
+            file.Prefetch(blob.Offset + done, std::min(blob.Size - done, bytes));
+
+            return bytes;
+        }
+    }
+
+    // Meshlets are built for LOD 0 only
+    const bool MeshStreamer::HasMeshlets(const StreamRequest& request) const {
+        return request.Target.Lod == 0 && file.Mesh(request.Target.Mesh).Meshlets.MeshletCount > 0;
+    }
+
+    const bool MeshStreamer::MeshletsDone(const StreamRequest& request) const {
+        if (!HasMeshlets(request)) return true;
+
+        const auto mesh{ request.Target.Mesh };
+        return request.MeshletBytesDone[0] == file.Meshlets(mesh).Size
+            && request.MeshletBytesDone[1] == file.MeshletVertices(mesh).Size
+            && request.MeshletBytesDone[2] == file.MeshletTriangles(mesh).Size;
+    }
+
+    MeshStreamer::MeshStreamer(const std::string& path) :
+        file(path) {
+
+        const auto& header{ file.Header() };
+
+        if (header.Vertices != EAM::VertexFormat::Pos2Col3 || header.VertexStride != sizeof(EAM::FileVertex)) {
+            throw std::runtime_error("Mesh file vertex format doesn't match the engine");
+        }
+    }
+
+    void MeshStreamer::Request(const uint32_t mesh, const uint32_t lod) {
+        const auto& entry{ file.Mesh(mesh) };
+
+        StreamRequest request{};
+        request.Target.Mesh     = mesh;
+        request.Target.Lod      = std::min(lod, entry.LodCount - 1);
+        request.Target.Volume   = entry.Volume;
+
+        pending.emplace_back(std::move(request));
+    }
+
+    void MeshStreamer::RequestAll(const uint32_t lod) {
+        for (uint32_t i = 0; i < file.MeshCount(); ++i) {
+            Request(i, lod);
+        }
+    }
+
+    void MeshStreamer::Allocate(const vk::Device& renderDevice, const Engine::Render::Device::PhysicalDevice& deviceInfo, StreamRequest& request) {
+        const auto vertexBlob{ file.Vertices(request.Target.Mesh) };
+        const auto indexBlob { file.Indices(request.Target.Mesh, request.Target.Lod) };
+
+        const auto hostMemory{ vk::MemoryPropertyFlagBits::eHostCoherent | vk::MemoryPropertyFlagBits::eHostVisible };
+
+        request.Target.Vertices = ERM::DeviceMemory<EP::Vertex>(renderDevice, deviceInfo, vk::BufferCreateInfo()
+            .setSharingMode(vk::SharingMode::eExclusive)
+            .setSize(vertexBlob.Size)
+            .setUsage(vk::BufferUsageFlagBits::eTransferSrc),
+            hostMemory
+        );
+
+        request.Target.Indices = ERM::DeviceMemory<uint32_t>(renderDevice, deviceInfo, vk::BufferCreateInfo()
+            .setSharingMode(vk::SharingMode::eExclusive)
+            .setSize(indexBlob.Size)
+            .setUsage(vk::BufferUsageFlagBits::eTransferSrc),
+            hostMemory
+        );
+
+        if (HasMeshlets(request)) {
+            const auto storage{ [&](const EAM::Blob& blob) {
+                return vk::BufferCreateInfo()
+                    .setSharingMode(vk::SharingMode::eExclusive)
+                    .setSize(blob.Size)
+                    .setUsage(vk::BufferUsageFlagBits::eStorageBuffer);
+            } };
+
+            request.Target.Meshlets         = ERM::DeviceMemory<EAM::Meshlet>(renderDevice, deviceInfo, storage(file.Meshlets(request.Target.Mesh)), hostMemory);
+            request.Target.MeshletVertices  = ERM::DeviceMemory<uint32_t>(renderDevice, deviceInfo, storage(file.MeshletVertices(request.Target.Mesh)), hostMemory);
+            request.Target.MeshletTriangles = ERM::DeviceMemory<uint32_t>(renderDevice, deviceInfo, storage(file.MeshletTriangles(request.Target.Mesh)), hostMemory);
+            request.Target.MeshletCount     = file.Mesh(request.Target.Mesh).Meshlets.MeshletCount;
+        }
+
+        file.File().Prefetch(vertexBlob.Offset, vertexBlob.Size);
+        request.Allocated = true;
+    }
+
+    std::vector<GpuMesh> MeshStreamer::Pump(const vk::Device& renderDevice, const Engine::Render::Device::PhysicalDevice& deviceInfo, const uint64_t byteBudget) {
+
+        std::vector<GpuMesh> finished{};
+        uint64_t budget{ byteBudget };
+
+        while (!pending.empty() && budget > 0) {
+            auto& request{ pending.front() };
+
+            if (!request.Allocated) {
+                Allocate(renderDevice, deviceInfo, request);
+            }
+
+            const auto vertexBlob{ file.Vertices(request.Target.Mesh) };
+            const auto indexBlob { file.Indices(request.Target.Mesh, request.Target.Lod) };
+
+            uint64_t copied{ 0 };
+
+            if (request.VertexBytesDone < vertexBlob.Size) {
+                copied = CopyChunk(renderDevice, file.File(), vertexBlob, request.Target.Vertices, request.VertexBytesDone, budget);
+            }
+            else if (request.IndexBytesDone < indexBlob.Size) {
+                copied = CopyChunk(renderDevice, file.File(), indexBlob, request.Target.Indices, request.IndexBytesDone, budget);
+            }
+            else if (HasMeshlets(request)) {
+                const auto mesh{ request.Target.Mesh };
+                auto* done{ request.MeshletBytesDone };
+
+                if (done[0] < file.Meshlets(mesh).Size) {
+                    copied = CopyChunk(renderDevice, file.File(), file.Meshlets(mesh), request.Target.Meshlets, done[0], budget);
+                }
+                else if (done[1] < file.MeshletVertices(mesh).Size) {
+                    copied = CopyChunk(renderDevice, file.File(), file.MeshletVertices(mesh), request.Target.MeshletVertices, done[1], budget);
+                }
+                else if (done[2] < file.MeshletTriangles(mesh).Size) {
+                    copied = CopyChunk(renderDevice, file.File(), file.MeshletTriangles(mesh), request.Target.MeshletTriangles, done[2], budget);
+                }
+            }
+
+            budget -= std::min(budget, copied);
+
+            if (request.VertexBytesDone == vertexBlob.Size && request.IndexBytesDone == indexBlob.Size && MeshletsDone(request)) {
+                request.Target.Vertices.Unmap(renderDevice);
+                request.Target.Indices.Unmap(renderDevice);
+                request.Target.Meshlets.Unmap(renderDevice);
+                request.Target.MeshletVertices.Unmap(renderDevice);
+                request.Target.MeshletTriangles.Unmap(renderDevice);
+                finished.emplace_back(std::move(request.Target));
+                pending.pop_front();
+            }
+        }
+
+        return finished;
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef RENDER_MESH_STREAMER_HPP
+#define RENDER_MESH_STREAMER_HPP
+
+#include "VKinclude/VKinclude.hpp"
+#include "Memory/Buffers.hpp"
+#include "Primitives/Vertex.hpp"
+#include "Assets/Mesh/MeshFile.hpp"
+
+#include <deque>
+#include <string>
+
+namespace Engine::Render::Device {
+    class PhysicalDevice;
+}
+
+namespace Engine::Render::Mesh {
+
+    // Meshlets come with LOD 0 only, when the file has them. Vertices and
+    // indices are only copied out of, into the renderer's geometry pool.
+    struct GpuMesh {
+        Engine::Render::Memory::DeviceMemory<Engine::Primitives::Vertex>    Vertices;
+        Engine::Render::Memory::DeviceMemory<uint32_t>                      Indices;
+        Engine::Render::Memory::DeviceMemory<Engine::Assets::Mesh::Meshlet> Meshlets;
+        Engine::Render::Memory::DeviceMemory<uint32_t>                      MeshletVertices;
+        Engine::Render::Memory::DeviceMemory<uint32_t>                      MeshletTriangles;
+        uint32_t                                                            MeshletCount{ 0 };
+        Engine::Assets::Mesh::Bounds                                        Volume{};
+        uint32_t                                                            Mesh{ 0 };
+        uint32_t                                                            Lod { 0 };
+    };
+
+    // Streams meshes out of a mapped .vmesh file into GPU buffers, a bounded
+    // number of bytes per Pump so a big world never stalls a frame. Blobs
+    // are copied from the mapping straight into the mapped buffers.
+    class MeshStreamer {
+
+    private:
+        struct StreamRequest {
+            GpuMesh     Target;
+            uint64_t    VertexBytesDone { 0 };
+            uint64_t    IndexBytesDone  { 0 };
+            uint64_t    MeshletBytesDone[3]{};     // Meshlets, their vertices, their triangles
+            bool        Allocated       { false };
+        };
+
+        Engine::Assets::Mesh::MeshFile  file;
+        std::deque<StreamRequest>       pending;
+
+        void Allocate(const vk::Device&, const Engine::Render::Device::PhysicalDevice&, StreamRequest&);
+        const bool HasMeshlets(const StreamRequest&) const;
+        const bool MeshletsDone(const StreamRequest&) const;
+
+    public:
+        explicit MeshStreamer(const std::string& path);
+
+        // No copies!
+        MeshStreamer(const MeshStreamer&) = delete;
+        MeshStreamer& operator=(const MeshStreamer&) = delete;
+
+        MeshStreamer(MeshStreamer&&) = default;
+        MeshStreamer& operator=(MeshStreamer&&) = default;
+
+        void Request(const uint32_t mesh, const uint32_t lod);
+        void RequestAll(const uint32_t lod);
+
+        // Copies at most byteBudget bytes and hands back whatever finished
+        std::vector<GpuMesh> Pump(const vk::Device&, const Engine::Render::Device::PhysicalDevice&, const uint64_t byteBudget);
+
+        const bool Idle() const { return pending.empty(); }
+        const Engine::Assets::Mesh::MeshFile& File() const { return file; }
+    };
+}
+
+#endif // !RENDER_MESH_STREAMER_HPP
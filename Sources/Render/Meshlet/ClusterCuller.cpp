@@ -0,0 +1,272 @@
+#include "ClusterCuller.hpp"
+#include "Device/Physical.hpp"
+#include "Shader/Shader.hpp"
+#include "Command/SecondaryCache.hpp"
+
+#include <glm/gtc/matrix_access.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace Engine::Render::Meshlet {
+
+    namespace ERD = Engine::Render::Device;
+    namespace ERM = Engine::Render::Memory;
+    namespace ERCD = Engine::Render::Command;
+    namespace ERSHD = Engine::Render::Shader;
+
+    namespace {
+        // Match local_size in GLSL/meshlet.task
+        constexpr uint32_t TaskGroupSize{ 32 };
+
+        // Minimum maxComputeWorkGroupCount and maxTaskWorkGroupCount, wider
+        // dispatches go 2D
+        constexpr uint32_t MaxGroupsPerRow{ 65535 };
+
+        // Meshlets, their vertices, their triangles, mesh vertices, then
+        // compacted indices and the draw when compacting
+        constexpr uint32_t MeshletBindings  { 4 };
+        constexpr uint32_t CompactBindings  { 6 };
+
+        const auto meshStages{ vk::ShaderStageFlagBits::eTaskEXT | vk::ShaderStageFlagBits::eMeshEXT };
+
+        // Rows of the clip transform give the planes in object space, facing
+        // in. Depth is 0 near and 1 far.
+        void FrustumPlanes(const glm::mat4& transform, glm::vec4 (&planes)[6]) {
+            const auto x{ glm::row(transform, 0) };
+            const auto y{ glm::row(transform, 1) };
+            const auto z{ glm::row(transform, 2) };
+            const auto w{ glm::row(transform, 3) };
+
+            planes[0] = w + x;
+            planes[1] = w - x;
+            planes[2] = w + y;
+            planes[3] = w - y;
+            planes[4] = z;
+            planes[5] = w - z;
+
+            for (auto& plane : planes) {
+                const auto length{ glm::length(glm::vec3(plane)) };
+                plane /= length > 0.0f ? length : 1.0f;
+            }
+        }
+
+        // The camera is where every clip space ray starts, the point
+        // transform takes to (0, 0, 1, 0). Orthographic projections put it
+        // at infinity, w = 0 turns the cone test off for those.
+        glm::vec4 CameraPosition(const glm::mat4& transform) {
+            const auto eye{ glm::inverse(transform) * glm::vec4(0.0f, 0.0f, 1.0f, 0.0f) };
+            if (std::abs(eye.w) < 1e-6f) return glm::vec4(0.0f);
+            return glm::vec4(glm::vec3(eye) / eye.w, 1.0f);
+        }
+
+        template <typename T>
+        ERM::DeviceMemory<T> CreateBuffer(const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo, const vk::DeviceSize size, const vk::BufferUsageFlags& usage) {
+            return ERM::DeviceMemory<T>(renderDevice, deviceInfo, vk::BufferCreateInfo()
+                .setSharingMode(vk::SharingMode::eExclusive)
+                .setSize(size)
+                .setUsage(usage),
+                vk::MemoryPropertyFlagBits::eDeviceLocal
+            );
+        }
+
+        // Fragment stage and set layouts of the regular pipeline, the meshlet set last
+        Engine::Render::Pipeline CreateMeshPipeline(const vk::Device& renderDevice, const AttachmentLayout& attachments, const std::vector<vk::DescriptorSetLayout>& sceneLayouts, const vk::DescriptorSetLayout& meshletLayout, const uint32_t constantsSize, const ERSHD::FeatureKey features) {
+            auto layouts{ sceneLayouts };
+            layouts.push_back(meshletLayout);
+            return Engine::Render::Pipeline(renderDevice, attachments, layouts, MeshShading{ "meshlet_task.spv", "meshlet_mesh.spv", constantsSize, features });
+        }
+
+        // Dispatches beyond one row wrap into y, the shaders rebuild the flat index
+        vk::Extent2D Groups(const uint32_t count) {
+            const auto row{ std::max(1u, std::min(count, MaxGroupsPerRow)) };
+            return { row, (count + row - 1) / row };
+        }
+    }
+
+    ClusterCuller::ClusterCuller(const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo, const AttachmentLayout& attachments, const std::vector<vk::DescriptorSetLayout>& sceneLayouts) :
+        meshShading(deviceInfo.SupportsMeshShaders()), sceneSetCount(static_cast<uint32_t>(sceneLayouts.size()))
+    {
+        const auto stages{ meshShading ? vk::ShaderStageFlags(meshStages) : vk::ShaderStageFlags(vk::ShaderStageFlagBits::eCompute) };
+        const auto bindingCount{ meshShading ? MeshletBindings : CompactBindings };
+
+        std::vector<vk::DescriptorSetLayoutBinding> bindings{};
+        for (uint32_t b = 0; b < bindingCount; ++b) {
+            bindings.emplace_back(b, vk::DescriptorType::eStorageBuffer, 1, stages);
+        }
+
+        setLayout = renderDevice.createDescriptorSetLayoutUnique(vk::DescriptorSetLayoutCreateInfo()
+            .setBindingCount(static_cast<uint32_t>(bindings.size()))
+            .setPBindings(bindings.data())
+        );
+
+        if (meshShading) {
+            meshPipeline = CreateMeshPipeline(renderDevice, attachments, sceneLayouts, setLayout.get(), sizeof(CullConstants), ERSHD::Features::None);
+            return;
+        }
+
+        const auto range{ vk::PushConstantRange(vk::ShaderStageFlagBits::eCompute, 0, sizeof(CullConstants)) };
+        compactLayout = renderDevice.createPipelineLayoutUnique(vk::PipelineLayoutCreateInfo()
+            .setSetLayoutCount(1)
+            .setPSetLayouts(&setLayout.get())
+            .setPushConstantRangeCount(1)
+            .setPPushConstantRanges(&range)
+        );
+
+        const auto code{ Engine::Render::Shader::CreateShaderModule(renderDevice, "meshlet_cull.spv") };
+        compactPipeline = renderDevice.createComputePipelineUnique(nullptr, vk::ComputePipelineCreateInfo()
+            .setStage(vk::PipelineShaderStageCreateInfo()
+                .setStage(vk::ShaderStageFlagBits::eCompute)
+                .setModule(code.get())
+                .setPName("main"))
+            .setLayout(compactLayout.get())
+        );
+    }
+
+    void ClusterCuller::ReloadPipeline(const vk::Device& renderDevice, const AttachmentLayout& attachments, const std::vector<vk::DescriptorSetLayout>& sceneLayouts, ERM::DeletionQueue& deletionQueue, const uint64_t frameNumber, const ERSHD::FeatureKey features) {
+        if (!meshShading) return;
+
+        deletionQueue.Retire(std::move(meshPipeline), frameNumber);
+        meshPipeline = CreateMeshPipeline(renderDevice, attachments, sceneLayouts, setLayout.get(), sizeof(CullConstants), features);
+    }
+
+    void ClusterCuller::Clear(ERM::DeletionQueue& deletionQueue, const uint64_t frameNumber) {
+        deletionQueue.Retire(std::move(geometry), frameNumber);
+        geometry = Geometry{};
+    }
+
+    // The compacted list has room for every triangle, so it never overflows
+    void ClusterCuller::SetGeometry(const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo, Engine::Render::Mesh::GpuMesh& mesh, const vk::Buffer& vertices, const uint32_t vertexBase, ERM::DeletionQueue& deletionQueue, const uint64_t frameNumber) {
+        Clear(deletionQueue, frameNumber);
+
+        if (mesh.MeshletCount == 0) return;
+
+        geometry.Meshlets       = std::move(mesh.Meshlets);
+        geometry.Vertices       = std::move(mesh.MeshletVertices);
+        geometry.Triangles      = std::move(mesh.MeshletTriangles);
+        geometry.MeshVertices   = vertices;
+        geometry.VertexBase     = vertexBase;
+
+        if (!meshShading) {
+            const auto indexCount{ vk::DeviceSize{ geometry.Triangles.Size() } * 3 };
+
+            geometry.Indices = CreateBuffer<uint32_t>(renderDevice, deviceInfo, sizeof(uint32_t) * std::max<vk::DeviceSize>(indexCount, 1),
+                vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndexBuffer);
+            geometry.Draw = CreateBuffer<vk::DrawIndexedIndirectCommand>(renderDevice, deviceInfo, sizeof(vk::DrawIndexedIndirectCommand),
+                vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransferDst);
+        }
+
+        CreateSet(renderDevice);
+
+        geometry.Count    = mesh.MeshletCount;
+        mesh.MeshletCount = 0;
+    }
+
+    // Sets of earlier frames may still be bound, the new one gets its own pool
+    void ClusterCuller::SetVertices(const vk::Device& renderDevice, const vk::Buffer& vertices, const uint32_t vertexBase, ERM::DeletionQueue& deletionQueue, const uint64_t frameNumber) {
+        if (!Active()) return;
+
+        deletionQueue.Retire(std::move(geometry.Pool), frameNumber);
+        geometry.MeshVertices   = vertices;
+        geometry.VertexBase     = vertexBase;
+        CreateSet(renderDevice);
+    }
+
+    void ClusterCuller::CreateSet(const vk::Device& renderDevice) {
+        const auto bindingCount{ meshShading ? MeshletBindings : CompactBindings };
+
+        const auto poolSize{ vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, bindingCount) };
+        geometry.Pool = renderDevice.createDescriptorPoolUnique(vk::DescriptorPoolCreateInfo()
+            .setMaxSets(1)
+            .setPoolSizeCount(1)
+            .setPPoolSizes(&poolSize)
+        );
+
+        geometry.Set = renderDevice.allocateDescriptorSets(vk::DescriptorSetAllocateInfo()
+            .setDescriptorPool(geometry.Pool.get())
+            .setDescriptorSetCount(1)
+            .setPSetLayouts(&setLayout.get())
+        ).front();
+
+        std::array<vk::DescriptorBufferInfo, CompactBindings> infos{
+            vk::DescriptorBufferInfo(*geometry.Meshlets.Buffer(),  0, VK_WHOLE_SIZE),
+            vk::DescriptorBufferInfo(*geometry.Vertices.Buffer(),  0, VK_WHOLE_SIZE),
+            vk::DescriptorBufferInfo(*geometry.Triangles.Buffer(), 0, VK_WHOLE_SIZE),
+            vk::DescriptorBufferInfo(geometry.MeshVertices,        0, VK_WHOLE_SIZE)
+        };
+        if (!meshShading) {
+            infos[4] = vk::DescriptorBufferInfo(*geometry.Indices.Buffer(), 0, VK_WHOLE_SIZE);
+            infos[5] = vk::DescriptorBufferInfo(*geometry.Draw.Buffer(),    0, VK_WHOLE_SIZE);
+        }
+
+        std::vector<vk::WriteDescriptorSet> writes{};
+        for (uint32_t b = 0; b < bindingCount; ++b) {
+            writes.push_back(vk::WriteDescriptorSet()
+                .setDstSet(geometry.Set)
+                .setDstBinding(b)
+                .setDescriptorCount(1)
+                .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+                .setPBufferInfo(&infos[b]));
+        }
+        renderDevice.updateDescriptorSets(writes, nullptr);
+    }
+
+    // The draw's index count is the compaction counter, reset every frame
+    // once the previous frame is done drawing from the list
+    void ClusterCuller::RecordCull(const vk::CommandBuffer& cmdBuffer, const ERD::DeviceDispatch& d, const glm::mat4& transform) {
+        FrustumPlanes(transform, constants.Planes);
+        constants.Camera = CameraPosition(transform);
+        constants.Counts = glm::uvec4(geometry.Count, geometry.VertexBase, 0, 0);
+
+        if (meshShading) return;
+
+        cmdBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eVertexInput | vk::PipelineStageFlagBits::eComputeShader,
+            vk::PipelineStageFlagBits::eTransfer | vk::PipelineStageFlagBits::eComputeShader, {},
+            vk::MemoryBarrier()
+                .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+                .setDstAccessMask(vk::AccessFlagBits::eTransferWrite | vk::AccessFlagBits::eShaderWrite),
+            nullptr, nullptr, d);
+
+        const auto reset{ vk::DrawIndexedIndirectCommand(0, 1, 0, static_cast<int32_t>(geometry.VertexBase), 0) };
+        cmdBuffer.updateBuffer(*geometry.Draw.Buffer(), 0, sizeof(reset), &reset, d);
+
+        cmdBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eComputeShader, {},
+            vk::MemoryBarrier()
+                .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+                .setDstAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite),
+            nullptr, nullptr, d);
+
+        const auto groups{ Groups(geometry.Count) };
+        cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, compactPipeline.get(), d);
+        cmdBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, compactLayout.get(), 0, geometry.Set, nullptr, d);
+        cmdBuffer.pushConstants(compactLayout.get(), vk::ShaderStageFlagBits::eCompute, 0, sizeof(CullConstants), &constants, d);
+        cmdBuffer.dispatch(groups.width, groups.height, 1, d);
+
+        cmdBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eVertexInput, {},
+            vk::MemoryBarrier()
+                .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+                .setDstAccessMask(vk::AccessFlagBits::eIndirectCommandRead | vk::AccessFlagBits::eIndexRead),
+            nullptr, nullptr, d);
+    }
+
+    void ClusterCuller::RecordDraws(const vk::CommandBuffer& cmdBuffer, const ERD::DeviceDispatch& d, const vk::ArrayProxy<const vk::DescriptorSet>& sceneSets) {
+        if (!meshShading) {
+            cmdBuffer.bindIndexBuffer(*geometry.Indices.Buffer(), 0, vk::IndexType::eUint32, d);
+            cmdBuffer.drawIndexedIndirect(*geometry.Draw.Buffer(), 0, 1, sizeof(vk::DrawIndexedIndirectCommand), d);
+            return;
+        }
+
+        const auto groups{ Groups((geometry.Count + TaskGroupSize - 1) / TaskGroupSize) };
+        cmdBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, meshPipeline.GetPipeline(), d);
+        cmdBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, meshPipeline.GetPipelineLayout(), 0, sceneSets, nullptr, d);
+        cmdBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, meshPipeline.GetPipelineLayout(), sceneSetCount, geometry.Set, nullptr, d);
+        cmdBuffer.pushConstants(meshPipeline.GetPipelineLayout(), meshStages, 0, sizeof(CullConstants), &constants, d);
+        cmdBuffer.drawMeshTasksEXT(groups.width, groups.height, 1, d);
+    }
+
+    const uint64_t ClusterCuller::DrawKey() const {
+        const auto key{ ERCD::HandleKey(geometry.Set) };
+        return meshShading ? ERCD::CombineKey(key, ERCD::HashBytes(&constants, sizeof(constants))) : key;
+    }
+}
@@ -0,0 +1,109 @@
+#ifndef RENDER_MESHLET_CLUSTER_CULLER_HPP
+#define RENDER_MESHLET_CLUSTER_CULLER_HPP
+
+#include "VKinclude/VKinclude.hpp"
+#include "Memory/Buffers.hpp"
+#include "Memory/DeletionQueue.hpp"
+#include "Device/Dispatch.hpp"
+#include "Pipeline/Pipeline.hpp"
+#include "Mesh/MeshStreamer.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace Engine::Render::Meshlet {
+
+    // Per meshlet frustum and backface cone culling of the streamed mesh,
+    // see Assets/Mesh/MeshFormat.hpp for the bounds. Nothing rejected ever
+    // reaches the rasterizer.
+    //
+    //  - With VK_EXT_mesh_shader a task shader culls and launches a mesh
+    //    shader workgroup per surviving meshlet, drawn with its own pipeline.
+    //  - Otherwise a compute pass culls and compacts the surviving
+    //    triangles into an index list, drawn with one indexed indirect draw
+    //    through the regular pipeline.
+    //
+    // Meshlet data, index list and draw are shared by all frames in flight,
+    // barriers order each frame's use after the previous one's.
+    class ClusterCuller {
+
+    private:
+        // Same as Cull in GLSL/meshlet_cull.glsl
+        struct CullConstants {
+            glm::vec4   Planes[6];
+            glm::vec4   Camera;
+            glm::uvec4  Counts;
+        };
+
+        // Recreated with every streamed mesh
+        struct Geometry {
+            Engine::Render::Memory::DeviceMemory<Engine::Assets::Mesh::Meshlet> Meshlets;
+            Engine::Render::Memory::DeviceMemory<uint32_t>                      Vertices;
+            Engine::Render::Memory::DeviceMemory<uint32_t>                      Triangles;
+            Engine::Render::Memory::DeviceMemory<uint32_t>                      Indices;    // Compaction only
+            Engine::Render::Memory::DeviceMemory<vk::DrawIndexedIndirectCommand> Draw;      // Compaction only
+            vk::UniqueDescriptorPool                                            Pool;
+            vk::DescriptorSet                                                   Set;
+            vk::Buffer                                                          MeshVertices;   // The geometry pool's
+            uint32_t                                                            VertexBase{ 0 };
+            uint32_t                                                            Count{ 0 };
+        };
+
+        bool                            meshShading { false };
+        uint32_t                        sceneSetCount{ 0 };     // The meshlet set's index
+        vk::UniqueDescriptorSetLayout   setLayout;
+        vk::UniquePipelineLayout        compactLayout;
+        vk::UniquePipeline              compactPipeline;
+        Engine::Render::Pipeline        meshPipeline;
+        Geometry                        geometry;
+        CullConstants                   constants{};
+
+        void CreateSet(const vk::Device&);
+
+    public:
+        ClusterCuller() = default;
+        // sceneLayouts are the regular pipeline's, the meshlet set goes after them
+        ClusterCuller(const vk::Device&, const Engine::Render::Device::PhysicalDevice&, const AttachmentLayout&, const std::vector<vk::DescriptorSetLayout>& sceneLayouts);
+
+        // No copies!
+        ClusterCuller(const ClusterCuller&) = delete;
+        ClusterCuller& operator=(const ClusterCuller&) = delete;
+
+        ClusterCuller(ClusterCuller&&) = default;
+        ClusterCuller& operator=(ClusterCuller&&) = default;
+
+        // Rebuilds the mesh shading pipeline, the old one is retired.
+        // features picks the fragment shader variant, as for the regular one.
+        void ReloadPipeline(const vk::Device&, const AttachmentLayout&, const std::vector<vk::DescriptorSetLayout>& sceneLayouts, Engine::Render::Memory::DeletionQueue&, const uint64_t frameNumber, const Engine::Render::Shader::FeatureKey features = Engine::Render::Shader::Features::None);
+
+        // Takes the meshlet buffers out of mesh. Its vertices are read from
+        // the geometry pool's vertex buffer, starting at vertexBase. A mesh
+        // without meshlets turns culling off.
+        void SetGeometry(const vk::Device&, const Engine::Render::Device::PhysicalDevice&, Engine::Render::Mesh::GpuMesh& mesh, const vk::Buffer& vertices, const uint32_t vertexBase, Engine::Render::Memory::DeletionQueue&, const uint64_t frameNumber);
+        // After the pool moved the mesh's vertices
+        void SetVertices(const vk::Device&, const vk::Buffer& vertices, const uint32_t vertexBase, Engine::Render::Memory::DeletionQueue&, const uint64_t frameNumber);
+        void Clear(Engine::Render::Memory::DeletionQueue&, const uint64_t frameNumber);
+
+        // Call outside of rendering, transform takes the mesh to clip space.
+        // Only compaction records anything, mesh shading culls while drawing.
+        void RecordCull(const vk::CommandBuffer&, const Engine::Render::Device::DeviceDispatch&, const glm::mat4& transform);
+        // Inside rendering. Compaction draws through whatever pipeline and
+        // vertex buffer are bound, mesh shading binds its own pipeline and
+        // sceneSets in front of the meshlet set. sceneSets may leave out the
+        // trailing scene sets the pipeline's variant doesn't read.
+        void RecordDraws(const vk::CommandBuffer&, const Engine::Render::Device::DeviceDispatch&, const vk::ArrayProxy<const vk::DescriptorSet>& sceneSets);
+        // Changes whenever RecordDraws would record something else for the
+        // same sets, pipeline and mesh: the constants mesh shading pushes.
+        // Valid after RecordCull.
+        const uint64_t DrawKey() const;
+
+        // Whether frames should draw through the culler
+        const bool Active()          const { return geometry.Count > 0; }
+        const bool UsesMeshShaders() const { return meshShading; }
+        const uint32_t MeshletCount() const { return geometry.Count; }
+    };
+}
+
+#endif // !RENDER_MESHLET_CLUSTER_CULLER_HPP
@@ -1,4 +1,5 @@
 #include "Pipeline.hpp"
+#include "PipelineState.hpp"
 #include "Shader/Shader.hpp"
 #include "Primitives/Vertex.hpp"
 
@@ -7,117 +8,102 @@
 
 namespace Engine::Render {
 
-    Pipeline::Pipeline(const vk::Device& renderDevice, const vk::RenderPass& renderPass, const vk::Extent2D& swapExtents) {
+    Pipeline::Pipeline(const vk::Device& renderDevice, const AttachmentLayout& attachments, const std::vector<vk::DescriptorSetLayout>& setLayouts, const vk::PipelineCache& cache) :
+        Pipeline(renderDevice, attachments, setLayouts, Engine::Primitives::Vertex::Input(), cache) {}
 
-        namespace ERSHD = Engine::Render::Shader;
-        namespace EP = Engine::Primitives;
+    Pipeline::Pipeline(const vk::Device& renderDevice, const AttachmentLayout& attachments, const std::vector<vk::DescriptorSetLayout>& setLayouts, const Engine::Primitives::VertexInputDescription& vertexInput, const vk::PipelineCache& cache) {
+        Shader::VariantCache shaders{};
+        BuildVariant(renderDevice, attachments, setLayouts, vertexInput, shaders, Shader::Features::None, cache);
+    }
 
-        const auto vertCode { ERSHD::CreateShaderModule(renderDevice, "vert.spv") };
-        const auto fragCode { ERSHD::CreateShaderModule(renderDevice, "frag.spv") };
+    Pipeline::Pipeline(const vk::Device& renderDevice, const AttachmentLayout& attachments, const std::vector<vk::DescriptorSetLayout>& setLayouts, Shader::VariantCache& shaders, const Shader::FeatureKey features, const vk::PipelineCache& cache) {
+        BuildVariant(renderDevice, attachments, setLayouts, Engine::Primitives::Vertex::Input(), shaders, features, cache);
+    }
 
-        const auto inputAssembly{ vk::PipelineInputAssemblyStateCreateInfo()
-            .setTopology(vk::PrimitiveTopology::eTriangleList)
-            .setPrimitiveRestartEnable(false)
-        };
+    void Pipeline::BuildVariant(const vk::Device& renderDevice, const AttachmentLayout& attachments, const std::vector<vk::DescriptorSetLayout>& setLayouts, const Engine::Primitives::VertexInputDescription& vertexInput, Shader::VariantCache& shaders, const Shader::FeatureKey features, const vk::PipelineCache& cache) {
+
+        const Shader::Specialization specialization(features);
 
         const auto vertShaderStage{ vk::PipelineShaderStageCreateInfo()
             .setStage(vk::ShaderStageFlagBits::eVertex)
-            .setModule(vertCode.get())
+            .setModule(shaders.Module(renderDevice, "vert", vk::ShaderStageFlagBits::eVertex, features))
             .setPName("main")
+            .setPSpecializationInfo(specialization.Info())
         };
 
         const auto fragShaderStage{ vk::PipelineShaderStageCreateInfo()
             .setStage(vk::ShaderStageFlagBits::eFragment)
-            .setModule(fragCode.get())
+            .setModule(shaders.Module(renderDevice, "frag", vk::ShaderStageFlagBits::eFragment, features))
             .setPName("main")
+            .setPSpecializationInfo(specialization.Info())
         };
 
-        vk::PipelineShaderStageCreateInfo shaderStages[]{vertShaderStage, fragShaderStage};
-
-        const auto vertexInputInfo{ vk::PipelineVertexInputStateCreateInfo()
-            //.setVertexBindingDescriptionCount(0)
-            //.setPVertexBindingDescriptions(nullptr)
-            //.setVertexAttributeDescriptionCount(0)
-            //.setPVertexAttributeDescriptions(nullptr)
-            .setVertexBindingDescriptionCount(1)
-            .setPVertexBindingDescriptions(EP::Vertex::Binding())
-            .setVertexAttributeDescriptionCount(EP::Vertex::Attributes().size())
-            .setPVertexAttributeDescriptions(EP::Vertex::Attributes().data())
-            // TODO: Check 'instancing'
-        };
-
-        const auto viewport{ vk::Viewport()
-            .setX(0)
-            .setY(0)
-            .setHeight(swapExtents.height)
-            .setWidth(swapExtents.width)
-            .setMinDepth(0.0f)
-            .setMaxDepth(1.0f)
-        };
+        Build(renderDevice, attachments, vk::PipelineLayoutCreateInfo()
+            .setSetLayoutCount(static_cast<uint32_t>(setLayouts.size()))
+            .setPSetLayouts(setLayouts.data()),
+            { vertShaderStage, fragShaderStage },
+            &vertexInput,
+            cache
+        );
+    }
 
-        const auto scissor{ vk::Rect2D()
-            .setOffset({0, 0})
-            .setExtent(swapExtents)
-        };
+    Pipeline::Pipeline(const vk::Device& renderDevice, const AttachmentLayout& attachments, const std::vector<vk::DescriptorSetLayout>& setLayouts, const MeshShading& meshShading, const vk::PipelineCache& cache) {
 
-        const auto viewportState{vk::PipelineViewportStateCreateInfo()
-            .setScissorCount(1)
-            .setPScissors(&scissor)
-            .setViewportCount(1)
-            .setPViewports(&viewport)
-        };
+        namespace ERSHD = Engine::Render::Shader;
 
-        const auto rasterizer{ vk::PipelineRasterizationStateCreateInfo()
-            .setLineWidth(1.0f)
-            .setDepthClampEnable(false)
-            .setRasterizerDiscardEnable(false)
-            .setPolygonMode(vk::PolygonMode::eFill)
-            .setCullMode(vk::CullModeFlagBits::eBack)
-            .setFrontFace(vk::FrontFace::eClockwise)
-            .setDepthBiasEnable(false)
+        const auto taskCode { ERSHD::CreateShaderModule(renderDevice, meshShading.Task) };
+        const auto meshCode { ERSHD::CreateShaderModule(renderDevice, meshShading.Mesh) };
+        const auto fragCode { ERSHD::CreateShaderModule(renderDevice, ERSHD::VariantFile("frag", vk::ShaderStageFlagBits::eFragment, meshShading.Features)) };
+        const ERSHD::Specialization specialization(meshShading.Features);
+
+        const std::vector<vk::PipelineShaderStageCreateInfo> stages{
+            vk::PipelineShaderStageCreateInfo()
+                .setStage(vk::ShaderStageFlagBits::eTaskEXT)
+                .setModule(taskCode.get())
+                .setPName("main"),
+            vk::PipelineShaderStageCreateInfo()
+                .setStage(vk::ShaderStageFlagBits::eMeshEXT)
+                .setModule(meshCode.get())
+                .setPName("main"),
+            vk::PipelineShaderStageCreateInfo()
+                .setStage(vk::ShaderStageFlagBits::eFragment)
+                .setModule(fragCode.get())
+                .setPName("main")
+                .setPSpecializationInfo(specialization.Info())
         };
 
-        const auto multiSample { vk::PipelineMultisampleStateCreateInfo()
-            .setRasterizationSamples(vk::SampleCountFlagBits::e1)
-            .setSampleShadingEnable(false)
-        };
+        const auto pushConstants{ vk::PushConstantRange(vk::ShaderStageFlagBits::eTaskEXT | vk::ShaderStageFlagBits::eMeshEXT, 0, meshShading.PushConstants) };
+
+        Build(renderDevice, attachments, vk::PipelineLayoutCreateInfo()
+            .setSetLayoutCount(static_cast<uint32_t>(setLayouts.size()))
+            .setPSetLayouts(setLayouts.data())
+            .setPushConstantRangeCount(meshShading.PushConstants > 0 ? 1 : 0)
+            .setPPushConstantRanges(&pushConstants),
+            stages,
+            nullptr,
+            cache
+        );
+    }
 
-        const auto colorBlendAttachment{ vk::PipelineColorBlendAttachmentState()
-            .setColorWriteMask(
-                vk::ColorComponentFlagBits::eR |
-                vk::ColorComponentFlagBits::eG |
-                vk::ColorComponentFlagBits::eB |
-                vk::ColorComponentFlagBits::eA )
-            .setBlendEnable(false)
-        };
+    Pipeline::Pipeline(vk::UniquePipelineLayout&& layout, vk::UniquePipeline&& pipeline) :
+        pipelineLayout(std::move(layout)),
+        graphicsPipeline(std::move(pipeline)) {}
 
-        const auto colorBlendState{ vk::PipelineColorBlendStateCreateInfo()
-            .setLogicOpEnable(false)
-            .setLogicOp(vk::LogicOp::eCopy)
-            .setAttachmentCount(1)
-            .setPAttachments(&colorBlendAttachment)
-            .setBlendConstants({0.0f, 0.0f, 0.0f, 0.0f})
-        };
+    // Everything but the shaders and the layout is shared by all pipelines,
+    // see PipelineState
+    void Pipeline::Build(const vk::Device& renderDevice, const AttachmentLayout& attachments, const vk::PipelineLayoutCreateInfo& pipelineLayoutCreateInfo, const std::vector<vk::PipelineShaderStageCreateInfo>& shaderStages, const Engine::Primitives::VertexInputDescription* vertexInput, const vk::PipelineCache& cache) {
 
-        const auto pipelineLayoutCreateInfo { vk::PipelineLayoutCreateInfo() };
+        const PipelineState state(attachments, vertexInput);
 
         pipelineLayout = renderDevice.createPipelineLayoutUnique(pipelineLayoutCreateInfo);
 
-        const auto graphicsPipelineCreateInfo { vk::GraphicsPipelineCreateInfo()
-            .setPInputAssemblyState(&inputAssembly)
-            .setStageCount(2)
-            .setPStages(shaderStages)
-            .setPVertexInputState(&vertexInputInfo)
-            .setPMultisampleState(&multiSample)
-            .setPViewportState(&viewportState)
+        const auto graphicsPipelineCreateInfo { state.Monolithic()
+            .setStageCount(static_cast<uint32_t>(shaderStages.size()))
+            .setPStages(shaderStages.data())
             .setLayout(pipelineLayout.get())
-            .setPColorBlendState(&colorBlendState)
-            .setPRasterizationState(&rasterizer)
-            .setRenderPass(renderPass)
-            .setSubpass(0)
         };
 
-        graphicsPipeline = renderDevice.createGraphicsPipelineUnique(nullptr, graphicsPipelineCreateInfo);
+        graphicsPipeline = renderDevice.createGraphicsPipelineUnique(cache, graphicsPipelineCreateInfo);
     }
 
 }
@@ -3,23 +3,60 @@
 #define RENDER_PIPELINE_HPP
 
 #include "VKinclude/VKinclude.hpp"
+#include "Primitives/VertexLayout.hpp"
+#include "Shader/ShaderVariant.hpp"
+
+#include <string>
+#include <vector>
 
 
 namespace Engine::Render {
 
+    // What a pipeline renders into. With dynamic rendering only the formats
+    // matter, the legacy path also needs a compatible render pass.
+    struct AttachmentLayout {
+        vk::Format      Color       { vk::Format::eUndefined };
+        vk::Format      Depth       { vk::Format::eUndefined };
+        vk::RenderPass  RenderPass  {};
+    };
+
+    // Shader files for a task and mesh shader pipeline, and the bytes of
+    // push constants both stages see. The fragment shader is the regular
+    // pipeline's, in the Features variant.
+    struct MeshShading {
+        std::string     Task;
+        std::string     Mesh;
+        uint32_t        PushConstants{ 0 };
+        Shader::FeatureKey Features{ Shader::Features::None };
+    };
+
     class Pipeline {
 
     private:
         vk::UniquePipelineLayout    pipelineLayout;
         vk::UniquePipeline          graphicsPipeline;
 
+        void BuildVariant(const vk::Device& renderDevice, const AttachmentLayout& attachments, const std::vector<vk::DescriptorSetLayout>& setLayouts, const Engine::Primitives::VertexInputDescription& vertexInput, Shader::VariantCache& shaders, const Shader::FeatureKey features, const vk::PipelineCache& cache);
+        void Build(const vk::Device& renderDevice, const AttachmentLayout& attachments, const vk::PipelineLayoutCreateInfo& layoutInfo, const std::vector<vk::PipelineShaderStageCreateInfo>& stages, const Engine::Primitives::VertexInputDescription* vertexInput, const vk::PipelineCache& cache);
+
     public:
         Pipeline() = default;
         Pipeline(const Pipeline&) = delete;
         Pipeline(Pipeline&&) = default;
         Pipeline& operator=(const Pipeline&) = delete;
         Pipeline& operator=(Pipeline&&) = default;
-        Pipeline(const vk::Device& renderDevice, const vk::RenderPass&, const vk::Extent2D& swapExtents);
+        // Viewport and scissor are dynamic state, resizes don't need a new pipeline.
+        // setLayouts are bound from set 0 on: the per frame uniforms, then the lights.
+        // A pipeline cache, if given, is looked up and filled while building.
+        Pipeline(const vk::Device& renderDevice, const AttachmentLayout& attachments, const std::vector<vk::DescriptorSetLayout>& setLayouts, const vk::PipelineCache& cache = {});
+        Pipeline(const vk::Device& renderDevice, const AttachmentLayout& attachments, const std::vector<vk::DescriptorSetLayout>& setLayouts, const Engine::Primitives::VertexInputDescription& vertexInput, const vk::PipelineCache& cache = {});
+        // The features variant of the vertex and fragment shaders, modules
+        // come out of and stay in shaders, see Shader/ShaderVariant.hpp
+        Pipeline(const vk::Device& renderDevice, const AttachmentLayout& attachments, const std::vector<vk::DescriptorSetLayout>& setLayouts, Shader::VariantCache& shaders, const Shader::FeatureKey features, const vk::PipelineCache& cache = {});
+        // Task and mesh shaders in place of vertex input and the vertex shader, VK_EXT_mesh_shader
+        Pipeline(const vk::Device& renderDevice, const AttachmentLayout& attachments, const std::vector<vk::DescriptorSetLayout>& setLayouts, const MeshShading& meshShading, const vk::PipelineCache& cache = {});
+        // Takes over a pipeline built elsewhere, see PipelineLibrary
+        Pipeline(vk::UniquePipelineLayout&& layout, vk::UniquePipeline&& pipeline);
         vk::Pipeline          GetPipeline() { return graphicsPipeline.get(); }
         vk::PipelineLayout    GetPipelineLayout() { return pipelineLayout.get(); }
     };
@@ -0,0 +1,264 @@
+#include "PipelineLibrary.hpp"
+#include "PipelineState.hpp"
+#include "Command/SecondaryCache.hpp"
+#include "Primitives/Vertex.hpp"
+#include "Logger.hpp"
+
+namespace Engine::Render {
+
+    namespace ERCD = Engine::Render::Command;
+
+    namespace {
+        constexpr auto PartFlags{ vk::PipelineCreateFlagBits::eLibraryKHR | vk::PipelineCreateFlagBits::eRetainLinkTimeOptimizationInfoEXT };
+
+        vk::PipelineLayoutCreateInfo LayoutInfo(const std::vector<vk::DescriptorSetLayout>& setLayouts) {
+            return vk::PipelineLayoutCreateInfo()
+                .setSetLayoutCount(static_cast<uint32_t>(setLayouts.size()))
+                .setPSetLayouts(setLayouts.data());
+        }
+
+        // Unoptimized links are what fast linking is fast at, the optimized
+        // one needs the parts built with eRetainLinkTimeOptimizationInfoEXT
+        vk::UniquePipeline LinkParts(const vk::Device& device, const vk::PipelineCache& cache, const vk::PipelineLayout& layout, const vk::ArrayProxy<const vk::Pipeline>& libraries, const bool optimize) {
+            const auto libraryInfo{ vk::PipelineLibraryCreateInfoKHR()
+                .setLibraryCount(libraries.size())
+                .setPLibraries(libraries.data())
+            };
+
+            return device.createGraphicsPipelineUnique(cache, vk::GraphicsPipelineCreateInfo()
+                .setPNext(&libraryInfo)
+                .setFlags(optimize ? vk::PipelineCreateFlags(vk::PipelineCreateFlagBits::eLinkTimeOptimizationEXT) : vk::PipelineCreateFlags())
+                .setLayout(layout)
+            );
+        }
+
+        uint64_t ShaderKey(const std::string& name, const vk::ShaderStageFlagBits stage, const Shader::FeatureKey features) {
+            const auto file{ Shader::VariantFile(name, stage, features) };
+            return ERCD::CombineKey(ERCD::HashBytes(file.data(), file.size()), features & Shader::Features::Specialized);
+        }
+    }
+
+    PipelineLibrary::Compiler::Compiler(const vk::Device& device, const vk::PipelineCache& cache) :
+        device(device),
+        cache(cache)
+    {
+        // Started last, Run needs everything above
+        thread = std::thread(&Compiler::Run, this);
+    }
+
+    PipelineLibrary::Compiler::~Compiler() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+            queued.clear();
+        }
+        wake.notify_all();
+
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+
+    void PipelineLibrary::Compiler::Run() {
+        std::unique_lock<std::mutex> guard(lock);
+
+        while (true) {
+            wake.wait(guard, [this] { return stopping || !queued.empty(); });
+            if (stopping) return;
+
+            const auto link{ std::move(queued.front()) };
+            queued.pop_front();
+            busy = true;
+            guard.unlock();
+
+            Pipeline optimized{};
+            bool built{ false };
+            try {
+                auto layout{ device.createPipelineLayoutUnique(LayoutInfo(link.SetLayouts)) };
+                auto pipeline{ LinkParts(device, cache, layout.get(), link.Parts, true) };
+                optimized = Pipeline(std::move(layout), std::move(pipeline));
+                built = true;
+            }
+            catch (const std::exception& e) {
+                // The quick link keeps drawing
+                LOGGER << "Optimized pipeline link failed: " << e.what() << '\n';
+            }
+
+            guard.lock();
+            busy = false;
+            if (built) {
+                finished.push_back(Linked{ link.Features, std::move(optimized) });
+                ready.store(static_cast<uint32_t>(finished.size()), std::memory_order_release);
+            }
+            idle.notify_all();
+        }
+    }
+
+    void PipelineLibrary::Compiler::Drain() {
+        std::unique_lock<std::mutex> guard(lock);
+        queued.clear();
+        idle.wait(guard, [this] { return !busy; });
+        finished.clear();
+        ready.store(0, std::memory_order_release);
+    }
+
+    PipelineLibrary::PipelineLibrary(const vk::Device& renderDevice, const Device::PhysicalDevice& deviceInfo, const vk::PipelineCache& pipelineCache) :
+        device(renderDevice),
+        cache(pipelineCache),
+        linking(deviceInfo.SupportsFastLinking())
+    {
+        if (linking) {
+            compiler = std::make_unique<Compiler>(device, cache);
+        }
+    }
+
+    // Parts are keyed by everything their create info is made of. Shader
+    // parts also have the layout and where they render into in the key.
+    Pipeline PipelineLibrary::Build(const AttachmentLayout& attachments, const std::vector<vk::DescriptorSetLayout>& setLayouts, Shader::VariantCache& shaders, const Shader::FeatureKey features) {
+
+        if (!linking) {
+            ++monolithicBuilds;
+            return Pipeline(device, attachments, setLayouts, shaders, features, cache);
+        }
+
+        const auto vertexInput{ Engine::Primitives::Vertex::Input() };
+        const PipelineState state(attachments, &vertexInput);
+        const Shader::Specialization specialization(features);
+
+        const auto layoutsKey{ ERCD::HashBytes(setLayouts.data(), setLayouts.size() * sizeof(vk::DescriptorSetLayout)) };
+        const auto outputKey{ ERCD::CombineKey(ERCD::CombineKey(static_cast<uint64_t>(attachments.Color), static_cast<uint64_t>(attachments.Depth)), ERCD::HandleKey(attachments.RenderPass)) };
+        const auto targetKey{ ERCD::CombineKey(layoutsKey, outputKey) };
+        const auto vertexKey{ ERCD::CombineKey(
+            ERCD::HashBytes(vertexInput.Binding, sizeof(vk::VertexInputBindingDescription)),
+            ERCD::HashBytes(vertexInput.Attributes, vertexInput.AttributeCount * sizeof(vk::VertexInputAttributeDescription))) };
+
+        const auto vertexInputPart{ vk::GraphicsPipelineLibraryCreateInfoEXT()
+            .setFlags(vk::GraphicsPipelineLibraryFlagBitsEXT::eVertexInputInterface)
+        };
+        const auto preRasterizationPart{ vk::GraphicsPipelineLibraryCreateInfoEXT()
+            .setPNext(state.RenderingNext())
+            .setFlags(vk::GraphicsPipelineLibraryFlagBitsEXT::ePreRasterizationShaders)
+        };
+        const auto fragmentShaderPart{ vk::GraphicsPipelineLibraryCreateInfoEXT()
+            .setPNext(state.RenderingNext())
+            .setFlags(vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentShader)
+        };
+        const auto fragmentOutputPart{ vk::GraphicsPipelineLibraryCreateInfoEXT()
+            .setPNext(state.RenderingNext())
+            .setFlags(vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentOutputInterface)
+        };
+
+        const auto vertStage{ vk::PipelineShaderStageCreateInfo()
+            .setStage(vk::ShaderStageFlagBits::eVertex)
+            .setModule(shaders.Module(device, "vert", vk::ShaderStageFlagBits::eVertex, features))
+            .setPName("main")
+            .setPSpecializationInfo(specialization.Info())
+        };
+        const auto fragStage{ vk::PipelineShaderStageCreateInfo()
+            .setStage(vk::ShaderStageFlagBits::eFragment)
+            .setModule(shaders.Module(device, "frag", vk::ShaderStageFlagBits::eFragment, features))
+            .setPName("main")
+            .setPSpecializationInfo(specialization.Info())
+        };
+
+        const std::array<vk::Pipeline, PartCount> libraries{
+            Get(vertexKey, vk::GraphicsPipelineCreateInfo()
+                .setPNext(&vertexInputPart)
+                .setPVertexInputState(&state.VertexInput)
+                .setPInputAssemblyState(&state.InputAssembly),
+                Part::VertexInput, setLayouts),
+            Get(ERCD::CombineKey(ShaderKey("vert", vk::ShaderStageFlagBits::eVertex, features), targetKey), vk::GraphicsPipelineCreateInfo()
+                .setPNext(&preRasterizationPart)
+                .setStageCount(1)
+                .setPStages(&vertStage)
+                .setPViewportState(&state.Viewport)
+                .setPRasterizationState(&state.Rasterizer)
+                .setPDynamicState(&state.Dynamic)
+                .setRenderPass(attachments.RenderPass)
+                .setSubpass(0),
+                Part::PreRasterization, setLayouts),
+            Get(ERCD::CombineKey(ShaderKey("frag", vk::ShaderStageFlagBits::eFragment, features), targetKey), vk::GraphicsPipelineCreateInfo()
+                .setPNext(&fragmentShaderPart)
+                .setStageCount(1)
+                .setPStages(&fragStage)
+                .setPMultisampleState(&state.Multisample)
+                .setPDepthStencilState(state.Depth())
+                .setRenderPass(attachments.RenderPass)
+                .setSubpass(0),
+                Part::FragmentShader, setLayouts),
+            Get(outputKey, vk::GraphicsPipelineCreateInfo()
+                .setPNext(&fragmentOutputPart)
+                .setPMultisampleState(&state.Multisample)
+                .setPColorBlendState(&state.Blend)
+                .setRenderPass(attachments.RenderPass)
+                .setSubpass(0),
+                Part::FragmentOutput, setLayouts)
+        };
+
+        auto layout{ device.createPipelineLayoutUnique(LayoutInfo(setLayouts)) };
+        auto pipeline{ LinkParts(device, cache, layout.get(), libraries, false) };
+        ++fastLinks;
+
+        {
+            std::lock_guard<std::mutex> guard(compiler->lock);
+            compiler->queued.push_back(Link{ features, libraries, setLayouts });
+        }
+        compiler->wake.notify_one();
+
+        return Pipeline(std::move(layout), std::move(pipeline));
+    }
+
+    const vk::Pipeline PipelineLibrary::Get(const uint64_t key, const vk::GraphicsPipelineCreateInfo& info, const Part part, const std::vector<vk::DescriptorSetLayout>& setLayouts) {
+        const auto partKey{ ERCD::CombineKey(static_cast<uint64_t>(part), key) };
+
+        const auto found{ parts.find(partKey) };
+        if (found != parts.end()) {
+            return found->second.Library.get();
+        }
+
+        // Only the shader parts are built against the layout, the final
+        // link takes an identical one
+        CachedPart cached{};
+        auto partInfo{ info };
+        if (part == Part::PreRasterization || part == Part::FragmentShader) {
+            cached.Layout = device.createPipelineLayoutUnique(LayoutInfo(setLayouts));
+            partInfo.setLayout(cached.Layout.get());
+        }
+
+        cached.Library = device.createGraphicsPipelineUnique(cache, partInfo.setFlags(PartFlags));
+        return parts.emplace(partKey, std::move(cached)).first->second.Library.get();
+    }
+
+    const bool PipelineLibrary::TakeOptimized(Shader::FeatureKey& features, Pipeline& optimized) {
+        if (!compiler || compiler->ready.load(std::memory_order_acquire) == 0) return false;
+
+        std::lock_guard<std::mutex> guard(compiler->lock);
+        if (compiler->finished.empty()) return false;
+
+        features  = compiler->finished.front().Features;
+        optimized = std::move(compiler->finished.front().Optimized);
+        compiler->finished.pop_front();
+        compiler->ready.store(static_cast<uint32_t>(compiler->finished.size()), std::memory_order_release);
+
+        ++optimizedLinks;
+        return true;
+    }
+
+    const bool PipelineLibrary::Pending() const {
+        if (!compiler) return false;
+
+        std::lock_guard<std::mutex> guard(compiler->lock);
+        return compiler->busy || !compiler->queued.empty() || !compiler->finished.empty();
+    }
+
+    void PipelineLibrary::Clear(Memory::DeletionQueue& deletionQueue, const uint64_t frameNumber) {
+        if (compiler) {
+            compiler->Drain();
+        }
+
+        for (auto& [key, part] : parts) {
+            deletionQueue.Retire(std::move(part), frameNumber);
+        }
+        parts.clear();
+    }
+}
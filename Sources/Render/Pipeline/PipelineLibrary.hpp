@@ -0,0 +1,130 @@
+#ifndef RENDER_PIPELINE_PIPELINE_LIBRARY_HPP
+#define RENDER_PIPELINE_PIPELINE_LIBRARY_HPP
+
+#include "VKinclude/VKinclude.hpp"
+#include "Pipeline.hpp"
+#include "Device/Physical.hpp"
+#include "Memory/DeletionQueue.hpp"
+#include "Shader/ShaderVariant.hpp"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Engine::Render {
+
+    // Builds the scene's shader variants without stalling a frame, with
+    // VK_EXT_graphics_pipeline_library. A pipeline is split in four parts,
+    // vertex input, pre-rasterization (vertex shader), fragment shader and
+    // fragment output, each compiled once and cached by what goes into it.
+    // A new variant only compiles the parts it doesn't share and links
+    // them unoptimized, which fast linking devices do in well under a
+    // millisecond. A fully optimized link is queued on a compile thread
+    // and handed back through TakeOptimized to replace the quick one.
+    //
+    // Devices without fast linking build monolithic pipelines, the way
+    // Pipeline does, right away.
+    class PipelineLibrary {
+
+    private:
+        enum class Part : uint32_t { VertexInput, PreRasterization, FragmentShader, FragmentOutput, Count };
+        static constexpr size_t PartCount{ static_cast<size_t>(Part::Count) };
+
+        struct CachedPart {
+            vk::UniquePipelineLayout    Layout;     // Shader parts only
+            vk::UniquePipeline          Library;
+        };
+
+        // An optimized link waiting for the compile thread
+        struct Link {
+            Shader::FeatureKey                      Features;
+            std::array<vk::Pipeline, PartCount>     Parts;
+            std::vector<vk::DescriptorSetLayout>    SetLayouts;
+        };
+
+        struct Linked {
+            Shader::FeatureKey  Features;
+            Pipeline            Optimized;
+        };
+
+        // Lives apart so the library can move while the thread runs
+        struct Compiler {
+            vk::Device                  device;
+            vk::PipelineCache           cache;
+            std::thread                 thread;
+            std::mutex                  lock;
+            std::condition_variable     wake;
+            std::condition_variable     idle;
+            std::deque<Link>            queued;
+            std::deque<Linked>          finished;
+            std::atomic<uint32_t>       ready{ 0 };     // finished.size(), read without the lock
+            bool                        busy{ false };
+            bool                        stopping{ false };
+
+            Compiler(const vk::Device& device, const vk::PipelineCache& cache);
+            // Finishes the link in progress, drops the rest
+            ~Compiler();
+
+            void Run();
+            // Drops what's queued or finished, waits out the link in progress
+            void Drain();
+        };
+
+        vk::Device                  device;
+        vk::PipelineCache           cache;
+        bool                        linking{ false };
+        std::unordered_map<uint64_t, CachedPart> parts;
+        std::unique_ptr<Compiler>   compiler;
+        uint64_t                    fastLinks{ 0 };
+        uint64_t                    monolithicBuilds{ 0 };
+        uint64_t                    optimizedLinks{ 0 };
+
+        const vk::Pipeline Get(const uint64_t key, const vk::GraphicsPipelineCreateInfo& info, const Part part, const std::vector<vk::DescriptorSetLayout>& setLayouts);
+
+    public:
+        PipelineLibrary() = default;
+        // A pipeline cache, if given, is used for every part and link
+        PipelineLibrary(const vk::Device& renderDevice, const Device::PhysicalDevice& deviceInfo, const vk::PipelineCache& cache = {});
+
+        // No copies!
+        PipelineLibrary(const PipelineLibrary&) = delete;
+        PipelineLibrary& operator=(const PipelineLibrary&) = delete;
+
+        // No move assignment either, it would drop the parts before joining
+        // the compiler still linking against them
+        PipelineLibrary(PipelineLibrary&&) = default;
+        PipelineLibrary& operator=(PipelineLibrary&&) = delete;
+
+        // The features variant of the scene pipeline, as the Pipeline
+        // constructor builds it. Linked from parts when the device can, an
+        // optimized one then follows through TakeOptimized.
+        Pipeline Build(const AttachmentLayout& attachments, const std::vector<vk::DescriptorSetLayout>& setLayouts, Shader::VariantCache& shaders, const Shader::FeatureKey features);
+
+        // A finished optimized pipeline and the variant it's for, false if
+        // there is none. Only takes a lock when one is ready.
+        const bool TakeOptimized(Shader::FeatureKey& features, Pipeline& optimized);
+
+        // Drops every part and pending link, for reloads and new attachments.
+        // Waits for the link in progress, the parts are retired.
+        void Clear(Memory::DeletionQueue& deletionQueue, const uint64_t frameNumber);
+
+        // Optimized links queued, in progress or not taken yet
+        const bool     Pending()            const;
+        const bool     Linking()            const { return linking; }
+        const size_t   Parts()              const { return parts.size(); }
+        const uint64_t FastLinks()          const { return fastLinks; }
+        const uint64_t MonolithicBuilds()   const { return monolithicBuilds; }
+        // Taken through TakeOptimized
+        const uint64_t OptimizedLinks()     const { return optimizedLinks; }
+    };
+}
+
+#endif // !RENDER_PIPELINE_PIPELINE_LIBRARY_HPP
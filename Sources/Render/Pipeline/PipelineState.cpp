@@ -0,0 +1,95 @@
+#include "PipelineState.hpp"
+
+namespace Engine::Render {
+
+    PipelineState::PipelineState(const AttachmentLayout& attachments, const Engine::Primitives::VertexInputDescription* vertexInput) :
+        Attachments(attachments),
+        HasVertexInput(vertexInput != nullptr),
+        DynamicStates{ vk::DynamicState::eViewport, vk::DynamicState::eScissor }
+    {
+        InputAssembly = vk::PipelineInputAssemblyStateCreateInfo()
+            .setTopology(vk::PrimitiveTopology::eTriangleList)
+            .setPrimitiveRestartEnable(false);
+
+        if (vertexInput) {
+            VertexInput
+                .setVertexBindingDescriptionCount(1)
+                .setPVertexBindingDescriptions(vertexInput->Binding)
+                .setVertexAttributeDescriptionCount(vertexInput->AttributeCount)
+                .setPVertexAttributeDescriptions(vertexInput->Attributes);
+                // TODO: Check 'instancing'
+        }
+
+        // Counts only, the values are set when recording
+        Viewport = vk::PipelineViewportStateCreateInfo()
+            .setScissorCount(1)
+            .setViewportCount(1);
+
+        Dynamic = vk::PipelineDynamicStateCreateInfo()
+            .setDynamicStateCount(static_cast<uint32_t>(DynamicStates.size()))
+            .setPDynamicStates(DynamicStates.data());
+
+        Rasterizer = vk::PipelineRasterizationStateCreateInfo()
+            .setLineWidth(1.0f)
+            .setDepthClampEnable(false)
+            .setRasterizerDiscardEnable(false)
+            .setPolygonMode(vk::PolygonMode::eFill)
+            .setCullMode(vk::CullModeFlagBits::eBack)
+            .setFrontFace(vk::FrontFace::eClockwise)
+            .setDepthBiasEnable(false);
+
+        Multisample = vk::PipelineMultisampleStateCreateInfo()
+            .setRasterizationSamples(vk::SampleCountFlagBits::e1)
+            .setSampleShadingEnable(false);
+
+        BlendAttachment = vk::PipelineColorBlendAttachmentState()
+            .setColorWriteMask(
+                vk::ColorComponentFlagBits::eR |
+                vk::ColorComponentFlagBits::eG |
+                vk::ColorComponentFlagBits::eB |
+                vk::ColorComponentFlagBits::eA )
+            .setBlendEnable(false);
+
+        Blend = vk::PipelineColorBlendStateCreateInfo()
+            .setLogicOpEnable(false)
+            .setLogicOp(vk::LogicOp::eCopy)
+            .setAttachmentCount(1)
+            .setPAttachments(&BlendAttachment)
+            .setBlendConstants({0.0f, 0.0f, 0.0f, 0.0f});
+
+        DepthStencil = vk::PipelineDepthStencilStateCreateInfo()
+            .setDepthTestEnable(true)
+            .setDepthWriteEnable(true)
+            .setDepthCompareOp(vk::CompareOp::eLess)
+            .setDepthBoundsTestEnable(false)
+            .setStencilTestEnable(false);
+
+        Rendering = vk::PipelineRenderingCreateInfoKHR()
+            .setColorAttachmentCount(1)
+            .setPColorAttachmentFormats(&Attachments.Color)
+            .setDepthAttachmentFormat(Attachments.Depth);
+    }
+
+    const vk::PipelineDepthStencilStateCreateInfo* PipelineState::Depth() const {
+        return Attachments.Depth != vk::Format::eUndefined ? &DepthStencil : nullptr;
+    }
+
+    const void* PipelineState::RenderingNext() const {
+        return Attachments.RenderPass ? nullptr : &Rendering;
+    }
+
+    vk::GraphicsPipelineCreateInfo PipelineState::Monolithic() const {
+        return vk::GraphicsPipelineCreateInfo()
+            .setPNext(RenderingNext())
+            .setPInputAssemblyState(HasVertexInput ? &InputAssembly : nullptr)
+            .setPVertexInputState(HasVertexInput ? &VertexInput : nullptr)
+            .setPMultisampleState(&Multisample)
+            .setPDepthStencilState(Depth())
+            .setPViewportState(&Viewport)
+            .setPDynamicState(&Dynamic)
+            .setPColorBlendState(&Blend)
+            .setPRasterizationState(&Rasterizer)
+            .setRenderPass(Attachments.RenderPass)
+            .setSubpass(0);
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef RENDER_PIPELINE_PIPELINE_STATE_HPP
+#define RENDER_PIPELINE_PIPELINE_STATE_HPP
+
+#include "Pipeline.hpp"
+
+#include <array>
+
+namespace Engine::Render {
+
+    // Fixed function state every graphics pipeline here shares, whole for
+    // a monolithic build or piece by piece for pipeline library parts.
+    // Points into itself, so it's built in place and never copied.
+    struct PipelineState {
+        AttachmentLayout                            Attachments;
+        bool                                        HasVertexInput;
+
+        vk::PipelineVertexInputStateCreateInfo      VertexInput;
+        vk::PipelineInputAssemblyStateCreateInfo    InputAssembly;
+        vk::PipelineViewportStateCreateInfo         Viewport;
+        std::array<vk::DynamicState, 2>             DynamicStates;
+        vk::PipelineDynamicStateCreateInfo          Dynamic;
+        vk::PipelineRasterizationStateCreateInfo    Rasterizer;
+        vk::PipelineMultisampleStateCreateInfo      Multisample;
+        vk::PipelineColorBlendAttachmentState       BlendAttachment;
+        vk::PipelineColorBlendStateCreateInfo       Blend;
+        vk::PipelineDepthStencilStateCreateInfo     DepthStencil;
+        vk::PipelineRenderingCreateInfoKHR          Rendering;
+
+        // Without vertexInput there's no vertex input or input assembly
+        // state, mesh shaders produce their own primitives
+        PipelineState(const AttachmentLayout& attachments, const Engine::Primitives::VertexInputDescription* vertexInput);
+
+        // No copies!
+        PipelineState(const PipelineState&) = delete;
+        PipelineState& operator=(const PipelineState&) = delete;
+
+        // Depth state only with a depth attachment, the legacy render pass has none
+        const vk::PipelineDepthStencilStateCreateInfo* Depth() const;
+        // Without a render pass the attachment formats come from the pNext chain
+        const void* RenderingNext() const;
+
+        // All of it, only stages and layout left to set
+        vk::GraphicsPipelineCreateInfo Monolithic() const;
+    };
+}
+
+#endif // !RENDER_PIPELINE_PIPELINE_STATE_HPP
@@ -27,7 +27,8 @@ namespace Engine::Render::Queue {
             qf.Flags    = queueProperties.queueFlags;
             qf.Index    = queueInx;
             qf.Used     = 0;
-            qf.PresentSupport = phyDev.getSurfaceSupportKHR(queueInx, surface) == VK_TRUE;
+            qf.Exists   = true;
+            qf.PresentSupport = surface && phyDev.getSurfaceSupportKHR(queueInx, surface) == VK_TRUE;
 
             // Now, we evaluate QueueType so it's easier to get
             // stuff later on.
@@ -67,61 +68,64 @@ namespace Engine::Render::Queue {
                     throw std::runtime_error("Unexpected queue case.");
             }
 
-            if (queueFamilies.count(queueFamilyType) > 0)
+            if (queueFamilies[queueFamilyType].Exists)
                 throw std::runtime_error("Same queue type found.");
 
-            queueFamilies.emplace(queueFamilyType, qf);
+            queueFamilies[queueFamilyType] = qf;
 
             LOGGER << "\t Queue Familiy [" << queueInx << "]: \n";
-            LOGGER << "\t\t Queue Count: "                          << queueFamilies.at(queueFamilyType).Count          << '\n';
-            LOGGER << "\t\t Present Support: "  << std::boolalpha   << queueFamilies.at(queueFamilyType).PresentSupport << '\n';
+            LOGGER << "\t\t Queue Count: "                          << qf.Count          << '\n';
+            LOGGER << "\t\t Present Support: "  << std::boolalpha   << qf.PresentSupport << '\n';
             LOGGER << "\t\t Queue flags: "      << vk::to_string(queueFam.queueFamilyProperties.queueFlags)             << '\n';
         }
     }
 
     // Reserve queues before logical device creation.
     // allocateQueues <QueueType to allocate, how many of the type to allocate>
-    QueueManager::QueueManager(const vk::PhysicalDevice& phyDev, const vk::SurfaceKHR& surface, const std::map<QueueType, int>& allocateQueues) :
+    QueueManager::QueueManager(const vk::PhysicalDevice& phyDev, const vk::SurfaceKHR& surface, const QueueTable<int>& allocateQueues) :
         QueueManager::QueueManager(phyDev, surface) {
 
-        for (const auto& i : allocateQueues) {
-            ReserveQueues(i.first, i.second);
+        for (const auto qt : QueueTypes) {
+            if (allocateQueues[qt] > 0) {
+                ReserveQueues(qt, allocateQueues[qt]);
+            }
         }
     }
 
 
     void QueueManager::ReserveQueues(const QueueType queueType, const int howMany) {
-        assert(queueFamilies.at(queueType).QueuesAvailable(howMany) && "No Queues available");
-        queueFamilies.at(queueType).Used += howMany;
+        assert(GetQF(queueType).QueuesAvailable(howMany) && "No Queues available");
+        queueFamilies[queueType].Used += howMany;
     }
 
     void QueueManager::PopulateQueues(const vk::Device& renderDevice) {
-        for (const auto& queueFam : queueFamilies) {
-            if (queueFam.second.Used > 0) {
-                for (uint32_t i = 0; i < queueFam.second.Used; ++i) {
-                    allocatedQueues.emplace(queueFam.first, renderDevice.getQueue(queueFam.second.Index, i));
-                }
+        // Only the first queue of each type is handed out for now
+        for (const auto qt : QueueTypes) {
+            const auto& queueFam{ queueFamilies[qt] };
+            if (queueFam.Used > 0) {
+                allocatedQueues[qt] = renderDevice.getQueue(queueFam.Index, 0);
             }
         }
     }
 
-    const std::map<QueueType, QueueFamily>& QueueManager::RequestedQueues() const {
+    const QueueTable<QueueFamily>& QueueManager::RequestedQueues() const {
         return queueFamilies;
     }
 
     // Returns the queue family of specified type
     const QueueFamily& QueueManager::GetQF(const QueueType qt) const {
-        return queueFamilies.at(qt);
+        if (!queueFamilies[qt].Exists) throw std::runtime_error("No queue family of this type");
+        return queueFamilies[qt];
     }
 
     // Returns the allocated queue.
     const vk::Queue& QueueManager::GetQ(const QueueType qt) const {
-        return allocatedQueues.at(qt);
+        return allocatedQueues[qt];
     }
 
-    // Returns the allocated queue.
+    // Returns the allocated queue. Per frame path, no checks
     vk::Queue& QueueManager::operator[] (const QueueType queueType) {
-        return allocatedQueues.at(queueType);
+        return allocatedQueues[queueType];
     }
 
 }
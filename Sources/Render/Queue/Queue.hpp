@@ -2,7 +2,8 @@
 #define RENDER_QUEUE_HPP
 
 #include "VKinclude/VKinclude.hpp"
-#include <map>
+#include <array>
+#include <cstddef>
 
 namespace Engine::Render::Queue {
 
@@ -18,27 +19,40 @@ namespace Engine::Render::Queue {
     // support. Hence, a Graphics queue is also a general-purpose queue
     // Well, I hope my understanding of the spec is correct, we'll see.
 
+    constexpr size_t QueueTypeCount{ 3 };
+    constexpr std::array<QueueType, QueueTypeCount> QueueTypes{ QueueType::Graphics, QueueType::Compute, QueueType::Transfer };
+
+    // One T per QueueType, a flat array so per frame lookups are an index
+    template <typename T>
+    struct QueueTable {
+        std::array<T, QueueTypeCount> Items{};
+
+        T&          operator[](const QueueType qt)          { return Items[static_cast<size_t>(qt)]; }
+        const T&    operator[](const QueueType qt) const    { return Items[static_cast<size_t>(qt)]; }
+    };
+
     struct QueueFamily {
         uint32_t Index   { 0 };
         uint32_t Count   { 0 };
         uint32_t Used    { 0 };
+        bool Exists      { false };
         bool PresentSupport{ false };
         vk::QueueFlags Flags;
 
-        const bool QueuesAvailable()                    { return Used < Count; }
-        const bool QueuesAvailable(const uint32_t newAlloc)  { return Used + newAlloc < Count; }
+        const bool QueuesAvailable()                        const { return Used < Count; }
+        const bool QueuesAvailable(const uint32_t newAlloc) const { return Used + newAlloc <= Count; }
     };
 
 
     class QueueManager {
     private:
 
-        std::map<QueueType, QueueFamily>    queueFamilies;
-        std::map<QueueType, vk::Queue>      allocatedQueues;
+        QueueTable<QueueFamily>     queueFamilies;
+        QueueTable<vk::Queue>       allocatedQueues;
 
     public:
         QueueManager(const vk::PhysicalDevice&, const vk::SurfaceKHR&);
-        QueueManager(const vk::PhysicalDevice&, const vk::SurfaceKHR&, const std::map<QueueType, int>&);
+        QueueManager(const vk::PhysicalDevice&, const vk::SurfaceKHR&, const QueueTable<int>&);
         QueueManager(QueueManager&&) = default;
         QueueManager& operator=(QueueManager&&) = default;
 
@@ -48,7 +62,7 @@ namespace Engine::Render::Queue {
 
         void    ReserveQueues(const QueueType, const int);
         void    PopulateQueues(const vk::Device&);
-        const std::map<QueueType, QueueFamily>& RequestedQueues() const;
+        const QueueTable<QueueFamily>& RequestedQueues() const;
         const QueueFamily&  GetQF(const QueueType qt) const;
         const vk::Queue&    GetQ (const QueueType qt) const;
 
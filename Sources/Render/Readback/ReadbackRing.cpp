@@ -0,0 +1,165 @@
+#include "ReadbackRing.hpp"
+#include "Device/Physical.hpp"
+
+#include <stdexcept>
+
+namespace Engine::Render::Readback {
+
+    namespace ERD = Engine::Render::Device;
+    namespace ERM = Engine::Render::Memory;
+
+    namespace {
+        const auto colorLayer{ vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, 1) };
+        const auto colorRange{ vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1) };
+
+        // The host reads every byte once, cached memory makes that a lot
+        // cheaper than write combined. Non coherent memory is invalidated.
+        vk::MemoryPropertyFlags ReadbackMemory(const ERD::PhysicalDevice& deviceInfo) {
+            const vk::MemoryPropertyFlags cached{ vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCached };
+            const auto memoryProperties{ deviceInfo.Get().getMemoryProperties() };
+
+            for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i) {
+                if ((memoryProperties.memoryTypes[i].propertyFlags & cached) == cached) {
+                    return cached;
+                }
+            }
+            return vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+        }
+    }
+
+    ReadbackRing::ReadbackRing(const ERD::PhysicalDevice& deviceInfo, const uint32_t slotCount) :
+        memoryFlags(ReadbackMemory(deviceInfo)),
+        slots(slotCount) {}
+
+    // Whatever last wrote the image, a render pass, dynamic rendering or
+    // the scaling blit, is waited on. Presentation reads after the copy
+    // the same way it would have after the write.
+    const bool ReadbackRing::RecordCopy(const vk::CommandBuffer& cmdBuffer, const ERD::DeviceDispatch& d, const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo,
+        const vk::Image& image, const vk::ImageLayout& layout, const vk::Extent2D& extent, const vk::Format& format, const uint64_t frameNumber) {
+
+        if (!callback || slots.empty()) return false;
+
+        auto& slot{ slots[next] };
+        if (slot.Pending) {
+            ++dropped;
+            return false;
+        }
+
+        const auto pixelBytes{ BytesPerPixel(format) };
+        if (pixelBytes == 0) {
+            throw std::runtime_error("Readback of an unsupported image format");
+        }
+
+        // Slots only grow, the previous copy out of this one was delivered
+        const vk::DeviceSize bytes{ vk::DeviceSize{ extent.width } * extent.height * pixelBytes };
+        if (slot.Buffer.Capacity() < bytes) {
+            slot.Buffer = ERM::DeviceMemory<uint8_t>(renderDevice, deviceInfo, vk::BufferCreateInfo()
+                .setSharingMode(vk::SharingMode::eExclusive)
+                .setSize(bytes)
+                .setUsage(vk::BufferUsageFlagBits::eTransferDst),
+                memoryFlags
+            );
+        }
+
+        cmdBuffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eColorAttachmentOutput | vk::PipelineStageFlagBits::eTransfer,
+            vk::PipelineStageFlagBits::eTransfer, {}, nullptr, nullptr,
+            vk::ImageMemoryBarrier()
+                .setSrcAccessMask(vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eTransferWrite)
+                .setDstAccessMask(vk::AccessFlagBits::eTransferRead)
+                .setOldLayout(layout)
+                .setNewLayout(vk::ImageLayout::eTransferSrcOptimal)
+                .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+                .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+                .setImage(image)
+                .setSubresourceRange(colorRange),
+            d);
+
+        cmdBuffer.copyImageToBuffer(image, vk::ImageLayout::eTransferSrcOptimal, *slot.Buffer.Buffer(),
+            vk::BufferImageCopy()
+                .setBufferOffset(0)
+                .setBufferRowLength(0)
+                .setBufferImageHeight(0)
+                .setImageSubresource(colorLayer)
+                .setImageOffset({ 0, 0, 0 })
+                .setImageExtent({ extent.width, extent.height, 1 }),
+            d);
+
+        cmdBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+            vk::PipelineStageFlagBits::eHost | vk::PipelineStageFlagBits::eBottomOfPipe, {}, nullptr,
+            vk::BufferMemoryBarrier()
+                .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+                .setDstAccessMask(vk::AccessFlagBits::eHostRead)
+                .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+                .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+                .setBuffer(*slot.Buffer.Buffer())
+                .setOffset(0)
+                .setSize(bytes),
+            vk::ImageMemoryBarrier()
+                .setSrcAccessMask(vk::AccessFlagBits::eTransferRead)
+                .setDstAccessMask({})
+                .setOldLayout(vk::ImageLayout::eTransferSrcOptimal)
+                .setNewLayout(layout)
+                .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+                .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+                .setImage(image)
+                .setSubresourceRange(colorRange),
+            d);
+
+        slot.Extent      = extent;
+        slot.Format      = format;
+        slot.FrameNumber = frameNumber;
+        slot.Pending     = true;
+        next = (next + 1) % static_cast<uint32_t>(slots.size());
+        return true;
+    }
+
+    void ReadbackRing::Collect(const vk::Device& renderDevice, const uint64_t completedFrame) {
+        const auto count{ static_cast<uint32_t>(slots.size()) };
+
+        for (uint32_t i = 0; i < count; ++i) {
+            auto& slot{ slots[(next + i) % count] };
+            if (!slot.Pending || slot.FrameNumber > completedFrame) continue;
+
+            slot.Pending = false;
+            if (!callback) continue;
+
+            slot.Buffer.Invalidate(renderDevice);
+
+            const auto pixelBytes{ BytesPerPixel(slot.Format) };
+            ReadbackFrame frame{};
+            frame.Pixels      = slot.Buffer.Mapped(renderDevice);
+            frame.Size        = vk::DeviceSize{ slot.Extent.width } * slot.Extent.height * pixelBytes;
+            frame.Extent      = slot.Extent;
+            frame.RowPitch    = slot.Extent.width * pixelBytes;
+            frame.Format      = slot.Format;
+            frame.FrameNumber = slot.FrameNumber;
+
+            callback(frame);
+            ++delivered;
+        }
+    }
+
+    const uint32_t BytesPerPixel(const vk::Format& format) {
+        switch (format) {
+        case vk::Format::eB8G8R8A8Unorm:
+        case vk::Format::eB8G8R8A8Srgb:
+        case vk::Format::eR8G8B8A8Unorm:
+        case vk::Format::eR8G8B8A8Srgb:
+        case vk::Format::eA8B8G8R8UnormPack32:
+        case vk::Format::eA8B8G8R8SrgbPack32:
+        case vk::Format::eA2B10G10R10UnormPack32:
+        case vk::Format::eA2R10G10B10UnormPack32:
+            return 4;
+        case vk::Format::eR16G16B16A16Sfloat:
+            return 8;
+        default:
+            return 0;
+        }
+    }
+
+    const bool ReadbackSupported(const ERD::PhysicalDevice& deviceInfo, const vk::SurfaceKHR& surface) {
+        const auto capabs{ deviceInfo.Get().getSurfaceCapabilitiesKHR(surface) };
+        return (capabs.supportedUsageFlags & vk::ImageUsageFlagBits::eTransferSrc) && BytesPerPixel(deviceInfo.SurfaceFormat().format) > 0;
+    }
+}
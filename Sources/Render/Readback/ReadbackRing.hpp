@@ -0,0 +1,94 @@
+#ifndef RENDER_READBACK_READBACK_RING_HPP
+#define RENDER_READBACK_READBACK_RING_HPP
+
+#include "VKinclude/VKinclude.hpp"
+#include "Memory/Buffers.hpp"
+#include "Device/Dispatch.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace Engine::Render::Device {
+    class PhysicalDevice;
+}
+
+namespace Engine::Render::Readback {
+
+    // One finished copy. Pixels point straight into the ring's mapped
+    // memory and are only valid during the callback, rows are tightly
+    // packed in Format, top row first.
+    struct ReadbackFrame {
+        const uint8_t*  Pixels      { nullptr };
+        vk::DeviceSize  Size        { 0 };
+        vk::Extent2D    Extent;
+        uint32_t        RowPitch    { 0 };          // Bytes
+        vk::Format      Format      { vk::Format::eUndefined };
+        uint64_t        FrameNumber { 0 };
+    };
+
+    using ReadbackCallback = std::function<void(const ReadbackFrame&)>;
+
+    // Copies rendered images into a ring of host visible buffers, cached
+    // where the device has such memory, and hands them to a callback once
+    // the frame that copied them has finished. Finished means the caller
+    // saw the frame's fence signal, nothing here ever waits on the GPU.
+    // With every slot still in flight the copy is skipped and counted as
+    // dropped, the frame itself goes on as usual.
+    class ReadbackRing {
+
+    private:
+        struct Slot {
+            Engine::Render::Memory::DeviceMemory<uint8_t> Buffer;
+            vk::Extent2D    Extent;
+            vk::Format      Format      { vk::Format::eUndefined };
+            uint64_t        FrameNumber { 0 };
+            bool            Pending     { false };
+        };
+
+        vk::MemoryPropertyFlags memoryFlags;
+        std::vector<Slot>       slots;
+        uint32_t                next        { 0 };      // Oldest slot, copies go there
+        ReadbackCallback        callback;
+        uint64_t                delivered   { 0 };
+        uint64_t                dropped     { 0 };
+
+    public:
+        ReadbackRing() = default;
+        // More slots than frames in flight keep copies from being dropped
+        ReadbackRing(const Engine::Render::Device::PhysicalDevice&, const uint32_t slotCount);
+
+        // No copies!
+        ReadbackRing(const ReadbackRing&) = delete;
+        ReadbackRing& operator=(const ReadbackRing&) = delete;
+
+        ReadbackRing(ReadbackRing&&) = default;
+        ReadbackRing& operator=(ReadbackRing&&) = default;
+
+        // Runs on the thread that calls Collect. An empty callback stops
+        // new copies, pending ones are thrown away as they finish.
+        void SetCallback(ReadbackCallback newCallback) { callback = std::move(newCallback); }
+        const bool Enabled() const { return static_cast<bool>(callback); }
+
+        // Call outside of rendering, once image is fully written. The image
+        // needs transfer source usage, it is left in layout as it was found.
+        // False if the copy was dropped.
+        const bool RecordCopy(const vk::CommandBuffer&, const Engine::Render::Device::DeviceDispatch&, const vk::Device&, const Engine::Render::Device::PhysicalDevice&,
+            const vk::Image& image, const vk::ImageLayout& layout, const vk::Extent2D& extent, const vk::Format& format, const uint64_t frameNumber);
+
+        // Delivers, oldest first, every copy made by frames up to and
+        // including completedFrame
+        void Collect(const vk::Device&, const uint64_t completedFrame);
+
+        const uint64_t Delivered()  const { return delivered; }
+        const uint64_t Dropped()    const { return dropped; }
+    };
+
+    // Bytes per texel of the color formats a surface may come in, 0 for anything else
+    const uint32_t BytesPerPixel(const vk::Format&);
+
+    // Whether this surface's swapchain images can be copied out of
+    const bool ReadbackSupported(const Engine::Render::Device::PhysicalDevice&, const vk::SurfaceKHR&);
+}
+
+#endif // !RENDER_READBACK_READBACK_RING_HPP
@@ -1,9 +1,11 @@
 #include "RenderPass.hpp"
 #include "Device/Physical.hpp"
 
+#include <array>
+
 namespace Engine::Render::RenderPass {
 
-    vk::UniqueRenderPass CreateRenderPass(const vk::Device& device, const ERD::PhysicalDevice& devInfo) {
+    vk::UniqueRenderPass CreateRenderPass(const vk::Device& device, const ERD::PhysicalDevice& devInfo, const vk::ImageLayout finalLayout) {
         const auto attachmentDescription{ vk::AttachmentDescription()
             .setFormat(devInfo.SurfaceFormat().format)
             .setSamples(vk::SampleCountFlagBits::e1)
@@ -12,7 +14,7 @@ namespace Engine::Render::RenderPass {
             .setStencilLoadOp(vk::AttachmentLoadOp::eDontCare)
             .setStencilStoreOp(vk::AttachmentStoreOp::eDontCare)
             .setInitialLayout(vk::ImageLayout::eUndefined)
-            .setFinalLayout(vk::ImageLayout::ePresentSrcKHR)
+            .setFinalLayout(finalLayout)
         };
 
         const auto attachmentReference{ vk::AttachmentReference()
@@ -26,22 +28,39 @@ namespace Engine::Render::RenderPass {
             .setPipelineBindPoint(vk::PipelineBindPoint::eGraphics)
         };
 
-        const auto subpassDependency{ vk::SubpassDependency()
+        // An offscreen target is still being blitted from by the previous frame
+        const bool blitted{ finalLayout == vk::ImageLayout::eTransferSrcOptimal };
+        const auto waitStages{ blitted
+            ? vk::PipelineStageFlagBits::eColorAttachmentOutput | vk::PipelineStageFlagBits::eTransfer
+            : vk::PipelineStageFlags(vk::PipelineStageFlagBits::eColorAttachmentOutput) };
+
+        const std::array<vk::SubpassDependency, 2> subpassDependencies{ vk::SubpassDependency()
             .setDstSubpass(0)
             .setSrcSubpass(VK_SUBPASS_EXTERNAL)
-            .setSrcStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput)
+            .setSrcStageMask(waitStages)
             .setSrcAccessMask(vk::AccessFlags())
             .setDstStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput)
-            .setDstAccessMask(vk::AccessFlagBits::eColorAttachmentRead | vk::AccessFlagBits::eColorAttachmentWrite)
+            .setDstAccessMask(vk::AccessFlagBits::eColorAttachmentRead | vk::AccessFlagBits::eColorAttachmentWrite),
+            // Blits read the attachment once the pass is done
+            vk::SubpassDependency()
+            .setSrcSubpass(0)
+            .setDstSubpass(VK_SUBPASS_EXTERNAL)
+            .setSrcStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput)
+            .setSrcAccessMask(vk::AccessFlagBits::eColorAttachmentWrite)
+            .setDstStageMask(vk::PipelineStageFlagBits::eTransfer)
+            .setDstAccessMask(vk::AccessFlagBits::eTransferRead)
         };
 
+        // Presenting is ordered by the semaphore, only the blit needs the second one
+        const uint32_t dependencyCount{ blitted ? 2u : 1u };
+
         const auto renderpassCreateInfo{ vk::RenderPassCreateInfo()
             .setAttachmentCount(1)
             .setPAttachments(&attachmentDescription)
             .setSubpassCount(1)
             .setPSubpasses(&subpass)
-            .setDependencyCount(1)
-            .setPDependencies(&subpassDependency)
+            .setDependencyCount(dependencyCount)
+            .setPDependencies(subpassDependencies.data())
         };
 
         return device.createRenderPassUnique(renderpassCreateInfo);
@@ -11,7 +11,9 @@ namespace Engine::Render::RenderPass {
 
     namespace ERD = Engine::Render::Device;
 
-    vk::UniqueRenderPass CreateRenderPass(const vk::Device& device, const ERD::PhysicalDevice& devInfo);
+    // finalLayout is ePresentSrcKHR when drawing into swapchain images, or
+    // eTransferSrcOptimal for an offscreen target that is blitted afterwards
+    vk::UniqueRenderPass CreateRenderPass(const vk::Device& device, const ERD::PhysicalDevice& devInfo, const vk::ImageLayout finalLayout = vk::ImageLayout::ePresentSrcKHR);
 
 }
 
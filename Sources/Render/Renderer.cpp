@@ -12,10 +12,16 @@
 #include "Command/Command.hpp"
 #include "Logger.hpp"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <iostream>
 #include <set>
+#include <stdexcept>
+#include <thread>
 
 template class Engine::Render::Memory::DeviceMemory<Engine::Primitives::Vertex>;
+template class Engine::Render::Memory::DeviceMemory<uint32_t>;
 
 namespace Engine::Render {
 
@@ -29,13 +35,38 @@ namespace Engine::Render {
     namespace ERRP  = Engine::Render::RenderPass;
     namespace ERCD  = Engine::Render::Command;
     namespace ERM   = Engine::Render::Memory;
+    namespace ERR   = Engine::Render::Resolution;
     namespace EP    = Engine::Primitives;
 
     auto ERQUG = ERQU::QueueType::Graphics;
 
+    // Upper bound on bytes copied out of mesh files per frame
+    constexpr uint64_t StreamingBudgetPerFrame{ 8ull << 20 };
+
+    // Room the geometry pool starts out with, it doubles whenever a mesh
+    // doesn't fit. 20 and 16 MB.
+    constexpr uint32_t InitialPoolVertices  { 1u << 20 };
+    constexpr uint32_t InitialPoolIndices   { 1u << 22 };
+
+    // Minimized, DrawFrame checks for the window coming back this often.
+    // Window events belong to the main thread, so it can't wait on those.
+    constexpr auto MinimizedPoll{ std::chrono::milliseconds(16) };
+
+    // Memory stats are dumped every this many frames in debug builds
+    constexpr uint64_t ResidencyDumpInterval{ 600 };
+#   ifdef BUILD_TYPE_DEBUG
+    const std::string ResidencyDumpPath{ "residency.json" };
+#   else
+    const std::string ResidencyDumpPath{};
+#   endif // BUILD_TYPE_DEBUG
+
     const char GetLevel(const vk::DebugUtilsMessageSeverityFlagBitsEXT& flags);
     const std::string GetType(const vk::DebugUtilsMessageTypeFlagsEXT& fl);
-    const std::map<ERQU::QueueType, int> GetNeededQueues();
+    const ERQU::QueueTable<int> GetNeededQueues();
+    vk::DeviceSize DefaultTextureBudget(const ERD::PhysicalDevice&);
+    vk::UniqueRenderPass LegacyRenderPass(const vk::Device&, const ERD::PhysicalDevice&, const bool scaled);
+    AttachmentLayout SwapchainAttachments(const ERD::PhysicalDevice&, const vk::RenderPass&, const vk::Format& depth);
+    vk::UniqueDescriptorSetLayout CreateFrameSetLayout(const vk::Device&, const ERD::PhysicalDevice&);
 
     const std::vector<Engine::Primitives::Vertex> vertices = {
         {{0.0f, -0.5f}, {1.0f, 0.0f, 0.0f}},
@@ -53,20 +84,49 @@ namespace Engine::Render {
         deviceInfo      (ERD::PickDevice              (renderInstance.get(),  renderSurface.get()           )),
         queues          (ERQU::QueueManager           (deviceInfo.Get(),      renderSurface.get(),   GetNeededQueues()   )),
         renderDevice    (ERDL::CreateLogicalDevice    (deviceInfo,            renderSurface.get(),   queues              )),
+        dispatch        (ERD::LoadDeviceDispatch      (renderInstance.get(),  renderDevice.get()                         )),
+        residency       (ERM::ResidencyManager        (renderDevice.get(),    deviceInfo,            ResidencyDumpPath,     ResidencyDumpInterval )),
+        resolution      (ERR::ResolutionController    (ERR::ResolutionSettings{}                                 )),
+        scaledRendering (resolution.Settings().Enabled && ERR::BlitSupported(deviceInfo, renderSurface.get())),
         swapchain       (ERSP::CreateSwapchain        (renderDevice.get(),    deviceInfo,            renderSurface.get() )),
         swapImages      (ERSP::GetSwapchainImages     (renderDevice.get(),    swapchain.get()                            )),
         swapImageViews  (ERSP::CreateImageViews       (renderDevice.get(),    deviceInfo,            swapImages          )),
-        renderPass      (ERRP::CreateRenderPass       (renderDevice.get(),    deviceInfo                                 )),
-        renderPipeline  (Pipeline                     (renderDevice.get(),    renderPass.get(),      deviceInfo.GetExtent2D(renderSurface.get()) )),
-        framebuffers    (ERSP::CreateFramebuffers     (renderDevice.get(),    renderPass.get(),      swapImageViews,                             deviceInfo.GetExtent2D(renderSurface.get())  )),
-        commandPools    (ERCD::CreateQueueCommandPool (renderDevice.get(),    queues                                     )),
-        commandBuffers  (ERCD::CreateCommandBuffers   (renderDevice.get(),    commandPools,          swapImageViews.size()))
+        renderPass      (LegacyRenderPass             (renderDevice.get(),    deviceInfo,            scaledRendering     )),
+        frameSetLayout  (CreateFrameSetLayout         (renderDevice.get(),    deviceInfo                                 )),
+        lighting        (Lighting::ClusteredLighting  (renderDevice.get(),    deviceInfo,            MaxFramesInFlight   )),
+        occlusion       (Culling::OcclusionCuller     (renderDevice.get(),    deviceInfo                                 )),
+        textureStreamer (std::make_unique<Texture::TextureStreamer>(renderDevice.get(), deviceInfo, queues[ERQUG], queues.GetQF(ERQUG), MaxFramesInFlight, DefaultTextureBudget(deviceInfo) )),
+        pipelineLibrary (PipelineLibrary              (renderDevice.get(),    deviceInfo                                 )),
+        renderPipeline  (pipelineLibrary.Build        (SwapchainAttachments(deviceInfo, renderPass.get(), occlusion.DepthFormat()), PipelineSetLayouts(), shaderVariants, shaderFeatures )),
+        clusters        (Meshlet::ClusterCuller       (renderDevice.get(),    deviceInfo,            SwapchainAttachments(deviceInfo, renderPass.get(), occlusion.DepthFormat()), PipelineSetLayouts() )),
+        transforms      (Transforms::TransformBuffer  (MaxFramesInFlight                                         )),
+        commandPools    (ERCD::CreateQueueCommandPool (renderDevice.get(),    queues,                vk::CommandPoolCreateFlagBits::eResetCommandBuffer )),
+        commandBuffers  (ERCD::CreateCommandBuffers   (renderDevice.get(),    commandPools,          MaxFramesInFlight   )),
+        gpuTimer        (ERR::GpuTimer                (renderDevice.get(),    deviceInfo,            queues.GetQF(ERQUG).Index, MaxFramesInFlight )),
+        geometry        (Geometry::GeometryPool       (renderDevice.get(),    deviceInfo,            InitialPoolVertices,       InitialPoolIndices )),
+        scenePasses     (ERCD::SecondaryCache         (renderDevice.get(),    queues.GetQF(ERQUG).Index, static_cast<uint32_t>(ScenePass::Count), MaxFramesInFlight )),
+        readback        (Readback::ReadbackRing       (deviceInfo,            MaxFramesInFlight + 1  ))
     {
-        p = ERM::DeviceMemory<EP::Vertex>(renderDevice.get(), deviceInfo, vk::BufferCreateInfo().setSharingMode(vk::SharingMode::eExclusive).setSize(EP::Vertex::Size(3)).setUsage(vk::BufferUsageFlagBits::eVertexBuffer), vk::MemoryPropertyFlagBits::eHostCoherent | vk::MemoryPropertyFlagBits::eHostVisible);
-        p.StagingBuffer() = vertices;
-        p.Map(renderDevice.get());
-        p.Unmap(renderDevice.get());
-        ERCD::RecordGraphicsCommandBuffers(commandBuffers[ERQU::QueueType::Graphics], framebuffers, renderPass.get(), renderPipeline, deviceInfo.GetExtent2D(renderSurface.get()), p);
+        sceneMesh          = geometry.Add(renderDevice.get(), deviceInfo, vertices);
+        geometryGeneration = geometry.Generation();
+
+        // Textures can always be streamed back in, so they go first
+        auto* textures{ textureStreamer.get() };
+        residency.Register({ "Textures", ERM::MemoryCategory::Textures, 0,
+            [textures](const vk::DeviceSize bytes) {
+                const auto before{ textures->Budget() };
+                textures->SetBudget(before - std::min(before, bytes));
+                return before - textures->Budget();
+            },
+            [textures]() {
+                textures->SetBudget(textures->Budget() + textures->DefaultBudget() / 16);
+            }
+        });
+        if (!scaledRendering) {
+            LOGGER << "Swapchain can't be blitted to, rendering at full resolution\n";
+        }
+        CreateSwapchainTargets();
+        CreateFrameResources();
         CreateSyncObjects();
     }
 
@@ -89,30 +149,71 @@ namespace Engine::Render {
         inFlightFences.clear();
     }
 
-    void Renderer::DrawFrame() {
+    void Renderer::DrawFrame(const FrameView& view) {
+        if (capture) capture->DrawFrame(view);
 
-        static int currentFrame{ 0 };
+        // Minimized, nothing to present to until the window comes back.
+        // Nothing this frame would do is needed either, so sleep instead.
+        if (swapchainStale) {
+            const auto extent{ deviceInfo.GetExtent2D(renderSurface.get()) };
 
-        vk::ResultValue<uint32_t> acquireResult{ vk::Result{}, 0 };
+            if (extent.width == 0 || extent.height == 0) {
+                std::this_thread::sleep_for(MinimizedPoll);
+                return;
+            }
+        }
+
+        // Once this slot's fence has signaled, every frame up to
+        // frameNumber - MaxFramesInFlight has finished on the GPU
+        renderDevice->waitForFences(1, &inFlightFences[currentFrame].get(), true, UINT64_MAX, dispatch);
 
-        try {
-            acquireResult = renderDevice->acquireNextImageKHR(swapchain.get(), UINT64_MAX, imageAvailableSemaphores[currentFrame].get(), nullptr);
-            renderDevice->waitForFences(1, &inFlightFences[acquireResult.value].get(), true, UINT64_MAX);
+        if (const auto gpuMs{ gpuTimer.Read(renderDevice.get(), dispatch, currentFrame) }) {
+            resolution.Update(*gpuMs);
         }
-        catch (const std::exception&) {
-            queues[ERQU::QueueType::Graphics].waitIdle();
+
+        if (frameNumber >= MaxFramesInFlight) {
+            deletionQueue.Collect(frameNumber - MaxFramesInFlight);
+            readback.Collect(renderDevice.get(), frameNumber - MaxFramesInFlight);
+        }
+        frameArenas[currentFrame].Reset();
+
+        PumpStreaming();
+        SwapOptimizedPipelines();
+        textureStreamer->Update(renderDevice.get(), dispatch, deviceInfo, deletionQueue, frameArenas[currentFrame], currentFrame, frameNumber);
+        residency.Update(deviceInfo, frameNumber);
+
+        if (swapchainStale) {
             ReInit();
+        }
+
+        uint32_t imageIndex{ 0 };
+        const auto acquired{ ERSP::AcquireNextImage(renderDevice.get(), dispatch, swapchain.get(), imageAvailableSemaphores[currentFrame].get(), imageIndex) };
+
+        // No image and the semaphore won't signal, try again next frame.
+        // A suboptimal image is still presentable, rebuild after this frame.
+        if (acquired == vk::Result::eErrorOutOfDateKHR) {
+            swapchainStale = true;
             return;
         }
+        if (acquired == vk::Result::eSuboptimalKHR) {
+            swapchainStale = true;
+        }
 
-        const auto imageIndex{ acquireResult.value };
+        // The slot's fence has signaled, so its uniforms and commands are free
+        *frameUniforms[currentFrame].Mapped(renderDevice.get()) = view;
 
-        static const auto stageMask { vk::PipelineStageFlags() |
-            vk::PipelineStageFlagBits::eColorAttachmentOutput };
+        const auto& cmdBuffer{ commandBuffers[ERQUG][currentFrame].get() };
+        RecordFrame(cmdBuffer, imageIndex, view);
+
+        // Scaled frames only touch the swapchain image in the blit, so
+        // drawing doesn't have to wait for the image to be acquired
+        const auto stageMask{ scaledRendering
+            ? vk::PipelineStageFlags(vk::PipelineStageFlagBits::eTransfer)
+            : vk::PipelineStageFlags(vk::PipelineStageFlagBits::eColorAttachmentOutput) };
 
         const auto submitInfo{ vk::SubmitInfo()
             .setCommandBufferCount(1)
-            .setPCommandBuffers(&commandBuffers[ERQU::QueueType::Graphics][imageIndex].get())
+            .setPCommandBuffers(&cmdBuffer)
             .setWaitSemaphoreCount(1)
             .setPWaitSemaphores(&imageAvailableSemaphores[currentFrame].get())
             .setSignalSemaphoreCount(1)
@@ -120,8 +221,8 @@ namespace Engine::Render {
             .setPWaitDstStageMask(&stageMask)
         };
 
-        renderDevice->resetFences(1, &inFlightFences[currentFrame].get());
-        queues[ERQU::QueueType::Graphics].submit(submitInfo, inFlightFences[currentFrame].get());
+        renderDevice->resetFences(1, &inFlightFences[currentFrame].get(), dispatch);
+        queues[ERQU::QueueType::Graphics].submit(submitInfo, inFlightFences[currentFrame].get(), dispatch);
 
         const auto presentInfo { vk::PresentInfoKHR()
             .setWaitSemaphoreCount(1)
@@ -131,65 +232,525 @@ namespace Engine::Render {
             .setPImageIndices(&imageIndex)
         };
 
-        try {
-            queues[ERQU::QueueType::Graphics].presentKHR(presentInfo);
+        if (ERSP::Present(queues[ERQU::QueueType::Graphics], dispatch, presentInfo) != vk::Result::eSuccess) {
+            swapchainStale = true;
         }
-        catch (const std::exception&) {
-            queues[ERQU::QueueType::Graphics].waitIdle();
-            ReInit();
-            return;
-        }
-
-        // TODO: Disable Vulkan exceptions and use if/else
 
+        ++frameNumber;
         currentFrame = (currentFrame + 1) % GetMaxFramesInFlight();
     }
 
-    const std::map<ERQU::QueueType, int> GetNeededQueues() {
-        return {
-            { ERQU::QueueType::Graphics, 1 }
-        };
+    const ERQU::QueueTable<int> GetNeededQueues() {
+        ERQU::QueueTable<int> needed{};
+        needed[ERQU::QueueType::Graphics] = 1;
+        return needed;
+    }
+
+    // Half the largest device local heap, the rest is for everything else
+    vk::DeviceSize DefaultTextureBudget(const ERD::PhysicalDevice& deviceInfo) {
+        const auto memoryProperties{ deviceInfo.Get().getMemoryProperties() };
+
+        vk::DeviceSize largest{ 0 };
+        for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; ++i) {
+            if (memoryProperties.memoryHeaps[i].flags & vk::MemoryHeapFlagBits::eDeviceLocal) {
+                largest = std::max(largest, memoryProperties.memoryHeaps[i].size);
+            }
+        }
+
+        return largest / 2;
+    }
+
+    void Renderer::SurfaceResized() {
+        if (capture) capture->SurfaceResized();
+        swapchainStale = true;
     }
 
     void Renderer::WaitDevice() {
         renderDevice->waitIdle();
+        deletionQueue.Flush();
+        // Everything submitted has finished, the last frames come out too
+        readback.Collect(renderDevice.get(), frameNumber);
     }
 
+    void Renderer::SetFrameReadback(Readback::ReadbackCallback callback) {
+        if (callback && !Readback::ReadbackSupported(deviceInfo, renderSurface.get())) {
+            throw std::runtime_error("Swapchain images of this surface can't be read back");
+        }
+        readback.SetCallback(std::move(callback));
+    }
+
+    // Settings go in first, the replay starts out like this renderer did
+    void Renderer::StartCapture(const std::string& path) {
+        capture = std::make_unique<Capture::CaptureWriter>(path);
+        capture->SetResolution(resolution.Settings());
+        capture->SetCommandReuse(commandReuse);
+        capture->SetShaderFeatures(shaderFeatures);
+        LOGGER << "Capturing to \"" << path << "\"\n";
+    }
+
+    void Renderer::StopCapture() {
+        if (!capture) return;
+
+        capture->Flush();
+        LOGGER << "Captured " << capture->Frames() << " frames, " << capture->Bytes() << " bytes\n";
+        capture.reset();
+    }
+
+    void Renderer::SetResolution(const ERR::ResolutionSettings& settings) {
+        if (capture) capture->SetResolution(settings);
+        resolution = ERR::ResolutionController(settings);
+        const bool scaled{ resolution.Settings().Enabled && ERR::BlitSupported(deviceInfo, renderSurface.get()) };
+
+        // Render passes bake in where the image goes next
+        if (scaled != scaledRendering && renderPass) {
+            deletionQueue.Retire(std::move(renderPass), frameNumber);
+            renderPass      = LegacyRenderPass(renderDevice.get(), deviceInfo, scaled);
+            RebuildPipelines();
+            ++sceneVersion;
+        }
+
+        scaledRendering = scaled;
+        swapchainStale  = true;
+    }
+
+    void Renderer::UpdateVertices(const std::vector<EP::Vertex>& vertices) {
+        if (capture) capture->UpdateVertices(vertices);
+
+        geometry.Remove(sceneMesh);
+        sceneMesh = geometry.Add(renderDevice.get(), deviceInfo, vertices);
+        drawObjects.clear();
+        UploadDrawObjects();
+        clusters.Clear(deletionQueue, frameNumber);
+        geometryGeneration = geometry.Generation();
+    }
+
+    void Renderer::SetDrawObjects(const std::vector<Culling::DrawObject>& objects) {
+        if (capture) capture->SetDrawObjects(objects);
+
+        drawObjects = objects;
+        UploadDrawObjects();
+    }
+
+    // The culler draws straight out of the pool, ranges move to where the
+    // mesh sits in it
+    void Renderer::UploadDrawObjects() {
+        const auto range{ geometry.Range(sceneMesh) };
+
+        auto pooled{ drawObjects };
+        for (auto& object : pooled) {
+            object.FirstIndex   += range.FirstIndex;
+            object.VertexOffset += static_cast<int32_t>(range.FirstVertex);
+        }
+        occlusion.SetObjects(renderDevice.get(), deviceInfo, pooled, deletionQueue, frameNumber);
+        ++sceneVersion;
+    }
+
+    // Compaction or growth moved every range in the pool, the cullers still
+    // hold the old ones
+    void Renderer::SyncGeometry() {
+        if (geometry.Generation() == geometryGeneration) return;
+        geometryGeneration = geometry.Generation();
+
+        UploadDrawObjects();
+        clusters.SetVertices(renderDevice.get(), geometry.VertexBuffer(), geometry.Range(sceneMesh).FirstVertex, deletionQueue, frameNumber);
+    }
+
+    void Renderer::LoadMesh(const std::string& path, const uint32_t mesh, const uint32_t lod) {
+        if (capture) capture->LoadMesh(path, mesh, lod);
+        meshStreamer = std::make_unique<Mesh::MeshStreamer>(path);
+        meshStreamer->Request(mesh, lod);
+    }
+
+    uint32_t Renderer::LoadTexture(const std::string& path) {
+        if (capture) capture->LoadTexture(path);
+        return textureStreamer->Load(renderDevice.get(), deviceInfo, path);
+    }
+
+    void Renderer::PumpStreaming() {
+        if (!meshStreamer) return;
+
+        auto finished{ meshStreamer->Pump(renderDevice.get(), deviceInfo, StreamingBudgetPerFrame) };
+
+        if (!finished.empty()) {
+            // Only one mesh is drawn for now, take the latest
+            auto& mesh{ finished.back() };
+            geometry.Remove(sceneMesh);
+            sceneMesh = geometry.Add(renderDevice.get(), deviceInfo, std::move(mesh.Vertices), std::move(mesh.Indices));
+
+            const auto range{ geometry.Range(sceneMesh) };
+            clusters.SetGeometry(renderDevice.get(), deviceInfo, mesh, geometry.VertexBuffer(), range.FirstVertex, deletionQueue, frameNumber);
+
+            Culling::DrawObject whole{};
+            whole.Min        = glm::vec3(mesh.Volume.Min[0], mesh.Volume.Min[1], mesh.Volume.Min[2]);
+            whole.Max        = glm::vec3(mesh.Volume.Max[0], mesh.Volume.Max[1], mesh.Volume.Max[2]);
+            whole.IndexCount = range.IndexCount;
+            drawObjects = { whole };
+            UploadDrawObjects();
+            geometryGeneration = geometry.Generation();
+        }
+
+        if (meshStreamer->Idle()) {
+            meshStreamer.reset();
+        }
+    }
+
+    // Dynamic rendering needs no render pass, pipelines are built against the
+    // attachment formats and frames render straight into the target views
+    vk::UniqueRenderPass LegacyRenderPass(const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo, const bool scaled) {
+        if (deviceInfo.SupportsDynamicRendering()) {
+            return {};
+        }
+        LOGGER << "Dynamic rendering not supported, using render passes\n";
+        return ERRP::CreateRenderPass(renderDevice, deviceInfo, scaled ? vk::ImageLayout::eTransferSrcOptimal : vk::ImageLayout::ePresentSrcKHR);
+    }
+
+    // Depth only comes with dynamic rendering, the legacy pass has no depth attachment
+    AttachmentLayout SwapchainAttachments(const ERD::PhysicalDevice& deviceInfo, const vk::RenderPass& renderPass, const vk::Format& depth) {
+        return { deviceInfo.SurfaceFormat().format, renderPass ? vk::Format::eUndefined : depth, renderPass };
+    }
+
+    // Mesh shaders transform the meshlet vertices themselves
+    vk::UniqueDescriptorSetLayout CreateFrameSetLayout(const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo) {
+        auto stages{ vk::ShaderStageFlags(vk::ShaderStageFlagBits::eVertex) };
+        if (deviceInfo.SupportsMeshShaders()) {
+            stages |= vk::ShaderStageFlagBits::eMeshEXT;
+        }
+
+        const auto binding{ vk::DescriptorSetLayoutBinding()
+            .setBinding(0)
+            .setDescriptorType(vk::DescriptorType::eUniformBuffer)
+            .setDescriptorCount(1)
+            .setStageFlags(stages)
+        };
+
+        return renderDevice.createDescriptorSetLayoutUnique(vk::DescriptorSetLayoutCreateInfo()
+            .setBindingCount(1)
+            .setPBindings(&binding)
+        );
+    }
+
+    // One uniform buffer and set per frame in flight, written right before
+    // that frame's submit. Host coherent and mapped for good.
+    void Renderer::CreateFrameResources() {
+        const auto imageCount{ static_cast<uint32_t>(MaxFramesInFlight) };
+
+        const auto poolSize{ vk::DescriptorPoolSize()
+            .setType(vk::DescriptorType::eUniformBuffer)
+            .setDescriptorCount(imageCount)
+        };
+
+        framePool = renderDevice->createDescriptorPoolUnique(vk::DescriptorPoolCreateInfo()
+            .setMaxSets(imageCount)
+            .setPoolSizeCount(1)
+            .setPPoolSizes(&poolSize)
+        );
+
+        const std::vector<vk::DescriptorSetLayout> layouts(imageCount, frameSetLayout.get());
+        frameSets = renderDevice->allocateDescriptorSets(vk::DescriptorSetAllocateInfo()
+            .setDescriptorPool(framePool.get())
+            .setDescriptorSetCount(imageCount)
+            .setPSetLayouts(layouts.data())
+        );
+
+        frameUniforms.clear();
+        for (uint32_t i = 0; i < imageCount; ++i) {
+            frameUniforms.emplace_back(renderDevice.get(), deviceInfo, vk::BufferCreateInfo()
+                .setSharingMode(vk::SharingMode::eExclusive)
+                .setSize(sizeof(FrameView))
+                .setUsage(vk::BufferUsageFlagBits::eUniformBuffer),
+                vk::MemoryPropertyFlagBits::eHostCoherent | vk::MemoryPropertyFlagBits::eHostVisible
+            );
+            *frameUniforms.back().Mapped(renderDevice.get()) = FrameView{};
+
+            const auto bufferInfo{ vk::DescriptorBufferInfo()
+                .setBuffer(*frameUniforms.back().Buffer())
+                .setOffset(0)
+                .setRange(sizeof(FrameView))
+            };
+
+            renderDevice->updateDescriptorSets(vk::WriteDescriptorSet()
+                .setDstSet(frameSets[i])
+                .setDstBinding(0)
+                .setDescriptorCount(1)
+                .setDescriptorType(vk::DescriptorType::eUniformBuffer)
+                .setPBufferInfo(&bufferInfo),
+                nullptr
+            );
+        }
+    }
+
+    void Renderer::ReloadPipeline() {
+        if (capture) capture->ReloadPipeline();
+        // Read the shader files again
+        shaderVariants.Clear();
+        RebuildPipelines();
+        ++sceneVersion;
+    }
+
+    // The variants switched away from and the library parts would be stale
+    // too, they're dropped and built again when asked for
+    void Renderer::RebuildPipelines() {
+        deletionQueue.Retire(std::move(renderPipeline), frameNumber);
+        for (auto& [features, pipeline] : idlePipelines) {
+            deletionQueue.Retire(std::move(pipeline), frameNumber);
+        }
+        idlePipelines.clear();
+        pipelineLibrary.Clear(deletionQueue, frameNumber);
+
+        renderPipeline = pipelineLibrary.Build(SwapchainAttachments(deviceInfo, renderPass.get(), occlusion.DepthFormat()), PipelineSetLayouts(), shaderVariants, shaderFeatures);
+        clusters.ReloadPipeline(renderDevice.get(), SwapchainAttachments(deviceInfo, renderPass.get(), occlusion.DepthFormat()), PipelineSetLayouts(), deletionQueue, frameNumber, shaderFeatures);
+    }
+
+    // The new pipeline is built before anything changes, a variant that
+    // isn't compiled throws and leaves the current one drawing. The old
+    // one may still be in flight, it's only parked. Cached scene passes
+    // key on the pipeline handle and are recorded again. The streamed
+    // texture variant samples the latest loaded texture and writes its
+    // feedback, so it needs one loaded and fragment stores.
+    void Renderer::SetShaderFeatures(const Shader::FeatureKey features) {
+        if (features & Shader::Features::StreamedTexture) {
+            if (textureStreamer->Count() == 0) {
+                throw std::runtime_error("Streamed texture variant needs a loaded texture");
+            }
+            if (!deviceInfo.Get().getFeatures().fragmentStoresAndAtomics) {
+                throw std::runtime_error("Streamed texture variant needs fragmentStoresAndAtomics");
+            }
+        }
+
+        if (capture) capture->SetShaderFeatures(features);
+        if (features == shaderFeatures) return;
+
+        auto idle{ idlePipelines.extract(features) };
+        auto pipeline{ idle
+            ? std::move(idle.mapped())
+            : pipelineLibrary.Build(SwapchainAttachments(deviceInfo, renderPass.get(), occlusion.DepthFormat()), PipelineSetLayouts(), shaderVariants, features) };
+
+        idlePipelines.emplace(shaderFeatures, std::move(renderPipeline));
+        renderPipeline = std::move(pipeline);
+        shaderFeatures = features;
+        clusters.ReloadPipeline(renderDevice.get(), SwapchainAttachments(deviceInfo, renderPass.get(), occlusion.DepthFormat()), PipelineSetLayouts(), deletionQueue, frameNumber, shaderFeatures);
+    }
+
+    // Optimized links finish on the library's thread. The quick pipeline
+    // they replace may still be in flight, so it's retired. Cached scene
+    // passes key on the pipeline handle and are recorded again.
+    void Renderer::SwapOptimizedPipelines() {
+        auto features{ Shader::Features::None };
+        Pipeline optimized{};
+
+        while (pipelineLibrary.TakeOptimized(features, optimized)) {
+            if (features == shaderFeatures) {
+                deletionQueue.Retire(std::move(renderPipeline), frameNumber);
+                renderPipeline = std::move(optimized);
+                continue;
+            }
+
+            const auto idle{ idlePipelines.find(features) };
+            if (idle != idlePipelines.end()) {
+                deletionQueue.Retire(std::move(idle->second), frameNumber);
+                idle->second = std::move(optimized);
+            }
+        }
+    }
+
+    void Renderer::SetCommandReuse(const bool enabled) {
+        if (capture) capture->SetCommandReuse(enabled);
+        if (enabled && !commandReuse) {
+            scenePasses.Invalidate();
+        }
+        commandReuse = enabled;
+    }
+
+    const std::vector<vk::DescriptorSetLayout> Renderer::PipelineSetLayouts() const {
+        return { frameSetLayout.get(), lighting.SetLayout(), textureStreamer->SetLayout() };
+    }
+
+    // Recorded fresh every frame, the render area changes with the scale.
+    // Only scene passes may be replayed, see RecordCulledScene. Whatever
+    // they reference is retired, never destroyed, while in flight.
+    void Renderer::RecordFrame(const vk::CommandBuffer& cmdBuffer, const uint32_t imageIndex, const FrameView& view) {
+        const auto slot{ static_cast<uint32_t>(currentFrame) };
+        const auto area{ scaledRendering ? resolution.Apply(swapExtent) : swapExtent };
+        const bool textured{ (shaderFeatures & Shader::Features::StreamedTexture) != 0 };
+        const std::array<vk::DescriptorSet, 3> allSets{ frameSets[slot], lighting.Set(slot), textured ? textureStreamer->Set(textureStreamer->Count() - 1, slot) : vk::DescriptorSet() };
+        const vk::ArrayProxy<const vk::DescriptorSet> sets(textured ? 3u : 2u, allSets.data());
+
+        lighting.Prepare(renderDevice.get(), slot, view.View, view.Projection, area);
+        transforms.Prepare(renderDevice.get(), deviceInfo, slot, deletionQueue, frameNumber);
+        geometry.Prepare(renderDevice.get(), deviceInfo);
+        SyncGeometry();
+
+        cmdBuffer.begin(vk::CommandBufferBeginInfo()
+            .setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit),
+            dispatch
+        );
+        gpuTimer.Begin(cmdBuffer, dispatch, slot);
+        lighting.RecordCulling(cmdBuffer, dispatch, slot);
+        transforms.RecordUpload(cmdBuffer, dispatch, slot);
+        geometry.RecordUploads(cmdBuffer, dispatch, deletionQueue, frameNumber);
+
+        if (scaledRendering) {
+            const ERCD::FrameTarget target{ renderTarget.Image.get(), renderTarget.View.get(), renderTarget.Framebuffer.get(), renderPass.get(), area, vk::ImageLayout::eTransferSrcOptimal, occlusion.DepthImage(), occlusion.DepthView() };
+
+            RecordCulledScene(cmdBuffer, target, sets, view);
+            ERCD::BlitToSwapchain(cmdBuffer, dispatch, renderTarget.Image.get(), area, swapImages[imageIndex], swapExtent);
+        }
+        else {
+            const auto framebuffer{ renderPass ? framebuffers[imageIndex].get() : vk::Framebuffer() };
+            const ERCD::FrameTarget target{ swapImages[imageIndex], swapImageViews[imageIndex].get(), framebuffer, renderPass.get(), area, vk::ImageLayout::ePresentSrcKHR, occlusion.DepthImage(), occlusion.DepthView() };
+
+            RecordCulledScene(cmdBuffer, target, sets, view);
+        }
+
+        if (textured) {
+            textureStreamer->RecordFeedbackBarrier(cmdBuffer, dispatch);
+        }
+
+        // Whatever ends up on screen, after the blit when scaled
+        readback.RecordCopy(cmdBuffer, dispatch, renderDevice.get(), deviceInfo, swapImages[imageIndex], vk::ImageLayout::ePresentSrcKHR, swapExtent, deviceInfo.SurfaceFormat().format, frameNumber);
+
+        gpuTimer.End(cmdBuffer, dispatch, slot);
+        cmdBuffer.end(dispatch);
+    }
+
+    // Meshes with meshlets are culled per meshlet in a single pass, see
+    // Meshlet/ClusterCuller.hpp. Anything else takes two passes over the
+    // same target with the depth pyramid rebuilt in between, see
+    // Culling/OcclusionCuller.hpp. Render passes, unindexed geometry and an
+    // empty draw list take the plain single pass.
+    //
+    // Culling stays in the frame's own commands. The draws only read what
+    // culling wrote, so with command reuse they are recorded once and
+    // replayed until the scene, pipeline, sets or area change.
+    void Renderer::RecordCulledScene(const vk::CommandBuffer& cmdBuffer, const ERCD::FrameTarget& target, const vk::ArrayProxy<const vk::DescriptorSet>& sets, const FrameView& view) {
+        const auto key{ ScenePassKey(sets) };
+
+        if (!target.RenderPass && clusters.Active()) {
+            clusters.RecordCull(cmdBuffer, dispatch, view.Transform);
+
+            ERCD::BeginScene(cmdBuffer, dispatch, target, false, commandReuse);
+            RecordPass(cmdBuffer, target, ScenePass::Clusters, ERCD::CombineKey(key, clusters.DrawKey()), sets);
+            ERCD::EndScene(cmdBuffer, dispatch, target);
+            return;
+        }
+
+        if (target.RenderPass || !occlusion.Active() || geometry.Range(sceneMesh).IndexCount == 0) {
+            ERCD::BeginScene(cmdBuffer, dispatch, target, false, commandReuse);
+            RecordPass(cmdBuffer, target, ScenePass::Plain, key, sets);
+            ERCD::EndScene(cmdBuffer, dispatch, target);
+            return;
+        }
+
+        for (uint32_t phase = 0; phase < 2; ++phase) {
+            if (phase == 1) {
+                occlusion.RecordPyramid(cmdBuffer, dispatch, target.Area);
+            }
+            occlusion.RecordCull(cmdBuffer, dispatch, phase, view.Transform, target.Area);
+
+            ERCD::BeginScene(cmdBuffer, dispatch, target, phase == 1, commandReuse);
+            RecordPass(cmdBuffer, target, phase == 0 ? ScenePass::Early : ScenePass::Late, key, sets);
+            ERCD::EndScene(cmdBuffer, dispatch, target, phase == 1);
+        }
+    }
+
+    // Inside BeginScene/EndScene, begun for secondaries with command reuse on
+    void Renderer::RecordPass(const vk::CommandBuffer& cmdBuffer, const ERCD::FrameTarget& target, const ScenePass pass, const uint64_t key, const vk::ArrayProxy<const vk::DescriptorSet>& sets) {
+        if (!commandReuse) {
+            RecordPassDraws(cmdBuffer, pass, sets);
+            return;
+        }
+
+        const auto layout{ SwapchainAttachments(deviceInfo, target.RenderPass, occlusion.DepthFormat()) };
+        const auto secondary{ scenePasses.Acquire(dispatch, static_cast<uint32_t>(pass), static_cast<uint32_t>(currentFrame), frameNumber, key, layout, target.Area) };
+
+        if (secondary.Record) {
+            RecordPassDraws(secondary.Buffer, pass, sets);
+            secondary.Buffer.end(dispatch);
+        }
+        cmdBuffer.executeCommands(secondary.Buffer, dispatch);
+    }
+
+    void Renderer::RecordPassDraws(const vk::CommandBuffer& cmdBuffer, const ScenePass pass, const vk::ArrayProxy<const vk::DescriptorSet>& sets) {
+        ERCD::BindPipeline(cmdBuffer, dispatch, sets, renderPipeline);
+        geometry.Bind(cmdBuffer, dispatch);
+
+        switch (pass) {
+        case ScenePass::Clusters:
+            clusters.RecordDraws(cmdBuffer, dispatch, sets);
+            break;
+        case ScenePass::Early:
+        case ScenePass::Late:
+            occlusion.RecordDraws(cmdBuffer, dispatch, pass == ScenePass::Late ? 1 : 0);
+            break;
+        default:
+            geometry.Draw(cmdBuffer, dispatch, sceneMesh);
+            break;
+        }
+    }
+
+    // Everything the scene passes record besides per pass extras. Pool
+    // moves, new draw objects and rebuilt pipelines bump the versions,
+    // sets are compared by handle since lighting may replace its own.
+    const uint64_t Renderer::ScenePassKey(const vk::ArrayProxy<const vk::DescriptorSet>& sets) {
+        auto key{ ERCD::CombineKey(sceneVersion, geometry.Generation()) };
+        key = ERCD::CombineKey(key, ERCD::HandleKey(renderPipeline.GetPipeline()));
+        for (const auto& set : sets) {
+            key = ERCD::CombineKey(key, ERCD::HandleKey(set));
+        }
+        return key;
+    }
+
+    // The surface format doesn't change, so the render pass and pipeline
+    // outlive the swapchain
     void Renderer::RecreateSwapchain() {
-        swapchain       = ERSP::CreateSwapchain(renderDevice.get(), deviceInfo, renderSurface.get(), swapchain.get());
         swapImages      = ERSP::GetSwapchainImages(renderDevice.get(), swapchain.get());
         swapImageViews  = ERSP::CreateImageViews(renderDevice.get(), deviceInfo, swapImages);
-        renderPass      = ERRP::CreateRenderPass(renderDevice.get(), deviceInfo);
-        renderPipeline  = Pipeline(renderDevice.get(), renderPass.get(), deviceInfo.GetExtent2D(renderSurface.get()));
-        framebuffers    = ERSP::CreateFramebuffers(renderDevice.get(), renderPass.get(), swapImageViews, deviceInfo.GetExtent2D(renderSurface.get()));
-        commandPools    = ERCD::CreateQueueCommandPool(renderDevice.get(), queues);
-        commandBuffers  = ERCD::CreateCommandBuffers(renderDevice.get(), commandPools, swapImageViews.size());
-        ERCD::RecordGraphicsCommandBuffers(commandBuffers[ERQU::QueueType::Graphics], framebuffers, renderPass.get(), renderPipeline, deviceInfo.GetExtent2D(renderSurface.get()), p);
+        CreateSwapchainTargets();
     }
 
+    // Scaled frames draw into a target sized for the largest scale,
+    // otherwise the legacy path needs a framebuffer per image
+    void Renderer::CreateSwapchainTargets() {
+        swapExtent = deviceInfo.GetExtent2D(renderSurface.get());
 
+        if (scaledRendering) {
+            renderTarget = ERR::CreateRenderTarget(renderDevice.get(), deviceInfo, resolution.Capacity(swapExtent), renderPass.get());
+        }
+        else if (renderPass) {
+            framebuffers = ERSP::CreateFramebuffers(renderDevice.get(), renderPass.get(), swapImageViews, swapExtent);
+        }
+
+        if (!renderPass) {
+            occlusion.Resize(renderDevice.get(), deviceInfo, scaledRendering ? renderTarget.Extent : swapExtent, deletionQueue, frameNumber);
+        }
+    }
+
+
+    // Nothing here is destroyed right away, frames in flight may still
+    // reference it. The old swapchain is kept alive by the queue too,
+    // RecreateSwapchain passes it on as oldSwapchain.
     void Renderer::CleanupSwapchain() {
-        commandBuffers.clear();
-        commandPools.clear();
+        deletionQueue.Retire(std::move(framebuffers), frameNumber);
+        deletionQueue.Retire(std::move(renderTarget), frameNumber);
+        deletionQueue.Retire(std::move(swapImageViews), frameNumber);
         framebuffers.clear();
-        renderPass.reset();
         swapImageViews.clear();
         swapImages.clear();
-        swapchain.reset();
     }
 
     const int Renderer::GetMaxFramesInFlight() {
-        assert(swapImages.size() > 0 || 0 == "Swap Images size is zero!");
-        return static_cast<int>(swapImages.size());
+        return MaxFramesInFlight;
     }
 
     // Better name would be nice. 
     void Renderer::ReInit() {
-        DestroySyncObjects();
-        WaitDevice();
+        auto oldSwapchain{ std::move(swapchain) };
+
         CleanupSwapchain();
+        swapchain = ERSP::CreateSwapchain(renderDevice.get(), deviceInfo, renderSurface.get(), oldSwapchain.get());
+        deletionQueue.Retire(std::move(oldSwapchain), frameNumber);
         RecreateSwapchain();
-        CreateSyncObjects();
+        swapchainStale = false;
     }
 
     // Utility functions
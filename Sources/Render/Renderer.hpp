@@ -4,12 +4,36 @@
 
 #include "VKinclude/VKinclude.hpp"
 #include "Device/Physical.hpp"
+#include "Device/Dispatch.hpp"
 #include "Pipeline/Pipeline.hpp"
+#include "Pipeline/PipelineLibrary.hpp"
+#include "Command/Command.hpp"
+#include "Command/SecondaryCache.hpp"
 #include "Queue/Queue.hpp"
 #include "Memory/Buffers.hpp"
+#include "Memory/DeletionQueue.hpp"
+#include "Memory/LinearArena.hpp"
+#include "Memory/Residency.hpp"
+#include "Mesh/MeshStreamer.hpp"
+#include "Texture/TextureStreamer.hpp"
+#include "Resolution/ResolutionController.hpp"
+#include "Resolution/GpuTimer.hpp"
+#include "Resolution/RenderTarget.hpp"
+#include "Lighting/ClusteredLighting.hpp"
+#include "Culling/OcclusionCuller.hpp"
+#include "Meshlet/ClusterCuller.hpp"
+#include "Transforms/TransformBuffer.hpp"
+#include "Geometry/GeometryPool.hpp"
+#include "Readback/ReadbackRing.hpp"
+#include "Capture/CaptureWriter.hpp"
 #include "Primitives/Vertex.hpp"
+#include "FrameView.hpp"
 #include "Version.hpp"
 
+#include <glm/glm.hpp>
+
+#include <unordered_map>
+
 
 struct GLFWwindow;
 typedef GLFWwindow WindowHandle;
@@ -25,13 +49,19 @@ namespace Engine::Render {
         using UniqueDebugMessenger  = vk::UniqueDebugUtilsMessengerEXT;
         using UniqueImageViews      = std::vector<vk::UniqueImageView>;
         using UniqueFramebuffers    = std::vector<vk::UniqueFramebuffer>;
-        using UniqueCommandPools    = std::map<ERQU::QueueType, vk::UniqueCommandPool>;
-        using UniqueCommandBuffers  = std::map<ERQU::QueueType, std::vector<vk::UniqueCommandBuffer>>;
+        using UniqueCommandPools    = ERQU::QueueTable<vk::UniqueCommandPool>;
+        using UniqueCommandBuffers  = ERQU::QueueTable<std::vector<vk::UniqueCommandBuffer>>;
         using UniqueImagesSemaphore = std::vector<vk::UniqueSemaphore>;
         using UniqueRenderSemaphore = std::vector<vk::UniqueSemaphore>;
         using UniqueImageFences     = std::vector<vk::UniqueFence>;
         using UniqueRenderFences    = std::vector<vk::UniqueFence>;
 
+        static constexpr int MaxFramesInFlight{ 2 };
+
+        // Scene passes kept as secondaries with command reuse on, one per
+        // way RecordCulledScene draws
+        enum class ScenePass : uint32_t { Plain, Early, Late, Clusters, Count };
+
         vk::UniqueInstance          renderInstance;
 #       ifdef BUILD_TYPE_DEBUG
         UniqueDebugMessenger        debugMessenger;
@@ -40,18 +70,53 @@ namespace Engine::Render {
         ERD::PhysicalDevice         deviceInfo;
         ERQU::QueueManager          queues;
         vk::UniqueDevice            renderDevice;
+        ERD::DeviceDispatch         dispatch;
+        Memory::DeletionQueue       deletionQueue;
+        Memory::ResidencyManager    residency;
+        Resolution::ResolutionController resolution;
+        bool                        scaledRendering{ false };   // Draw into renderTarget and blit
         vk::UniqueSwapchainKHR      swapchain;
         std::vector<vk::Image>      swapImages;
         UniqueImageViews            swapImageViews;
+        vk::Extent2D                swapExtent;
         vk::UniqueRenderPass        renderPass;
+        vk::UniqueDescriptorSetLayout frameSetLayout;
+        Lighting::ClusteredLighting lighting;
+        Culling::OcclusionCuller    occlusion;
+        Shader::VariantCache        shaderVariants;
+        Shader::FeatureKey          shaderFeatures{ Shader::Features::None };
+        std::unique_ptr<Texture::TextureStreamer> textureStreamer;     // Its set layout is part of the pipelines'
+        PipelineLibrary             pipelineLibrary;
         Pipeline                    renderPipeline;
+        std::unordered_map<Shader::FeatureKey, Pipeline> idlePipelines;     // Variants switched away from
+        Meshlet::ClusterCuller      clusters;
+        Transforms::TransformBuffer transforms;
         UniqueFramebuffers          framebuffers;
+        Resolution::RenderTarget    renderTarget;
         UniqueCommandPools          commandPools;
         UniqueCommandBuffers        commandBuffers;
+        Resolution::GpuTimer        gpuTimer;
+        vk::UniqueDescriptorPool    framePool;
+        std::vector<vk::DescriptorSet> frameSets;
+        std::vector<Memory::DeviceMemory<FrameView>> frameUniforms;
         UniqueImagesSemaphore       imageAvailableSemaphores;
         UniqueRenderSemaphore       renderFinishedSemaphores;
         UniqueImageFences           inFlightFences;
-        Engine::Render::Memory::DeviceMemory<Engine::Primitives::Vertex> p;
+        std::array<Memory::LinearArena, MaxFramesInFlight> frameArenas;
+        Geometry::GeometryPool      geometry;
+        Geometry::MeshHandle        sceneMesh{ Geometry::NoMesh };
+        uint64_t                    geometryGeneration{ 0 };    // Of the ranges handed to the cullers
+        std::vector<Culling::DrawObject> drawObjects;           // Relative to sceneMesh
+        Command::SecondaryCache     scenePasses;
+        Readback::ReadbackRing      readback;
+        bool                        commandReuse{ false };
+        uint64_t                    sceneVersion{ 0 };          // Bumped when cached passes go stale
+        std::unique_ptr<Mesh::MeshStreamer> meshStreamer;
+        std::unique_ptr<Capture::CaptureWriter> capture;
+
+        int                         currentFrame{ 0 };
+        uint64_t                    frameNumber{ 0 };
+        bool                        swapchainStale{ false };
 
         // No copies!
         Renderer(const Renderer&) = delete;
@@ -60,8 +125,21 @@ namespace Engine::Render {
         void CreateSyncObjects();
         void DestroySyncObjects();
         void RecreateSwapchain();
+        void CreateSwapchainTargets();
         void CleanupSwapchain();
         void ReInit();
+        void RecordFrame(const vk::CommandBuffer& cmdBuffer, const uint32_t imageIndex, const FrameView& view);
+        void RecordCulledScene(const vk::CommandBuffer& cmdBuffer, const Command::FrameTarget& target, const vk::ArrayProxy<const vk::DescriptorSet>& sets, const FrameView& view);
+        void RecordPass(const vk::CommandBuffer& cmdBuffer, const Command::FrameTarget& target, const ScenePass pass, const uint64_t key, const vk::ArrayProxy<const vk::DescriptorSet>& sets);
+        void RecordPassDraws(const vk::CommandBuffer& cmdBuffer, const ScenePass pass, const vk::ArrayProxy<const vk::DescriptorSet>& sets);
+        const uint64_t ScenePassKey(const vk::ArrayProxy<const vk::DescriptorSet>& sets);
+        const std::vector<vk::DescriptorSetLayout> PipelineSetLayouts() const;
+        void RebuildPipelines();
+        void SwapOptimizedPipelines();
+        void CreateFrameResources();
+        void PumpStreaming();
+        void UploadDrawObjects();
+        void SyncGeometry();
 
         const int GetMaxFramesInFlight();
 
@@ -72,11 +150,98 @@ namespace Engine::Render {
         Renderer& operator=(Renderer&&) = default;
         ~Renderer()                     = default;
 
-        void DrawFrame();
+        void DrawFrame(const FrameView& view = {});
         void WaitDevice();
+        // Marks the swapchain for a rebuild at the start of the next frame,
+        // any number of resizes in between result in a single rebuild
+        void SurfaceResized();
         void SuspendRendering();
         void ResumeRendering();
 
+        // Swap resources mid-session. The old ones are handed to the
+        // deletion queue and freed once the frames using them finish.
+        void UpdateVertices(const std::vector<Engine::Primitives::Vertex>& vertices);
+        void ReloadPipeline();
+
+        // Shader variant the scene is drawn with from the next frame on, see
+        // Shader/ShaderVariant.hpp. Each variant's pipeline is built the first
+        // time it's asked for and kept, switching back costs nothing. With
+        // pipeline libraries a new one is linked from cached parts without
+        // a hitch and swapped for an optimized build a few frames later,
+        // see Pipeline/PipelineLibrary.hpp.
+        void SetShaderFeatures(const Shader::FeatureKey features);
+        const Shader::FeatureKey ShaderFeatures() const { return shaderFeatures; }
+        const PipelineLibrary& Pipelines() const { return pipelineLibrary; }
+
+        // Scene passes go into secondary command buffers that are executed
+        // again as long as nothing they draw changed, instead of being
+        // recorded every frame. Off by default.
+        void SetCommandReuse(const bool enabled);
+        const bool CommandReuse() const { return commandReuse; }
+        // Scene passes recorded and reused since the renderer started
+        const uint64_t PassesRecorded() const { return scenePasses.Recorded(); }
+        const uint64_t PassesReused()   const { return scenePasses.Reused(); }
+
+        // Streams a mesh out of a .vmesh file over the next few frames,
+        // it replaces the current geometry once fully uploaded
+        void LoadMesh(const std::string& path, const uint32_t mesh = 0, const uint32_t lod = 0);
+        // A mesh is still streaming, which only moves on while frames are drawn
+        const bool Busy() const { return static_cast<bool>(meshStreamer); }
+
+        // Splits the current geometry into separately culled index ranges,
+        // from the next frame on. Ranges are relative to the mesh, as in its
+        // file. A newly streamed mesh starts as one object.
+        void SetDrawObjects(const std::vector<Culling::DrawObject>& objects);
+        const uint32_t DrawObjectCount() const { return occlusion.ObjectCount(); }
+        // Meshlets of the streamed mesh culled per frame, 0 without any
+        const uint32_t MeshletCount() const { return clusters.MeshletCount(); }
+        // Shared vertex and index buffers every mesh is drawn from
+        const Geometry::GeometryPool& Meshes() const { return geometry; }
+
+        // World matrices of the scene in slot order, see Scene::TransformStore.
+        // Only [first, first + changed) is copied and uploaded, a new count
+        // sends everything. Call from the thread that draws.
+        void SetTransforms(const glm::mat4* worlds, const uint32_t count, const uint32_t first, const uint32_t changed) {
+            if (capture) capture->SetTransforms(worlds, count, first, changed);
+            transforms.Set(worlds, count, first, changed);
+        }
+        const vk::Buffer* WorldTransforms() const { return transforms.Buffer(); }
+
+        // Lights drawn from the next frame on, copied. Call from the thread that draws.
+        void SetLights(const std::vector<Lighting::PointLight>& lights) {
+            if (capture) capture->SetLights(lights);
+            lighting.SetLights(lights);
+        }
+        const uint32_t LightCount() const { return lighting.LightCount(); }
+
+        // Opens a tiled .vtex file for streaming, returns its handle
+        uint32_t LoadTexture(const std::string& path);
+        const Texture::TextureStreamer& Textures() const { return *textureStreamer; }
+
+        // Every presented frame is copied out and handed to callback a couple
+        // of frames later, on the thread that draws, see Readback/ReadbackRing.hpp.
+        // Frames never wait on it. An empty callback turns it off.
+        void SetFrameReadback(Readback::ReadbackCallback callback);
+        const uint64_t ReadbacksDropped() const { return readback.Dropped(); }
+
+        // Writes every frame and every scene, streaming and settings call from
+        // here on to a capture file the CaptureReplay tool runs again, see
+        // Capture/CaptureFormat.hpp. Scene state set before isn't in it, so
+        // start before setting the scene up. Call from the thread that draws.
+        void StartCapture(const std::string& path);
+        void StopCapture();
+        const bool Capturing() const { return static_cast<bool>(capture); }
+
+        // Per heap budget, usage and engine allocations by category
+        const Memory::ResidencyStats& MemoryStats() const { return residency.Stats(); }
+        std::string MemoryStatsJson() const { return residency.ToJson(); }
+
+        // Bounds and GPU budget for the render scale. Takes effect with a
+        // swapchain rebuild at the start of the next frame.
+        void SetResolution(const Resolution::ResolutionSettings& settings);
+        const float RenderScale()   const { return scaledRendering ? resolution.Scale() : 1.0f; }
+        const float GpuFrameMs()    const { return resolution.GpuMs(); }
+
         void ValidationMessageCallback(
             const vk::DebugUtilsMessageSeverityFlagBitsEXT& messageSeverity,
             const vk::DebugUtilsMessageTypeFlagsEXT&        messageType,
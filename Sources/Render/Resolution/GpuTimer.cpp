@@ -0,0 +1,58 @@
+#include "GpuTimer.hpp"
+#include "Device/Physical.hpp"
+#include "Logger.hpp"
+
+#include <array>
+
+namespace Engine::Render::Resolution {
+
+    namespace ERD = Engine::Render::Device;
+
+    GpuTimer::GpuTimer(const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo, const uint32_t queueFamily, const uint32_t slots) {
+        const auto families{ deviceInfo.Get().getQueueFamilyProperties() };
+        const auto validBits{ families[queueFamily].timestampValidBits };
+
+        if (validBits == 0) {
+            LOGGER << "Graphics queue has no timestamps, render scale stays fixed\n";
+            return;
+        }
+
+        period    = deviceInfo.Get().getProperties().limits.timestampPeriod;
+        validMask = validBits >= 64 ? UINT64_MAX : (1ull << validBits) - 1;
+        written.assign(slots, 0);
+
+        pool = renderDevice.createQueryPoolUnique(vk::QueryPoolCreateInfo()
+            .setQueryType(vk::QueryType::eTimestamp)
+            .setQueryCount(2 * slots)
+        );
+    }
+
+    void GpuTimer::Begin(const vk::CommandBuffer& cmdBuffer, const ERD::DeviceDispatch& d, const uint32_t slot) {
+        if (!pool) return;
+
+        cmdBuffer.resetQueryPool(pool.get(), 2 * slot, 2, d);
+        cmdBuffer.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, pool.get(), 2 * slot, d);
+    }
+
+    void GpuTimer::End(const vk::CommandBuffer& cmdBuffer, const ERD::DeviceDispatch& d, const uint32_t slot) {
+        if (!pool) return;
+
+        cmdBuffer.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, pool.get(), 2 * slot + 1, d);
+        written[slot] = 1;
+    }
+
+    std::optional<float> GpuTimer::Read(const vk::Device& renderDevice, const ERD::DeviceDispatch& d, const uint32_t slot) {
+        if (!pool || !written[slot]) return std::nullopt;
+
+        std::array<uint64_t, 2> ticks{};
+        const auto result{ renderDevice.getQueryPoolResults(pool.get(), 2 * slot, 2,
+            sizeof(ticks), ticks.data(), sizeof(uint64_t), vk::QueryResultFlagBits::e64, d) };
+
+        // Asked for after the slot's fence, so eNotReady is unexpected. Never block on it though.
+        if (result != vk::Result::eSuccess) return std::nullopt;
+        written[slot] = 0;
+
+        const auto elapsed{ ((ticks[1] & validMask) - (ticks[0] & validMask)) & validMask };
+        return static_cast<float>(static_cast<double>(elapsed) * period / 1e6);
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef RENDER_RESOLUTION_GPU_TIMER_HPP
+#define RENDER_RESOLUTION_GPU_TIMER_HPP
+
+#include "VKinclude/VKinclude.hpp"
+#include "Device/Dispatch.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace Engine::Render::Device {
+    class PhysicalDevice;
+}
+
+namespace Engine::Render::Resolution {
+
+    // A pair of timestamps per frame slot around everything the frame
+    // records. Results are read once the slot's fence has signaled, so
+    // reading never stalls. Queues without timestamp support time nothing.
+    class GpuTimer {
+
+    private:
+        vk::UniqueQueryPool     pool;
+        float                   period      { 0.0f };   // Nanoseconds per tick
+        uint64_t                validMask   { 0 };
+        std::vector<uint8_t>    written;
+
+    public:
+        GpuTimer() = default;
+        GpuTimer(const vk::Device&, const Engine::Render::Device::PhysicalDevice&, const uint32_t queueFamily, const uint32_t slots);
+
+        // No copies!
+        GpuTimer(const GpuTimer&) = delete;
+        GpuTimer& operator=(const GpuTimer&) = delete;
+
+        GpuTimer(GpuTimer&&) = default;
+        GpuTimer& operator=(GpuTimer&&) = default;
+
+        void Begin(const vk::CommandBuffer&, const Engine::Render::Device::DeviceDispatch&, const uint32_t slot);
+        void End(const vk::CommandBuffer&, const Engine::Render::Device::DeviceDispatch&, const uint32_t slot);
+
+        // Milliseconds between Begin and End of the last frame in slot, once
+        std::optional<float> Read(const vk::Device&, const Engine::Render::Device::DeviceDispatch&, const uint32_t slot);
+
+        const bool Supported() const { return static_cast<bool>(pool); }
+    };
+}
+
+#endif // !RENDER_RESOLUTION_GPU_TIMER_HPP
@@ -0,0 +1,75 @@
+#include "RenderTarget.hpp"
+#include "Device/Physical.hpp"
+#include "Memory/Buffers.hpp"
+
+namespace Engine::Render::Resolution {
+
+    namespace ERD = Engine::Render::Device;
+    namespace ERM = Engine::Render::Memory;
+
+    RenderTarget CreateRenderTarget(const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo, const vk::Extent2D& extent, const vk::RenderPass& renderPass) {
+        const auto format{ deviceInfo.SurfaceFormat().format };
+
+        RenderTarget target{};
+        target.Extent = extent;
+
+        target.Image = renderDevice.createImageUnique(vk::ImageCreateInfo()
+            .setImageType(vk::ImageType::e2D)
+            .setFormat(format)
+            .setExtent(vk::Extent3D(extent.width, extent.height, 1))
+            .setMipLevels(1)
+            .setArrayLayers(1)
+            .setSamples(vk::SampleCountFlagBits::e1)
+            .setTiling(vk::ImageTiling::eOptimal)
+            .setUsage(vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc)
+            .setSharingMode(vk::SharingMode::eExclusive)
+            .setInitialLayout(vk::ImageLayout::eUndefined)
+        );
+
+        const auto requirements{ renderDevice.getImageMemoryRequirements(target.Image.get()) };
+        const auto memoryProperties{ deviceInfo.Get().getMemoryProperties() };
+        const auto memoryType{ ERM::FindMemoryType(memoryProperties, requirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal) };
+
+        target.Memory = renderDevice.allocateMemoryUnique(vk::MemoryAllocateInfo()
+            .setAllocationSize(requirements.size)
+            .setMemoryTypeIndex(memoryType)
+        );
+        target.Tracked = ERM::TrackedAllocation(renderDevice, ERM::HeapOfType(memoryProperties, memoryType), ERM::MemoryCategory::RenderTargets, requirements.size);
+
+        renderDevice.bindImageMemory(target.Image.get(), target.Memory.get(), 0u);
+
+        target.View = renderDevice.createImageViewUnique(vk::ImageViewCreateInfo()
+            .setImage(target.Image.get())
+            .setViewType(vk::ImageViewType::e2D)
+            .setFormat(format)
+            .setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1))
+        );
+
+        if (renderPass) {
+            target.Framebuffer = renderDevice.createFramebufferUnique(vk::FramebufferCreateInfo()
+                .setRenderPass(renderPass)
+                .setAttachmentCount(1)
+                .setPAttachments(&target.View.get())
+                .setWidth(extent.width)
+                .setHeight(extent.height)
+                .setLayers(1)
+            );
+        }
+
+        return target;
+    }
+
+    // The swapchain has to take transfer writes, and the surface format
+    // has to blit with linear filtering both ways
+    const bool BlitSupported(const ERD::PhysicalDevice& deviceInfo, const vk::SurfaceKHR& surface) {
+        const auto capabs{ deviceInfo.Get().getSurfaceCapabilitiesKHR(surface) };
+        if (!(capabs.supportedUsageFlags & vk::ImageUsageFlagBits::eTransferDst)) {
+            return false;
+        }
+
+        const auto needed{ vk::FormatFeatureFlagBits::eBlitSrc | vk::FormatFeatureFlagBits::eBlitDst | vk::FormatFeatureFlagBits::eSampledImageFilterLinear };
+        const auto features{ deviceInfo.Get().getFormatProperties(deviceInfo.SurfaceFormat().format).optimalTilingFeatures };
+
+        return (features & needed) == needed;
+    }
+}
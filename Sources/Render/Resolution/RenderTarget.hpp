@@ -0,0 +1,31 @@
+#ifndef RENDER_RESOLUTION_RENDER_TARGET_HPP
+#define RENDER_RESOLUTION_RENDER_TARGET_HPP
+
+#include "VKinclude/VKinclude.hpp"
+#include "Memory/Tracking.hpp"
+
+namespace Engine::Render::Device {
+    class PhysicalDevice;
+}
+
+namespace Engine::Render::Resolution {
+
+    // Offscreen color image frames are drawn into before being blitted to
+    // the swapchain. Sized for the largest scale, smaller scales draw into
+    // the top left corner. The framebuffer only exists for render passes.
+    struct RenderTarget {
+        vk::UniqueImage         Image;
+        vk::UniqueDeviceMemory  Memory;
+        vk::UniqueImageView     View;
+        vk::UniqueFramebuffer   Framebuffer;
+        Engine::Render::Memory::TrackedAllocation Tracked;
+        vk::Extent2D            Extent;
+    };
+
+    RenderTarget CreateRenderTarget(const vk::Device&, const Engine::Render::Device::PhysicalDevice&, const vk::Extent2D&, const vk::RenderPass& renderPass);
+
+    // Whether frames can be drawn offscreen and blitted to this surface
+    const bool BlitSupported(const Engine::Render::Device::PhysicalDevice&, const vk::SurfaceKHR&);
+}
+
+#endif // !RENDER_RESOLUTION_RENDER_TARGET_HPP
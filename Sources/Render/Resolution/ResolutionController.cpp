@@ -0,0 +1,68 @@
+#include "ResolutionController.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Engine::Render::Resolution {
+
+    namespace {
+        // Weight of the newest sample in the running average
+        constexpr float Smoothing{ 0.1f };
+        // Aim a bit under the budget, spikes eat the rest
+        constexpr float Headroom{ 0.9f };
+        // No change while the time is within [LowerBand, 1] of the budget
+        constexpr float LowerBand{ 0.75f };
+        // Largest step per change, as a factor of the current scale
+        constexpr float MaxStep{ 0.1f };
+        // Samples to skip after a change, a couple of frames are still in flight
+        constexpr uint32_t SettleFrames{ 6 };
+
+        constexpr float ScaleFloor{ 0.1f };
+
+        uint32_t ScaleAxis(const uint32_t size, const float scale) {
+            return std::max(1u, static_cast<uint32_t>(static_cast<float>(size) * scale));
+        }
+    }
+
+    ResolutionController::ResolutionController(const ResolutionSettings& settings) :
+        settings(settings)
+    {
+        this->settings.MaxScale = std::clamp(settings.MaxScale, ScaleFloor, 1.0f);
+        this->settings.MinScale = std::clamp(settings.MinScale, ScaleFloor, this->settings.MaxScale);
+        scale = this->settings.Enabled ? this->settings.MaxScale : 1.0f;
+    }
+
+    void ResolutionController::Update(const float gpuMs) {
+        if (gpuMs <= 0.0f) return;
+
+        smoothedMs = measured ? smoothedMs + (gpuMs - smoothedMs) * Smoothing : gpuMs;
+        measured   = true;
+
+        if (!settings.Enabled) return;
+        if (settling > 0) {
+            --settling;
+            return;
+        }
+
+        const auto budget{ settings.TargetMs };
+        if (smoothedMs <= budget && smoothedMs >= budget * LowerBand) return;
+
+        const auto wanted{ scale * std::sqrt(budget * Headroom / smoothedMs) };
+        const auto stepped{ std::clamp(wanted, scale * (1.0f - MaxStep), scale * (1.0f + MaxStep)) };
+        const auto next{ std::clamp(stepped, settings.MinScale, settings.MaxScale) };
+
+        if (next != scale) {
+            scale    = next;
+            settling = SettleFrames;
+        }
+    }
+
+    const vk::Extent2D ResolutionController::Apply(const vk::Extent2D& full) const {
+        return { ScaleAxis(full.width, scale), ScaleAxis(full.height, scale) };
+    }
+
+    const vk::Extent2D ResolutionController::Capacity(const vk::Extent2D& full) const {
+        const auto top{ settings.Enabled ? settings.MaxScale : 1.0f };
+        return { ScaleAxis(full.width, top), ScaleAxis(full.height, top) };
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef RENDER_RESOLUTION_CONTROLLER_HPP
+#define RENDER_RESOLUTION_CONTROLLER_HPP
+
+#include "VKinclude/VKinclude.hpp"
+
+#include <cstdint>
+
+namespace Engine::Render::Resolution {
+
+    // Scales are per axis, relative to the swapchain extent. The internal
+    // target is allocated at MaxScale, so only downscaling is supported.
+    struct ResolutionSettings {
+        bool    Enabled     { true };
+        float   MinScale    { 0.5f };
+        float   MaxScale    { 1.0f };
+        float   TargetMs    { 1000.0f / 60.0f };   // GPU time per frame to hold
+    };
+
+    // Picks the render scale from measured GPU frame times. Cost is assumed
+    // to follow the pixel count, so the scale moves with the square root of
+    // budget over time. Measurements are smoothed and show up a few frames
+    // late, so after each change the controller waits for them to settle,
+    // and it leaves the scale alone while the time is within a band below
+    // the budget to keep it from oscillating.
+    class ResolutionController {
+
+    private:
+        ResolutionSettings  settings;
+        float               scale       { 1.0f };
+        float               smoothedMs  { 0.0f };
+        uint32_t            settling    { 0 };
+        bool                measured    { false };
+
+    public:
+        explicit ResolutionController(const ResolutionSettings& settings = {});
+
+        // One GPU time per finished frame, in milliseconds
+        void Update(const float gpuMs);
+
+        // The part of the internal target drawn this frame, at least 1x1
+        const vk::Extent2D Apply(const vk::Extent2D& full) const;
+        // Size the internal target is allocated at
+        const vk::Extent2D Capacity(const vk::Extent2D& full) const;
+
+        const float                 Scale()     const { return scale; }
+        const float                 GpuMs()     const { return smoothedMs; }
+        const ResolutionSettings&   Settings()  const { return settings; }
+    };
+}
+
+#endif // !RENDER_RESOLUTION_CONTROLLER_HPP
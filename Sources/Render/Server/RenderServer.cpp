@@ -0,0 +1,487 @@
+#include "RenderServer.hpp"
+
+#include "Instance/Instance.hpp"
+#include "Device/Logical.hpp"
+#include "Command/Command.hpp"
+#include "Logger.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+
+namespace Engine::Render::Server {
+
+    namespace ERI   = Engine::Render::Instance;
+    namespace ERD   = Engine::Render::Device;
+    namespace ERDL  = Engine::Render::Device::Logical;
+    namespace ERQU  = Engine::Render::Queue;
+    namespace ERCD  = Engine::Render::Command;
+    namespace ERM   = Engine::Render::Memory;
+    namespace ERR   = Engine::Render::Resolution;
+    namespace EP    = Engine::Primitives;
+
+    namespace {
+        const auto ERQUG{ ERQU::QueueType::Graphics };
+
+        // Room the geometry pool starts out with, it doubles whenever a mesh
+        // doesn't fit. 20 and 16 MB, as in the Renderer.
+        constexpr uint32_t InitialPoolVertices  { 1u << 20 };
+        constexpr uint32_t InitialPoolIndices   { 1u << 22 };
+
+        const ERQU::QueueTable<int> ServerQueues() {
+            ERQU::QueueTable<int> needed{};
+            needed[ERQUG] = 1;
+            return needed;
+        }
+
+        // Sessions draw with dynamic rendering only, so there is no render
+        // pass to match against every target size and format
+        ERD::PhysicalDevice PickHeadlessDevice(const vk::Instance& instance) {
+            auto deviceInfo{ ERD::PickDevice(instance, {}) };
+            if (!deviceInfo.SupportsDynamicRendering()) {
+                throw std::runtime_error("Headless rendering needs VK_KHR_dynamic_rendering");
+            }
+            return deviceInfo;
+        }
+
+        vk::UniqueDevice CreateHeadlessDevice(ERD::PhysicalDevice& deviceInfo, ERQU::QueueManager& queues) {
+            vk::SurfaceKHR noSurface{};
+            return ERDL::CreateLogicalDevice(deviceInfo, noSurface, queues);
+        }
+
+        // Nothing samples session depth, it only has to be attachable
+        vk::Format PickDepthFormat(const ERD::PhysicalDevice& deviceInfo) {
+            for (const auto format : { vk::Format::eD32Sfloat, vk::Format::eD16Unorm }) {
+                const auto features{ deviceInfo.Get().getFormatProperties(format).optimalTilingFeatures };
+                if (features & vk::FormatFeatureFlagBits::eDepthStencilAttachment) return format;
+            }
+            throw std::runtime_error("No depth attachment format");
+        }
+
+        vk::UniqueDescriptorSetLayout CreateFrameSetLayout(const vk::Device& renderDevice) {
+            const auto binding{ vk::DescriptorSetLayoutBinding()
+                .setBinding(0)
+                .setDescriptorType(vk::DescriptorType::eUniformBuffer)
+                .setDescriptorCount(1)
+                .setStageFlags(vk::ShaderStageFlagBits::eVertex)
+            };
+
+            return renderDevice.createDescriptorSetLayoutUnique(vk::DescriptorSetLayoutCreateInfo()
+                .setBindingCount(1)
+                .setPBindings(&binding)
+            );
+        }
+
+        // Data saved for another driver or device is left out rather than
+        // handed to the driver, which should ignore it but need not
+        const bool CacheMatches(const std::vector<char>& data, const ERD::PhysicalDevice& deviceInfo) {
+            const auto properties{ deviceInfo.Get().getProperties() };
+
+            uint32_t header[4]{};
+            if (data.size() < sizeof(header) + VK_UUID_SIZE) return false;
+            std::memcpy(header, data.data(), sizeof(header));
+
+            return header[1] == static_cast<uint32_t>(VK_PIPELINE_CACHE_HEADER_VERSION_ONE)
+                && header[2] == properties.vendorID
+                && header[3] == properties.deviceID
+                && std::memcmp(data.data() + sizeof(header), properties.pipelineCacheUUID.data(), VK_UUID_SIZE) == 0;
+        }
+
+        vk::UniquePipelineCache LoadPipelineCache(const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo, const std::string& path) {
+            std::vector<char> data{};
+
+            if (!path.empty()) {
+                std::ifstream file(path, std::ios::binary);
+                data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+                if (!data.empty() && !CacheMatches(data, deviceInfo)) {
+                    LOGGER << "Pipeline cache \"" << path << "\" is for another device, starting empty\n";
+                    data.clear();
+                }
+            }
+
+            return renderDevice.createPipelineCacheUnique(vk::PipelineCacheCreateInfo()
+                .setInitialDataSize(data.size())
+                .setPInitialData(data.empty() ? nullptr : data.data())
+            );
+        }
+    }
+
+    RenderServer::RenderServer(const ServerSettings& settings) :
+
+        settings        (settings),
+        renderInstance  (ERI::CreateInstance          ({},                    std::nullopt,          nullptr )),
+        deviceInfo      (PickHeadlessDevice           (renderInstance.get()                                  )),
+        queues          (ERQU::QueueManager           (deviceInfo.Get(),      vk::SurfaceKHR(),      ServerQueues() )),
+        renderDevice    (CreateHeadlessDevice         (deviceInfo,            queues                         )),
+        dispatch        (ERD::LoadDeviceDispatch      (renderInstance.get(),  renderDevice.get()             )),
+        depthFormat     (PickDepthFormat              (deviceInfo                                            )),
+        pipelineCache   (LoadPipelineCache            (renderDevice.get(),    deviceInfo,            settings.PipelineCachePath )),
+        frameSetLayout  (CreateFrameSetLayout         (renderDevice.get()                                    )),
+        lighting        (Lighting::ClusteredLighting  (renderDevice.get(),    deviceInfo,            settings.MaxSessions * TickSlots, settings.Lighting )),
+        renderPipeline  (Pipeline                     (renderDevice.get(),    AttachmentLayout{ deviceInfo.SurfaceFormat().format, depthFormat, {} }, { frameSetLayout.get(), lighting.SetLayout() }, pipelineCache.get() )),
+        geometry        (Geometry::GeometryPool       (renderDevice.get(),    deviceInfo,            InitialPoolVertices,       InitialPoolIndices ))
+    {
+        sessions.reserve(settings.MaxSessions);
+        scheduled.reserve(settings.MaxSessionsPerTick);
+        submitted.reserve(settings.MaxSessionsPerTick + 1);
+
+        CreateFrameResources();
+        CreateTickObjects();
+    }
+
+    RenderServer::~RenderServer() {
+        if (!renderDevice) return;
+
+        try {
+            WaitIdle();
+            SavePipelineCache();
+        }
+        catch (const std::exception& e) {
+            LOGGER << "Shutting the render server down: " << e.what() << '\n';
+        }
+    }
+
+    // A uniform buffer and set per session and tick slot, all made up
+    // front so sessions come and go without touching descriptor pools
+    void RenderServer::CreateFrameResources() {
+        const auto count{ settings.MaxSessions * TickSlots };
+
+        const auto poolSize{ vk::DescriptorPoolSize()
+            .setType(vk::DescriptorType::eUniformBuffer)
+            .setDescriptorCount(count)
+        };
+
+        framePool = renderDevice->createDescriptorPoolUnique(vk::DescriptorPoolCreateInfo()
+            .setMaxSets(count)
+            .setPoolSizeCount(1)
+            .setPPoolSizes(&poolSize)
+        );
+
+        const std::vector<vk::DescriptorSetLayout> layouts(count, frameSetLayout.get());
+        frameSets = renderDevice->allocateDescriptorSets(vk::DescriptorSetAllocateInfo()
+            .setDescriptorPool(framePool.get())
+            .setDescriptorSetCount(count)
+            .setPSetLayouts(layouts.data())
+        );
+
+        for (uint32_t i = 0; i < count; ++i) {
+            frameUniforms.emplace_back(renderDevice.get(), deviceInfo, vk::BufferCreateInfo()
+                .setSharingMode(vk::SharingMode::eExclusive)
+                .setSize(sizeof(FrameView))
+                .setUsage(vk::BufferUsageFlagBits::eUniformBuffer),
+                vk::MemoryPropertyFlagBits::eHostCoherent | vk::MemoryPropertyFlagBits::eHostVisible
+            );
+            *frameUniforms.back().Mapped(renderDevice.get()) = FrameView{};
+
+            const auto bufferInfo{ vk::DescriptorBufferInfo()
+                .setBuffer(*frameUniforms.back().Buffer())
+                .setOffset(0)
+                .setRange(sizeof(FrameView))
+            };
+
+            renderDevice->updateDescriptorSets(vk::WriteDescriptorSet()
+                .setDstSet(frameSets[i])
+                .setDstBinding(0)
+                .setDescriptorCount(1)
+                .setDescriptorType(vk::DescriptorType::eUniformBuffer)
+                .setPBufferInfo(&bufferInfo),
+                nullptr
+            );
+        }
+    }
+
+    // Buffer 0 of a slot carries the geometry uploads, the rest one session each
+    void RenderServer::CreateTickObjects() {
+        const auto perTick{ std::max(1u, settings.MaxSessionsPerTick) + 1 };
+
+        for (uint32_t i = 0; i < TickSlots; ++i) {
+            commandPools.emplace_back(renderDevice->createCommandPoolUnique(vk::CommandPoolCreateInfo()
+                .setQueueFamilyIndex(queues.GetQF(ERQUG).Index)
+            ));
+
+            commandBuffers.emplace_back(renderDevice->allocateCommandBuffersUnique(vk::CommandBufferAllocateInfo()
+                .setCommandPool(commandPools.back().get())
+                .setCommandBufferCount(perTick)
+                .setLevel(vk::CommandBufferLevel::ePrimary)
+            ));
+
+            tickFences.emplace_back(renderDevice->createFenceUnique(vk::FenceCreateInfo()
+                .setFlags(vk::FenceCreateFlagBits::eSignaled)
+            ));
+        }
+    }
+
+    void RenderServer::CreateTargets(Session& session, const vk::Extent2D& extent) {
+        session.Target = ERR::CreateRenderTarget(renderDevice.get(), deviceInfo, extent, {});
+
+        session.DepthImage = renderDevice->createImageUnique(vk::ImageCreateInfo()
+            .setImageType(vk::ImageType::e2D)
+            .setFormat(depthFormat)
+            .setExtent(vk::Extent3D(extent.width, extent.height, 1))
+            .setMipLevels(1)
+            .setArrayLayers(1)
+            .setSamples(vk::SampleCountFlagBits::e1)
+            .setTiling(vk::ImageTiling::eOptimal)
+            .setUsage(vk::ImageUsageFlagBits::eDepthStencilAttachment)
+            .setSharingMode(vk::SharingMode::eExclusive)
+            .setInitialLayout(vk::ImageLayout::eUndefined)
+        );
+
+        const auto requirements{ renderDevice->getImageMemoryRequirements(session.DepthImage.get()) };
+        const auto memoryProperties{ deviceInfo.Get().getMemoryProperties() };
+        const auto memoryType{ ERM::FindMemoryType(memoryProperties, requirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal) };
+
+        session.DepthMemory = renderDevice->allocateMemoryUnique(vk::MemoryAllocateInfo()
+            .setAllocationSize(requirements.size)
+            .setMemoryTypeIndex(memoryType)
+        );
+        session.DepthTracked = ERM::TrackedAllocation(renderDevice.get(), ERM::HeapOfType(memoryProperties, memoryType), ERM::MemoryCategory::RenderTargets, requirements.size);
+
+        renderDevice->bindImageMemory(session.DepthImage.get(), session.DepthMemory.get(), 0u);
+
+        session.DepthView = renderDevice->createImageViewUnique(vk::ImageViewCreateInfo()
+            .setImage(session.DepthImage.get())
+            .setViewType(vk::ImageViewType::e2D)
+            .setFormat(depthFormat)
+            .setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eDepth, 0, 1, 0, 1))
+        );
+    }
+
+    // Ticks in flight may still draw into them
+    void RenderServer::RetireTargets(Session& session) {
+        deletionQueue.Retire(std::move(session.Target), tickNumber);
+        deletionQueue.Retire(std::move(session.DepthView), tickNumber);
+        deletionQueue.Retire(std::move(session.DepthImage), tickNumber);
+        deletionQueue.Retire(std::move(session.DepthMemory), tickNumber);
+        deletionQueue.Retire(std::move(session.DepthTracked), tickNumber);
+    }
+
+    SessionHandle RenderServer::CreateSession(const vk::Extent2D& extent) {
+        SessionHandle handle{ NoSession };
+
+        if (!freeSessions.empty()) {
+            handle = freeSessions.back();
+            freeSessions.pop_back();
+        }
+        else if (sessions.size() < settings.MaxSessions) {
+            handle = static_cast<SessionHandle>(sessions.size());
+            sessions.emplace_back();
+        }
+        else {
+            throw std::runtime_error("Render server is full, raise MaxSessions");
+        }
+
+        auto& session{ sessions[handle] };
+        session.Readback = Readback::ReadbackRing(deviceInfo, TickSlots + 1);
+        CreateTargets(session, extent);
+        session.Live = true;
+        return handle;
+    }
+
+    void RenderServer::DestroySession(const SessionHandle handle) {
+        auto& session{ SessionOf(handle) };
+
+        RetireTargets(session);
+        deletionQueue.Retire(std::move(session.Readback), tickNumber);
+        session = Session{};
+        freeSessions.push_back(handle);
+    }
+
+    void RenderServer::Resize(const SessionHandle handle, const vk::Extent2D& extent) {
+        auto& session{ SessionOf(handle) };
+        if (extent == session.Target.Extent) return;
+
+        RetireTargets(session);
+        CreateTargets(session, extent);
+    }
+
+    void RenderServer::SetMeshes(const SessionHandle handle, const std::vector<Geometry::MeshHandle>& meshes) {
+        auto& session{ SessionOf(handle) };
+        for (const auto mesh : meshes) {
+            geometry.Range(mesh);   // Throws for meshes the pool doesn't have
+        }
+        session.Meshes = meshes;
+    }
+
+    void RenderServer::SetReadback(const SessionHandle handle, Readback::ReadbackCallback callback) {
+        if (callback && Readback::BytesPerPixel(deviceInfo.SurfaceFormat().format) == 0) {
+            throw std::runtime_error("Session images can't be read back in this format");
+        }
+        SessionOf(handle).Readback.SetCallback(std::move(callback));
+    }
+
+    Geometry::MeshHandle RenderServer::AddMesh(const std::vector<EP::Vertex>& vertices, const std::vector<uint32_t>& indices) {
+        return geometry.Add(renderDevice.get(), deviceInfo, vertices, indices);
+    }
+
+    void RenderServer::RemoveMesh(const Geometry::MeshHandle mesh) {
+        for (auto& session : sessions) {
+            session.Meshes.erase(std::remove(session.Meshes.begin(), session.Meshes.end(), mesh), session.Meshes.end());
+        }
+        geometry.Remove(mesh);
+    }
+
+    // Round robin from where the last tick stopped. Sessions that were
+    // skipped for lack of room come first next time.
+    void RenderServer::Schedule() {
+        scheduled.clear();
+
+        const auto count{ static_cast<SessionHandle>(sessions.size()) };
+        const auto limit{ std::max(1u, settings.MaxSessionsPerTick) };
+
+        for (SessionHandle i = 0; i < count && scheduled.size() < limit; ++i) {
+            const auto handle{ (cursor + i) % count };
+            const auto& session{ sessions[handle] };
+
+            if (session.Live && (session.Continuous || session.Requested > 0)) {
+                scheduled.push_back(handle);
+            }
+        }
+
+        if (!scheduled.empty()) {
+            cursor = (scheduled.back() + 1) % count;
+        }
+    }
+
+    uint32_t RenderServer::Tick() {
+
+        // Once this slot's fence has signaled, every tick up to
+        // tickNumber - TickSlots has finished on the GPU
+        renderDevice->waitForFences(1, &tickFences[currentSlot].get(), true, UINT64_MAX, dispatch);
+
+        if (tickNumber >= TickSlots) {
+            const auto completed{ tickNumber - TickSlots };
+            deletionQueue.Collect(completed);
+            for (auto& session : sessions) {
+                session.Readback.Collect(renderDevice.get(), completed);
+            }
+        }
+
+        Schedule();
+
+        // Nothing to draw, the last tick's readbacks still go out once it's done
+        if (scheduled.empty()) {
+            const auto lastSlot{ (currentSlot + TickSlots - 1) % TickSlots };
+            if (tickNumber > 0 && renderDevice->getFenceStatus(tickFences[lastSlot].get(), dispatch) == vk::Result::eSuccess) {
+                for (auto& session : sessions) {
+                    session.Readback.Collect(renderDevice.get(), tickNumber - 1);
+                }
+            }
+            return 0;
+        }
+
+        renderDevice->resetCommandPool(commandPools[currentSlot].get(), {}, dispatch);
+        geometry.Prepare(renderDevice.get(), deviceInfo);
+
+        const auto& buffers{ commandBuffers[currentSlot] };
+        submitted.clear();
+
+        // Meshes added since the last tick land before any session draws
+        const auto& uploads{ buffers[0].get() };
+        uploads.begin(vk::CommandBufferBeginInfo()
+            .setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit),
+            dispatch
+        );
+        geometry.RecordUploads(uploads, dispatch, deletionQueue, tickNumber);
+        uploads.end(dispatch);
+        submitted.push_back(uploads);
+
+        for (size_t i = 0; i < scheduled.size(); ++i) {
+            const auto& cmdBuffer{ buffers[i + 1].get() };
+            RecordSession(cmdBuffer, scheduled[i]);
+            submitted.push_back(cmdBuffer);
+        }
+
+        const auto submitInfo{ vk::SubmitInfo()
+            .setCommandBufferCount(static_cast<uint32_t>(submitted.size()))
+            .setPCommandBuffers(submitted.data())
+        };
+
+        renderDevice->resetFences(1, &tickFences[currentSlot].get(), dispatch);
+        queues[ERQUG].submit(submitInfo, tickFences[currentSlot].get(), dispatch);
+
+        const auto drawn{ static_cast<uint32_t>(scheduled.size()) };
+        framesDrawn += drawn;
+        ++tickNumber;
+        currentSlot = (currentSlot + 1) % TickSlots;
+        return drawn;
+    }
+
+    // The session's uniforms and lighting slot for this tick slot are free,
+    // the fence of the tick that last used them has been waited on
+    void RenderServer::RecordSession(const vk::CommandBuffer& cmdBuffer, const SessionHandle handle) {
+        auto& session{ sessions[handle] };
+        const auto slot{ handle * TickSlots + currentSlot };
+        const auto& extent{ session.Target.Extent };
+        const std::array<vk::DescriptorSet, 2> sets{ frameSets[slot], lighting.Set(slot) };
+
+        *frameUniforms[slot].Mapped(renderDevice.get()) = session.View;
+        lighting.SetLights(session.Lights);
+        lighting.Prepare(renderDevice.get(), slot, session.View.View, session.View.Projection, extent);
+
+        cmdBuffer.begin(vk::CommandBufferBeginInfo()
+            .setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit),
+            dispatch
+        );
+        lighting.RecordCulling(cmdBuffer, dispatch, slot);
+
+        const ERCD::FrameTarget target{ session.Target.Image.get(), session.Target.View.get(), {}, {}, extent, vk::ImageLayout::eTransferSrcOptimal, session.DepthImage.get(), session.DepthView.get() };
+
+        ERCD::BeginScene(cmdBuffer, dispatch, target);
+        if (!session.Meshes.empty()) {
+            ERCD::BindPipeline(cmdBuffer, dispatch, sets, renderPipeline);
+            geometry.Bind(cmdBuffer, dispatch);
+
+            for (const auto mesh : session.Meshes) {
+                geometry.Draw(cmdBuffer, dispatch, mesh);
+            }
+        }
+        ERCD::EndScene(cmdBuffer, dispatch, target);
+
+        session.Readback.RecordCopy(cmdBuffer, dispatch, renderDevice.get(), deviceInfo, target.Image, vk::ImageLayout::eTransferSrcOptimal, extent, deviceInfo.SurfaceFormat().format, tickNumber);
+        cmdBuffer.end(dispatch);
+
+        if (session.Requested > 0) {
+            --session.Requested;
+        }
+    }
+
+    void RenderServer::WaitIdle() {
+        renderDevice->waitIdle();
+        deletionQueue.Flush();
+        for (auto& session : sessions) {
+            session.Readback.Collect(renderDevice.get(), tickNumber);
+        }
+    }
+
+    void RenderServer::SavePipelineCache() const {
+        if (settings.PipelineCachePath.empty()) return;
+
+        const auto data{ renderDevice->getPipelineCacheData(pipelineCache.get()) };
+        std::ofstream file(settings.PipelineCachePath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+        if (!file) {
+            throw std::runtime_error("Couldn't write the pipeline cache to " + settings.PipelineCachePath);
+        }
+    }
+
+    RenderServer::Session& RenderServer::SessionOf(const SessionHandle handle) {
+        if (handle >= sessions.size() || !sessions[handle].Live) {
+            throw std::runtime_error("No such render session");
+        }
+        return sessions[handle];
+    }
+
+    const RenderServer::Session& RenderServer::SessionOf(const SessionHandle handle) const {
+        if (handle >= sessions.size() || !sessions[handle].Live) {
+            throw std::runtime_error("No such render session");
+        }
+        return sessions[handle];
+    }
+}
@@ -0,0 +1,160 @@
+#ifndef RENDER_SERVER_RENDER_SERVER_HPP
+#define RENDER_SERVER_RENDER_SERVER_HPP
+
+#include "VKinclude/VKinclude.hpp"
+#include "Device/Physical.hpp"
+#include "Device/Dispatch.hpp"
+#include "Pipeline/Pipeline.hpp"
+#include "Queue/Queue.hpp"
+#include "Memory/Buffers.hpp"
+#include "Memory/DeletionQueue.hpp"
+#include "Resolution/RenderTarget.hpp"
+#include "Lighting/ClusteredLighting.hpp"
+#include "Geometry/GeometryPool.hpp"
+#include "Readback/ReadbackRing.hpp"
+#include "Primitives/Vertex.hpp"
+#include "FrameView.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace Engine::Render::Server {
+
+    using SessionHandle = uint32_t;
+    constexpr SessionHandle NoSession{ std::numeric_limits<uint32_t>::max() };
+
+    struct ServerSettings {
+        uint32_t    MaxSessions         { 16 };
+        uint32_t    MaxSessionsPerTick  { 8 };      // Sessions drawn by one Tick at most
+        std::string PipelineCachePath   {};         // Loaded on start, saved by SavePipelineCache. Empty keeps it in memory.
+        Engine::Render::Lighting::LightingSettings Lighting{};
+    };
+
+    // Renders many independent sessions offscreen on one instance and
+    // device, without a window. Each session has its own view, lights,
+    // list of meshes and color and depth images, and reads its frames back
+    // through a ReadbackRing of its own. The pipeline, the pipeline cache,
+    // the geometry pool and the light binning pipeline are shared.
+    //
+    // Tick draws up to MaxSessionsPerTick sessions that have a frame due,
+    // taking turns round robin so a busy session can't starve the others,
+    // and sends all of them to the queue in a single submit. Like frames in
+    // the Renderer, TickSlots ticks can be in flight, a tick waits for the
+    // one that used its slot before.
+    //
+    // Needs dynamic rendering. Everything here runs on the thread that
+    // calls Tick, readback callbacks included.
+    class RenderServer {
+
+    private:
+        static constexpr uint32_t TickSlots{ 2 };
+
+        struct Session {
+            Engine::Render::Resolution::RenderTarget    Target;
+            vk::UniqueImage             DepthImage;
+            vk::UniqueDeviceMemory      DepthMemory;
+            vk::UniqueImageView         DepthView;
+            Engine::Render::Memory::TrackedAllocation   DepthTracked;
+            Engine::Render::Readback::ReadbackRing      Readback;
+            FrameView                   View;
+            std::vector<Engine::Render::Lighting::PointLight> Lights;
+            std::vector<Geometry::MeshHandle>           Meshes;
+            uint32_t                    Requested   { 0 };      // Frames asked for and not drawn yet
+            bool                        Continuous  { false };
+            bool                        Live        { false };
+        };
+
+        ServerSettings              settings;
+        vk::UniqueInstance          renderInstance;
+        Device::PhysicalDevice      deviceInfo;
+        Queue::QueueManager         queues;
+        vk::UniqueDevice            renderDevice;
+        Device::DeviceDispatch      dispatch;
+        Memory::DeletionQueue       deletionQueue;
+        vk::Format                  depthFormat;
+        vk::UniquePipelineCache     pipelineCache;
+        vk::UniqueDescriptorSetLayout frameSetLayout;
+        Lighting::ClusteredLighting lighting;               // A slot per session and tick slot
+        Pipeline                    renderPipeline;
+        Geometry::GeometryPool      geometry;
+        vk::UniqueDescriptorPool    framePool;
+        std::vector<vk::DescriptorSet> frameSets;           // Session major, like the lighting slots
+        std::vector<Memory::DeviceMemory<FrameView>> frameUniforms;
+        std::vector<vk::UniqueCommandPool>      commandPools;       // One per tick slot, reset as a whole
+        std::vector<std::vector<vk::UniqueCommandBuffer>> commandBuffers;
+        std::vector<vk::UniqueFence>            tickFences;
+
+        std::vector<Session>        sessions;               // By handle
+        std::vector<SessionHandle>  freeSessions;
+        std::vector<SessionHandle>  scheduled;              // This tick's, kept to avoid allocating
+        std::vector<vk::CommandBuffer> submitted;
+        SessionHandle               cursor      { 0 };      // Where the next tick starts looking
+        uint32_t                    currentSlot { 0 };
+        uint64_t                    tickNumber  { 0 };
+        uint64_t                    framesDrawn { 0 };
+
+        // No copies!
+        RenderServer(const RenderServer&) = delete;
+        RenderServer& operator=(const RenderServer&) = delete;
+
+        void CreateFrameResources();
+        void CreateTickObjects();
+        void CreateTargets(Session& session, const vk::Extent2D& extent);
+        void RetireTargets(Session& session);
+        void RecordSession(const vk::CommandBuffer& cmdBuffer, const SessionHandle handle);
+        void Schedule();
+        Session& SessionOf(const SessionHandle handle);
+        const Session& SessionOf(const SessionHandle handle) const;
+
+    public:
+        explicit RenderServer(const ServerSettings& settings = {});
+        // Waits for the device, then saves the pipeline cache
+        ~RenderServer();
+
+        RenderServer(RenderServer&&)            = default;
+        RenderServer& operator=(RenderServer&&) = default;
+
+        // Sessions start out with an identity view, no lights, nothing to
+        // draw and no frame due. Throws past MaxSessions.
+        SessionHandle CreateSession(const vk::Extent2D& extent);
+        // Frames in flight finish drawing it, their readbacks are dropped
+        void DestroySession(const SessionHandle handle);
+        void Resize(const SessionHandle handle, const vk::Extent2D& extent);
+
+        // Take effect from the session's next frame, copied
+        void SetView(const SessionHandle handle, const FrameView& view)  { SessionOf(handle).View = view; }
+        void SetLights(const SessionHandle handle, const std::vector<Lighting::PointLight>& lights) { SessionOf(handle).Lights = lights; }
+        void SetMeshes(const SessionHandle handle, const std::vector<Geometry::MeshHandle>& meshes);
+        // Finished frames of the session, see Readback/ReadbackRing.hpp
+        void SetReadback(const SessionHandle handle, Readback::ReadbackCallback callback);
+
+        // One more frame of the session, drawn by one of the next ticks
+        void RequestFrame(const SessionHandle handle) { ++SessionOf(handle).Requested; }
+        // A frame every time the session's turn comes up, until turned off
+        void SetContinuous(const SessionHandle handle, const bool continuous) { SessionOf(handle).Continuous = continuous; }
+
+        // Meshes go into the shared pool, any session can draw them.
+        // Removing one takes it out of every session's list.
+        Geometry::MeshHandle AddMesh(const std::vector<Engine::Primitives::Vertex>& vertices, const std::vector<uint32_t>& indices = {});
+        void RemoveMesh(const Geometry::MeshHandle mesh);
+
+        // Hands out the readbacks of ticks that have finished, then draws
+        // the sessions whose turn it is in one submit. Returns how many
+        // sessions were drawn, 0 submits nothing.
+        uint32_t Tick();
+        // Finishes everything submitted and delivers the last readbacks
+        void WaitIdle();
+        // Writes the cache to PipelineCachePath, if there is one
+        void SavePipelineCache() const;
+
+        const uint32_t SessionCount()   const { return static_cast<uint32_t>(sessions.size() - freeSessions.size()); }
+        const uint64_t Ticks()          const { return tickNumber; }
+        const uint64_t FramesDrawn()    const { return framesDrawn; }
+        const uint64_t ReadbacksDropped(const SessionHandle handle) const { return SessionOf(handle).Readback.Dropped(); }
+        const Geometry::GeometryPool& Meshes() const { return geometry; }
+    };
+}
+
+#endif // !RENDER_SERVER_RENDER_SERVER_HPP
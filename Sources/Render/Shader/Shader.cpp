@@ -29,7 +29,7 @@ namespace Engine::Render::Shader {
         std::ifstream file(fname, std::ios::binary);
 
         if (!file.is_open()) {
-            throw std::runtime_error("Could not open file");
+            throw std::runtime_error("Could not open shader " + fname);
         }
 
         std::vector<std::byte> shader_buffer(fs::file_size(fname));
@@ -0,0 +1,69 @@
+#include "ShaderVariant.hpp"
+#include "Shader.hpp"
+#include "Command/SecondaryCache.hpp"
+
+#include <stdexcept>
+
+namespace Engine::Render::Shader {
+
+    namespace ERCD = Engine::Render::Command;
+
+    namespace {
+        // The compiled features stage has out of features
+        FeatureKey StageFeatures(const vk::ShaderStageFlagBits stage, const FeatureKey features) {
+            FeatureKey known{ Features::None };
+            for (const auto& compiled : CompiledFeatures) {
+                known |= compiled.Key;
+            }
+            if ((features & Features::Compiled & ~known) != 0) {
+                throw std::runtime_error("Unknown compiled shader feature");
+            }
+
+            FeatureKey own{ Features::None };
+            for (const auto& compiled : CompiledFeatures) {
+                if ((features & compiled.Key) && (compiled.Stages & stage)) {
+                    own |= compiled.Key;
+                }
+            }
+            return own;
+        }
+    }
+
+    std::string VariantFile(const std::string& name, const vk::ShaderStageFlagBits stage, const FeatureKey features) {
+        const auto own{ StageFeatures(stage, features) };
+
+        auto file{ name };
+        for (const auto& compiled : CompiledFeatures) {
+            if (own & compiled.Key) {
+                file += std::string("_") + compiled.Suffix;
+            }
+        }
+        return file + ".spv";
+    }
+
+    Specialization::Specialization(const FeatureKey features) {
+        for (uint32_t bit = 0; bit < ConstantCount; ++bit) {
+            entries[bit] = vk::SpecializationMapEntry(bit, bit * sizeof(vk::Bool32), sizeof(vk::Bool32));
+            values[bit]  = (features >> bit) & 1u ? VK_TRUE : VK_FALSE;
+        }
+
+        info = vk::SpecializationInfo()
+            .setMapEntryCount(ConstantCount)
+            .setPMapEntries(entries.data())
+            .setDataSize(sizeof(values))
+            .setPData(values.data());
+    }
+
+    // Keyed by the name and the compiled features this stage has, so keys
+    // that only differ in specialized or other stages' features share
+    const vk::ShaderModule VariantCache::Module(const vk::Device& device, const std::string& name, const vk::ShaderStageFlagBits stage, const FeatureKey features) {
+        const auto own{ StageFeatures(stage, features) };
+        const auto key{ ERCD::CombineKey(ERCD::HashBytes(name.data(), name.size()), own) };
+
+        auto found{ modules.find(key) };
+        if (found == modules.end()) {
+            found = modules.emplace(key, CreateShaderModule(device, VariantFile(name, stage, own))).first;
+        }
+        return found->second.get();
+    }
+}
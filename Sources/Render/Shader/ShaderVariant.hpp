@@ -0,0 +1,108 @@
+#ifndef RENDER_SHADER_SHADER_VARIANT_HPP
+#define RENDER_SHADER_SHADER_VARIANT_HPP
+
+#include "VKinclude/VKinclude.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace Engine::Render::Shader {
+
+    // Which variant of a shader to build a pipeline from, a set of Features.
+    //
+    // The low half are small toggles: specialization constants of the one
+    // SPIR-V module, constant_id is the bit index, so they cost a pipeline
+    // but no extra module and no runtime branch once the driver folds them.
+    // The high half change the shader's interface or most of its code and
+    // are compiled offline into modules of their own, see CompiledFeatures.
+    using FeatureKey = uint32_t;
+
+    namespace Features {
+        constexpr FeatureKey None           { 0 };
+
+        // Specialized, constant_id 0 and up
+        constexpr FeatureKey LightHeatmap   { 1u << 0 };    // Lights per cluster in place of shading
+        constexpr FeatureKey ShowNormals    { 1u << 1 };    // View space normals as colour
+
+        // Compiled
+        constexpr FeatureKey Unlit          { 1u << 16 };   // No clustered lighting, nothing read from set 1
+        constexpr FeatureKey StreamedTexture{ 1u << 17 };   // Base colour from the streamed texture in set 2
+
+        constexpr FeatureKey Specialized    { 0x0000ffffu };
+        constexpr FeatureKey Compiled       { 0xffff0000u };
+    }
+
+    struct CompiledFeature {
+        FeatureKey              Key;
+        const char*             Suffix;     // frag.spv with Unlit is frag_unlit.spv
+        const char*             Define;     // Passed to glslc as -D
+        vk::ShaderStageFlags    Stages;     // Only these have the variant
+    };
+
+    // Every compiled feature, in bit order. Variants are built next to the
+    // plain modules in GLSL/bin, one per combination in use, suffixes in
+    // this order:
+    //     glslc -fshader-stage=frag -DUNLIT shader.frag -o bin/frag_unlit.spv
+    //     glslc -fshader-stage=frag -DUNLIT -DTEXTURED shader.frag -o bin/frag_unlit_textured.spv
+    inline const std::array<CompiledFeature, 2> CompiledFeatures{ {
+        { Features::Unlit,           "unlit",    "UNLIT",    vk::ShaderStageFlagBits::eFragment },
+        { Features::StreamedTexture, "textured", "TEXTURED", vk::ShaderStageFlagBits::eFragment },
+    } };
+
+    // Module file of stage's variant, the compiled features stage doesn't
+    // have are ignored. Throws on a compiled bit with no CompiledFeature.
+    std::string VariantFile(const std::string& name, const vk::ShaderStageFlagBits stage, const FeatureKey features);
+
+    // Specialization constants for the low half of a key, one VkBool32 per
+    // bit. Constants a module doesn't declare are ignored, so every stage
+    // of a pipeline can share one.
+    class Specialization {
+
+    private:
+        static constexpr uint32_t ConstantCount{ 16 };
+
+        std::array<vk::SpecializationMapEntry, ConstantCount> entries;
+        std::array<vk::Bool32, ConstantCount> values;
+        vk::SpecializationInfo info;
+
+    public:
+        explicit Specialization(const FeatureKey features);
+
+        // No copies, info points into the object!
+        Specialization(const Specialization&) = delete;
+        Specialization& operator=(const Specialization&) = delete;
+
+        const vk::SpecializationInfo* Info() const { return &info; }
+    };
+
+    // Shader modules by file and compiled features, loaded the first time
+    // a pipeline asks for them. Specialized features share a module, so
+    // toggling them never reads or creates one.
+    class VariantCache {
+
+    private:
+        std::unordered_map<uint64_t, vk::UniqueShaderModule> modules;
+
+    public:
+        VariantCache() = default;
+
+        // No copies!
+        VariantCache(const VariantCache&) = delete;
+        VariantCache& operator=(const VariantCache&) = delete;
+
+        VariantCache(VariantCache&&) = default;
+        VariantCache& operator=(VariantCache&&) = default;
+
+        // name is the plain module, "frag" for frag.spv
+        const vk::ShaderModule Module(const vk::Device& device, const std::string& name, const vk::ShaderStageFlagBits stage, const FeatureKey features);
+        // Drops every module so the next pipelines read the files again.
+        // Pipelines built from them don't need them anymore.
+        void Clear() { modules.clear(); }
+
+        const size_t Size() const { return modules.size(); }
+    };
+}
+
+#endif // !RENDER_SHADER_SHADER_VARIANT_HPP
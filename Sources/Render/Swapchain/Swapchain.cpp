@@ -1,6 +1,9 @@
 #include "Swapchain.hpp"
 #include "Device/Physical.hpp"
 
+#include <stdexcept>
+#include <string>
+
 namespace Engine::Render::Swapchain {
 
     namespace ERD = Engine::Render::Device;
@@ -47,6 +50,11 @@ namespace Engine::Render::Swapchain {
         const auto capabs       { devInf.Get().getSurfaceCapabilitiesKHR(surface) };
         const auto imageCount   { capabs.minImageCount + 2 };
 
+        // Scaled frames are blitted in and readback copies out, when the
+        // surface allows it
+        const auto usage        { vk::ImageUsageFlagBits::eColorAttachment |
+            (capabs.supportedUsageFlags & (vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eTransferSrc)) };
+
         const auto swpInfo{ vk::SwapchainCreateInfoKHR()
             .setImageArrayLayers(1)
             .setImageExtent(capabs.currentExtent)
@@ -54,8 +62,7 @@ namespace Engine::Render::Swapchain {
             .setImageFormat(devInf.SurfaceFormat().format)
             .setImageColorSpace(devInf.SurfaceFormat().colorSpace)
             .setImageSharingMode(vk::SharingMode::eExclusive)
-            // TODO: use eTransferDst + memory OP to allow for post processing
-            .setImageUsage(vk::ImageUsageFlagBits::eColorAttachment)
+            .setImageUsage(usage)
             .setPreTransform(capabs.currentTransform)
             .setSurface(surface)
             // TODO: Handle the case when we use 2 different queues
@@ -89,4 +96,38 @@ namespace Engine::Render::Swapchain {
 
         return frameBuffers;
     }
+
+    namespace {
+        vk::Result CheckFrameResult(const vk::Result result, const char* what) {
+            switch (result) {
+                case vk::Result::eSuccess:
+                case vk::Result::eSuboptimalKHR:
+                case vk::Result::eErrorOutOfDateKHR:
+                    return result;
+                default:
+                    throw std::runtime_error(std::string(what) + " failed: " + vk::to_string(result));
+            }
+        }
+    }
+
+    // The C entry points, the vulkan.hpp wrappers throw on out of date
+    vk::Result AcquireNextImage(const vk::Device& renderDevice, const ERD::DeviceDispatch& d, const vk::SwapchainKHR& swapchain, const vk::Semaphore& signal, uint32_t& imageIndex) {
+        const auto result{ d.vkAcquireNextImageKHR(
+            static_cast<VkDevice>(renderDevice),
+            static_cast<VkSwapchainKHR>(swapchain),
+            UINT64_MAX,
+            static_cast<VkSemaphore>(signal),
+            VK_NULL_HANDLE,
+            &imageIndex) };
+
+        return CheckFrameResult(static_cast<vk::Result>(result), "Swapchain image acquire");
+    }
+
+    vk::Result Present(const vk::Queue& queue, const ERD::DeviceDispatch& d, const vk::PresentInfoKHR& presentInfo) {
+        const auto result{ d.vkQueuePresentKHR(
+            static_cast<VkQueue>(queue),
+            reinterpret_cast<const VkPresentInfoKHR*>(&presentInfo)) };
+
+        return CheckFrameResult(static_cast<vk::Result>(result), "Present");
+    }
 }
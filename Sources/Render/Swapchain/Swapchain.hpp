@@ -2,6 +2,7 @@
 #define RENDER_SWAPCHAIN_HPP
 
 #include "VKinclude/VKinclude.hpp"
+#include "Device/Dispatch.hpp"
 #include <vector>
 
 namespace Engine::Render::Device {
@@ -20,6 +21,11 @@ namespace Engine::Render::Swapchain {
     std::vector<vk::UniqueImageView>    CreateImageViews(const vk::Device& renderDevice, const Engine::Render::Device::PhysicalDevice& devInf, const std::vector<vk::Image>& swapImages);
     std::vector<vk::UniqueFramebuffer>  CreateFramebuffers(const vk::Device& renderDevice, const vk::RenderPass& renderPass, const std::vector<vk::UniqueImageView>& swapImageViews, const vk::Extent2D&);
 
+    // Per frame calls, these report eSuboptimalKHR and eErrorOutOfDateKHR
+    // as results instead of throwing. Anything else still throws.
+    vk::Result  AcquireNextImage(const vk::Device& renderDevice, const Engine::Render::Device::DeviceDispatch& d, const vk::SwapchainKHR& swapchain, const vk::Semaphore& signal, uint32_t& imageIndex);
+    vk::Result  Present(const vk::Queue& queue, const Engine::Render::Device::DeviceDispatch& d, const vk::PresentInfoKHR& presentInfo);
+
 }
 
 
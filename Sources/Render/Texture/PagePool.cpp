@@ -0,0 +1,49 @@
+#include "PagePool.hpp"
+
+#include <algorithm>
+
+namespace Engine::Render::Texture {
+
+    PagePool::PagePool(const vk::DeviceSize pageSize, const uint32_t memoryType, const uint32_t heap, const uint32_t maxPages, const uint32_t pagesPerChunk) :
+        pageSize(pageSize), memoryType(memoryType), heap(heap), pagesPerChunk(std::max(pagesPerChunk, 1u)), maxPages(maxPages) {}
+
+    std::optional<Page> PagePool::Acquire(const vk::Device& renderDevice) {
+        if (inUse >= maxPages) return std::nullopt;
+
+        if (freePages.empty()) {
+            const auto first{ static_cast<uint32_t>(chunks.size()) * pagesPerChunk };
+            const auto count{ std::min(pagesPerChunk, maxPages - first) };
+            if (count == 0) return std::nullopt;
+
+            chunks.emplace_back(renderDevice.allocateMemoryUnique(vk::MemoryAllocateInfo()
+                .setAllocationSize(pageSize * count)
+                .setMemoryTypeIndex(memoryType)
+            ));
+            tracked.emplace_back(renderDevice, heap, Engine::Render::Memory::MemoryCategory::Textures, pageSize * count);
+
+            // Hand out low ids first
+            for (uint32_t i = count; i > 0; --i) {
+                freePages.emplace_back(first + i - 1);
+            }
+        }
+
+        const auto id{ freePages.back() };
+        freePages.pop_back();
+        ++inUse;
+
+        return Lookup(id);
+    }
+
+    void PagePool::Release(const Page& page) {
+        freePages.emplace_back(page.Id);
+        --inUse;
+    }
+
+    const Page PagePool::Lookup(const uint32_t id) const {
+        return {
+            chunks[id / pagesPerChunk].get(),
+            pageSize * (id % pagesPerChunk),
+            id
+        };
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef RENDER_TEXTURE_PAGE_POOL_HPP
+#define RENDER_TEXTURE_PAGE_POOL_HPP
+
+#include "VKinclude/VKinclude.hpp"
+#include "Memory/Tracking.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace Engine::Render::Texture {
+
+    struct Page {
+        vk::DeviceMemory    Memory  {};
+        vk::DeviceSize      Offset  { 0 };
+        uint32_t            Id      { 0 };
+    };
+
+    // Fixed size pages carved out of a few large allocations, so binding a
+    // sparse tile never hits vkAllocateMemory (which is slow and limited in
+    // count). Chunks are allocated lazily, up to maxPages pages in total.
+    class PagePool {
+
+    private:
+        std::vector<vk::UniqueDeviceMemory> chunks;
+        std::vector<Engine::Render::Memory::TrackedAllocation> tracked;
+        std::vector<uint32_t>               freePages;
+
+        vk::DeviceSize  pageSize        { 0 };
+        uint32_t        memoryType      { 0 };
+        uint32_t        heap            { 0 };
+        uint32_t        pagesPerChunk   { 0 };
+        uint32_t        maxPages        { 0 };
+        uint32_t        inUse           { 0 };
+
+        const Page      Lookup(const uint32_t id) const;
+
+    public:
+        PagePool() = default;
+        PagePool(const vk::DeviceSize pageSize, const uint32_t memoryType, const uint32_t heap, const uint32_t maxPages, const uint32_t pagesPerChunk);
+
+        // No copies!
+        PagePool(const PagePool&) = delete;
+        PagePool& operator=(const PagePool&) = delete;
+
+        PagePool(PagePool&&) = default;
+        PagePool& operator=(PagePool&&) = default;
+
+        // Empty when every page is taken and the pool can't grow
+        std::optional<Page> Acquire(const vk::Device&);
+        void                Release(const Page&);
+
+        const vk::DeviceSize    PageSize()      const { return pageSize; }
+        const uint32_t          MemoryType()    const { return memoryType; }
+        const uint32_t          InUse()         const { return inUse; }
+        const uint32_t          Capacity()      const { return maxPages; }
+        const vk::DeviceSize    InUseBytes()    const { return pageSize * inUse; }
+        // Only the last chunk can be short, it stops at maxPages
+        const vk::DeviceSize    AllocatedBytes()const { return pageSize * std::min<uint64_t>(uint64_t{ pagesPerChunk } * chunks.size(), maxPages); }
+    };
+}
+
+#endif // !RENDER_TEXTURE_PAGE_POOL_HPP
@@ -0,0 +1,640 @@
+#include "StreamedTexture.hpp"
+#include "Command/Command.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace Engine::Render::Texture {
+
+    namespace EAT   = Engine::Assets::Texture;
+    namespace ERM   = Engine::Render::Memory;
+    namespace ERD   = Engine::Render::Device;
+    namespace ERCD  = Engine::Render::Command;
+
+    namespace {
+
+        constexpr vk::DeviceSize StagingAlignment{ 16 };
+
+        // Updates a lower resolution has to be enough for before the fallback drops mips
+        constexpr uint32_t DowngradeDelay{ 120 };
+
+        const auto TextureUsage{ vk::ImageUsageFlags() | vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst };
+        const auto HostMemory  { vk::MemoryPropertyFlags() | vk::MemoryPropertyFlagBits::eHostCoherent | vk::MemoryPropertyFlagBits::eHostVisible };
+
+        vk::Format ToVkFormat(const EAT::TexelFormat format) {
+            switch (format) {
+                case EAT::TexelFormat::Rgba8Unorm:  return vk::Format::eR8G8B8A8Unorm;
+                case EAT::TexelFormat::Rgba8Srgb:   return vk::Format::eR8G8B8A8Srgb;
+                default:                            throw std::runtime_error("Unhandled texel format");
+            }
+        }
+
+        vk::DeviceSize AlignUp(const vk::DeviceSize bytes, const vk::DeviceSize alignment) {
+            return (bytes + alignment - 1) / alignment * alignment;
+        }
+
+        vk::UniqueImageView CreateView(const vk::Device& renderDevice, const vk::Image& image, const vk::Format format, const uint32_t levels) {
+            return renderDevice.createImageViewUnique(vk::ImageViewCreateInfo()
+                .setImage(image)
+                .setViewType(vk::ImageViewType::e2D)
+                .setFormat(format)
+                .setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, levels, 0, 1))
+            );
+        }
+
+        vk::BufferImageCopy CopyRegion(const vk::DeviceSize offset, const uint32_t level, const EAT::TileRegion& region) {
+            return vk::BufferImageCopy()
+                .setBufferOffset(offset)
+                .setBufferRowLength(0)
+                .setBufferImageHeight(0)
+                .setImageSubresource(vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, level, 0, 1))
+                .setImageOffset(vk::Offset3D(static_cast<int32_t>(region.X), static_cast<int32_t>(region.Y), 0))
+                .setImageExtent(vk::Extent3D(region.Width, region.Height, 1));
+        }
+
+        // Streamed images stay in eGeneral for life, tiles are written while
+        // other tiles of the same mip are being sampled
+        void TransitionToGeneral(const vk::CommandBuffer& cmdBuffer, const vk::Image& image, const uint32_t levels) {
+            cmdBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer, {}, nullptr, nullptr,
+                vk::ImageMemoryBarrier()
+                    .setDstAccessMask(vk::AccessFlagBits::eTransferWrite)
+                    .setOldLayout(vk::ImageLayout::eUndefined)
+                    .setNewLayout(vk::ImageLayout::eGeneral)
+                    .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+                    .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+                    .setImage(image)
+                    .setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, levels, 0, 1))
+            );
+        }
+    }
+
+    std::optional<vk::DeviceSize> UploadBatch::Reserve(const vk::DeviceSize bytes) {
+        const auto offset{ (StagingUsed + StagingAlignment - 1) & ~(StagingAlignment - 1) };
+        if (offset + bytes > StagingSize) return std::nullopt;
+
+        StagingUsed = offset + bytes;
+        return offset;
+    }
+
+    StreamedTexture::StreamedTexture(const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo, const vk::Queue& queue, const vk::CommandPool& pool, const std::string& path, const bool sparseSupported, const uint32_t framesInFlight) :
+        file(path), format(ToVkFormat(file.Header().Format)), framesInFlight(framesInFlight) {
+
+        tilesX = file.Mip(0).TilesX;
+        tilesY = file.Mip(0).TilesY;
+        requested.assign(size_t{ tilesX } * tilesY, NotRequested);
+
+        // Regions are bound at their offsets, which the device may want aligned
+        const auto alignment{ std::max<vk::DeviceSize>(deviceInfo.Get().getProperties().limits.minStorageBufferOffsetAlignment, sizeof(uint32_t)) };
+        feedbackStride  = AlignUp(FeedbackRange(), alignment);
+        residencyStride = AlignUp(ResidencyRange(), alignment);
+
+        feedback = ERM::DeviceMemory<uint32_t>(renderDevice, deviceInfo, vk::BufferCreateInfo()
+            .setSharingMode(vk::SharingMode::eExclusive)
+            .setSize(feedbackStride * framesInFlight)
+            .setUsage(vk::BufferUsageFlagBits::eStorageBuffer),
+            HostMemory
+        );
+        std::fill_n(feedback.Mapped(renderDevice), feedbackStride * framesInFlight / sizeof(uint32_t), NotRequested);
+
+        residency = ERM::DeviceMemory<uint32_t>(renderDevice, deviceInfo, vk::BufferCreateInfo()
+            .setSharingMode(vk::SharingMode::eExclusive)
+            .setSize(residencyStride * framesInFlight)
+            .setUsage(vk::BufferUsageFlagBits::eStorageBuffer),
+            HostMemory
+        );
+        residencyTable.resize(ResidencyRange() / sizeof(uint32_t));
+        residencyStale.assign(framesInFlight, true);
+
+        sparse = sparseSupported && SparseCompatible(deviceInfo, format, file.Header());
+
+        if (sparse) CreateSparse(renderDevice, deviceInfo, queue, pool);
+        else        CreateWholeMip(renderDevice, deviceInfo, queue, pool);
+
+        UpdateResidency();
+        for (uint32_t slot = 0; slot < framesInFlight; ++slot) {
+            Publish(renderDevice, slot);
+        }
+    }
+
+    bool StreamedTexture::SparseCompatible(const ERD::PhysicalDevice& deviceInfo, const vk::Format format, const EAT::TextureHeader& header) {
+        const auto properties{ deviceInfo.Get().getSparseImageFormatProperties(
+            format, vk::ImageType::e2D, vk::SampleCountFlagBits::e1, TextureUsage, vk::ImageTiling::eOptimal)
+        };
+
+        for (const auto& p : properties) {
+            if (p.aspectMask & vk::ImageAspectFlagBits::eColor) {
+                return !(p.flags & vk::SparseImageFormatFlagBits::eNonstandardBlockSize) &&
+                    p.imageGranularity.width  == header.TileWidth &&
+                    p.imageGranularity.height == header.TileHeight &&
+                    p.imageGranularity.depth  == 1;
+            }
+        }
+
+        return false;
+    }
+
+    void StreamedTexture::CreateSparse(const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo, const vk::Queue& queue, const vk::CommandPool& pool) {
+        const auto& header{ file.Header() };
+
+        image = renderDevice.createImageUnique(vk::ImageCreateInfo()
+            .setFlags(vk::ImageCreateFlagBits::eSparseBinding | vk::ImageCreateFlagBits::eSparseResidency)
+            .setImageType(vk::ImageType::e2D)
+            .setFormat(format)
+            .setExtent(vk::Extent3D(header.Width, header.Height, 1))
+            .setMipLevels(header.MipCount)
+            .setArrayLayers(1)
+            .setSamples(vk::SampleCountFlagBits::e1)
+            .setTiling(vk::ImageTiling::eOptimal)
+            .setUsage(TextureUsage)
+            .setSharingMode(vk::SharingMode::eExclusive)
+            .setInitialLayout(vk::ImageLayout::eUndefined)
+        );
+
+        const auto requirements{ renderDevice.getImageMemoryRequirements(image.get()) };
+        memoryTypeBits  = requirements.memoryTypeBits;
+        pageSize        = requirements.alignment;
+
+        const auto memoryProperties{ deviceInfo.Get().getMemoryProperties() };
+        const auto memoryType{ ERM::FindMemoryType(memoryProperties, memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal) };
+
+        // The mip tail (and metadata, if the format has any) can't be bound
+        // per tile, it is bound once and stays resident for good
+        tailFirstMip = header.MipCount;
+        std::vector<vk::SparseMemoryBind> opaqueBinds{};
+
+        for (const auto& req : renderDevice.getImageSparseMemoryRequirements(image.get())) {
+            const bool metadata{ static_cast<bool>(req.formatProperties.aspectMask & vk::ImageAspectFlagBits::eMetadata) };
+
+            if (!metadata) tailFirstMip = std::min(req.imageMipTailFirstLod, header.MipCount);
+            if (req.imageMipTailFirstLod >= header.MipCount || req.imageMipTailSize == 0) continue;
+
+            // Single layer, so one tail whether or not the format has eSingleMiptail
+            tailMemory.emplace_back(renderDevice.allocateMemoryUnique(vk::MemoryAllocateInfo()
+                .setAllocationSize(req.imageMipTailSize)
+                .setMemoryTypeIndex(memoryType)
+            ));
+            tailTracked.emplace_back(renderDevice, ERM::HeapOfType(memoryProperties, memoryType), ERM::MemoryCategory::Textures, req.imageMipTailSize);
+
+            opaqueBinds.emplace_back(vk::SparseMemoryBind()
+                .setResourceOffset(req.imageMipTailOffset)
+                .setSize(req.imageMipTailSize)
+                .setMemory(tailMemory.back().get())
+                .setFlags(metadata ? vk::SparseMemoryBindFlagBits::eMetadata : vk::SparseMemoryBindFlags())
+            );
+        }
+
+        if (!opaqueBinds.empty()) {
+            const auto opaqueInfo{ vk::SparseImageOpaqueMemoryBindInfo()
+                .setImage(image.get())
+                .setBindCount(static_cast<uint32_t>(opaqueBinds.size()))
+                .setPBinds(opaqueBinds.data())
+            };
+
+            const auto fence{ renderDevice.createFenceUnique({}) };
+            queue.bindSparse(vk::BindSparseInfo()
+                .setImageOpaqueBindCount(1)
+                .setPImageOpaqueBinds(&opaqueInfo),
+                fence.get()
+            );
+            renderDevice.waitForFences(1, &fence.get(), true, UINT64_MAX);
+        }
+
+        tiles.resize(file.Mip(header.MipCount - 1).FirstTile + 1);
+        for (uint32_t m = 0; m < header.MipCount; ++m) {
+            const auto& mip{ file.Mip(m) };
+
+            for (uint32_t y = 0; y < mip.TilesY; ++y) {
+                for (uint32_t x = 0; x < mip.TilesX; ++x) {
+                    auto& tile{ tiles[TileIndex(m, x, y)] };
+                    tile.X      = static_cast<uint16_t>(x);
+                    tile.Y      = static_cast<uint16_t>(y);
+                    tile.Mip    = static_cast<uint8_t>(m);
+
+                    // Without a tail something still has to always be there
+                    tile.Pinned = tailFirstMip == header.MipCount && m == header.MipCount - 1;
+                }
+            }
+        }
+
+        // Fill the tail now, it is small and everything falls back to it
+        ERM::DeviceMemory<std::byte> staging{};
+
+        if (tailFirstMip < header.MipCount) {
+            staging = ERM::DeviceMemory<std::byte>(renderDevice, deviceInfo, vk::BufferCreateInfo()
+                .setSharingMode(vk::SharingMode::eExclusive)
+                .setSize(BytesFrom(tailFirstMip))
+                .setUsage(vk::BufferUsageFlagBits::eTransferSrc),
+                HostMemory
+            );
+        }
+
+        ERCD::SubmitOnce(renderDevice, queue, pool, [&](const vk::CommandBuffer& cmdBuffer) {
+            TransitionToGeneral(cmdBuffer, image.get(), header.MipCount);
+
+            if (tailFirstMip < header.MipCount) {
+                RecordMipUploads(cmdBuffer, image.get(), *staging.Buffer(), staging.Mapped(renderDevice), tailFirstMip, 0);
+            }
+        });
+    }
+
+    void StreamedTexture::CreateWholeMip(const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo, const vk::Queue& queue, const vk::CommandPool& pool) {
+        const auto& header{ file.Header() };
+
+        // Start from the first mip that fits in a single tile
+        uint32_t baseMip{ 0 };
+        while (baseMip + 1 < header.MipCount && file.Mip(baseMip).TilesX * file.Mip(baseMip).TilesY > 1) {
+            ++baseMip;
+        }
+
+        current = AllocateWholeMip(renderDevice, deviceInfo, baseMip);
+
+        auto staging{ ERM::DeviceMemory<std::byte>(renderDevice, deviceInfo, vk::BufferCreateInfo()
+            .setSharingMode(vk::SharingMode::eExclusive)
+            .setSize(BytesFrom(baseMip))
+            .setUsage(vk::BufferUsageFlagBits::eTransferSrc),
+            HostMemory
+        ) };
+
+        ERCD::SubmitOnce(renderDevice, queue, pool, [&](const vk::CommandBuffer& cmdBuffer) {
+            TransitionToGeneral(cmdBuffer, current.Image.get(), header.MipCount - baseMip);
+            RecordMipUploads(cmdBuffer, current.Image.get(), *staging.Buffer(), staging.Mapped(renderDevice), baseMip, baseMip);
+        });
+    }
+
+    StreamedTexture::WholeMipImage StreamedTexture::AllocateWholeMip(const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo, const uint32_t baseMip) const {
+        const auto& header{ file.Header() };
+        const auto  levels{ header.MipCount - baseMip };
+
+        WholeMipImage result{};
+        result.BaseMip = baseMip;
+
+        result.Image = renderDevice.createImageUnique(vk::ImageCreateInfo()
+            .setImageType(vk::ImageType::e2D)
+            .setFormat(format)
+            .setExtent(vk::Extent3D(EAT::MipExtent(header.Width, baseMip), EAT::MipExtent(header.Height, baseMip), 1))
+            .setMipLevels(levels)
+            .setArrayLayers(1)
+            .setSamples(vk::SampleCountFlagBits::e1)
+            .setTiling(vk::ImageTiling::eOptimal)
+            .setUsage(TextureUsage)
+            .setSharingMode(vk::SharingMode::eExclusive)
+            .setInitialLayout(vk::ImageLayout::eUndefined)
+        );
+
+        const auto requirements{ renderDevice.getImageMemoryRequirements(result.Image.get()) };
+        result.Bytes = requirements.size;
+
+        const auto memoryProperties{ deviceInfo.Get().getMemoryProperties() };
+        const auto memoryType{ ERM::FindMemoryType(memoryProperties, requirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal) };
+
+        result.Memory = renderDevice.allocateMemoryUnique(vk::MemoryAllocateInfo()
+            .setAllocationSize(requirements.size)
+            .setMemoryTypeIndex(memoryType)
+        );
+        result.Tracked = ERM::TrackedAllocation(renderDevice, ERM::HeapOfType(memoryProperties, memoryType), ERM::MemoryCategory::Textures, requirements.size);
+
+        renderDevice.bindImageMemory(result.Image.get(), result.Memory.get(), 0u);
+        result.View = CreateView(renderDevice, result.Image.get(), format, levels);
+
+        return result;
+    }
+
+    // Tiles are packed back to back in file order, baseMip is the image's mip 0
+    void StreamedTexture::RecordMipUploads(const vk::CommandBuffer& cmdBuffer, const vk::Image& target, const vk::Buffer& buffer, std::byte* staging, const uint32_t firstMip, const uint32_t baseMip) const {
+        std::vector<vk::BufferImageCopy> regions{};
+        vk::DeviceSize offset{ 0 };
+
+        for (uint32_t m = firstMip; m < file.MipCount(); ++m) {
+            const auto& mip{ file.Mip(m) };
+            regions.clear();
+
+            for (uint32_t y = 0; y < mip.TilesY; ++y) {
+                for (uint32_t x = 0; x < mip.TilesX; ++x) {
+                    const auto blob{ file.Tile(m, x, y) };
+
+                    std::memcpy(staging + offset, blob.Data, blob.Size);
+                    regions.emplace_back(CopyRegion(offset, m - baseMip, file.Region(m, x, y)));
+                    offset += blob.Size;
+                }
+            }
+
+            cmdBuffer.copyBufferToImage(buffer, target, vk::ImageLayout::eGeneral, regions);
+        }
+    }
+
+    void StreamedTexture::ReadFeedback(const vk::Device& renderDevice, const uint32_t slot) {
+        const auto regionSize{ requested.size() };
+        auto* region{ feedback.Mapped(renderDevice) + FeedbackOffset(slot) / sizeof(uint32_t) };
+
+        std::copy_n(region, regionSize, requested.begin());
+        std::fill_n(region, regionSize, NotRequested);
+    }
+
+    // Earlier frames read the other regions, so a change reaches each one
+    // when its own frame comes around
+    void StreamedTexture::Publish(const vk::Device& renderDevice, const uint32_t slot) {
+        if (!residencyStale[slot]) return;
+
+        auto* region{ residency.Mapped(renderDevice) + ResidencyOffset(slot) / sizeof(uint32_t) };
+        std::copy(residencyTable.cbegin(), residencyTable.cend(), region);
+        residencyStale[slot] = false;
+    }
+
+    void StreamedTexture::Stream(const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo, UploadBatch& batch) {
+        if (sparse) StreamSparse(renderDevice, batch);
+        else        StreamWholeMip(renderDevice, deviceInfo, batch);
+    }
+
+    void StreamedTexture::StreamSparse(const vk::Device& renderDevice, UploadBatch& batch) {
+
+        // Unbind evicted tiles no frame in flight can sample anymore
+        const auto retired{ std::find_if(evicting.begin(), evicting.end(), [&](const auto& e) {
+            return !batch.Retired(e.first);
+        }) };
+
+        for (auto i{ evicting.begin() }; i != retired; ++i) {
+            auto& tile{ tiles[i->second] };
+
+            binds.emplace_back(TileBind(tile, nullptr, 0));
+            unboundPages.emplace_back(tile.Memory);
+            tile.Memory = {};
+            tile.State  = TileState::Absent;
+        }
+        evicting.erase(evicting.begin(), retired);
+
+        // Everything sampled last time, and the coarser tiles under it, is in use
+        missing.clear();
+
+        const auto touch{ [&](const uint32_t index) {
+            auto& tile{ tiles[index] };
+            if (tile.LastUsed == batch.Frame) return;
+            tile.LastUsed = batch.Frame;
+
+            if (tile.State == TileState::Evicting) {
+                // Still bound, take it back
+                tile.State = TileState::Resident;
+                evicting.erase(std::find_if(evicting.begin(), evicting.end(), [&](const auto& e) { return e.second == index; }));
+                residencyDirty = true;
+            }
+            else if (tile.State == TileState::Absent) {
+                missing.emplace_back(index);
+            }
+        }};
+
+        for (uint32_t y0 = 0; y0 < tilesY; ++y0) {
+            for (uint32_t x0 = 0; x0 < tilesX; ++x0) {
+                const auto mip{ requested[y0 * tilesX + x0] };
+                if (mip == NotRequested) continue;
+
+                for (auto m{ mip }; m < tailFirstMip; ++m) {
+                    touch(TileIndexFromMip0(m, x0, y0));
+                }
+            }
+        }
+
+        if (tailFirstMip == file.MipCount()) {
+            const auto& last{ file.Mip(file.MipCount() - 1) };
+            for (uint32_t i = 0; i < last.TilesX * last.TilesY; ++i) {
+                touch(last.FirstTile + i);
+            }
+        }
+
+        // Coarse tiles first, they unlock residency for everything above them
+        std::sort(missing.begin(), missing.end(), [&](const uint32_t a, const uint32_t b) {
+            return tiles[a].Mip > tiles[b].Mip;
+        });
+
+        for (size_t i = 0; i < missing.size(); ++i) {
+            auto& tile{ tiles[missing[i]] };
+
+            if (batch.UsedBytes + pageSize > batch.BudgetBytes) {
+                Evict(batch, missing.size() - i);
+                break;
+            }
+
+            const auto blob  { file.Tile(tile.Mip, tile.X, tile.Y) };
+            const auto offset{ batch.Reserve(blob.Size) };
+            if (!offset) break;
+
+            const auto page{ batch.Pages->Acquire(renderDevice) };
+            if (!page) {
+                Evict(batch, missing.size() - i);
+                break;
+            }
+
+            tile.Memory = *page;
+            tile.State  = TileState::Uploading;
+            binds.emplace_back(TileBind(tile, page->Memory, page->Offset));
+
+            std::memcpy(batch.StagingData + *offset, blob.Data, blob.Size);
+            file.File().Release(blob.Offset, blob.Size);
+
+            batch.Commands.copyBufferToImage(batch.Staging, image.get(), vk::ImageLayout::eGeneral,
+                CopyRegion(*offset, tile.Mip, file.Region(tile.Mip, tile.X, tile.Y)), *batch.Dispatch
+            );
+
+            uploading.emplace_back(batch.Frame, missing[i]);
+            batch.UsedBytes += pageSize;
+            batch.Recorded   = true;
+            ++batch.Uploads;
+        }
+
+        if (residencyDirty) UpdateResidency();
+    }
+
+    // Least recently sampled first. Evicted tiles stop being sampled right
+    // away, but their pages only come back once the unbind is safe.
+    void StreamedTexture::Evict(UploadBatch& batch, const size_t count) {
+        auto& candidates{ evictCandidates };
+        candidates.clear();
+
+        for (uint32_t i = 0; i < tiles.size(); ++i) {
+            const auto& tile{ tiles[i] };
+            if (tile.State == TileState::Resident && !tile.Pinned && tile.LastUsed < batch.Frame) {
+                candidates.emplace_back(i);
+            }
+        }
+
+        const auto evictCount{ std::min(count, candidates.size()) };
+        if (evictCount == 0) return;
+
+        std::nth_element(candidates.begin(), candidates.begin() + (evictCount - 1), candidates.end(), [&](const uint32_t a, const uint32_t b) {
+            return tiles[a].LastUsed < tiles[b].LastUsed;
+        });
+
+        for (size_t i = 0; i < evictCount; ++i) {
+            tiles[candidates[i]].State = TileState::Evicting;
+            evicting.emplace_back(batch.Frame, candidates[i]);
+        }
+
+        batch.Evictions += static_cast<uint32_t>(evictCount);
+        residencyDirty = true;
+    }
+
+    void StreamedTexture::StreamWholeMip(const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo, UploadBatch& batch) {
+        // One rebuild at a time
+        if (next) return;
+
+        const auto desired{ *std::min_element(requested.cbegin(), requested.cend()) };
+        if (desired == NotRequested && !forceDowngrade) return;
+
+        // Drop detail until it fits next to everything else
+        const auto others   { batch.UsedBytes - current.Bytes };
+        const auto available{ batch.BudgetBytes > others ? batch.BudgetBytes - others : 0 };
+
+        auto target{ std::min(desired, file.MipCount() - 1) };
+        while (target + 1 < file.MipCount() && BytesFrom(target) > available) {
+            ++target;
+        }
+
+        if (forceDowngrade) {
+            target = std::max(target, std::min(current.BaseMip + 1, file.MipCount() - 1));
+        }
+
+        if (target == current.BaseMip) {
+            coarserUpdates = 0;
+            forceDowngrade = false;
+            return;
+        }
+
+        // Sharpen right away, but don't throw mips away on a brief zoom out
+        if (target > current.BaseMip && !forceDowngrade && ++coarserUpdates < DowngradeDelay) return;
+        coarserUpdates = 0;
+        forceDowngrade = false;
+
+        next = AllocateWholeMip(renderDevice, deviceInfo, target);
+
+        auto staging{ ERM::DeviceMemory<std::byte>(renderDevice, deviceInfo, vk::BufferCreateInfo()
+            .setSharingMode(vk::SharingMode::eExclusive)
+            .setSize(BytesFrom(target))
+            .setUsage(vk::BufferUsageFlagBits::eTransferSrc),
+            HostMemory
+        ) };
+
+        TransitionToGeneral(batch.Commands, next->Image.get(), file.MipCount() - target);
+        RecordMipUploads(batch.Commands, next->Image.get(), *staging.Buffer(), staging.Mapped(renderDevice), target, target);
+
+        batch.Deletion->Retire(std::move(staging), batch.Frame);
+        batch.UsedBytes += next->Bytes;
+        batch.Uploads   += file.MipCount() - target;
+        batch.Recorded   = true;
+        nextFrame        = batch.Frame;
+    }
+
+    vk::DeviceSize StreamedTexture::Trim(UploadBatch& batch, const vk::DeviceSize bytes) {
+        if (sparse) {
+            const auto before{ evicting.size() };
+            Evict(batch, static_cast<size_t>((bytes + pageSize - 1) / pageSize));
+
+            if (residencyDirty) UpdateResidency();
+            return pageSize * (evicting.size() - before);
+        }
+
+        if (next || current.BaseMip + 1 >= file.MipCount()) return 0;
+
+        // Mip 0 of the image is about three quarters of it
+        forceDowngrade = true;
+        return current.Bytes * 3 / 4;
+    }
+
+    void StreamedTexture::BindsSubmitted(PagePool& pages) {
+        for (const auto& page : unboundPages) {
+            pages.Release(page);
+        }
+        unboundPages.clear();
+        binds.clear();
+    }
+
+    void StreamedTexture::UploadsComplete(ERM::DeletionQueue& deletionQueue, const uint64_t frame, const uint64_t currentFrame) {
+        if (sparse) {
+            const auto done{ std::find_if(uploading.begin(), uploading.end(), [&](const auto& u) {
+                return u.first > frame;
+            }) };
+
+            for (auto i{ uploading.begin() }; i != done; ++i) {
+                tiles[i->second].State = TileState::Resident;
+            }
+
+            residencyDirty |= done != uploading.begin();
+            uploading.erase(uploading.begin(), done);
+
+            if (residencyDirty) UpdateResidency();
+        }
+        else if (next && nextFrame <= frame) {
+            deletionQueue.Retire(std::move(current), currentFrame);
+            current = std::move(*next);
+            next.reset();
+            UpdateResidency();
+        }
+    }
+
+    // A mip 0 tile can sample down to mip m if the tile covering it is
+    // resident at m and every coarser mip, the tail always is
+    void StreamedTexture::UpdateResidency() {
+        auto* data{ residencyTable.data() };
+
+        const ResidencyHeader header{ sparse ? 0u : current.BaseMip, tilesX, tilesY, file.MipCount() };
+        std::memcpy(data, &header, sizeof(header));
+
+        auto* minMip{ data + sizeof(ResidencyHeader) / sizeof(uint32_t) };
+
+        for (uint32_t y0 = 0; y0 < tilesY; ++y0) {
+            for (uint32_t x0 = 0; x0 < tilesX; ++x0) {
+                if (!sparse) {
+                    minMip[y0 * tilesX + x0] = current.BaseMip;
+                    continue;
+                }
+
+                auto mip{ tailFirstMip };
+                while (mip > 0 && tiles[TileIndexFromMip0(mip - 1, x0, y0)].State == TileState::Resident) {
+                    --mip;
+                }
+                minMip[y0 * tilesX + x0] = std::min(mip, file.MipCount() - 1);
+            }
+        }
+
+        residencyDirty = false;
+        residencyStale.assign(framesInFlight, true);
+    }
+
+    const vk::SparseImageMemoryBind StreamedTexture::TileBind(const Tile& tile, const vk::DeviceMemory& memory, const vk::DeviceSize memoryOffset) const {
+        const auto region{ file.Region(tile.Mip, tile.X, tile.Y) };
+
+        return vk::SparseImageMemoryBind()
+            .setSubresource(vk::ImageSubresource(vk::ImageAspectFlagBits::eColor, tile.Mip, 0))
+            .setOffset(vk::Offset3D(static_cast<int32_t>(region.X), static_cast<int32_t>(region.Y), 0))
+            .setExtent(vk::Extent3D(region.Width, region.Height, 1))
+            .setMemory(memory)
+            .setMemoryOffset(memoryOffset);
+    }
+
+    const uint32_t StreamedTexture::TileIndex(const uint32_t mip, const uint32_t x, const uint32_t y) const {
+        const auto& entry{ file.Mip(mip) };
+        return entry.FirstTile + y * entry.TilesX + x;
+    }
+
+    // Tiles are the same size at every mip, so mip 0 tile (x0, y0) lies in tile (x0 >> m, y0 >> m)
+    const uint32_t StreamedTexture::TileIndexFromMip0(const uint32_t mip, const uint32_t x0, const uint32_t y0) const {
+        const auto& entry{ file.Mip(mip) };
+        return TileIndex(mip, std::min(x0 >> mip, entry.TilesX - 1), std::min(y0 >> mip, entry.TilesY - 1));
+    }
+
+    const vk::DeviceSize StreamedTexture::BytesFrom(const uint32_t mip) const {
+        vk::DeviceSize bytes{ 0 };
+        for (auto m{ mip }; m < file.MipCount(); ++m) {
+            bytes += file.MipBytes(m);
+        }
+        return bytes;
+    }
+
+    const vk::DeviceSize StreamedTexture::WholeMipBytes() const {
+        return current.Bytes + (next ? next->Bytes : 0);
+    }
+
+    const uint32_t StreamedTexture::ResidentTiles() const {
+        return static_cast<uint32_t>(std::count_if(tiles.cbegin(), tiles.cend(), [](const Tile& t) {
+            return t.State == TileState::Resident;
+        }));
+    }
+}
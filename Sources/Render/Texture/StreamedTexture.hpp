@@ -0,0 +1,204 @@
+#ifndef RENDER_TEXTURE_STREAMED_TEXTURE_HPP
+#define RENDER_TEXTURE_STREAMED_TEXTURE_HPP
+
+#include "VKinclude/VKinclude.hpp"
+#include "PagePool.hpp"
+#include "Memory/Buffers.hpp"
+#include "Memory/DeletionQueue.hpp"
+#include "Device/Dispatch.hpp"
+#include "Assets/Texture/TextureFile.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Engine::Render::Texture {
+
+    constexpr uint32_t NotRequested{ 0xFFFFFFFF };
+
+    // Start of the residency buffer, followed by one uint per mip 0 tile holding
+    // the finest mip resident there. Read by GLSL/streamed_texture.glsl
+    struct ResidencyHeader {
+        uint32_t BaseMip;       // File mip that is mip 0 of the bound image
+        uint32_t TilesX;
+        uint32_t TilesY;
+        uint32_t MipCount;
+    };
+
+    // Scratch for one streaming update, owned by the TextureStreamer.
+    // Textures record their copies into it and queue their sparse binds.
+    struct UploadBatch {
+        vk::CommandBuffer               Commands;
+        const Engine::Render::Device::DeviceDispatch* Dispatch { nullptr };
+        vk::Buffer                      Staging;
+        std::byte*                      StagingData     { nullptr };
+        vk::DeviceSize                  StagingUsed     { 0 };
+        vk::DeviceSize                  StagingSize     { 0 };
+        PagePool*                       Pages           { nullptr };
+        Engine::Render::Memory::DeletionQueue* Deletion { nullptr };
+        uint64_t                        Frame           { 0 };
+        uint32_t                        FramesInFlight  { 0 };
+        vk::DeviceSize                  BudgetBytes     { 0 };
+        vk::DeviceSize                  UsedBytes       { 0 };  // Pages and whole-mip images of every texture
+        uint32_t                        Uploads         { 0 };
+        uint32_t                        Evictions       { 0 };
+        bool                            Recorded        { false };
+
+        // Staging offset for bytes, empty once this batch's staging is used up
+        std::optional<vk::DeviceSize> Reserve(const vk::DeviceSize bytes);
+
+        // True once every frame that could have seen the state of frame has finished
+        const bool Retired(const uint64_t frame) const { return Frame >= frame + FramesInFlight; }
+    };
+
+    // A texture larger than we can afford to keep resident. With sparse
+    // residency the image is created at full size but only the mip tail is
+    // backed up front, 64 KiB tiles are bound from a shared PagePool and
+    // filled from the mapped file as shaders ask for them, and the least
+    // recently sampled ones are unbound when the budget runs out.
+    //
+    // Without sparse residency it falls back to whole mips: the image holds
+    // mips [BaseMip, MipCount) and is rebuilt with more or fewer of them.
+    //
+    // Shaders report the mip they wanted per mip 0 tile into a feedback
+    // buffer and clamp their LOD to what the residency buffer says is
+    // there. Both have one region per frame in flight, a frame's residency
+    // region is only rewritten once that frame finished, see Publish.
+    class StreamedTexture {
+
+    private:
+        enum class TileState : uint8_t {
+            Absent,
+            Uploading,
+            Resident,
+            Evicting        // Unbound once no frame in flight can sample it
+        };
+
+        struct Tile {
+            Page        Memory      {};
+            uint64_t    LastUsed    { UINT64_MAX };
+            uint16_t    X           { 0 };
+            uint16_t    Y           { 0 };
+            uint8_t     Mip         { 0 };
+            TileState   State       { TileState::Absent };
+            bool        Pinned      { false };
+        };
+
+        struct WholeMipImage {
+            vk::UniqueImage         Image;
+            vk::UniqueDeviceMemory  Memory;
+            vk::UniqueImageView     View;
+            Engine::Render::Memory::TrackedAllocation Tracked;
+            uint32_t                BaseMip { 0 };
+            vk::DeviceSize          Bytes   { 0 };
+        };
+
+        Engine::Assets::Texture::TextureFile        file;
+        vk::Format                                  format{};
+        bool                                        sparse{ false };
+        uint32_t                                    framesInFlight{ 0 };
+
+        // Sparse path
+        vk::UniqueImage                             image;
+        vk::UniqueImageView                         view;
+        std::vector<vk::UniqueDeviceMemory>         tailMemory;
+        std::vector<Engine::Render::Memory::TrackedAllocation> tailTracked;
+        uint32_t                                    memoryTypeBits{ 0 };
+        vk::DeviceSize                              pageSize{ 0 };
+        uint32_t                                    tailFirstMip{ 0 };
+        std::vector<Tile>                           tiles;
+        // Both in frame order, so whatever is done is always a prefix
+        std::vector<std::pair<uint64_t, uint32_t>>  uploading;
+        std::vector<std::pair<uint64_t, uint32_t>>  evicting;
+        std::vector<vk::SparseImageMemoryBind>      binds;
+        std::vector<Page>                           unboundPages;
+        std::vector<uint32_t>                       missing;
+        std::vector<uint32_t>                       evictCandidates;
+        bool                                        residencyDirty{ false };
+
+        // Whole-mip fallback
+        WholeMipImage                               current;
+        std::optional<WholeMipImage>                next;
+        uint64_t                                    nextFrame{ 0 };
+        uint32_t                                    coarserUpdates{ 0 };
+        bool                                        forceDowngrade{ false };
+
+        // Shader feedback
+        Engine::Render::Memory::DeviceMemory<uint32_t> feedback;
+        Engine::Render::Memory::DeviceMemory<uint32_t> residency;
+        uint32_t                                    tilesX{ 0 };
+        uint32_t                                    tilesY{ 0 };
+        vk::DeviceSize                              feedbackStride{ 0 };    // Bytes, regions are storage buffer offset aligned
+        vk::DeviceSize                              residencyStride{ 0 };
+        std::vector<uint32_t>                       requested;
+        std::vector<uint32_t>                       residencyTable;         // Header and min mips, copied out by Publish
+        std::vector<bool>                           residencyStale;         // Per region
+
+        const uint32_t      TileIndex(const uint32_t mip, const uint32_t x, const uint32_t y) const;
+        const uint32_t      TileIndexFromMip0(const uint32_t mip, const uint32_t x0, const uint32_t y0) const;
+        const vk::DeviceSize BytesFrom(const uint32_t mip) const;
+
+        void CreateSparse(const vk::Device&, const Engine::Render::Device::PhysicalDevice&, const vk::Queue&, const vk::CommandPool&);
+        void CreateWholeMip(const vk::Device&, const Engine::Render::Device::PhysicalDevice&, const vk::Queue&, const vk::CommandPool&);
+        WholeMipImage AllocateWholeMip(const vk::Device&, const Engine::Render::Device::PhysicalDevice&, const uint32_t baseMip) const;
+        void RecordMipUploads(const vk::CommandBuffer&, const vk::Image&, const vk::Buffer&, std::byte* staging, const uint32_t firstMip, const uint32_t baseMip) const;
+        const vk::SparseImageMemoryBind TileBind(const Tile&, const vk::DeviceMemory&, const vk::DeviceSize memoryOffset) const;
+
+        void StreamSparse(const vk::Device&, UploadBatch&);
+        void StreamWholeMip(const vk::Device&, const Engine::Render::Device::PhysicalDevice&, UploadBatch&);
+        void Evict(UploadBatch&, const size_t count);
+        void UpdateResidency();
+
+    public:
+        StreamedTexture(const vk::Device&, const Engine::Render::Device::PhysicalDevice&, const vk::Queue&, const vk::CommandPool&, const std::string& path, const bool sparseSupported, const uint32_t framesInFlight);
+
+        // No copies!
+        StreamedTexture(const StreamedTexture&) = delete;
+        StreamedTexture& operator=(const StreamedTexture&) = delete;
+
+        StreamedTexture(StreamedTexture&&) = default;
+        StreamedTexture& operator=(StreamedTexture&&) = default;
+
+        // Checks the file's tiles line up with the device's sparse block shape
+        static bool SparseCompatible(const Engine::Render::Device::PhysicalDevice&, const vk::Format, const Engine::Assets::Texture::TextureHeader&);
+
+        // Takes the requests the frame in slot left behind and resets its region
+        void ReadFeedback(const vk::Device&, const uint32_t slot);
+        // Copies the residency table into slot's region if it changed since.
+        // Call once the frame in slot finished, before the next one records.
+        void Publish(const vk::Device&, const uint32_t slot);
+
+        void Stream(const vk::Device&, const Engine::Render::Device::PhysicalDevice&, UploadBatch&);
+
+        // Gives back roughly bytes of memory, returns how much it let go of.
+        // Tiles are evicted, whole-mip textures drop their finest mip.
+        vk::DeviceSize Trim(UploadBatch&, const vk::DeviceSize bytes);
+
+        // After the batch's binds went to the queue, unbound pages can be reused
+        void BindsSubmitted(PagePool&);
+
+        // The batch submitted at frame finished on the GPU
+        void UploadsComplete(Engine::Render::Memory::DeletionQueue&, const uint64_t frame, const uint64_t currentFrame);
+
+        const std::vector<vk::SparseImageMemoryBind>& PendingBinds() const { return binds; }
+
+        const bool              IsSparse()          const { return sparse; }
+        const vk::Image         Image()             const { return sparse ? image.get() : current.Image.get(); }
+        const vk::ImageView     View()              const { return sparse ? view.get()  : current.View.get(); }
+        const uint32_t          MemoryTypeBits()    const { return memoryTypeBits; }
+        const vk::DeviceSize    PageSize()          const { return pageSize; }
+        const vk::DeviceSize    WholeMipBytes()     const;
+        const uint32_t          ResidentTiles()     const;
+        const vk::DeviceSize    EvictingBytes()     const { return pageSize * evicting.size(); }
+
+        const vk::Buffer        FeedbackBuffer()    const { return *feedback.Buffer(); }
+        const vk::DeviceSize    FeedbackOffset(const uint32_t slot) const { return feedbackStride * slot; }
+        const vk::DeviceSize    FeedbackRange()     const { return vk::DeviceSize{ tilesX } * tilesY * sizeof(uint32_t); }
+        const vk::Buffer        ResidencyBuffer()   const { return *residency.Buffer(); }
+        const vk::DeviceSize    ResidencyOffset(const uint32_t slot) const { return residencyStride * slot; }
+        const vk::DeviceSize    ResidencyRange()    const { return sizeof(ResidencyHeader) + vk::DeviceSize{ tilesX } * tilesY * sizeof(uint32_t); }
+    };
+}
+
+#endif // !RENDER_TEXTURE_STREAMED_TEXTURE_HPP
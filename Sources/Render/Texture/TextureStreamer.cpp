@@ -0,0 +1,338 @@
+#include "TextureStreamer.hpp"
+#include "Device/Physical.hpp"
+#include "Logger.hpp"
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+
+namespace Engine::Render::Texture {
+
+    namespace ERM   = Engine::Render::Memory;
+    namespace ERD   = Engine::Render::Device;
+    namespace ERQU  = Engine::Render::Queue;
+
+    namespace {
+
+        // Staging per frame slot, bounds how much is copied per update
+        constexpr vk::DeviceSize StagingBytesPerSlot{ 8ull << 20 };
+
+        // Pages are allocated 64 at a time, 4 MiB for the usual 64 KiB page
+        constexpr uint32_t PagesPerChunk{ 64 };
+
+        // Image, feedback and residency, as STREAMED_TEXTURE declares them
+        constexpr uint32_t SetBindings{ 3 };
+    }
+
+    TextureStreamer::TextureStreamer(const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo, const vk::Queue& queue, const ERQU::QueueFamily& family, const uint32_t framesInFlight, const vk::DeviceSize budgetBytes) :
+        queue(queue), budget(budgetBytes), defaultBudget(budgetBytes), framesInFlight(framesInFlight) {
+
+        const auto features{ deviceInfo.Get().getFeatures() };
+
+        sparseSupported = features.sparseBinding && features.sparseResidencyImage2D &&
+            static_cast<bool>(family.Flags & vk::QueueFlagBits::eSparseBinding);
+
+        LOGGER << "Texture streaming: " << (sparseSupported ? "sparse residency" : "whole mips")
+               << ", budget " << (budget >> 20) << " MiB\n";
+
+        commandPool = renderDevice.createCommandPoolUnique(vk::CommandPoolCreateInfo()
+            .setFlags(vk::CommandPoolCreateFlagBits::eResetCommandBuffer)
+            .setQueueFamilyIndex(family.Index)
+        );
+
+        // LOD is clamped in the shader against the residency table
+        sampler = renderDevice.createSamplerUnique(vk::SamplerCreateInfo()
+            .setMagFilter(vk::Filter::eLinear)
+            .setMinFilter(vk::Filter::eLinear)
+            .setMipmapMode(vk::SamplerMipmapMode::eLinear)
+            .setAddressModeU(vk::SamplerAddressMode::eRepeat)
+            .setAddressModeV(vk::SamplerAddressMode::eRepeat)
+            .setAddressModeW(vk::SamplerAddressMode::eRepeat)
+            .setMinLod(0.0f)
+            .setMaxLod(VK_LOD_CLAMP_NONE)
+        );
+
+        const std::array<vk::DescriptorSetLayoutBinding, SetBindings> bindings{
+            vk::DescriptorSetLayoutBinding(0, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment),
+            vk::DescriptorSetLayoutBinding(1, vk::DescriptorType::eStorageBuffer,        1, vk::ShaderStageFlagBits::eFragment),
+            vk::DescriptorSetLayoutBinding(2, vk::DescriptorType::eStorageBuffer,        1, vk::ShaderStageFlagBits::eFragment)
+        };
+
+        setLayout = renderDevice.createDescriptorSetLayoutUnique(vk::DescriptorSetLayoutCreateInfo()
+            .setBindingCount(static_cast<uint32_t>(bindings.size()))
+            .setPBindings(bindings.data())
+        );
+
+        auto commandBuffers{ renderDevice.allocateCommandBuffersUnique(vk::CommandBufferAllocateInfo()
+            .setCommandPool(commandPool.get())
+            .setCommandBufferCount(framesInFlight)
+            .setLevel(vk::CommandBufferLevel::ePrimary)
+        ) };
+
+        for (auto& commandBuffer : commandBuffers) {
+            Slot slot{};
+            slot.Commands   = std::move(commandBuffer);
+            slot.Done       = renderDevice.createFenceUnique({});
+            slot.BindsDone  = renderDevice.createSemaphoreUnique({});
+            slot.Staging    = ERM::DeviceMemory<std::byte>(renderDevice, deviceInfo, vk::BufferCreateInfo()
+                .setSharingMode(vk::SharingMode::eExclusive)
+                .setSize(StagingBytesPerSlot)
+                .setUsage(vk::BufferUsageFlagBits::eTransferSrc),
+                vk::MemoryPropertyFlagBits::eHostCoherent | vk::MemoryPropertyFlagBits::eHostVisible
+            );
+            slots.emplace_back(std::move(slot));
+        }
+
+        stats.BudgetBytes = budget;
+    }
+
+    uint32_t TextureStreamer::Load(const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo, const std::string& path) {
+        auto texture{ std::make_unique<StreamedTexture>(renderDevice, deviceInfo, queue, commandPool.get(), path, sparseSupported, framesInFlight) };
+
+        if (texture->IsSparse()) {
+            // Every sparse texture shares one pool, created with the first
+            if (pages.Capacity() == 0) {
+                const auto memoryProperties{ deviceInfo.Get().getMemoryProperties() };
+                const auto memoryType{ ERM::FindMemoryType(memoryProperties, texture->MemoryTypeBits(), vk::MemoryPropertyFlagBits::eDeviceLocal) };
+                pages = PagePool(texture->PageSize(), memoryType, ERM::HeapOfType(memoryProperties, memoryType), static_cast<uint32_t>(budget / texture->PageSize()), PagesPerChunk);
+            }
+
+            if (texture->PageSize() != pages.PageSize() || !(texture->MemoryTypeBits() & (1u << pages.MemoryType()))) {
+                throw std::runtime_error("Sparse texture can't share the page pool: " + path);
+            }
+        }
+
+        const std::array<vk::DescriptorPoolSize, 2> poolSizes{
+            vk::DescriptorPoolSize(vk::DescriptorType::eCombinedImageSampler, framesInFlight),
+            vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer,        framesInFlight * 2)
+        };
+
+        TextureSets sets{};
+        sets.Pool = renderDevice.createDescriptorPoolUnique(vk::DescriptorPoolCreateInfo()
+            .setMaxSets(framesInFlight)
+            .setPoolSizeCount(static_cast<uint32_t>(poolSizes.size()))
+            .setPPoolSizes(poolSizes.data())
+        );
+
+        const std::vector<vk::DescriptorSetLayout> layouts(framesInFlight, setLayout.get());
+        sets.Sets = renderDevice.allocateDescriptorSets(vk::DescriptorSetAllocateInfo()
+            .setDescriptorPool(sets.Pool.get())
+            .setDescriptorSetCount(framesInFlight)
+            .setPSetLayouts(layouts.data())
+        );
+        sets.Views.resize(framesInFlight);
+
+        textures.emplace_back(std::move(texture));
+        textureSets.emplace_back(std::move(sets));
+
+        const auto handle{ static_cast<uint32_t>(textures.size() - 1) };
+        for (uint32_t slot = 0; slot < framesInFlight; ++slot) {
+            WriteSet(renderDevice, handle, slot);
+        }
+        return handle;
+    }
+
+    // The regions never move, only the whole-mip fallback swaps its view
+    void TextureStreamer::WriteSet(const vk::Device& renderDevice, const uint32_t texture, const uint32_t slot) {
+        const auto& streamed{ *textures[texture] };
+        auto&       sets    { textureSets[texture] };
+
+        const auto imageInfo    { vk::DescriptorImageInfo(sampler.get(), streamed.View(), vk::ImageLayout::eGeneral) };
+        const auto feedbackInfo { vk::DescriptorBufferInfo(streamed.FeedbackBuffer(),  streamed.FeedbackOffset(slot),  streamed.FeedbackRange()) };
+        const auto residencyInfo{ vk::DescriptorBufferInfo(streamed.ResidencyBuffer(), streamed.ResidencyOffset(slot), streamed.ResidencyRange()) };
+
+        const std::array<vk::WriteDescriptorSet, SetBindings> writes{
+            vk::WriteDescriptorSet()
+                .setDstSet(sets.Sets[slot])
+                .setDstBinding(0)
+                .setDescriptorCount(1)
+                .setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
+                .setPImageInfo(&imageInfo),
+            vk::WriteDescriptorSet()
+                .setDstSet(sets.Sets[slot])
+                .setDstBinding(1)
+                .setDescriptorCount(1)
+                .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+                .setPBufferInfo(&feedbackInfo),
+            vk::WriteDescriptorSet()
+                .setDstSet(sets.Sets[slot])
+                .setDstBinding(2)
+                .setDescriptorCount(1)
+                .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+                .setPBufferInfo(&residencyInfo)
+        };
+
+        renderDevice.updateDescriptorSets(writes, nullptr);
+        sets.Views[slot] = streamed.View();
+    }
+
+    // Whatever streaming changed reaches this slot's frame, the other slots
+    // catch up when their frames come around
+    void TextureStreamer::Update(const vk::Device& renderDevice, const ERD::DeviceDispatch& d, const ERD::PhysicalDevice& deviceInfo, ERM::DeletionQueue& deletionQueue, ERM::LinearArena& frameArena, const uint32_t slotIndex, const uint64_t frameNumber) {
+        if (textures.empty()) return;
+
+        Stream(renderDevice, d, deviceInfo, deletionQueue, frameArena, slotIndex, frameNumber);
+
+        for (uint32_t i = 0; i < textures.size(); ++i) {
+            textures[i]->Publish(renderDevice, slotIndex);
+
+            if (textureSets[i].Views[slotIndex] != textures[i]->View()) {
+                WriteSet(renderDevice, i, slotIndex);
+            }
+        }
+    }
+
+    void TextureStreamer::Stream(const vk::Device& renderDevice, const ERD::DeviceDispatch& d, const ERD::PhysicalDevice& deviceInfo, ERM::DeletionQueue& deletionQueue, ERM::LinearArena& frameArena, const uint32_t slotIndex, const uint64_t frameNumber) {
+        auto& slot{ slots[slotIndex] };
+
+        // Never block the frame on streaming, skip a turn instead
+        if (slot.Busy) {
+            if (renderDevice.getFenceStatus(slot.Done.get(), d) != vk::Result::eSuccess) return;
+
+            for (auto& texture : textures) {
+                texture->UploadsComplete(deletionQueue, slot.Frame, frameNumber);
+            }
+
+            renderDevice.resetFences(1, &slot.Done.get(), d);
+            slot.Busy = false;
+        }
+
+        UploadBatch batch{};
+        batch.Commands          = slot.Commands.get();
+        batch.Staging           = *slot.Staging.Buffer();
+        batch.StagingData       = slot.Staging.Mapped(renderDevice);
+        batch.StagingSize       = slot.Staging.Capacity();
+        batch.Pages             = &pages;
+        batch.Dispatch          = &d;
+        batch.Deletion          = &deletionQueue;
+        batch.Frame             = frameNumber;
+        batch.FramesInFlight    = framesInFlight;
+        batch.BudgetBytes       = budget;
+        batch.UsedBytes         = UsedBytes();
+
+        batch.Commands.begin(vk::CommandBufferBeginInfo()
+            .setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit), d
+        );
+
+        bool anyBinds{ false };
+
+        for (auto& texture : textures) {
+            texture->ReadFeedback(renderDevice, slotIndex);
+            texture->Stream(renderDevice, deviceInfo, batch);
+            anyBinds |= !texture->PendingBinds().empty();
+        }
+
+        // The budget was lowered, give back the least recently used
+        vk::DeviceSize evictingBytes{ 0 };
+        for (const auto& texture : textures) {
+            evictingBytes += texture->EvictingBytes();
+        }
+
+        if (batch.UsedBytes > budget + evictingBytes) {
+            auto excess{ batch.UsedBytes - budget - evictingBytes };
+
+            for (auto& texture : textures) {
+                excess -= std::min(excess, texture->Trim(batch, excess));
+                if (excess == 0) break;
+            }
+        }
+
+        // Make the new texels visible to whatever samples them next
+        batch.Commands.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+            vk::PipelineStageFlagBits::eFragmentShader | vk::PipelineStageFlagBits::eComputeShader, {},
+            vk::MemoryBarrier()
+                .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+                .setDstAccessMask(vk::AccessFlagBits::eShaderRead),
+            nullptr, nullptr, d
+        );
+        batch.Commands.end(d);
+
+        stats.Uploads   += batch.Uploads;
+        stats.Evictions += batch.Evictions;
+
+        if (!batch.Recorded && !anyBinds) return;
+
+        slot.Frame = frameNumber;
+        Submit(d, frameArena, slot);
+    }
+
+    // Binds first, the copies wait on them. Unbinds ride along in the same batch.
+    void TextureStreamer::Submit(const ERD::DeviceDispatch& d, ERM::LinearArena& frameArena, Slot& slot) {
+        auto*    imageBinds{ frameArena.Allocate<vk::SparseImageMemoryBindInfo>(textures.size()) };
+        uint32_t bindCount { 0 };
+
+        for (const auto& texture : textures) {
+            const auto& binds{ texture->PendingBinds() };
+            if (binds.empty()) continue;
+
+            imageBinds[bindCount++] = vk::SparseImageMemoryBindInfo()
+                .setImage(texture->Image())
+                .setBindCount(static_cast<uint32_t>(binds.size()))
+                .setPBinds(binds.data());
+        }
+
+        if (bindCount > 0) {
+            queue.bindSparse(vk::BindSparseInfo()
+                .setImageBindCount(bindCount)
+                .setPImageBinds(imageBinds)
+                .setSignalSemaphoreCount(1)
+                .setPSignalSemaphores(&slot.BindsDone.get()),
+                nullptr, d
+            );
+
+            for (auto& texture : textures) {
+                texture->BindsSubmitted(pages);
+            }
+        }
+
+        const vk::PipelineStageFlags waitStage{ vk::PipelineStageFlagBits::eTransfer };
+
+        queue.submit(vk::SubmitInfo()
+            .setWaitSemaphoreCount(bindCount > 0 ? 1 : 0)
+            .setPWaitSemaphores(&slot.BindsDone.get())
+            .setPWaitDstStageMask(&waitStage)
+            .setCommandBufferCount(1)
+            .setPCommandBuffers(&slot.Commands.get()),
+            slot.Done.get(), d
+        );
+
+        slot.Busy = true;
+    }
+
+    void TextureStreamer::RecordFeedbackBarrier(const vk::CommandBuffer& cmdBuffer, const ERD::DeviceDispatch& d) const {
+        if (textures.empty()) return;
+
+        cmdBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eFragmentShader, vk::PipelineStageFlagBits::eHost, {},
+            vk::MemoryBarrier()
+                .setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+                .setDstAccessMask(vk::AccessFlagBits::eHostRead),
+            nullptr, nullptr, d
+        );
+    }
+
+    void TextureStreamer::SetBudget(const vk::DeviceSize bytes) {
+        budget = std::min(bytes, defaultBudget);
+        stats.BudgetBytes = budget;
+    }
+
+    const vk::DeviceSize TextureStreamer::UsedBytes() const {
+        vk::DeviceSize used{ pages.InUseBytes() };
+        for (const auto& texture : textures) {
+            used += texture->WholeMipBytes();
+        }
+        return used;
+    }
+
+    const TextureStreamingStats TextureStreamer::Stats() const {
+        auto result{ stats };
+        result.ResidentBytes = UsedBytes();
+        result.ResidentPages = pages.InUse();
+
+        for (const auto& texture : textures) {
+            if (texture->IsSparse()) ++result.SparseTextures;
+            else                     ++result.WholeMipTextures;
+        }
+
+        return result;
+    }
+}
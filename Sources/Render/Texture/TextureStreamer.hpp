@@ -0,0 +1,110 @@
+#ifndef RENDER_TEXTURE_STREAMER_HPP
+#define RENDER_TEXTURE_STREAMER_HPP
+
+#include "VKinclude/VKinclude.hpp"
+#include "PagePool.hpp"
+#include "StreamedTexture.hpp"
+#include "Queue/Queue.hpp"
+#include "Memory/LinearArena.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Engine::Render::Texture {
+
+    struct TextureStreamingStats {
+        vk::DeviceSize  BudgetBytes     { 0 };
+        vk::DeviceSize  ResidentBytes   { 0 };
+        uint32_t        ResidentPages   { 0 };
+        uint32_t        SparseTextures  { 0 };
+        uint32_t        WholeMipTextures{ 0 };
+        uint64_t        Uploads         { 0 };
+        uint64_t        Evictions       { 0 };
+    };
+
+    // Keeps a set of streamed textures under one memory budget. Once a frame
+    // it reads back what the frame in the same slot sampled, binds and fills
+    // the missing tiles (or whole mips) and evicts what wasn't used lately.
+    // Binds go through vkQueueBindSparse on the graphics queue, which has to
+    // advertise sparse binding, the copies are submitted right after.
+    //
+    // Each texture has a descriptor set per frame in flight for
+    // GLSL/streamed_texture.glsl: the image, that slot's feedback region and
+    // that slot's residency region. A slot's set and residency are only
+    // touched in Update, once the frame that used them finished.
+    class TextureStreamer {
+
+    private:
+        struct Slot {
+            vk::UniqueCommandBuffer                         Commands;
+            vk::UniqueFence                                 Done;
+            vk::UniqueSemaphore                             BindsDone;
+            Engine::Render::Memory::DeviceMemory<std::byte> Staging;
+            uint64_t                                        Frame   { 0 };
+            bool                                            Busy    { false };
+        };
+
+        struct TextureSets {
+            vk::UniqueDescriptorPool                        Pool;
+            std::vector<vk::DescriptorSet>                  Sets;   // Per slot
+            std::vector<vk::ImageView>                      Views;  // What each set samples
+        };
+
+        vk::Queue                                       queue;
+        bool                                            sparseSupported{ false };
+        vk::DeviceSize                                  budget{ 0 };
+        vk::DeviceSize                                  defaultBudget{ 0 };
+        uint32_t                                        framesInFlight{ 0 };
+        vk::UniqueCommandPool                           commandPool;
+        vk::UniqueSampler                               sampler;
+        PagePool                                        pages;
+        std::vector<Slot>                               slots;
+        std::vector<std::unique_ptr<StreamedTexture>>   textures;
+        vk::UniqueDescriptorSetLayout                   setLayout;
+        std::vector<TextureSets>                        textureSets;
+        TextureStreamingStats                           stats;
+
+        const vk::DeviceSize UsedBytes() const;
+        void Stream(const vk::Device&, const Engine::Render::Device::DeviceDispatch&, const Engine::Render::Device::PhysicalDevice&, Engine::Render::Memory::DeletionQueue&, Engine::Render::Memory::LinearArena& frameArena, const uint32_t slot, const uint64_t frameNumber);
+        void WriteSet(const vk::Device&, const uint32_t texture, const uint32_t slot);
+        void Submit(const Engine::Render::Device::DeviceDispatch&, Engine::Render::Memory::LinearArena&, Slot&);
+
+    public:
+        TextureStreamer(const vk::Device&, const Engine::Render::Device::PhysicalDevice&, const vk::Queue&, const Engine::Render::Queue::QueueFamily&, const uint32_t framesInFlight, const vk::DeviceSize budgetBytes);
+
+        // No copies!
+        TextureStreamer(const TextureStreamer&) = delete;
+        TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+        TextureStreamer(TextureStreamer&&) = default;
+        TextureStreamer& operator=(TextureStreamer&&) = default;
+
+        // Opens a .vtex file, only the mip tail (or a small whole-mip chain) is loaded up front
+        uint32_t Load(const vk::Device&, const Engine::Render::Device::PhysicalDevice&, const std::string& path);
+
+        // Call once the frame that last used slot has finished on the GPU,
+        // and before the next frame in slot records
+        void Update(const vk::Device&, const Engine::Render::Device::DeviceDispatch&, const Engine::Render::Device::PhysicalDevice&, Engine::Render::Memory::DeletionQueue&, Engine::Render::Memory::LinearArena& frameArena, const uint32_t slot, const uint64_t frameNumber);
+
+        // Makes the feedback the frame wrote visible to Update, record after
+        // the last draw that samples a streamed texture
+        void RecordFeedbackBarrier(const vk::CommandBuffer&, const Engine::Render::Device::DeviceDispatch&) const;
+
+        const StreamedTexture&          Get(const uint32_t texture)     const { return *textures.at(texture); }
+        const uint32_t                  Count()                         const { return static_cast<uint32_t>(textures.size()); }
+        // Layout of the sets below, the same for every texture
+        const vk::DescriptorSetLayout   SetLayout()                     const { return setLayout.get(); }
+        const vk::DescriptorSet         Set(const uint32_t texture, const uint32_t slot) const { return textureSets.at(texture).Sets[slot]; }
+        // Lowered by the residency manager under memory pressure, never above the budget it was created with
+        void                            SetBudget(const vk::DeviceSize bytes);
+        const vk::DeviceSize            Budget()                        const { return budget; }
+        const vk::DeviceSize            DefaultBudget()                 const { return defaultBudget; }
+
+        const vk::Sampler               Sampler()                       const { return sampler.get(); }
+        const bool                      SparseSupported()               const { return sparseSupported; }
+        const TextureStreamingStats     Stats()                         const;
+    };
+}
+
+#endif // !RENDER_TEXTURE_STREAMER_HPP
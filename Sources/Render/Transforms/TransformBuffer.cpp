@@ -0,0 +1,107 @@
+#include "TransformBuffer.hpp"
+#include "Device/Physical.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Engine::Render::Transforms {
+
+    namespace ERD = Engine::Render::Device;
+    namespace ERM = Engine::Render::Memory;
+
+    namespace {
+        // Growth leaves headroom so spawning a few nodes doesn't reallocate
+        uint32_t GrownCapacity(const uint32_t count) {
+            return std::max(1024u, count + count / 4);
+        }
+    }
+
+    void TransformBuffer::Set(const glm::mat4* matrices, const uint32_t count, const uint32_t first, const uint32_t changed) {
+        if (count != worlds.size()) {
+            worlds.assign(matrices, matrices + count);
+            pendingFirst = 0;
+            pendingEnd   = count;
+            return;
+        }
+
+        if (changed == 0) return;
+
+        const auto end{ std::min(count, first + changed) };
+        std::copy(matrices + first, matrices + end, worlds.begin() + first);
+
+        if (pendingFirst == pendingEnd) {
+            pendingFirst = first;
+            pendingEnd   = end;
+        }
+        else {
+            pendingFirst = std::min(pendingFirst, first);
+            pendingEnd   = std::max(pendingEnd, end);
+        }
+    }
+
+    // A new device buffer starts out empty, everything goes up again
+    void TransformBuffer::Prepare(const vk::Device& renderDevice, const ERD::PhysicalDevice& deviceInfo, const uint32_t slot, ERM::DeletionQueue& deletionQueue, const uint64_t frameNumber) {
+        recordFirst = recordEnd = 0;
+
+        const auto count{ Count() };
+        if (count == 0) return;
+
+        if (count > storage.Capacity) {
+            deletionQueue.Retire(std::move(storage), frameNumber);
+            storage = Storage{};
+            storage.Capacity = GrownCapacity(count);
+
+            const auto bytes{ sizeof(glm::mat4) * storage.Capacity };
+
+            storage.World = ERM::DeviceMemory<glm::mat4>(renderDevice, deviceInfo, vk::BufferCreateInfo()
+                .setSharingMode(vk::SharingMode::eExclusive)
+                .setSize(bytes)
+                .setUsage(vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst),
+                vk::MemoryPropertyFlagBits::eDeviceLocal
+            );
+
+            for (uint32_t i = 0; i < framesInFlight; ++i) {
+                storage.Staging.emplace_back(renderDevice, deviceInfo, vk::BufferCreateInfo()
+                    .setSharingMode(vk::SharingMode::eExclusive)
+                    .setSize(bytes)
+                    .setUsage(vk::BufferUsageFlagBits::eTransferSrc),
+                    vk::MemoryPropertyFlagBits::eHostCoherent | vk::MemoryPropertyFlagBits::eHostVisible
+                );
+            }
+
+            pendingFirst = 0;
+            pendingEnd   = count;
+        }
+
+        if (pendingFirst == pendingEnd) return;
+
+        // Same offsets as the device buffer, so the copy is one region
+        std::memcpy(storage.Staging[slot].Mapped(renderDevice) + pendingFirst, worlds.data() + pendingFirst, sizeof(glm::mat4) * (pendingEnd - pendingFirst));
+
+        recordFirst  = pendingFirst;
+        recordEnd    = pendingEnd;
+        pendingFirst = pendingEnd = 0;
+    }
+
+    // Earlier frames may still read the matrices being overwritten
+    void TransformBuffer::RecordUpload(const vk::CommandBuffer& cmdBuffer, const ERD::DeviceDispatch& d, const uint32_t slot) {
+        if (recordFirst == recordEnd) return;
+
+        const auto readers{ vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eComputeShader };
+        const vk::DeviceSize offset{ sizeof(glm::mat4) * recordFirst };
+
+        cmdBuffer.pipelineBarrier(readers, vk::PipelineStageFlagBits::eTransfer, {}, nullptr, nullptr, nullptr, d);
+
+        cmdBuffer.copyBuffer(*storage.Staging[slot].Buffer(), *storage.World.Buffer(),
+            vk::BufferCopy(offset, offset, sizeof(glm::mat4) * (recordEnd - recordFirst)), d);
+
+        // The next upload copies over the same ranges
+        cmdBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, readers | vk::PipelineStageFlagBits::eTransfer, {},
+            vk::MemoryBarrier()
+                .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+                .setDstAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eTransferRead | vk::AccessFlagBits::eTransferWrite),
+            nullptr, nullptr, d);
+
+        recordFirst = recordEnd = 0;
+    }
+}
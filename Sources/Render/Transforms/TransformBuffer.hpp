@@ -0,0 +1,69 @@
+#ifndef RENDER_TRANSFORMS_TRANSFORM_BUFFER_HPP
+#define RENDER_TRANSFORMS_TRANSFORM_BUFFER_HPP
+
+#include "VKinclude/VKinclude.hpp"
+#include "Memory/Buffers.hpp"
+#include "Memory/DeletionQueue.hpp"
+#include "Device/Dispatch.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace Engine::Render::Transforms {
+
+    // World matrices of every scene node in one device local storage
+    // buffer, indexed by the node's slot in Scene::TransformStore.
+    //
+    // Set takes the range that changed since the last call, the union of
+    // everything set between two frames goes up as a single buffer copy
+    // out of the frame's staging buffer. The device buffer keeps whatever
+    // earlier frames uploaded, so unchanged matrices never move again.
+    class TransformBuffer {
+
+    private:
+        // Recreated when the node count outgrows it
+        struct Storage {
+            Engine::Render::Memory::DeviceMemory<glm::mat4>                 World;
+            std::vector<Engine::Render::Memory::DeviceMemory<glm::mat4>>    Staging;    // Per frame in flight
+            uint32_t                                                        Capacity{ 0 };
+        };
+
+        uint32_t                framesInFlight{ 0 };
+        Storage                 storage;
+        std::vector<glm::mat4>  worlds;             // Host copy, the caller's array may change before the frame
+        uint32_t                pendingFirst{ 0 };
+        uint32_t                pendingEnd  { 0 };
+        uint32_t                recordFirst { 0 };  // What Prepare staged for RecordUpload
+        uint32_t                recordEnd   { 0 };
+
+    public:
+        TransformBuffer() = default;
+        explicit TransformBuffer(const uint32_t framesInFlight) : framesInFlight(framesInFlight) {}
+
+        // No copies!
+        TransformBuffer(const TransformBuffer&) = delete;
+        TransformBuffer& operator=(const TransformBuffer&) = delete;
+
+        TransformBuffer(TransformBuffer&&) = default;
+        TransformBuffer& operator=(TransformBuffer&&) = default;
+
+        // count matrices in slot order, of which [first, first + changed)
+        // differ from the last call. A new count uploads all of them.
+        void Set(const glm::mat4* matrices, const uint32_t count, const uint32_t first, const uint32_t changed);
+
+        // Grows the buffers if needed, the old ones are retired, and stages
+        // the pending range. The slot's previous frame must have finished.
+        void Prepare(const vk::Device&, const Engine::Render::Device::PhysicalDevice&, const uint32_t slot, Engine::Render::Memory::DeletionQueue&, const uint64_t frameNumber);
+
+        // Call outside of rendering. Leaves the matrices ready for vertex,
+        // mesh and compute shaders.
+        void RecordUpload(const vk::CommandBuffer&, const Engine::Render::Device::DeviceDispatch&, const uint32_t slot);
+
+        const vk::Buffer*   Buffer()    const { return storage.World.Buffer(); }
+        const uint32_t      Count()     const { return static_cast<uint32_t>(worlds.size()); }
+    };
+}
+
+#endif // !RENDER_TRANSFORMS_TRANSFORM_BUFFER_HPP
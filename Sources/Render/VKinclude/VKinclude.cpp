@@ -3,5 +3,9 @@
 VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE
 
 namespace Engine::Render {
-    static vk::DynamicLoader dynamicLoader{};
+
+    const vk::DynamicLoader& Loader() {
+        static const vk::DynamicLoader dynamicLoader{};
+        return dynamicLoader;
+    }
 }
@@ -9,6 +9,10 @@
 
 #include <vulkan/vulkan.hpp>
 
-static vk::DynamicLoader dynamicLoader;
+namespace Engine::Render {
+
+    // The one Vulkan library handle in the process, opened on first use
+    const vk::DynamicLoader& Loader();
+}
 
 #endif // !VKINCLUDE_HPP
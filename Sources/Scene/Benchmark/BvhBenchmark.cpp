@@ -0,0 +1,235 @@
+#include "Scene/Bvh.hpp"
+#include "Jobs/Scheduler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+// Build, refit and query throughput of the BVH against a linear walk over
+// every box, for a few scene sizes. Queries are frusta and rays from
+// random cameras inside the scene.
+
+using namespace Engine::Scene;
+using Clock = std::chrono::high_resolution_clock;
+
+namespace {
+
+    constexpr uint32_t  SceneSizes[]    { 10000, 100000, 1000000 };
+    constexpr uint32_t  FrustumQueries  { 200 };
+    constexpr uint32_t  RayQueries      { 20000 };
+    constexpr uint32_t  LinearQueryCap  { 50 };        // The linear walk is slow, fewer of those
+    constexpr float     WorldSize       { 2000.0f };
+    constexpr int       Repeats         { 3 };
+
+    struct Scene {
+        std::vector<glm::vec4> Mins;
+        std::vector<glm::vec4> Maxs;
+    };
+
+    double Seconds(const Clock::time_point& start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    Scene RandomScene(const uint32_t count, std::mt19937& rng) {
+        std::uniform_real_distribution<float> position(-WorldSize * 0.5f, WorldSize * 0.5f);
+        std::uniform_real_distribution<float> size(0.25f, 4.0f);
+
+        Scene scene{ std::vector<glm::vec4>(count), std::vector<glm::vec4>(count) };
+        for (uint32_t i = 0; i < count; ++i) {
+            const glm::vec3 center{ position(rng), position(rng), position(rng) };
+            const glm::vec3 half{ size(rng), size(rng), size(rng) };
+            scene.Mins[i] = glm::vec4(center - half, 1.0f);
+            scene.Maxs[i] = glm::vec4(center + half, 1.0f);
+        }
+        return scene;
+    }
+
+    // 90 degree frustum looking down one axis, 200 units deep
+    Frustum RandomFrustum(std::mt19937& rng) {
+        std::uniform_real_distribution<float> position(-WorldSize * 0.5f, WorldSize * 0.5f);
+        std::uniform_int_distribution<int> axis(0, 2);
+
+        const glm::vec3 eye{ position(rng), position(rng), position(rng) };
+        const int forward{ axis(rng) };
+        const int side{ (forward + 1) % 3 };
+        const int up{ (forward + 2) % 3 };
+        const float diagonal{ std::sqrt(0.5f) };
+
+        const auto plane{ [&eye](glm::vec3 normal) {
+            normal = glm::normalize(normal);
+            return glm::vec4(normal, -glm::dot(normal, eye));
+        } };
+
+        glm::vec3 f{ 0.0f }, s{ 0.0f }, u{ 0.0f };
+        f[forward] = 1.0f;
+        s[side]    = 1.0f;
+        u[up]      = 1.0f;
+
+        Frustum frustum{};
+        frustum.Planes[0] = plane((f + s) * diagonal);
+        frustum.Planes[1] = plane((f - s) * diagonal);
+        frustum.Planes[2] = plane((f + u) * diagonal);
+        frustum.Planes[3] = plane((f - u) * diagonal);
+        frustum.Planes[4] = plane(f);
+        frustum.Planes[5] = plane(-f);
+        frustum.Planes[4].w -= 0.1f;
+        frustum.Planes[5].w += 200.0f;
+        return frustum;
+    }
+
+    uint32_t LinearCull(const Scene& scene, const Frustum& frustum) {
+        uint32_t visible{ 0 };
+        for (size_t i = 0; i < scene.Mins.size(); ++i) {
+            bool inside{ true };
+            for (const auto& p : frustum.Planes) {
+                const auto distance{ p.x * (p.x >= 0.0f ? scene.Maxs[i].x : scene.Mins[i].x)
+                                   + p.y * (p.y >= 0.0f ? scene.Maxs[i].y : scene.Mins[i].y)
+                                   + p.z * (p.z >= 0.0f ? scene.Maxs[i].z : scene.Mins[i].z) + p.w };
+                if (distance < 0.0f) { inside = false; break; }
+            }
+            visible += inside ? 1 : 0;
+        }
+        return visible;
+    }
+
+    uint32_t LinearRaycast(const Scene& scene, const glm::vec3& origin, const glm::vec3& direction) {
+        const glm::vec3 inverse{ 1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z };
+        float best{ std::numeric_limits<float>::max() };
+        uint32_t hit{ NoObject };
+
+        for (size_t i = 0; i < scene.Mins.size(); ++i) {
+            float enter{ 0.0f }, leave{ best };
+            for (int a = 0; a < 3; ++a) {
+                const auto t0{ (scene.Mins[i][a] - origin[a]) * inverse[a] };
+                const auto t1{ (scene.Maxs[i][a] - origin[a]) * inverse[a] };
+                enter = std::max(enter, std::min(t0, t1));
+                leave = std::min(leave, std::max(t0, t1));
+            }
+            if (enter <= leave && enter < best) {
+                best = enter;
+                hit  = static_cast<uint32_t>(i);
+            }
+        }
+        return hit;
+    }
+
+    template <typename Body>
+    double Best(Body&& body) {
+        double best{ 1e30 };
+        for (int r = 0; r < Repeats; ++r) {
+            const auto start{ Clock::now() };
+            body();
+            best = std::min(best, Seconds(start));
+        }
+        return best;
+    }
+}
+
+int main() {
+
+    std::mt19937 rng{ 42 };
+    Engine::Jobs::Scheduler scheduler{};
+
+    std::cout << "Threads: " << scheduler.ThreadCount() << ", node size: " << sizeof(BvhNode) << " bytes\n\n";
+    std::cout << std::fixed << std::setprecision(2);
+
+    for (const auto count : SceneSizes) {
+        auto scene{ RandomScene(count, rng) };
+        Bvh bvh{};
+
+        const auto serial  { Best([&]() { bvh.Build(scene.Mins.data(), scene.Maxs.data(), count); }) };
+        const auto parallel{ Best([&]() { bvh.Build(scene.Mins.data(), scene.Maxs.data(), count, &scheduler); }) };
+
+        // Everything drifts a little, as if every object moved this frame
+        for (uint32_t i = 0; i < count; ++i) {
+            scene.Mins[i] += glm::vec4(0.5f, 0.0f, 0.0f, 0.0f);
+            scene.Maxs[i] += glm::vec4(0.5f, 0.0f, 0.0f, 0.0f);
+        }
+        const auto refit{ Best([&]() { bvh.Refit(scene.Mins.data(), scene.Maxs.data()); }) };
+
+        std::vector<Frustum> frusta{};
+        for (uint32_t q = 0; q < FrustumQueries; ++q) {
+            frusta.push_back(RandomFrustum(rng));
+        }
+
+        std::uniform_real_distribution<float> position(-WorldSize * 0.5f, WorldSize * 0.5f);
+        std::vector<glm::vec3> origins{}, directions{};
+        for (uint32_t q = 0; q < RayQueries; ++q) {
+            origins.emplace_back(position(rng), position(rng), position(rng));
+            directions.emplace_back(position(rng), position(rng), position(rng));
+        }
+
+        std::vector<uint32_t> visible{};
+        uint64_t found{ 0 };
+        const auto bvhCull{ Best([&]() {
+            found = 0;
+            for (const auto& frustum : frusta) {
+                visible.clear();
+                bvh.Cull(frustum, visible);
+                found += visible.size();
+            }
+        }) };
+
+        uint64_t linearFound{ 0 };
+        const auto linearQueries{ std::min(FrustumQueries, LinearQueryCap) };
+        const auto linearCull{ Best([&]() {
+            linearFound = 0;
+            for (uint32_t q = 0; q < linearQueries; ++q) {
+                linearFound += LinearCull(scene, frusta[q]);
+            }
+        }) };
+
+        uint32_t hits{ 0 };
+        const auto bvhRays{ Best([&]() {
+            hits = 0;
+            for (uint32_t q = 0; q < RayQueries; ++q) {
+                hits += bvh.Raycast(origins[q], directions[q]).Object != NoObject ? 1 : 0;
+            }
+        }) };
+
+        uint32_t linearHits{ 0 };
+        const auto linearRays{ Best([&]() {
+            linearHits = 0;
+            for (uint32_t q = 0; q < linearQueries; ++q) {
+                linearHits += LinearRaycast(scene, origins[q], directions[q]) != NoObject ? 1 : 0;
+            }
+        }) };
+
+        // Both walks have to agree on the queries they share
+        uint64_t sharedFound{ 0 };
+        uint32_t sharedHits{ 0 };
+        for (uint32_t q = 0; q < linearQueries; ++q) {
+            visible.clear();
+            bvh.Cull(frusta[q], visible);
+            sharedFound += visible.size();
+            sharedHits  += bvh.Raycast(origins[q], directions[q]).Object != NoObject ? 1 : 0;
+        }
+
+        const auto cullRate     { FrustumQueries / bvhCull };
+        const auto linearRate   { linearQueries / linearCull };
+        const auto rayRate      { RayQueries / bvhRays };
+        const auto linearRayRate{ linearQueries / linearRays };
+
+        std::cout << "Objects: " << count << " (" << bvh.NodeCount() << " nodes)\n"
+                  << "  Build          " << std::setw(10) << serial * 1e3   << " ms serial, " << parallel * 1e3 << " ms parallel\n"
+                  << "  Refit          " << std::setw(10) << refit * 1e3    << " ms\n"
+                  << "  Frustum        " << std::setw(10) << cullRate       << " queries/s, linear " << linearRate    << " (" << cullRate / linearRate << "x), "
+                  << found / FrustumQueries << " visible on average\n"
+                  << "  Ray            " << std::setw(10) << rayRate        << " queries/s, linear " << linearRayRate << " (" << rayRate / linearRayRate << "x), "
+                  << hits << " of " << RayQueries << " hit\n";
+
+        if (sharedFound != linearFound || sharedHits != linearHits) {
+            std::cout << "  Mismatch: " << sharedFound << " visible against " << linearFound << " linear, "
+                      << sharedHits << " hits against " << linearHits << "\n";
+            return 1;
+        }
+        std::cout << "\n";
+    }
+
+    return 0;
+}
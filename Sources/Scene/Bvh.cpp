@@ -0,0 +1,523 @@
+#include "Bvh.hpp"
+#include "MatrixBatch.hpp"
+#include "Jobs/Scheduler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+
+#if ENGINE_SCENE_SSE
+#   include <emmintrin.h>
+#endif
+
+namespace Engine::Scene {
+
+    namespace {
+        constexpr uint32_t BinCount             { 16 };
+        // Smaller subtrees aren't worth a job
+        constexpr uint32_t ParallelThreshold    { 8192 };
+        // Below this SAH gives way to median splits, which bounds the depth
+        // and with it the traversal stacks
+        constexpr uint32_t MaxSahDepth          { 32 };
+        // Three axes of bins cost more than they save on a handful of objects
+        constexpr uint32_t MinSahCount          { 8 };
+        constexpr uint32_t StackSize            { 256 };
+        constexpr uint32_t InsideBit            { 0x80000000u };
+
+        // Empty lanes get an inverted box, finite so 0 * Empty stays 0 and
+        // every test fails without a special case
+        constexpr float Empty{ 1e30f };
+
+        struct Box {
+            glm::vec3 Min{  Empty };
+            glm::vec3 Max{ -Empty };
+
+            void Grow(const glm::vec3& p)   { Min = glm::min(Min, p); Max = glm::max(Max, p); }
+            void Grow(const Box& b)         { Min = glm::min(Min, b.Min); Max = glm::max(Max, b.Max); }
+
+            float Area() const {
+                const auto e{ glm::max(Max - Min, glm::vec3(0.0f)) };
+                return e.x * e.y + e.y * e.z + e.z * e.x;
+            }
+        };
+
+        // Binary tree the four wide nodes are collapsed from. Leaves hold
+        // exactly one object.
+        struct BuildNode {
+            Box         Bounds;
+            uint32_t    Left    { 0 };
+            uint32_t    Right   { 0 };
+            uint32_t    First   { 0 };
+            uint32_t    Count   { 0 };
+        };
+
+        // What the builder sorts, the box travels with the object so the
+        // passes over a range read memory in order
+        struct Reference {
+            glm::vec3   Min;
+            uint32_t    Object;
+            glm::vec3   Max;
+            glm::vec3   Centroid;
+        };
+
+        struct Builder {
+            std::vector<Reference>  references;
+            std::vector<BuildNode>  tree;
+            std::atomic<uint32_t>   used{ 1 };
+            Engine::Jobs::Scheduler* scheduler{ nullptr };
+
+            // Bins centroids along each axis and takes the cheapest plane.
+            // Returns the partition point, first when nothing splits.
+            uint32_t SahSplit(const uint32_t first, const uint32_t count, const Box& centers) {
+                struct Bin {
+                    Box         Bounds;
+                    uint32_t    Count{ 0 };
+                };
+
+                float    bestCost   { std::numeric_limits<float>::max() };
+                int      bestAxis   { -1 };
+                uint32_t bestBin    { 0 };
+
+                const auto extent{ centers.Max - centers.Min };
+
+                for (int axis = 0; axis < 3; ++axis) {
+                    if (extent[axis] <= 0.0f) continue;
+
+                    const float scale{ BinCount / extent[axis] };
+                    std::array<Bin, BinCount> bins{};
+
+                    for (uint32_t i = first; i < first + count; ++i) {
+                        const auto& reference{ references[i] };
+                        const auto bin{ std::min(BinCount - 1, static_cast<uint32_t>((reference.Centroid[axis] - centers.Min[axis]) * scale)) };
+                        bins[bin].Count++;
+                        bins[bin].Bounds.Grow(Box{ reference.Min, reference.Max });
+                    }
+
+                    // Right side costs from the top down, then sweep up from the left
+                    std::array<float, BinCount> rightCost{};
+                    Box right{};
+                    uint32_t rightCount{ 0 };
+                    for (uint32_t b = BinCount - 1; b > 0; --b) {
+                        right.Grow(bins[b].Bounds);
+                        rightCount += bins[b].Count;
+                        rightCost[b] = rightCount * right.Area();
+                    }
+
+                    Box left{};
+                    uint32_t leftCount{ 0 };
+                    for (uint32_t b = 0; b + 1 < BinCount; ++b) {
+                        left.Grow(bins[b].Bounds);
+                        leftCount += bins[b].Count;
+                        if (leftCount == 0 || leftCount == count) continue;
+
+                        const auto cost{ leftCount * left.Area() + rightCost[b + 1] };
+                        if (cost < bestCost) {
+                            bestCost = cost;
+                            bestAxis = axis;
+                            bestBin  = b;
+                        }
+                    }
+                }
+
+                if (bestAxis < 0) return first;
+
+                const float scale{ BinCount / extent[bestAxis] };
+                const auto middle{ std::partition(references.begin() + first, references.begin() + first + count, [&](const Reference& reference) {
+                    return std::min(BinCount - 1, static_cast<uint32_t>((reference.Centroid[bestAxis] - centers.Min[bestAxis]) * scale)) <= bestBin;
+                }) };
+                return static_cast<uint32_t>(middle - references.begin());
+            }
+
+            // Halves the objects along the widest centroid axis
+            uint32_t MedianSplit(const uint32_t first, const uint32_t count, const Box& centers) {
+                const auto extent{ centers.Max - centers.Min };
+                const int axis{ extent.x >= extent.y && extent.x >= extent.z ? 0 : extent.y >= extent.z ? 1 : 2 };
+                const auto middle{ first + count / 2 };
+
+                std::nth_element(references.begin() + first, references.begin() + middle, references.begin() + first + count, [&](const Reference& a, const Reference& b) {
+                    return a.Centroid[axis] < b.Centroid[axis];
+                });
+                return middle;
+            }
+
+            void Split(const uint32_t index, const uint32_t first, const uint32_t count, const uint32_t depth) {
+                auto& node{ tree[index] };
+
+                Box centers{};
+                for (uint32_t i = first; i < first + count; ++i) {
+                    node.Bounds.Grow(Box{ references[i].Min, references[i].Max });
+                    centers.Grow(references[i].Centroid);
+                }
+
+                if (count == 1) {
+                    node.First = first;
+                    node.Count = 1;
+                    return;
+                }
+
+                auto middle{ depth < MaxSahDepth && count > MinSahCount ? SahSplit(first, count, centers) : first };
+                if (middle == first || middle == first + count) {
+                    middle = MedianSplit(first, count, centers);
+                }
+
+                const auto children{ used.fetch_add(2, std::memory_order_relaxed) };
+                node.Left  = children;
+                node.Right = children + 1;
+
+                const auto leftCount{ middle - first };
+                const auto rightCount{ count - leftCount };
+
+                if (scheduler && count > ParallelThreshold) {
+                    Engine::Jobs::Counter done{};
+                    scheduler->Run([this, children, first, leftCount, depth]() { Split(children, first, leftCount, depth + 1); }, &done);
+                    Split(children + 1, middle, rightCount, depth + 1);
+                    scheduler->Wait(done);
+                }
+                else {
+                    Split(children,     first,  leftCount,  depth + 1);
+                    Split(children + 1, middle, rightCount, depth + 1);
+                }
+            }
+        };
+
+        void ClearLane(BvhNode& node, const int lane) {
+            node.MinX[lane] = node.MinY[lane] = node.MinZ[lane] =  Empty;
+            node.MaxX[lane] = node.MaxY[lane] = node.MaxZ[lane] = -Empty;
+            node.Child[lane] = NoObject;
+            node.Count[lane] = 0;
+        }
+
+        void SetLane(BvhNode& node, const int lane, const Box& box) {
+            node.MinX[lane] = box.Min.x;
+            node.MinY[lane] = box.Min.y;
+            node.MinZ[lane] = box.Min.z;
+            node.MaxX[lane] = box.Max.x;
+            node.MaxY[lane] = box.Max.y;
+            node.MaxZ[lane] = box.Max.z;
+        }
+
+        Box NodeBox(const BvhNode& node) {
+            Box box{};
+            for (int lane = 0; lane < 4; ++lane) {
+                box.Grow(Box{ { node.MinX[lane], node.MinY[lane], node.MinZ[lane] }, { node.MaxX[lane], node.MaxY[lane], node.MaxZ[lane] } });
+            }
+            return box;
+        }
+
+        // Depth first, so every child lands after its parent. Each binary
+        // node hands its two children to a four wide node, then the inner
+        // child with the biggest area is opened until four lanes are full.
+        uint32_t Collapse(const std::vector<BuildNode>& tree, const uint32_t index, std::vector<BvhNode>& nodes) {
+            const auto flat{ static_cast<uint32_t>(nodes.size()) };
+            nodes.emplace_back();
+
+            std::array<uint32_t, 4> lanes{};
+            int used{ 0 };
+
+            if (tree[index].Count > 0) {
+                lanes[used++] = index;
+            }
+            else {
+                lanes[used++] = tree[index].Left;
+                lanes[used++] = tree[index].Right;
+
+                while (used < 4) {
+                    int widest{ -1 };
+                    for (int lane = 0; lane < used; ++lane) {
+                        if (tree[lanes[lane]].Count == 0 && (widest < 0 || tree[lanes[lane]].Bounds.Area() > tree[lanes[widest]].Bounds.Area())) {
+                            widest = lane;
+                        }
+                    }
+                    if (widest < 0) break;
+
+                    const auto opened{ lanes[widest] };
+                    lanes[widest]  = tree[opened].Left;
+                    lanes[used++]  = tree[opened].Right;
+                }
+            }
+
+            std::array<uint32_t, 4> children{};
+            for (int lane = 0; lane < used; ++lane) {
+                const auto& child{ tree[lanes[lane]] };
+                children[lane] = child.Count > 0 ? child.First : Collapse(tree, lanes[lane], nodes);
+            }
+
+            // nodes may have grown, only index it now
+            auto& node{ nodes[flat] };
+            for (int lane = 0; lane < 4; ++lane) {
+                if (lane >= used) {
+                    ClearLane(node, lane);
+                    continue;
+                }
+                SetLane(node, lane, tree[lanes[lane]].Bounds);
+                node.Child[lane] = children[lane];
+                node.Count[lane] = tree[lanes[lane]].Count;
+            }
+            return flat;
+        }
+
+        struct Ray {
+            glm::vec3 Origin;
+            glm::vec3 Inverse;
+        };
+
+        // Lanes that aren't empty
+        int LiveLanes(const BvhNode& node) {
+            int live{ 0 };
+            for (int lane = 0; lane < 4; ++lane) {
+                live |= node.Child[lane] != NoObject ? 1 << lane : 0;
+            }
+            return live;
+        }
+
+#       if ENGINE_SCENE_SSE
+
+        // Per plane the corner farthest along the normal decides whether a
+        // box is outside, the nearest one whether it's fully inside
+        int FrustumLanes(const BvhNode& node, const Frustum& frustum, int& inside) {
+            const __m128 zero{ _mm_setzero_ps() };
+            const __m128 minX{ _mm_load_ps(node.MinX) }, minY{ _mm_load_ps(node.MinY) }, minZ{ _mm_load_ps(node.MinZ) };
+            const __m128 maxX{ _mm_load_ps(node.MaxX) }, maxY{ _mm_load_ps(node.MaxY) }, maxZ{ _mm_load_ps(node.MaxZ) };
+
+            __m128 outside{ zero };
+            __m128 partial{ zero };
+
+            for (const auto& plane : frustum.Planes) {
+                const __m128 nx{ _mm_set1_ps(plane.x) }, ny{ _mm_set1_ps(plane.y) }, nz{ _mm_set1_ps(plane.z) }, w{ _mm_set1_ps(plane.w) };
+
+                const __m128 farthest{ _mm_add_ps(_mm_add_ps(
+                    _mm_mul_ps(nx, plane.x >= 0.0f ? maxX : minX),
+                    _mm_mul_ps(ny, plane.y >= 0.0f ? maxY : minY)), _mm_add_ps(
+                    _mm_mul_ps(nz, plane.z >= 0.0f ? maxZ : minZ), w)) };
+                const __m128 nearest{ _mm_add_ps(_mm_add_ps(
+                    _mm_mul_ps(nx, plane.x >= 0.0f ? minX : maxX),
+                    _mm_mul_ps(ny, plane.y >= 0.0f ? minY : maxY)), _mm_add_ps(
+                    _mm_mul_ps(nz, plane.z >= 0.0f ? minZ : maxZ), w)) };
+
+                outside = _mm_or_ps(outside, _mm_cmplt_ps(farthest, zero));
+                partial = _mm_or_ps(partial, _mm_cmplt_ps(nearest, zero));
+            }
+
+            const int visible{ ~_mm_movemask_ps(outside) & LiveLanes(node) };
+            inside = visible & ~_mm_movemask_ps(partial);
+            return visible;
+        }
+
+        // Slab test, entry distances of the hit lanes go to enter
+        int RayLanes(const BvhNode& node, const Ray& ray, const float maxT, float (&enter)[4]) {
+            const __m128 ox{ _mm_set1_ps(ray.Origin.x) },  oy{ _mm_set1_ps(ray.Origin.y) },  oz{ _mm_set1_ps(ray.Origin.z) };
+            const __m128 ix{ _mm_set1_ps(ray.Inverse.x) }, iy{ _mm_set1_ps(ray.Inverse.y) }, iz{ _mm_set1_ps(ray.Inverse.z) };
+
+            const __m128 x0{ _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.MinX), ox), ix) };
+            const __m128 x1{ _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.MaxX), ox), ix) };
+            const __m128 y0{ _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.MinY), oy), iy) };
+            const __m128 y1{ _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.MaxY), oy), iy) };
+            const __m128 z0{ _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.MinZ), oz), iz) };
+            const __m128 z1{ _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.MaxZ), oz), iz) };
+
+            const __m128 first{ _mm_max_ps(_mm_max_ps(_mm_min_ps(x0, x1), _mm_min_ps(y0, y1)), _mm_max_ps(_mm_min_ps(z0, z1), _mm_setzero_ps())) };
+            const __m128 leave{ _mm_min_ps(_mm_min_ps(_mm_max_ps(x0, x1), _mm_max_ps(y0, y1)), _mm_min_ps(_mm_max_ps(z0, z1), _mm_set1_ps(maxT))) };
+
+            _mm_storeu_ps(enter, first);
+            return _mm_movemask_ps(_mm_cmple_ps(first, leave)) & LiveLanes(node);
+        }
+
+#       else
+
+        int FrustumLanes(const BvhNode& node, const Frustum& frustum, int& inside) {
+            int visible{ 0 };
+            inside = 0;
+
+            for (int lane = 0; lane < 4; ++lane) {
+                const glm::vec3 lo{ node.MinX[lane], node.MinY[lane], node.MinZ[lane] };
+                const glm::vec3 hi{ node.MaxX[lane], node.MaxY[lane], node.MaxZ[lane] };
+                bool out{ false }, partial{ false };
+
+                for (const auto& plane : frustum.Planes) {
+                    const glm::vec3 n{ plane };
+                    const glm::vec3 farthest{ plane.x >= 0.0f ? hi.x : lo.x, plane.y >= 0.0f ? hi.y : lo.y, plane.z >= 0.0f ? hi.z : lo.z };
+                    const glm::vec3 nearest { plane.x >= 0.0f ? lo.x : hi.x, plane.y >= 0.0f ? lo.y : hi.y, plane.z >= 0.0f ? lo.z : hi.z };
+                    out     = out     || glm::dot(n, farthest) + plane.w < 0.0f;
+                    partial = partial || glm::dot(n, nearest)  + plane.w < 0.0f;
+                }
+
+                visible |= out ? 0 : 1 << lane;
+                inside  |= out || partial ? 0 : 1 << lane;
+            }
+
+            visible &= LiveLanes(node);
+            inside  &= visible;
+            return visible;
+        }
+
+        int RayLanes(const BvhNode& node, const Ray& ray, const float maxT, float (&enter)[4]) {
+            int hit{ 0 };
+
+            for (int lane = 0; lane < 4; ++lane) {
+                const auto t0{ (glm::vec3(node.MinX[lane], node.MinY[lane], node.MinZ[lane]) - ray.Origin) * ray.Inverse };
+                const auto t1{ (glm::vec3(node.MaxX[lane], node.MaxY[lane], node.MaxZ[lane]) - ray.Origin) * ray.Inverse };
+                const auto lo{ glm::min(t0, t1) };
+                const auto hi{ glm::max(t0, t1) };
+
+                enter[lane] = std::max(std::max(lo.x, lo.y), std::max(lo.z, 0.0f));
+                const auto leave{ std::min(std::min(hi.x, hi.y), std::min(hi.z, maxT)) };
+                hit |= enter[lane] <= leave ? 1 << lane : 0;
+            }
+            return hit & LiveLanes(node);
+        }
+
+#       endif
+    }
+
+    Frustum ExtractFrustum(const glm::mat4& clip) {
+        const auto row{ [&clip](const int r) { return glm::vec4(clip[0][r], clip[1][r], clip[2][r], clip[3][r]); } };
+        const auto x{ row(0) }, y{ row(1) }, z{ row(2) }, w{ row(3) };
+
+        Frustum frustum{ { w + x, w - x, w + y, w - y, z, w - z } };
+        for (auto& plane : frustum.Planes) {
+            const auto length{ glm::length(glm::vec3(plane)) };
+            plane = plane / (length > 0.0f ? length : 1.0f);
+        }
+        return frustum;
+    }
+
+    void Bvh::Build(const glm::vec4* mins, const glm::vec4* maxs, const uint32_t count, Engine::Jobs::Scheduler* scheduler) {
+        nodes.clear();
+        objects.resize(count);
+        objectCount = count;
+
+        if (count == 0) return;
+
+        Builder builder{ std::vector<Reference>(count), std::vector<BuildNode>(2 * count - 1) };
+        builder.scheduler = scheduler;
+
+        for (uint32_t i = 0; i < count; ++i) {
+            const glm::vec3 low{ mins[i] };
+            const glm::vec3 high{ maxs[i] };
+            builder.references[i] = { low, i, high, (low + high) * 0.5f };
+        }
+
+        builder.Split(0, 0, count, 0);
+
+        for (uint32_t i = 0; i < count; ++i) {
+            objects[i] = builder.references[i].Object;
+        }
+
+        // About one four wide node per two objects
+        nodes.reserve(count / 2 + 1);
+        Collapse(builder.tree, 0, nodes);
+    }
+
+    void Bvh::Refit(const glm::vec4* mins, const glm::vec4* maxs) {
+        for (auto i{ nodes.size() }; i-- > 0;) {
+            auto& node{ nodes[i] };
+
+            for (int lane = 0; lane < 4; ++lane) {
+                if (node.Child[lane] == NoObject) continue;
+
+                Box box{};
+                if (node.Count[lane] > 0) {
+                    for (uint32_t o = node.Child[lane]; o < node.Child[lane] + node.Count[lane]; ++o) {
+                        box.Grow(Box{ glm::vec3(mins[objects[o]]), glm::vec3(maxs[objects[o]]) });
+                    }
+                }
+                else {
+                    box = NodeBox(nodes[node.Child[lane]]);
+                }
+                SetLane(node, lane, box);
+            }
+        }
+    }
+
+    void Bvh::Cull(const Frustum& frustum, std::vector<uint32_t>& visible) const {
+        if (nodes.empty()) return;
+
+        uint32_t stack[StackSize];
+        uint32_t top{ 0 };
+        stack[top++] = 0;
+
+        while (top > 0) {
+            const auto entry{ stack[--top] };
+            const auto& node{ nodes[entry & ~InsideBit] };
+
+            // Below a fully inside lane everything is visible
+            int inside{ 0 };
+            int hit{ 0 };
+            if (entry & InsideBit) {
+                hit = inside = LiveLanes(node);
+            }
+            else {
+                hit = FrustumLanes(node, frustum, inside);
+            }
+
+            for (int lane = 0; lane < 4; ++lane) {
+                if (!(hit & (1 << lane))) continue;
+
+                if (node.Count[lane] > 0) {
+                    visible.insert(visible.end(), objects.begin() + node.Child[lane], objects.begin() + node.Child[lane] + node.Count[lane]);
+                }
+                else {
+                    stack[top++] = node.Child[lane] | ((inside & (1 << lane)) ? InsideBit : 0);
+                }
+            }
+        }
+    }
+
+    // Nearest lanes are pushed last, so they're opened first and shrink
+    // the search distance for the rest
+    const RayHit Bvh::Raycast(const glm::vec3& origin, const glm::vec3& direction, const float maxT) const {
+        RayHit best{};
+        best.T = maxT;
+
+        if (nodes.empty()) return RayHit{};
+
+        const Ray ray{ origin, glm::vec3(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z) };
+
+        struct Entry {
+            uint32_t    Node;
+            float       T;
+        };
+
+        Entry stack[StackSize];
+        uint32_t top{ 0 };
+        stack[top++] = { 0, 0.0f };
+
+        while (top > 0) {
+            const auto entry{ stack[--top] };
+            if (entry.T > best.T) continue;
+
+            const auto& node{ nodes[entry.Node] };
+            float enter[4];
+            const int hit{ RayLanes(node, ray, best.T, enter) };
+
+            Entry inner[4];
+            int innerCount{ 0 };
+
+            for (int lane = 0; lane < 4; ++lane) {
+                if (!(hit & (1 << lane)) || enter[lane] > best.T) continue;
+
+                // Leaves hold one object, the lane box is its box
+                if (node.Count[lane] > 0) {
+                    if (best.Object == NoObject || enter[lane] < best.T) {
+                        best = { objects[node.Child[lane]], enter[lane] };
+                    }
+                    continue;
+                }
+
+                // Farthest first
+                auto at{ innerCount++ };
+                while (at > 0 && inner[at - 1].T < enter[lane]) {
+                    inner[at] = inner[at - 1];
+                    --at;
+                }
+                inner[at] = { node.Child[lane], enter[lane] };
+            }
+
+            for (int i = 0; i < innerCount; ++i) {
+                stack[top++] = inner[i];
+            }
+        }
+
+        return best.Object == NoObject ? RayHit{} : best;
+    }
+}
@@ -0,0 +1,94 @@
+#ifndef ENGINE_SCENE_BVH_HPP
+#define ENGINE_SCENE_BVH_HPP
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Engine::Jobs {
+    class Scheduler;
+}
+
+namespace Engine::Scene {
+
+    constexpr uint32_t NoObject{ std::numeric_limits<uint32_t>::max() };
+
+    // Inward facing planes, normalized, xyz . p + w >= 0 inside
+    struct Frustum {
+        glm::vec4 Planes[6];
+    };
+
+    // Planes of a clip transform with depth 0 near and 1 far, in the space
+    // the transform takes from
+    Frustum ExtractFrustum(const glm::mat4& clip);
+
+    struct RayHit {
+        uint32_t    Object  { NoObject };
+        float       T       { std::numeric_limits<float>::max() };
+    };
+
+    // Four children per node, their boxes stored axis by axis so one SSE
+    // register holds the same coordinate of all four. Two cache lines.
+    struct alignas(64) BvhNode {
+        float       MinX[4];
+        float       MinY[4];
+        float       MinZ[4];
+        float       MaxX[4];
+        float       MaxY[4];
+        float       MaxZ[4];
+        uint32_t    Child[4];       // Node index, or the first entry in the object list for leaves
+        uint32_t    Count[4];       // Objects of a leaf, 0 for inner nodes and empty lanes
+    };
+
+    static_assert(sizeof(BvhNode) == 128);
+
+    // Bounding volume hierarchy over object boxes, for culling and picking
+    // in O(log n) instead of a walk over every object.
+    //
+    // Built top down as a binary tree with binned SAH, subtrees above a size
+    // threshold go to the job scheduler, then collapsed into four wide nodes
+    // in depth first order. Children always come after their parent, which
+    // lets Refit update the bounds of moved objects in a single backwards
+    // pass without touching the topology. Refitting degrades the tree as
+    // objects move far, rebuild once queries slow down.
+    //
+    // Objects are indices into the box arrays the tree was built from, e.g.
+    // slots of Scene::TransformStore.
+    class Bvh {
+
+    private:
+        std::vector<BvhNode>    nodes;
+        std::vector<uint32_t>   objects;        // Leaves index into this
+        uint32_t                objectCount{ 0 };
+
+    public:
+        Bvh() = default;
+
+        // No copies!
+        Bvh(const Bvh&) = delete;
+        Bvh& operator=(const Bvh&) = delete;
+
+        Bvh(Bvh&&) = default;
+        Bvh& operator=(Bvh&&) = default;
+
+        // Only the xyz of the boxes is read. Without a scheduler the build
+        // stays on the calling thread.
+        void Build(const glm::vec4* mins, const glm::vec4* maxs, const uint32_t count, Engine::Jobs::Scheduler* scheduler = nullptr);
+        // Same objects, new boxes
+        void Refit(const glm::vec4* mins, const glm::vec4* maxs);
+
+        // Appends every object whose box touches the frustum. Subtrees fully
+        // inside are taken without further tests.
+        void Cull(const Frustum& frustum, std::vector<uint32_t>& visible) const;
+        // Nearest object box the ray hits within maxT, direction needn't be normalized
+        const RayHit Raycast(const glm::vec3& origin, const glm::vec3& direction, const float maxT = std::numeric_limits<float>::max()) const;
+
+        const uint32_t      ObjectCount()   const { return objectCount; }
+        const uint32_t      NodeCount()     const { return static_cast<uint32_t>(nodes.size()); }
+        const BvhNode*      Nodes()         const { return nodes.data(); }
+    };
+}
+
+#endif // !ENGINE_SCENE_BVH_HPP
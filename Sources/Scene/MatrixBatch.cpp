@@ -0,0 +1,87 @@
+#include "MatrixBatch.hpp"
+
+#if ENGINE_SCENE_SSE
+#   include <emmintrin.h>
+#endif
+
+namespace Engine::Scene {
+
+#   if ENGINE_SCENE_SSE
+
+    namespace {
+
+        // Column major, every result column is the left columns weighted by
+        // one column of the right
+        inline void Multiply(const float* a, const float* b, float* out) {
+            const __m128 a0{ _mm_loadu_ps(a) };
+            const __m128 a1{ _mm_loadu_ps(a + 4) };
+            const __m128 a2{ _mm_loadu_ps(a + 8) };
+            const __m128 a3{ _mm_loadu_ps(a + 12) };
+
+            for (int c = 0; c < 4; ++c) {
+                const float* column{ b + 4 * c };
+
+                __m128 r{ _mm_mul_ps(a0, _mm_set1_ps(column[0])) };
+                r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(column[1])));
+                r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(column[2])));
+                r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_set1_ps(column[3])));
+
+                _mm_storeu_ps(out + 4 * c, r);
+            }
+        }
+    }
+
+    void MultiplyParents(glm::mat4* worlds, const glm::mat4* locals, const uint32_t* parents, const uint32_t first, const uint32_t last) {
+        for (uint32_t i = first; i < last; ++i) {
+            Multiply(&worlds[parents[i]][0][0], &locals[i][0][0], &worlds[i][0][0]);
+        }
+    }
+
+    void TransformBounds(const glm::mat4* worlds, const glm::vec4* centers, const glm::vec4* extents, glm::vec4* mins, glm::vec4* maxs, const uint32_t first, const uint32_t last) {
+        const __m128 signBits{ _mm_set1_ps(-0.0f) };
+
+        for (uint32_t i = first; i < last; ++i) {
+            const float* m{ &worlds[i][0][0] };
+            const __m128 x{ _mm_loadu_ps(m) };
+            const __m128 y{ _mm_loadu_ps(m + 4) };
+            const __m128 z{ _mm_loadu_ps(m + 8) };
+            const __m128 t{ _mm_loadu_ps(m + 12) };
+
+            const auto& c{ centers[i] };
+            const auto& e{ extents[i] };
+
+            __m128 center{ _mm_mul_ps(x, _mm_set1_ps(c.x)) };
+            center = _mm_add_ps(center, _mm_mul_ps(y, _mm_set1_ps(c.y)));
+            center = _mm_add_ps(center, _mm_mul_ps(z, _mm_set1_ps(c.z)));
+            center = _mm_add_ps(center, t);
+
+            __m128 extent{ _mm_mul_ps(_mm_andnot_ps(signBits, x), _mm_set1_ps(e.x)) };
+            extent = _mm_add_ps(extent, _mm_mul_ps(_mm_andnot_ps(signBits, y), _mm_set1_ps(e.y)));
+            extent = _mm_add_ps(extent, _mm_mul_ps(_mm_andnot_ps(signBits, z), _mm_set1_ps(e.z)));
+
+            _mm_storeu_ps(&mins[i].x, _mm_sub_ps(center, extent));
+            _mm_storeu_ps(&maxs[i].x, _mm_add_ps(center, extent));
+        }
+    }
+
+#   else
+
+    void MultiplyParents(glm::mat4* worlds, const glm::mat4* locals, const uint32_t* parents, const uint32_t first, const uint32_t last) {
+        for (uint32_t i = first; i < last; ++i) {
+            worlds[i] = worlds[parents[i]] * locals[i];
+        }
+    }
+
+    void TransformBounds(const glm::mat4* worlds, const glm::vec4* centers, const glm::vec4* extents, glm::vec4* mins, glm::vec4* maxs, const uint32_t first, const uint32_t last) {
+        for (uint32_t i = first; i < last; ++i) {
+            const auto& m{ worlds[i] };
+            const auto center{ m * glm::vec4(glm::vec3(centers[i]), 1.0f) };
+            const auto extent{ glm::abs(m[0]) * extents[i].x + glm::abs(m[1]) * extents[i].y + glm::abs(m[2]) * extents[i].z };
+
+            mins[i] = center - extent;
+            maxs[i] = center + extent;
+        }
+    }
+
+#   endif
+}
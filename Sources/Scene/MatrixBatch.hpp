@@ -0,0 +1,27 @@
+#ifndef ENGINE_SCENE_MATRIX_BATCH_HPP
+#define ENGINE_SCENE_MATRIX_BATCH_HPP
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+
+// SSE2 is baseline on x64, everything else takes the scalar loops
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define ENGINE_SCENE_SSE 1
+#else
+#   define ENGINE_SCENE_SSE 0
+#endif
+
+namespace Engine::Scene {
+
+    // Batch kernels over structure of arrays transform data. Ranges are
+    // [first, last), nothing written may alias anything read.
+
+    // worlds[i] = worlds[parents[i]] * locals[i], every parent outside the range
+    void MultiplyParents(glm::mat4* worlds, const glm::mat4* locals, const uint32_t* parents, const uint32_t first, const uint32_t last);
+
+    // Box given as center and half extent to world space min and max, Arvo's method
+    void TransformBounds(const glm::mat4* worlds, const glm::vec4* centers, const glm::vec4* extents, glm::vec4* mins, glm::vec4* maxs, const uint32_t first, const uint32_t last);
+}
+
+#endif // !ENGINE_SCENE_MATRIX_BATCH_HPP
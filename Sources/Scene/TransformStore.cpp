@@ -0,0 +1,268 @@
+#include "TransformStore.hpp"
+#include "MatrixBatch.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Engine::Scene {
+
+    namespace {
+        // Nodes created since the last sort are appended, which keeps parents
+        // before children but not the levels contiguous. They are walked one
+        // by one until there are this many, or an eighth of the store.
+        constexpr uint32_t MinUnsortedTail{ 1024 };
+
+        template <typename T>
+        void Permute(std::vector<T>& values, const std::vector<uint32_t>& order) {
+            std::vector<T> sorted{};
+            sorted.reserve(order.size());
+            for (const auto slot : order) {
+                sorted.push_back(values[slot]);
+            }
+            values = std::move(sorted);
+        }
+    }
+
+    void TransformStore::Reserve(const uint32_t nodes) {
+        locals.reserve(nodes);
+        worlds.reserve(nodes);
+        parents.reserve(nodes);
+        centers.reserve(nodes);
+        extents.reserve(nodes);
+        worldMins.reserve(nodes);
+        worldMaxs.reserve(nodes);
+        dirty.reserve(nodes);
+        dead.reserve(nodes);
+        handles.reserve(nodes);
+        slots.reserve(nodes);
+    }
+
+    const uint32_t TransformStore::SlotOf(const NodeHandle node) const {
+        if (!Alive(node)) {
+            throw std::runtime_error("No such scene node");
+        }
+        return slots[node];
+    }
+
+    const NodeHandle TransformStore::Parent(const NodeHandle node) const {
+        const auto parent{ parents[SlotOf(node)] };
+        return parent == NoNode ? NoNode : handles[parent];
+    }
+
+    NodeHandle TransformStore::Create(const NodeHandle parent, const glm::mat4& local, const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+        const auto parentSlot{ parent == NoNode ? NoNode : SlotOf(parent) };
+
+        NodeHandle node{ static_cast<NodeHandle>(slots.size()) };
+        if (!freeHandles.empty()) {
+            node = freeHandles.back();
+            freeHandles.pop_back();
+        }
+        else {
+            slots.push_back(NoNode);
+        }
+
+        slots[node] = Count();
+
+        locals.push_back(local);
+        worlds.push_back(local);
+        parents.push_back(parentSlot);
+        centers.emplace_back((boundsMin + boundsMax) * 0.5f, 0.0f);
+        extents.emplace_back((boundsMax - boundsMin) * 0.5f, 0.0f);
+        worldMins.emplace_back(boundsMin, 1.0f);
+        worldMaxs.emplace_back(boundsMax, 1.0f);
+        dirty.push_back(1);
+        dead.push_back(0);
+        handles.push_back(node);
+
+        return node;
+    }
+
+    void TransformStore::Destroy(const NodeHandle node) {
+        dead[SlotOf(node)] = 1;
+        reorder = true;
+    }
+
+    void TransformStore::SetParent(const NodeHandle node, const NodeHandle parent) {
+        const auto slot{ SlotOf(node) };
+        const auto parentSlot{ parent == NoNode ? NoNode : SlotOf(parent) };
+
+        for (auto above{ parentSlot }; above != NoNode; above = parents[above]) {
+            if (above == slot) {
+                throw std::runtime_error("Scene node would become its own ancestor");
+            }
+        }
+
+        parents[slot]   = parentSlot;
+        dirty[slot]     = 1;
+        reorder         = true;
+    }
+
+    void TransformStore::SetLocal(const NodeHandle node, const glm::mat4& local) {
+        const auto slot{ SlotOf(node) };
+        locals[slot] = local;
+        dirty[slot]  = 1;
+    }
+
+    void TransformStore::SetBounds(const NodeHandle node, const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+        const auto slot{ SlotOf(node) };
+        centers[slot] = glm::vec4((boundsMin + boundsMax) * 0.5f, 0.0f);
+        extents[slot] = glm::vec4((boundsMax - boundsMin) * 0.5f, 0.0f);
+        dirty[slot]   = 1;
+    }
+
+    // Depth first needs every ancestor's depth, reparenting can put parents
+    // after their children, so walk up until a known depth and unwind
+    void TransformStore::Reorder() {
+        const auto count{ Count() };
+
+        std::vector<uint32_t> depths(count, NoNode);
+        std::vector<uint32_t> path{};
+        uint32_t maxDepth{ 0 };
+
+        for (uint32_t slot = 0; slot < count; ++slot) {
+            auto at{ slot };
+            while (at != NoNode && depths[at] == NoNode) {
+                path.push_back(at);
+                at = parents[at];
+            }
+
+            auto depth{ at == NoNode ? 0u : depths[at] + 1 };
+            auto gone { at != NoNode && dead[at] };
+
+            while (!path.empty()) {
+                const auto node{ path.back() };
+                path.pop_back();
+
+                gone          = gone || dead[node];
+                dead[node]    = gone ? 1 : 0;
+                depths[node]  = depth++;
+            }
+        }
+
+        for (uint32_t slot = 0; slot < count; ++slot) {
+            if (!dead[slot]) maxDepth = std::max(maxDepth, depths[slot]);
+        }
+
+        // Levels in order, each sorted by its parents' new slots
+        std::vector<std::vector<uint32_t>> buckets(count > 0 ? maxDepth + 1 : 0);
+        for (uint32_t slot = 0; slot < count; ++slot) {
+            if (dead[slot]) {
+                freeHandles.push_back(handles[slot]);
+                slots[handles[slot]] = NoNode;
+            }
+            else {
+                buckets[depths[slot]].push_back(slot);
+            }
+        }
+
+        std::vector<uint32_t> order{};
+        std::vector<uint32_t> newSlots(count, NoNode);
+        levels.clear();
+
+        for (auto& bucket : buckets) {
+            std::stable_sort(bucket.begin(), bucket.end(), [&](const uint32_t a, const uint32_t b) {
+                const auto pa{ parents[a] == NoNode ? 0u : newSlots[parents[a]] };
+                const auto pb{ parents[b] == NoNode ? 0u : newSlots[parents[b]] };
+                return pa < pb;
+            });
+
+            levels.push_back(static_cast<uint32_t>(order.size()));
+            for (const auto slot : bucket) {
+                newSlots[slot] = static_cast<uint32_t>(order.size());
+                order.push_back(slot);
+            }
+        }
+        levels.push_back(static_cast<uint32_t>(order.size()));
+
+        for (auto& parent : parents) {
+            parent = parent == NoNode ? NoNode : newSlots[parent];
+        }
+
+        Permute(locals,     order);
+        Permute(worlds,     order);
+        Permute(parents,    order);
+        Permute(centers,    order);
+        Permute(extents,    order);
+        Permute(worldMins,  order);
+        Permute(worldMaxs,  order);
+        Permute(dirty,      order);
+        Permute(dead,       order);
+        Permute(handles,    order);
+
+        for (uint32_t slot = 0; slot < handles.size(); ++slot) {
+            slots[handles[slot]] = slot;
+        }
+
+        reorder = false;
+    }
+
+    const ChangedRange TransformStore::Update() {
+        const auto sortedBefore{ levels.empty() ? 0u : levels.back() };
+        const bool resort{ reorder || Count() - sortedBefore > std::max(MinUnsortedTail, sortedBefore / 8) };
+
+        if (resort) {
+            Reorder();
+        }
+
+        const auto count{ Count() };
+        const auto sorted{ levels.empty() ? 0u : levels.back() };
+        uint32_t lo{ NoNode };
+        uint32_t hi{ 0 };
+
+        const auto compute{ [&](const uint32_t first, const uint32_t last, const bool roots) {
+            if (roots) {
+                std::copy(locals.begin() + first, locals.begin() + last, worlds.begin() + first);
+            }
+            else {
+                MultiplyParents(worlds.data(), locals.data(), parents.data(), first, last);
+            }
+            TransformBounds(worlds.data(), centers.data(), extents.data(), worldMins.data(), worldMaxs.data(), first, last);
+
+            lo = std::min(lo, first);
+            hi = std::max(hi, last);
+        } };
+
+        for (uint32_t level = 0; level + 1 < levels.size(); ++level) {
+            const auto first{ levels[level] };
+            const auto last { levels[level + 1] };
+
+            // A recomputed parent is still flagged, it drags its children along
+            if (level > 0) {
+                for (uint32_t i = first; i < last; ++i) {
+                    dirty[i] |= dirty[parents[i]];
+                }
+            }
+
+            for (uint32_t i = first; i < last;) {
+                if (!dirty[i]) {
+                    ++i;
+                    continue;
+                }
+
+                auto end{ i + 1 };
+                while (end < last && dirty[end]) ++end;
+
+                compute(i, end, level == 0);
+                i = end;
+            }
+        }
+
+        // Appended since the sort, parents still come first
+        for (uint32_t i = sorted; i < count; ++i) {
+            const bool root{ parents[i] == NoNode };
+            if (!root) {
+                dirty[i] |= dirty[parents[i]];
+            }
+            if (dirty[i]) {
+                compute(i, i + 1, root);
+            }
+        }
+
+        if (lo != NoNode) {
+            std::fill(dirty.begin() + lo, dirty.begin() + hi, uint8_t{ 0 });
+        }
+
+        changed = resort ? ChangedRange{ 0, count } : lo == NoNode ? ChangedRange{} : ChangedRange{ lo, hi - lo };
+        return changed;
+    }
+}
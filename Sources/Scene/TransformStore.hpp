@@ -0,0 +1,105 @@
+#ifndef ENGINE_SCENE_TRANSFORM_STORE_HPP
+#define ENGINE_SCENE_TRANSFORM_STORE_HPP
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Engine::Scene {
+
+    // Stable name of a node, its slot moves whenever the hierarchy changes
+    using NodeHandle = uint32_t;
+    constexpr NodeHandle NoNode{ std::numeric_limits<uint32_t>::max() };
+
+    // Slots whose world matrix changed in the last Update
+    struct ChangedRange {
+        uint32_t First{ 0 };
+        uint32_t Count{ 0 };
+    };
+
+    // Local and world transforms, parents and bounds of every node, each in
+    // its own array indexed by slot. Slots are sorted by depth, so parents
+    // come before their children and every level of the hierarchy is one
+    // contiguous run, siblings next to each other.
+    //
+    // Update walks the levels in order. A node is recomputed only when its
+    // own local transform changed or its parent was recomputed this pass,
+    // so untouched subtrees cost one flag test per node. Dirty runs within
+    // a level go through the batch kernels in MatrixBatch.hpp.
+    //
+    // Creating, destroying or reparenting nodes resorts the slots on the
+    // next Update, which then reports every slot as changed.
+    class TransformStore {
+
+    private:
+        // By slot
+        std::vector<glm::mat4>  locals;
+        std::vector<glm::mat4>  worlds;
+        std::vector<uint32_t>   parents;        // Slot of the parent, NoNode for roots
+        std::vector<glm::vec4>  centers;        // Local bounds, center and half extent
+        std::vector<glm::vec4>  extents;
+        std::vector<glm::vec4>  worldMins;
+        std::vector<glm::vec4>  worldMaxs;
+        std::vector<uint8_t>    dirty;
+        std::vector<uint8_t>    dead;
+        std::vector<NodeHandle> handles;
+        std::vector<uint32_t>   levels;         // First slot of every depth, then the slot count
+
+        // By handle
+        std::vector<uint32_t>   slots;          // NoNode once freed
+        std::vector<NodeHandle> freeHandles;
+
+        bool                    reorder{ false };
+        ChangedRange            changed{};
+
+        void Reorder();
+        const uint32_t SlotOf(const NodeHandle node) const;
+
+    public:
+        TransformStore() = default;
+
+        // No copies!
+        TransformStore(const TransformStore&) = delete;
+        TransformStore& operator=(const TransformStore&) = delete;
+
+        TransformStore(TransformStore&&) = default;
+        TransformStore& operator=(TransformStore&&) = default;
+
+        void Reserve(const uint32_t nodes);
+
+        // Bounds are the local space box of whatever the node draws
+        NodeHandle Create(const NodeHandle parent = NoNode, const glm::mat4& local = glm::mat4(1.0f), const glm::vec3& boundsMin = glm::vec3(0.0f), const glm::vec3& boundsMax = glm::vec3(0.0f));
+        // Takes the whole subtree with it, the children's handles are freed too
+        void Destroy(const NodeHandle node);
+        // Throws if parent is node or one of its descendants
+        void SetParent(const NodeHandle node, const NodeHandle parent);
+
+        void SetLocal(const NodeHandle node, const glm::mat4& local);
+        void SetBounds(const NodeHandle node, const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+
+        // Brings every world transform and world box up to date
+        const ChangedRange Update();
+
+        const glm::mat4&    Local(const NodeHandle node)    const { return locals[SlotOf(node)]; }
+        // As of the last Update
+        const glm::mat4&    World(const NodeHandle node)    const { return worlds[SlotOf(node)]; }
+        const glm::vec3     WorldMin(const NodeHandle node) const { return glm::vec3(worldMins[SlotOf(node)]); }
+        const glm::vec3     WorldMax(const NodeHandle node) const { return glm::vec3(worldMaxs[SlotOf(node)]); }
+        const NodeHandle    Parent(const NodeHandle node)   const;
+        const bool          Alive(const NodeHandle node)    const { return node < slots.size() && slots[node] != NoNode && !dead[slots[node]]; }
+
+        // Slot order, for uploading or culling the whole store
+        const uint32_t          Count()             const { return static_cast<uint32_t>(handles.size()); }
+        const uint32_t          Slot(const NodeHandle node) const { return SlotOf(node); }
+        const NodeHandle        Handle(const uint32_t slot) const { return handles[slot]; }
+        const glm::mat4*        Worlds()            const { return worlds.data(); }
+        const glm::vec4*        WorldMins()         const { return worldMins.data(); }
+        const glm::vec4*        WorldMaxs()         const { return worldMaxs.data(); }
+        const ChangedRange      Changed()           const { return changed; }
+        const uint32_t          Depth()             const { return levels.empty() ? 0 : static_cast<uint32_t>(levels.size() - 1); }
+    };
+}
+
+#endif // !ENGINE_SCENE_TRANSFORM_STORE_HPP
@@ -0,0 +1,208 @@
+#include "Window/GLFW.hpp"
+#include "Render/Renderer.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Counts C++ heap allocations made by Renderer::DrawFrame once it has warmed
+// up. Anything above zero per frame is a regression. Driver allocations go
+// through malloc or the Vulkan allocation callbacks and aren't counted.
+//
+// --lights 0,256,1024,4096 runs once per light count and reports the frame
+// and GPU time of each, for the clustered lighting. Lights are scattered in
+// front of the camera and move every frame. Render scaling is off so the
+// resolution stays put while measuring.
+//
+// --reuse replays scene passes from cached secondary command buffers, see
+// Renderer::SetCommandReuse, and reports how many had to be recorded again.
+//
+// --readback copies every frame back to the host, see Renderer::SetFrameReadback,
+// and reports how many frames arrived and how many copies were dropped.
+
+namespace {
+
+    namespace ER = Engine::Render;
+
+    constexpr int WarmupFrames  { 300 };
+    constexpr int MeasureFrames { 1000 };
+
+    std::atomic<bool>       counting{ false };
+    std::atomic<uint64_t>   allocations{ 0 };
+    std::atomic<uint64_t>   allocatedBytes{ 0 };
+
+    void* CountedAlloc(const size_t size) {
+        if (counting.load(std::memory_order_relaxed)) {
+            allocations.fetch_add(1, std::memory_order_relaxed);
+            allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+        }
+
+        if (auto* p{ std::malloc(size == 0 ? 1 : size) }) return p;
+        throw std::bad_alloc();
+    }
+
+    std::vector<uint32_t> ParseCounts(const std::string& list) {
+        std::vector<uint32_t> counts{};
+        std::stringstream stream(list);
+
+        for (std::string item; std::getline(stream, item, ',');) {
+            counts.push_back(static_cast<uint32_t>(std::stoul(item)));
+        }
+        return counts;
+    }
+
+    ER::FrameView Camera() {
+        ER::FrameView view{};
+        view.View       = glm::lookAt(glm::vec3(0.0f, 0.0f, 2.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        view.Projection = glm::perspectiveRH_ZO(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f);
+        view.Transform  = view.Projection * view.View;
+        return view;
+    }
+
+    // A 20 x 20 x 20 box in front of the camera, same lights for the same count
+    std::vector<ER::Lighting::PointLight> ScatterLights(const uint32_t count) {
+        std::mt19937 random{ count };
+        std::uniform_real_distribution<float> position{ -10.0f, 10.0f };
+        std::uniform_real_distribution<float> unit{ 0.0f, 1.0f };
+
+        std::vector<ER::Lighting::PointLight> lights(count);
+        for (auto& light : lights) {
+            light.Position  = glm::vec3(position(random), position(random), position(random) - 8.0f);
+            light.Radius    = 0.5f + 1.5f * unit(random);
+            light.Color     = glm::vec3(unit(random), unit(random), unit(random));
+        }
+        return lights;
+    }
+
+    // Up and down, so every frame uploads and bins again
+    void MoveLights(std::vector<ER::Lighting::PointLight>& lights, const int frame) {
+        const auto step{ (frame % 128 < 64) ? 0.01f : -0.01f };
+        for (auto& light : lights) {
+            light.Position.y += step;
+        }
+    }
+}
+
+void* operator new(size_t size)                 { return CountedAlloc(size); }
+void* operator new[](size_t size)               { return CountedAlloc(size); }
+void  operator delete(void* p) noexcept         { std::free(p); }
+void  operator delete[](void* p) noexcept       { std::free(p); }
+void  operator delete(void* p, size_t) noexcept    { std::free(p); }
+void  operator delete[](void* p, size_t) noexcept  { std::free(p); }
+
+int main(int argc, char* argv[]) {
+    using Clock = std::chrono::high_resolution_clock;
+
+    std::vector<uint32_t> lightCounts{ 0 };
+    bool reuse{ false };
+    bool readback{ false };
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--lights") == 0 && i + 1 < argc) {
+            lightCounts = ParseCounts(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--reuse") == 0) {
+            reuse = true;
+        }
+        else if (std::strcmp(argv[i], "--readback") == 0) {
+            readback = true;
+        }
+    }
+
+    try {
+        Engine::Window::GLFW_Window_wrapper window(800, 600, "Frame benchmark");
+        ER::Renderer renderer(window.GetGLFWRequiredInstanceExtensions(), window.GetHandle());
+
+        ER::Resolution::ResolutionSettings fixedResolution{};
+        fixedResolution.Enabled = false;
+        renderer.SetResolution(fixedResolution);
+        renderer.SetCommandReuse(reuse);
+
+        // Touches every row, as an encoder would
+        uint64_t framesRead{ 0 };
+        uint64_t checksum{ 0 };
+        if (readback) {
+            renderer.SetFrameReadback([&framesRead, &checksum](const ER::Readback::ReadbackFrame& frame) {
+                for (uint32_t y = 0; y < frame.Extent.height; ++y) {
+                    checksum += frame.Pixels[vk::DeviceSize{ y } * frame.RowPitch];
+                }
+                ++framesRead;
+            });
+        }
+
+        const auto camera{ Camera() };
+        bool allocationFree{ true };
+
+        for (const auto lightCount : lightCounts) {
+            auto lights{ ScatterLights(lightCount) };
+
+            // Optimized pipelines swapped in mid measurement would count
+            for (int i = 0; i < WarmupFrames || renderer.Pipelines().Pending(); ++i) {
+                window.PollEvents();
+                MoveLights(lights, i);
+                renderer.SetLights(lights);
+                renderer.DrawFrame(camera);
+            }
+
+            allocations     = 0;
+            allocatedBytes  = 0;
+            const auto recordedBefore{ renderer.PassesRecorded() };
+            const auto reusedBefore  { renderer.PassesReused() };
+            const auto readBefore    { framesRead };
+            const auto droppedBefore { renderer.ReadbacksDropped() };
+            uint64_t    worstFrame{ 0 };
+            const auto  start{ Clock::now() };
+
+            for (int i = 0; i < MeasureFrames; ++i) {
+                window.PollEvents();
+                MoveLights(lights, i);
+                renderer.SetLights(lights);
+
+                const auto before{ allocations.load() };
+                counting = true;
+                renderer.DrawFrame(camera);
+                counting = false;
+
+                worstFrame = std::max(worstFrame, allocations.load() - before);
+            }
+
+            const auto seconds{ std::chrono::duration<double>(Clock::now() - start).count() };
+            renderer.WaitDevice();
+
+            std::cout << "Lights:               " << renderer.LightCount() << '\n'
+                      << "Frames:               " << MeasureFrames << '\n'
+                      << "Frame time (ms):      " << std::fixed << std::setprecision(3) << seconds * 1e3 / MeasureFrames << '\n'
+                      << "GPU time (ms):        " << renderer.GpuFrameMs() << '\n'
+                      << "Allocations / frame:  " << std::setprecision(2) << static_cast<double>(allocations) / MeasureFrames << '\n'
+                      << "Bytes / frame:        " << static_cast<double>(allocatedBytes) / MeasureFrames << '\n'
+                      << "Worst frame:          " << worstFrame << " allocations\n";
+            if (reuse) {
+                std::cout << "Passes recorded:      " << renderer.PassesRecorded() - recordedBefore << '\n'
+                          << "Passes reused:        " << renderer.PassesReused() - reusedBefore << '\n';
+            }
+            if (readback) {
+                std::cout << "Frames read back:     " << framesRead - readBefore << " (checksum " << checksum << ")\n"
+                          << "Readbacks dropped:    " << renderer.ReadbacksDropped() - droppedBefore << '\n';
+            }
+            std::cout << '\n';
+
+            allocationFree = allocationFree && allocations == 0;
+        }
+
+        return allocationFree ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Exception " << e.what() << " was raised.\n";
+        return EXIT_FAILURE;
+    }
+}
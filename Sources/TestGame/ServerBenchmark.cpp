@@ -0,0 +1,128 @@
+#include "Render/Server/RenderServer.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Renders many thumbnail sized sessions on one device with no window, see
+// Render/Server/RenderServer.hpp, and reports how many frames per second
+// come back through readback. Every session spins the same triangle from
+// its own angle and asks for a new frame as soon as the last one arrives.
+//
+// --sessions N     sessions to host, 32 by default
+// --per-tick N     sessions drawn by one tick at most, 8 by default
+// --size N         width and height of every session, 256 by default
+// --cache PATH     pipeline cache file, loaded on start and saved at the end
+
+namespace {
+
+    namespace ER  = Engine::Render;
+    namespace ERS = Engine::Render::Server;
+
+    constexpr int Ticks{ 2000 };
+
+    const std::vector<Engine::Primitives::Vertex> triangle = {
+        {{0.0f, -0.5f}, {1.0f, 0.0f, 0.0f}},
+        {{0.5f, 0.5f},  {0.0f, 1.0f, 0.0f}},
+        {{-0.5f, 0.5f}, {0.0f, 0.0f, 1.0f}}
+    };
+
+    ER::FrameView Camera(const float angle) {
+        ER::FrameView view{};
+        view.View       = glm::lookAt(glm::vec3(2.0f * glm::sin(angle), 0.0f, 2.0f * glm::cos(angle)), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        view.Projection = glm::perspectiveRH_ZO(glm::radians(45.0f), 1.0f, 0.1f, 100.0f);
+        view.Transform  = view.Projection * view.View;
+        return view;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    using Clock = std::chrono::high_resolution_clock;
+
+    uint32_t sessionCount{ 32 };
+    uint32_t size{ 256 };
+    ERS::ServerSettings settings{};
+    settings.MaxSessionsPerTick = 8;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--sessions") == 0 && i + 1 < argc) {
+            sessionCount = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "--per-tick") == 0 && i + 1 < argc) {
+            settings.MaxSessionsPerTick = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            size = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+            settings.PipelineCachePath = argv[++i];
+        }
+    }
+    settings.MaxSessions = sessionCount;
+
+    try {
+        const auto startup{ Clock::now() };
+        ERS::RenderServer server(settings);
+        const auto startupMs{ std::chrono::duration<double, std::milli>(Clock::now() - startup).count() };
+
+        const auto mesh{ server.AddMesh(triangle) };
+
+        std::vector<ERS::SessionHandle> sessions{};
+        std::vector<uint64_t> received(sessionCount, 0);
+
+        for (uint32_t i = 0; i < sessionCount; ++i) {
+            const auto session{ server.CreateSession({ size, size }) };
+            sessions.push_back(session);
+
+            server.SetMeshes(session, { mesh });
+            server.SetView(session, Camera(i * 0.2f));
+            server.SetReadback(session, [&server, &received, session, i](const ER::Readback::ReadbackFrame&) {
+                ++received[i];
+                server.SetView(session, Camera(i * 0.2f + received[i] * 0.05f));
+                server.RequestFrame(session);
+            });
+            server.RequestFrame(session);
+        }
+
+        const auto start{ Clock::now() };
+        uint64_t busyTicks{ 0 };
+
+        for (int i = 0; i < Ticks; ++i) {
+            busyTicks += server.Tick() > 0 ? 1 : 0;
+        }
+
+        server.WaitIdle();
+        const auto seconds{ std::chrono::duration<double>(Clock::now() - start).count() };
+
+        uint64_t fewest{ UINT64_MAX };
+        uint64_t most{ 0 };
+        uint64_t total{ 0 };
+        for (const auto count : received) {
+            fewest = std::min(fewest, count);
+            most   = std::max(most, count);
+            total += count;
+        }
+
+        std::cout << "Sessions:             " << sessionCount << " at " << size << 'x' << size << '\n'
+                  << "Startup (ms):         " << std::fixed << std::setprecision(1) << startupMs << '\n'
+                  << "Ticks submitted:      " << busyTicks << " of " << Ticks << '\n'
+                  << "Frames drawn:         " << server.FramesDrawn() << '\n'
+                  << "Frames read back:     " << total << '\n'
+                  << "Frames / second:      " << total / seconds << '\n'
+                  << "Per session:          " << fewest << " to " << most << '\n';
+
+        return EXIT_SUCCESS;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Exception " << e.what() << " was raised.\n";
+        return EXIT_FAILURE;
+    }
+}
@@ -3,16 +3,76 @@
 #include "Logging/Logger.hpp"
 #include "Version.hpp"
 
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
 
 using namespace Engine;
 
+namespace {
+    // Simulation rate, independent of how fast frames are presented
+    constexpr double SimulationStep     { 1.0 / 60.0 };
+    // Longest stretch simulated at once, so a stall doesn't snowball
+    constexpr double MaxCatchUp         { 0.25 };
+    constexpr float  SpinRadiansPerSec  { 1.0f };
+
+    // Lights circling the triangle, a little towards the camera
+    constexpr uint32_t LightCount       { 16 };
+    constexpr float    LightOrbit       { 0.6f };
+    constexpr float    LightHeight      { 0.3f };
+    constexpr float    LightRadius      { 1.0f };
+
+    const glm::vec3    CameraPosition   { 0.0f, 0.0f, 2.0f };
+}
+
 int main(int argc, char *argv[]) {
 
     GameWindow::DumpVersion();
 
     try {
-        GameWindow termWindow{ GameWindow(800, 600, std::string("Yay!")) };
+        auto threading{ GameWindow::ThreadingMode::RenderThread };
+        const char* meshPath{ nullptr };
+        const char* capturePath{ nullptr };
+        bool onDemand{ false };
+        double idleFrameCap{ 30.0 };
+
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--single-thread") == 0) {
+                threading = GameWindow::ThreadingMode::SingleThread;
+            }
+            else if (std::strcmp(argv[i], "--on-demand") == 0) {
+                onDemand = true;
+            }
+            else if (std::strcmp(argv[i], "--idle-fps") == 0 && i + 1 < argc) {
+                idleFrameCap = std::atof(argv[++i]);
+            }
+            else if (std::strcmp(argv[i], "--capture") == 0 && i + 1 < argc) {
+                // Renderer calls to a file for Tools/CaptureReplay
+                capturePath = argv[++i];
+            }
+            else {
+                // Optional packed mesh to show instead of the triangle
+                meshPath = argv[i];
+            }
+        }
+
+        GameWindow termWindow{ GameWindow(800, 600, std::string("Yay!"), threading) };
+
+        // Before the mesh load so the replay streams it in too
+        if (capturePath) {
+            termWindow.StartCapture(capturePath);
+        }
+        if (meshPath) {
+            termWindow.LoadMesh(meshPath);
+        }
+        termWindow.SetOnDemand(onDemand, idleFrameCap);
+
         termWindow.WindowLoop();
     }
     catch (std::exception e){
@@ -23,36 +83,289 @@ int main(int argc, char *argv[]) {
     return EXIT_SUCCESS;
 }
 
-GameWindow::GameWindow(int w, int h, const std::string& title) :
+GameWindow::GameWindow(int w, int h, const std::string& title, const ThreadingMode threading) :
     GLFW_Window_wrapper(w, h, title),
-    renderer(std::make_unique<Engine::Render::Renderer>(GetGLFWRequiredInstanceExtensions(), GetHandle())) {}
+    renderer(std::make_unique<Engine::Render::Renderer>(GetGLFWRequiredInstanceExtensions(), GetHandle())),
+    mode(threading),
+    aspect(static_cast<float>(w) / static_cast<float>(std::max(h, 1))),
+    lights(LightCount) {}
+
+GameWindow::~GameWindow() = default;
 
 void GameWindow::WindowLoop() {
 
-    auto start = std::chrono::high_resolution_clock::now();
-    auto diff = std::chrono::high_resolution_clock::now() - start;
-    auto tdiff = std::chrono::duration_cast<std::chrono::milliseconds>(diff);
+    lastTick = Clock::now();
+    simulation.CurrentTime = lastTick;
+    snapshots.Back() = simulation;
+    snapshots.Publish();
+
+    auto fpsStart{ Clock::now() };
+
+    if (mode == ThreadingMode::SingleThread) {
+        uint64_t seenResizes{ 0 };
+
+        while (KeepWindowOpen()) {
+            if (onDemand) {
+                WaitForWork(Clock::now(), renderer->Busy());
+            }
+            else {
+                PollEvents();
+            }
+            jobs.PumpMainThread();
+
+            const auto now{ Clock::now() };
+            Simulate(now);
+
+            if (!onDemand || renderer->Busy() || FrameDue(now)) {
+                dirty       = false;
+                lastRequest = now;
+                Draw(simulation, seenResizes);
+            }
+            ReportFps(fpsStart);
+        }
+
+        renderer->WaitDevice();
+        return;
+    }
+
+    // From here on only the render thread touches the renderer
+    rendering = true;
+    std::thread renderThread(&GameWindow::RenderLoop, this);
+
+    while (KeepWindowOpen() && rendering.load(std::memory_order_acquire)) {
+        // Sleep until input arrives or the next step is due
+        if (onDemand) {
+            WaitForWork(Clock::now(), false);
+        }
+        else {
+            WaitEventsTimeout(std::max(0.0, SimulationStep - accumulator));
+        }
+        jobs.PumpMainThread();
+
+        const auto now{ Clock::now() };
+        if (Simulate(now)) {
+            snapshots.Back() = simulation;
+            snapshots.Publish();
+        }
 
-    int count = 0;
-    while (KeepWindowOpen()) {
+        if (onDemand) {
+            const bool due{ FrameDue(now) };
+            if (due) {
+                dirty       = false;
+                lastRequest = now;
+            }
+            PublishRequests(due);
+        }
+        ReportFps(fpsStart);
+    }
 
-        PollEvents();
-        // draw frame
-        renderer->DrawFrame();
-        ++count;
+    StopRendering();
+    renderThread.join();
+
+    if (renderFailure) {
+        std::rethrow_exception(renderFailure);
+    }
+}
 
-        diff = std::chrono::high_resolution_clock::now() - start;
-        tdiff = std::chrono::duration_cast<std::chrono::milliseconds>(diff);
+// Advances in fixed steps, true if at least one was taken
+const bool GameWindow::Simulate(const Clock::time_point now) {
+    accumulator += std::min(std::chrono::duration<double>(now - lastTick).count(), MaxCatchUp);
+    lastTick = now;
 
-        if (tdiff.count() >= 1000) {
-            start = std::chrono::high_resolution_clock::now();
-            std::cerr << "\rFPS: " << count << "      ";
-            count = 0;
+    bool stepped{ false };
+
+    while (accumulator >= SimulationStep) {
+        simulation.Previous = simulation.Current;
+        if (spinning) {
+            simulation.Current.Angle += SpinRadiansPerSec * static_cast<float>(SimulationStep);
         }
+        accumulator -= SimulationStep;
+        stepped = true;
+    }
+
+    if (stepped) {
+        // Current belongs to the last step boundary, not to now
+        simulation.CurrentTime = now - std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(accumulator));
+    }
+    return stepped;
+}
 
+void GameWindow::Draw(const Snapshot& snapshot, uint64_t& seenResizes) {
+    // Resizes come in on the main thread, the renderer only learns of them here
+    const auto resized{ resizes.load(std::memory_order_acquire) };
+    if (resized != seenResizes) {
+        seenResizes = resized;
+        renderer->SurfaceResized();
     }
 
-    renderer->WaitDevice();
+    PlaceLights(snapshot.Current.Angle);
+    renderer->DrawFrame(Interpolate(snapshot, Clock::now(), aspect.load(std::memory_order_relaxed)));
+    framesDrawn.fetch_add(1, std::memory_order_relaxed);
+}
+
+void GameWindow::RenderLoop() {
+    uint64_t seenResizes{ 0 };
+
+    try {
+        while (rendering.load(std::memory_order_acquire)) {
+            // Streaming only moves on while frames are drawn
+            if (onDemand && !renderer->Busy() && !WaitForRequest()) break;
+
+            snapshots.Update();
+            Draw(snapshots.Front(), seenResizes);
+        }
+
+        renderer->WaitDevice();
+    }
+    catch (...) {
+        renderFailure = std::current_exception();
+        rendering = false;
+        // The main thread may be asleep in WaitEvents
+        PostEmptyEvent();
+    }
+}
+
+// Drawn one step behind the simulation, blending the two latest states
+// by how far into the following step the frame is
+Engine::Render::FrameView GameWindow::Interpolate(const Snapshot& snapshot, const Clock::time_point now, const float aspect) {
+    const auto sinceStep{ std::chrono::duration<double>(now - snapshot.CurrentTime).count() };
+    const auto alpha    { static_cast<float>(std::clamp(sinceStep / SimulationStep, 0.0, 1.0)) };
+    const auto angle    { snapshot.Previous.Angle + (snapshot.Current.Angle - snapshot.Previous.Angle) * alpha };
+
+    Engine::Render::FrameView view{};
+    view.View       = glm::lookAt(CameraPosition, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    view.Projection = glm::perspectiveRH_ZO(glm::radians(45.0f), aspect, 0.1f, 100.0f);
+    view.Transform  = view.Projection * view.View * glm::rotate(glm::mat4(1.0f), angle, glm::vec3(0.0f, 0.0f, 1.0f));
+    return view;
+}
+
+// Spread around the hue wheel, orbiting against the spin
+void GameWindow::PlaceLights(const float angle) {
+    for (uint32_t i = 0; i < LightCount; ++i) {
+        const auto phase{ glm::two_pi<float>() * static_cast<float>(i) / LightCount };
+        auto& light{ lights[i] };
+
+        light.Position  = glm::vec3(std::cos(phase - angle) * LightOrbit, std::sin(phase - angle) * LightOrbit, LightHeight);
+        light.Radius    = LightRadius;
+        light.Color     = glm::vec3(0.5f) + 0.5f * glm::vec3(std::cos(phase), std::cos(phase + 2.1f), std::cos(phase + 4.2f));
+        light.Intensity = 1.5f;
+    }
+    renderer->SetLights(lights);
+}
+
+void GameWindow::ReportFps(Clock::time_point& start) {
+    if (Clock::now() - start < std::chrono::seconds(1)) return;
+
+    start = Clock::now();
+    std::cerr << "\rFPS: " << framesDrawn.exchange(0, std::memory_order_relaxed) << "      ";
+}
+
+void GameWindow::WindowResized(int new_width, int new_height) {
+    if (new_width > 0 && new_height > 0) {
+        aspect.store(static_cast<float>(new_width) / static_cast<float>(new_height), std::memory_order_relaxed);
+    }
+    resizes.fetch_add(1, std::memory_order_release);
+}
+
+void GameWindow::WindowRefresh() {
+    dirty = true;
+}
+
+void GameWindow::ProcessInput() {
+    dirty = true;
+}
+
+void GameWindow::ProcessScroll(double x, double y) {
+    dirty = true;
+}
+
+void GameWindow::ProcessTextInput(unsigned int codepoint) {
+    if (codepoint == ' ') {
+        spinning = !spinning;
+    }
+    dirty = true;
+}
+
+void GameWindow::SetOnDemand(const bool enabled, const double cap) {
+    onDemand     = enabled;
+    idleFrameCap = std::max(cap, 0.0);
+}
+
+void GameWindow::MarkDirty() {
+    dirty = true;
+    PostEmptyEvent();
+}
+
+// The spin, and the step after it stops while interpolation catches up
+const bool GameWindow::Animating() const {
+    return spinning || simulation.Previous.Angle != simulation.Current.Angle;
+}
+
+// Animation draws every frame, anything else at most idleFrameCap a second
+const bool GameWindow::FrameDue(const Clock::time_point now) const {
+    if (Animating()) return true;
+    if (!dirty) return false;
+
+    return idleFrameCap <= 0.0 || std::chrono::duration<double>(now - lastRequest).count() >= 1.0 / idleFrameCap;
+}
+
+// Sleeps until input arrives or the next frame is due, indefinitely while
+// nothing changes
+void GameWindow::WaitForWork(const Clock::time_point now, const bool busy) {
+    if (busy || Animating()) {
+        if (mode == ThreadingMode::SingleThread) {
+            PollEvents();
+        }
+        else {
+            WaitEventsTimeout(std::max(0.0, SimulationStep - accumulator));
+        }
+        return;
+    }
+
+    if (dirty) {
+        const auto sinceFrame{ std::chrono::duration<double>(now - lastRequest).count() };
+        const auto wait      { idleFrameCap > 0.0 ? 1.0 / idleFrameCap - sinceFrame : 0.0 };
+        WaitEventsTimeout(std::max(0.0, wait));
+        return;
+    }
+
+    WaitEvents();
+}
+
+void GameWindow::PublishRequests(const bool request) {
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        requests.Requested = requests.Requested || request;
+        requests.Animating = Animating();
+    }
+    requestSignal.notify_one();
+}
+
+// Render thread, false once rendering stops
+const bool GameWindow::WaitForRequest() {
+    std::unique_lock<std::mutex> lock(requestMutex);
+    requestSignal.wait(lock, [this]() {
+        return requests.Requested || requests.Animating || !rendering.load(std::memory_order_acquire);
+    });
+
+    requests.Requested = false;
+    return rendering.load(std::memory_order_acquire);
+}
+
+void GameWindow::StopRendering() {
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        rendering = false;
+    }
+    requestSignal.notify_one();
+}
+
+void GameWindow::LoadMesh(const std::string& path) {
+    renderer->LoadMesh(path);
+}
+
+void GameWindow::StartCapture(const std::string& path) {
+    renderer->StartCapture(path);
 }
 
 void GameWindow::DumpVersion() {
@@ -60,4 +373,3 @@ void GameWindow::DumpVersion() {
     LOGGER << "Engine version: " << ERDBI::GetVersionString() << '\n';
     LOGGER << "Compiled with " << ERDBI::GetCompilerString() << '\n';
 }
-
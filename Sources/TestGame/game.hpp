@@ -2,22 +2,123 @@
 #define GAME_MAIN_HPP
 
 #include "Window/GLFW.hpp"
+#include "Jobs/Scheduler.hpp"
+#include "Jobs/TripleBuffer.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
 #include <string>
 #include <memory>
+#include <vector>
 
 namespace Engine::Render {
     class Renderer;
+    struct FrameView;
+}
+
+namespace Engine::Render::Lighting {
+    struct PointLight;
 }
 
 class GameWindow : public Engine::Window::GLFW_Window_wrapper {
 
+public:
+    // RenderThread keeps GLFW and the simulation on the main thread and hands
+    // frames to a thread that owns the renderer, so GPU backpressure can't
+    // stall input or the simulation. SingleThread does both in one loop.
+    enum class ThreadingMode {
+        SingleThread,
+        RenderThread
+    };
+
 private:
+    using Clock = std::chrono::steady_clock;
+
+    struct GameState {
+        float Angle{ 0.0f };
+    };
+
+    // The last two simulation steps, the renderer blends between them
+    struct Snapshot {
+        GameState           Previous;
+        GameState           Current;
+        Clock::time_point   CurrentTime;    // When Current became the present
+    };
+
+    Engine::Jobs::Scheduler jobs;
     std::unique_ptr<Engine::Render::Renderer> renderer;
+    ThreadingMode mode;
+
+    // Render thread side of on demand rendering, guarded by requestMutex
+    struct FrameRequests {
+        bool Requested  { false };
+        bool Animating  { false };      // Draw continuously
+    };
+
+    Engine::Jobs::TripleBuffer<Snapshot> snapshots;
+    std::atomic<uint64_t>   resizes{ 0 };
+    std::atomic<float>      aspect{ 1.0f };         // Width over height, written by resizes
+    std::atomic<uint32_t>   framesDrawn{ 0 };
+    std::atomic<bool>       rendering{ false };
+    std::exception_ptr      renderFailure;          // Rethrown on the main thread after the join
+
+    // Render side only, reused every frame
+    std::vector<Engine::Render::Lighting::PointLight> lights;
+
+    // Fixed timestep simulation state, main thread only
+    Snapshot        simulation{};
+    double          accumulator{ 0.0 };
+    Clock::time_point lastTick{};
+    bool            spinning{ true };
+
+    // On demand rendering, see SetOnDemand
+    bool                    onDemand{ false };
+    double                  idleFrameCap{ 30.0 };
+    std::atomic<bool>       dirty{ true };
+    Clock::time_point       lastRequest{};          // Main thread only
+    std::mutex              requestMutex;
+    std::condition_variable requestSignal;
+    FrameRequests           requests{};
+
+    const bool  Simulate(const Clock::time_point now);
+    void        Draw(const Snapshot& snapshot, uint64_t& seenResizes);
+    void        RenderLoop();
+    void        ReportFps(Clock::time_point& start);
+    void        PlaceLights(const float angle);
+
+    const bool  Animating() const;
+    const bool  FrameDue(const Clock::time_point now) const;
+    void        WaitForWork(const Clock::time_point now, const bool busy);
+    void        PublishRequests(const bool request);
+    const bool  WaitForRequest();
+    void        StopRendering();
+
+    static Engine::Render::FrameView Interpolate(const Snapshot& snapshot, const Clock::time_point now, const float aspect);
 
 public:
-    GameWindow(int w, int h, const std::string& title);
+    GameWindow(int w, int h, const std::string& title, const ThreadingMode threading = ThreadingMode::RenderThread);
+    ~GameWindow();
     void WindowLoop() override;
+    void WindowResized(int new_width, int new_height) override;
+    void WindowRefresh() override;
+    void ProcessInput() override;
+    void ProcessScroll(double x, double y) override;
+    // Space starts and stops the spin
+    void ProcessTextInput(unsigned int codepoint) override;
+    void LoadMesh(const std::string& path);
+    // Records every renderer call from here on, see Render/Capture
+    void StartCapture(const std::string& path);
+
+    // Frames only when input arrives, MarkDirty is called, something
+    // animates or a mesh is streaming, otherwise the loop sleeps in
+    // WaitEvents. Frames that aren't animation are capped at
+    // idleFrameCap a second, 0 for no cap. Call before WindowLoop.
+    void SetOnDemand(const bool enabled, const double idleFrameCap = 30.0);
+    // Something the next frame has to show changed, from any thread
+    void MarkDirty();
     static void DumpVersion();
 };
 
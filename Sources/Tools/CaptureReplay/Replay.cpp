@@ -0,0 +1,161 @@
+#include "Replay.hpp"
+#include "Render/Renderer.hpp"
+#include "Render/Server/RenderServer.hpp"
+#include "Window/GLFW.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace Engine::Tools::CaptureReplay {
+
+    namespace ER  = Engine::Render;
+    namespace ERS = Engine::Render::Server;
+    namespace EP  = Engine::Primitives;
+
+    namespace {
+        using Clock = std::chrono::high_resolution_clock;
+
+        // What a fresh Renderer draws until told otherwise, the headless
+        // replay starts out the same way
+        const std::vector<EP::Vertex> DefaultVertices = {
+            {{0.0f, -0.5f}, {1.0f, 0.0f, 0.0f}},
+            {{0.5f, 0.5f},  {0.0f, 1.0f, 0.0f}},
+            {{-0.5f, 0.5f}, {0.0f, 0.0f, 1.0f}}
+        };
+
+        // SetTransforms only carries the changed range, the rest is kept
+        // from earlier records the way the renderer keeps it
+        void ApplyTransforms(const ERC::Record& record, std::vector<glm::mat4>& worlds, ER::Renderer& renderer) {
+            const auto range{ record.Head<ERC::TransformRange>() };
+            const auto changed{ record.Array<glm::mat4>(sizeof(range)) };
+            if (changed.size() != range.Changed || uint64_t{ range.First } + range.Changed > range.Count) {
+                throw std::runtime_error("Capture transforms out of range");
+            }
+
+            worlds.resize(range.Count, glm::mat4(1.0f));
+            std::copy(changed.begin(), changed.end(), worlds.begin() + range.First);
+            renderer.SetTransforms(worlds.data(), range.Count, range.First, range.Changed);
+        }
+
+        void Skip(ReplayStats& stats, const ERC::Op operation) {
+            ++stats.Skipped[static_cast<size_t>(operation)];
+        }
+    }
+
+    ReplayStats ReplayWindowed(ERC::CaptureReader& capture, const uint32_t width, const uint32_t height, const uint32_t loops) {
+        Engine::Window::GLFW_Window_wrapper window(static_cast<int>(width), static_cast<int>(height), "Capture replay");
+        ER::Renderer renderer(window.GetGLFWRequiredInstanceExtensions(), window.GetHandle());
+
+        ReplayStats stats{};
+        stats.FrameMs.reserve(capture.Frames() * loops);
+        std::vector<glm::mat4> worlds{};
+
+        auto frameStart{ Clock::now() };
+        for (uint32_t loop = 0; loop < loops; ++loop) {
+            capture.Rewind();
+
+            for (ERC::Record record{}; capture.Next(record);) {
+                switch (record.Operation) {
+                case ERC::Op::Frame:
+                    window.PollEvents();
+                    renderer.DrawFrame(record.Value<ER::FrameView>());
+                    stats.FrameMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - frameStart).count());
+                    frameStart = Clock::now();
+                    break;
+                case ERC::Op::Vertices:
+                    renderer.UpdateVertices(record.Array<EP::Vertex>());
+                    break;
+                case ERC::Op::DrawObjects:
+                    renderer.SetDrawObjects(record.Array<ER::Culling::DrawObject>());
+                    break;
+                case ERC::Op::Transforms:
+                    ApplyTransforms(record, worlds, renderer);
+                    break;
+                case ERC::Op::Lights:
+                    renderer.SetLights(record.Array<ER::Lighting::PointLight>());
+                    break;
+                case ERC::Op::LoadMesh: {
+                    const auto request{ record.Head<ERC::MeshRequest>() };
+                    renderer.LoadMesh(record.Text(sizeof(ERC::MeshRequest)), request.Mesh, request.Lod);
+                    break;
+                }
+                case ERC::Op::LoadTexture:
+                    renderer.LoadTexture(record.Text());
+                    break;
+                case ERC::Op::CommandReuse:
+                    renderer.SetCommandReuse(record.Value<uint8_t>() != 0);
+                    break;
+                case ERC::Op::Resolution:
+                    renderer.SetResolution(record.Value<ER::Resolution::ResolutionSettings>());
+                    break;
+                case ERC::Op::ReloadPipeline:
+                    renderer.ReloadPipeline();
+                    break;
+                case ERC::Op::SurfaceResized:
+                    // The replay window keeps its size, the rebuild still happens
+                    renderer.SurfaceResized();
+                    break;
+                case ERC::Op::ShaderFeatures:
+                    renderer.SetShaderFeatures(record.Value<ER::Shader::FeatureKey>());
+                    break;
+                default:
+                    Skip(stats, record.Operation);
+                    break;
+                }
+            }
+        }
+
+        renderer.WaitDevice();
+        stats.GpuMs = renderer.GpuFrameMs();
+        return stats;
+    }
+
+    ReplayStats ReplayHeadless(ERC::CaptureReader& capture, const uint32_t width, const uint32_t height, const uint32_t loops) {
+        ERS::ServerSettings settings{};
+        settings.MaxSessions        = 1;
+        settings.MaxSessionsPerTick = 1;
+        ERS::RenderServer server(settings);
+
+        const auto session{ server.CreateSession({ width, height }) };
+        auto mesh{ server.AddMesh(DefaultVertices) };
+        server.SetMeshes(session, { mesh });
+
+        ReplayStats stats{};
+        stats.FrameMs.reserve(capture.Frames() * loops);
+
+        auto frameStart{ Clock::now() };
+        for (uint32_t loop = 0; loop < loops; ++loop) {
+            capture.Rewind();
+
+            for (ERC::Record record{}; capture.Next(record);) {
+                switch (record.Operation) {
+                case ERC::Op::Frame:
+                    server.SetView(session, record.Value<ER::FrameView>());
+                    server.RequestFrame(session);
+                    server.Tick();
+                    stats.FrameMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - frameStart).count());
+                    frameStart = Clock::now();
+                    break;
+                case ERC::Op::Vertices:
+                    server.RemoveMesh(mesh);
+                    mesh = server.AddMesh(record.Array<EP::Vertex>());
+                    server.SetMeshes(session, { mesh });
+                    break;
+                case ERC::Op::Lights:
+                    server.SetLights(session, record.Array<ER::Lighting::PointLight>());
+                    break;
+                case ERC::Op::SurfaceResized:
+                    // The session keeps its size
+                    break;
+                default:
+                    Skip(stats, record.Operation);
+                    break;
+                }
+            }
+        }
+
+        server.WaitIdle();
+        return stats;
+    }
+}
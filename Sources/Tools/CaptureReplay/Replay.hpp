@@ -0,0 +1,37 @@
+#ifndef TOOLS_CAPTURE_REPLAY_REPLAY_HPP
+#define TOOLS_CAPTURE_REPLAY_REPLAY_HPP
+
+#include "Render/Capture/CaptureReader.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace Engine::Tools::CaptureReplay {
+
+    namespace ERC = Engine::Render::Capture;
+
+    struct ReplayStats {
+        // Wall time of each frame, from the end of the one before, so the
+        // scene changes recorded in between are counted in
+        std::vector<double>     FrameMs;
+        // Records the replay had no way to run, by Op
+        std::array<uint64_t, static_cast<size_t>(ERC::Op::Count)> Skipped{};
+        float                   GpuMs   { 0.0f };      // Last smoothed GPU frame time, windowed only
+    };
+
+    // Runs every record through a Renderer in a window of its own, the same
+    // path the game takes. Frames are presented, so the present mode and
+    // the compositor still have a say. The default mode.
+    ReplayStats ReplayWindowed(ERC::CaptureReader& capture, const uint32_t width, const uint32_t height, const uint32_t loops);
+
+    // Runs the capture as one session of a RenderServer, with no window or
+    // surface at all, see Render/Server/RenderServer.hpp. Views, lights and
+    // vertex updates carry over, anything the server doesn't do (culling
+    // objects, transforms, streaming, renderer settings and shader features)
+    // is skipped and counted, so its timings are only comparable between
+    // captures that don't use them. Opt in with --headless.
+    ReplayStats ReplayHeadless(ERC::CaptureReader& capture, const uint32_t width, const uint32_t height, const uint32_t loops);
+}
+
+#endif // !TOOLS_CAPTURE_REPLAY_REPLAY_HPP
@@ -0,0 +1,101 @@
+#include "Replay.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <numeric>
+#include <string>
+
+using namespace Engine::Tools::CaptureReplay;
+
+namespace {
+
+    const char* OpNames[]{
+        "Frame", "Vertices", "DrawObjects", "Transforms", "Lights", "LoadMesh",
+        "LoadTexture", "CommandReuse", "Resolution", "ReloadPipeline", "SurfaceResized",
+        "ShaderFeatures"
+    };
+    static_assert(std::size(OpNames) == static_cast<size_t>(ERC::Op::Count));
+
+    // Nearest rank, times come in sorted
+    double Percentile(const std::vector<double>& sorted, const double p) {
+        if (sorted.empty()) return 0.0;
+        const auto rank{ static_cast<size_t>(p / 100.0 * static_cast<double>(sorted.size() - 1) + 0.5) };
+        return sorted[std::min(rank, sorted.size() - 1)];
+    }
+}
+
+int main(int argc, char* argv[]) {
+
+    // The Renderer path runs every record, headless only what a server session can
+    bool windowed{ true };
+    uint32_t width{ 800 };
+    uint32_t height{ 600 };
+    uint32_t loops{ 1 };
+    std::string csvPath{};
+    std::string capturePath{};
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg{ argv[i] };
+        if      (arg == "--window")                     windowed = true;
+        else if (arg == "--headless")                   windowed = false;
+        else if (arg == "--size" && i + 2 < argc)       { width = std::stoul(argv[++i]); height = std::stoul(argv[++i]); }
+        else if (arg == "--loops" && i + 1 < argc)      loops = std::max(1ul, std::stoul(argv[++i]));
+        else if (arg == "--csv" && i + 1 < argc)        csvPath = argv[++i];
+        else                                            capturePath = arg;
+    }
+
+    if (capturePath.empty()) {
+        std::cerr << "Usage: CaptureReplay [--window | --headless] [--size <w> <h>] [--loops <n>] [--csv <frames.csv>] <capture.ecap>\n";
+        return EXIT_FAILURE;
+    }
+
+    try {
+        ERC::CaptureReader capture(capturePath);
+        std::cout << "Capture:          " << capturePath << ", " << capture.Frames() << " frames, " << capture.Bytes() << " bytes\n";
+
+        const auto stats{ windowed
+            ? ReplayWindowed(capture, width, height, loops)
+            : ReplayHeadless(capture, width, height, loops) };
+
+        if (!csvPath.empty()) {
+            std::ofstream csv(csvPath);
+            csv << "frame,ms\n";
+            for (size_t i = 0; i < stats.FrameMs.size(); ++i) {
+                csv << i << ',' << stats.FrameMs[i] << '\n';
+            }
+        }
+
+        auto sorted{ stats.FrameMs };
+        std::sort(sorted.begin(), sorted.end());
+        const auto total{ std::accumulate(sorted.begin(), sorted.end(), 0.0) };
+
+        std::cout << std::fixed << std::setprecision(3)
+                  << "Mode:             " << (windowed ? "window" : "headless") << ", " << width << 'x' << height << ", " << loops << " loop(s)\n"
+                  << "Frames:           " << sorted.size() << '\n'
+                  << "Total (ms):       " << total << '\n'
+                  << "Mean (ms):        " << (sorted.empty() ? 0.0 : total / sorted.size()) << '\n'
+                  << "Median (ms):      " << Percentile(sorted, 50.0) << '\n'
+                  << "95th (ms):        " << Percentile(sorted, 95.0) << '\n'
+                  << "99th (ms):        " << Percentile(sorted, 99.0) << '\n'
+                  << "Worst (ms):       " << (sorted.empty() ? 0.0 : sorted.back()) << '\n';
+        if (windowed) {
+            std::cout << "GPU (ms):         " << stats.GpuMs << '\n';
+        }
+
+        for (size_t op = 0; op < stats.Skipped.size(); ++op) {
+            if (stats.Skipped[op] > 0) {
+                std::cout << "Skipped:          " << stats.Skipped[op] << ' ' << OpNames[op] << '\n';
+            }
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Replay failed: " << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,155 @@
+#include "MeshWriter.hpp"
+#include "Assets/Mesh/MeshFormat.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace Engine::Tools::MeshConverter {
+
+    namespace EAM = Engine::Assets::Mesh;
+
+    namespace {
+
+        // No vertex colors in OBJ, visualize normals instead
+        glm::vec3 VertexColor(const SourceVertex& v, const bool hasNormals) {
+            return hasNormals ? glm::normalize(v.Normal) * 0.5f + 0.5f : glm::vec3(1.0f);
+        }
+
+        void PackVertices(const SourceMesh& mesh, std::vector<EAM::FileVertex>& out) {
+            out.resize(mesh.Vertices.size());
+
+            for (size_t i = 0; i < mesh.Vertices.size(); ++i) {
+                const auto& v    { mesh.Vertices[i] };
+                const auto  color{ VertexColor(v, mesh.HasNormals) };
+
+                out[i] = { { v.Position.x, v.Position.y }, { color.r, color.g, color.b } };
+            }
+        }
+
+        EAM::Bounds ComputeBounds(const SourceMesh& mesh) {
+            glm::vec3 minBound{ mesh.Vertices[0].Position };
+            glm::vec3 maxBound{ mesh.Vertices[0].Position };
+
+            for (const auto& v : mesh.Vertices) {
+                minBound = glm::min(minBound, v.Position);
+                maxBound = glm::max(maxBound, v.Position);
+            }
+
+            const auto center{ (minBound + maxBound) * 0.5f };
+            float radius{ 0.0f };
+
+            for (const auto& v : mesh.Vertices) {
+                radius = std::max(radius, glm::length(v.Position - center));
+            }
+
+            return {
+                { minBound.x, minBound.y, minBound.z },
+                { maxBound.x, maxBound.y, maxBound.z },
+                { center.x,   center.y,   center.z   },
+                radius
+            };
+        }
+
+        void Pad(std::ofstream& out, const uint64_t to) {
+            static const char zeros[EAM::BlobAlignment]{};
+            const auto at{ static_cast<uint64_t>(out.tellp()) };
+            out.write(zeros, static_cast<std::streamsize>(to - at));
+        }
+    }
+
+    void WriteMeshFile(const std::string& path, const std::vector<SourceMesh>& meshes) {
+
+        // Lay out the whole file first so the table can be written in one go
+        std::vector<EAM::MeshEntry> table(meshes.size());
+
+        uint64_t offset{ EAM::AlignBlob(sizeof(EAM::FileHeader) + sizeof(EAM::MeshEntry) * meshes.size()) };
+
+        for (size_t i = 0; i < meshes.size(); ++i) {
+            const auto& mesh { meshes[i] };
+            auto&       entry{ table[i] };
+
+            std::strncpy(entry.Name, mesh.Name.c_str(), EAM::MaxNameLength - 1);
+            entry.Volume        = ComputeBounds(mesh);
+            entry.VertexOffset  = offset;
+            entry.VertexCount   = static_cast<uint32_t>(mesh.Vertices.size());
+            entry.LodCount      = static_cast<uint32_t>(std::min<size_t>(mesh.Lods.size(), EAM::MaxLods));
+
+            offset = EAM::AlignBlob(offset + sizeof(EAM::FileVertex) * mesh.Vertices.size());
+
+            for (uint32_t lod = 0; lod < entry.LodCount; ++lod) {
+                entry.Lods[lod].IndexOffset = offset;
+                entry.Lods[lod].IndexCount  = static_cast<uint32_t>(mesh.Lods[lod].Indices.size());
+                entry.Lods[lod].Error       = mesh.Lods[lod].Error;
+
+                offset = EAM::AlignBlob(offset + sizeof(uint32_t) * mesh.Lods[lod].Indices.size());
+            }
+
+            const auto& meshlets{ mesh.Meshlets };
+            auto&       section { entry.Meshlets };
+
+            section.MeshletCount    = static_cast<uint32_t>(meshlets.Meshlets.size());
+            section.VertexCount     = static_cast<uint32_t>(meshlets.Vertices.size());
+            section.TriangleCount   = static_cast<uint32_t>(meshlets.Triangles.size());
+
+            section.MeshletOffset   = offset;
+            offset                  = EAM::AlignBlob(offset + sizeof(EAM::Meshlet) * meshlets.Meshlets.size());
+            section.VertexOffset    = offset;
+            offset                  = EAM::AlignBlob(offset + sizeof(uint32_t) * meshlets.Vertices.size());
+            section.TriangleOffset  = offset;
+            offset                  = EAM::AlignBlob(offset + sizeof(uint32_t) * meshlets.Triangles.size());
+        }
+
+        EAM::FileHeader header{};
+        header.Magic            = EAM::MeshMagic;
+        header.Version          = EAM::MeshVersion;
+        header.MeshCount        = static_cast<uint32_t>(meshes.size());
+        header.VertexStride     = sizeof(EAM::FileVertex);
+        header.Vertices         = EAM::VertexFormat::Pos2Col3;
+        header.Indices          = EAM::IndexFormat::Uint32;
+        header.MeshTableOffset  = sizeof(EAM::FileHeader);
+        header.FileSize         = offset;
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            throw std::runtime_error("Could not open file " + path);
+        }
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(table.data()), static_cast<std::streamsize>(sizeof(EAM::MeshEntry) * table.size()));
+
+        std::vector<EAM::FileVertex> vertices{};
+
+        for (size_t i = 0; i < meshes.size(); ++i) {
+            const auto& mesh{ meshes[i] };
+
+            PackVertices(mesh, vertices);
+
+            Pad(out, table[i].VertexOffset);
+            out.write(reinterpret_cast<const char*>(vertices.data()), static_cast<std::streamsize>(sizeof(EAM::FileVertex) * vertices.size()));
+
+            for (uint32_t lod = 0; lod < table[i].LodCount; ++lod) {
+                const auto& indices{ mesh.Lods[lod].Indices };
+                Pad(out, table[i].Lods[lod].IndexOffset);
+                out.write(reinterpret_cast<const char*>(indices.data()), static_cast<std::streamsize>(sizeof(uint32_t) * indices.size()));
+            }
+
+            const auto& meshlets{ mesh.Meshlets };
+            const auto& section { table[i].Meshlets };
+
+            Pad(out, section.MeshletOffset);
+            out.write(reinterpret_cast<const char*>(meshlets.Meshlets.data()), static_cast<std::streamsize>(sizeof(EAM::Meshlet) * meshlets.Meshlets.size()));
+            Pad(out, section.VertexOffset);
+            out.write(reinterpret_cast<const char*>(meshlets.Vertices.data()), static_cast<std::streamsize>(sizeof(uint32_t) * meshlets.Vertices.size()));
+            Pad(out, section.TriangleOffset);
+            out.write(reinterpret_cast<const char*>(meshlets.Triangles.data()), static_cast<std::streamsize>(sizeof(uint32_t) * meshlets.Triangles.size()));
+        }
+
+        Pad(out, offset);
+
+        if (!out.good()) {
+            throw std::runtime_error("Failed writing " + path);
+        }
+    }
+}
@@ -0,0 +1,11 @@
+#ifndef TOOLS_MESHCONV_MESH_WRITER_HPP
+#define TOOLS_MESHCONV_MESH_WRITER_HPP
+
+#include "SourceMesh.hpp"
+
+namespace Engine::Tools::MeshConverter {
+
+    void WriteMeshFile(const std::string& path, const std::vector<SourceMesh>& meshes);
+}
+
+#endif // !TOOLS_MESHCONV_MESH_WRITER_HPP
@@ -0,0 +1,134 @@
+#include "Meshlets.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Engine::Tools::MeshConverter {
+
+    namespace EAM = Engine::Assets::Mesh;
+
+    namespace {
+
+        // Below this the normals are too spread for the cone to ever cull
+        constexpr float MinConeSpread{ 0.1f };
+
+        constexpr uint8_t NotInMeshlet{ 0xFF };
+
+        glm::vec3 Position(const SourceMesh& mesh, const uint32_t vertex, const bool flat) {
+            const auto& p{ mesh.Vertices[vertex].Position };
+            return flat ? glm::vec3(p.x, p.y, 0.0f) : p;
+        }
+
+        // Sphere around the vertices' box and a cone around the triangle normals
+        void ComputeBounds(const SourceMesh& mesh, const SourceMeshlets& out, EAM::Meshlet& meshlet, const bool flat) {
+            const auto* vertices { out.Vertices.data()  + meshlet.VertexOffset };
+            const auto* triangles{ out.Triangles.data() + meshlet.TriangleOffset };
+
+            glm::vec3 lo{ Position(mesh, vertices[0], flat) };
+            glm::vec3 hi{ lo };
+            for (uint32_t i = 1; i < meshlet.VertexCount; ++i) {
+                lo = glm::min(lo, Position(mesh, vertices[i], flat));
+                hi = glm::max(hi, Position(mesh, vertices[i], flat));
+            }
+
+            const auto center{ (lo + hi) * 0.5f };
+            float radius{ 0.0f };
+            for (uint32_t i = 0; i < meshlet.VertexCount; ++i) {
+                radius = std::max(radius, glm::length(Position(mesh, vertices[i], flat) - center));
+            }
+
+            std::vector<glm::vec3> normals{};
+            normals.reserve(meshlet.TriangleCount);
+            glm::vec3 sum{ 0.0f };
+
+            for (uint32_t t = 0; t < meshlet.TriangleCount; ++t) {
+                const auto packed{ triangles[t] };
+                const auto a{ Position(mesh, vertices[packed & 0xFF], flat) };
+                const auto b{ Position(mesh, vertices[(packed >> 8) & 0xFF], flat) };
+                const auto c{ Position(mesh, vertices[(packed >> 16) & 0xFF], flat) };
+
+                const auto normal{ glm::cross(b - a, c - a) };
+                const auto length{ glm::length(normal) };
+
+                // Degenerate triangles can't face anywhere
+                if (length > 1e-12f) {
+                    normals.push_back(normal / length);
+                    sum += normals.back();
+                }
+            }
+
+            std::copy_n(&center.x, 3, meshlet.Center);
+            meshlet.Radius = radius;
+
+            const auto sumLength{ glm::length(sum) };
+            glm::vec3 axis{ 0.0f };
+            float spread{ -1.0f };
+
+            if (!normals.empty() && sumLength > 1e-12f) {
+                axis   = sum / sumLength;
+                spread = 1.0f;
+                for (const auto& n : normals) {
+                    spread = std::min(spread, glm::dot(axis, n));
+                }
+            }
+
+            std::copy_n(&axis.x, 3, meshlet.ConeAxis);
+            meshlet.ConeCutoff = spread > MinConeSpread ? std::sqrt(1.0f - spread * spread) : 1.0f;
+        }
+    }
+
+    void BuildMeshlets(SourceMesh& mesh, const bool flat) {
+        auto& out{ mesh.Meshlets };
+        out = SourceMeshlets{};
+
+        if (mesh.Lods.empty()) return;
+        const auto& indices{ mesh.Lods[0].Indices };
+
+        // Position of each vertex in the meshlet being built
+        std::vector<uint8_t> local(mesh.Vertices.size(), NotInMeshlet);
+        EAM::Meshlet current{};
+
+        const auto finish{ [&]() {
+            if (current.TriangleCount == 0) return;
+
+            ComputeBounds(mesh, out, current, flat);
+            out.Meshlets.push_back(current);
+
+            for (uint32_t i = 0; i < current.VertexCount; ++i) {
+                local[out.Vertices[current.VertexOffset + i]] = NotInMeshlet;
+            }
+
+            current                 = EAM::Meshlet{};
+            current.VertexOffset    = static_cast<uint32_t>(out.Vertices.size());
+            current.TriangleOffset  = static_cast<uint32_t>(out.Triangles.size());
+        } };
+
+        for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+            const uint32_t corners[3]{ indices[t], indices[t + 1], indices[t + 2] };
+
+            uint32_t added{ 0 };
+            for (const auto v : corners) {
+                added += local[v] == NotInMeshlet ? 1 : 0;
+            }
+            // Repeated corners of a degenerate triangle count once too many, harmless
+            if (current.VertexCount + added > EAM::MaxMeshletVertices || current.TriangleCount + 1 > EAM::MaxMeshletTriangles) {
+                finish();
+            }
+
+            uint32_t packed{ 0 };
+            for (uint32_t c = 0; c < 3; ++c) {
+                const auto v{ corners[c] };
+                if (local[v] == NotInMeshlet) {
+                    local[v] = static_cast<uint8_t>(current.VertexCount++);
+                    out.Vertices.push_back(v);
+                }
+                packed |= uint32_t{ local[v] } << (8 * c);
+            }
+
+            out.Triangles.push_back(packed);
+            ++current.TriangleCount;
+        }
+
+        finish();
+    }
+}
@@ -0,0 +1,17 @@
+#ifndef TOOLS_MESHCONV_MESHLETS_HPP
+#define TOOLS_MESHCONV_MESHLETS_HPP
+
+#include "SourceMesh.hpp"
+
+namespace Engine::Tools::MeshConverter {
+
+    // Splits LOD 0 into meshlets of at most MaxMeshletVertices vertices and
+    // MaxMeshletTriangles triangles, filling mesh.Meshlets. Triangles are
+    // taken in index order, so run it after the vertex cache optimisation
+    // to get tight clusters. Bounds use the positions as the runtime sees
+    // them, flat drops z for the 2D vertex format. Front faces are counter
+    // clockwise, as in OBJ.
+    void BuildMeshlets(SourceMesh& mesh, const bool flat);
+}
+
+#endif // !TOOLS_MESHCONV_MESHLETS_HPP
@@ -0,0 +1,163 @@
+#include "ObjReader.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace Engine::Tools::MeshConverter {
+
+    namespace {
+
+        struct ObjIndex {
+            int Position{ 0 };
+            int UV      { 0 };
+            int Normal  { 0 };
+
+            bool operator==(const ObjIndex& other) const {
+                return Position == other.Position && UV == other.UV && Normal == other.Normal;
+            }
+        };
+
+        struct ObjIndexHash {
+            size_t operator()(const ObjIndex& i) const {
+                return (static_cast<size_t>(i.Position) * 73856093u) ^
+                       (static_cast<size_t>(i.UV)       * 19349663u) ^
+                       (static_cast<size_t>(i.Normal)   * 83492791u);
+            }
+        };
+
+        // OBJ indices are 1 based, negative ones count back from the end
+        int Resolve(const int index, const size_t count) {
+            if (index > 0)  return index - 1;
+            if (index < 0)  return static_cast<int>(count) + index;
+            return -1;
+        }
+
+        ObjIndex ParseCorner(const std::string& token) {
+            ObjIndex corner{};
+            int* fields[]{ &corner.Position, &corner.UV, &corner.Normal };
+
+            size_t field{ 0 };
+            size_t begin{ 0 };
+            while (field < 3 && begin <= token.size()) {
+                const auto end{ token.find('/', begin) };
+                const auto part{ token.substr(begin, end == std::string::npos ? std::string::npos : end - begin) };
+
+                if (!part.empty()) *fields[field] = std::stoi(part);
+                if (end == std::string::npos) break;
+
+                begin = end + 1;
+                ++field;
+            }
+
+            return corner;
+        }
+    }
+
+    std::vector<SourceMesh> ReadObj(const std::string& path) {
+
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open file " + path);
+        }
+
+        std::vector<glm::vec3> positions{};
+        std::vector<glm::vec3> normals{};
+        std::vector<glm::vec2> uvs{};
+
+        std::vector<SourceMesh> meshes{};
+        std::unordered_map<ObjIndex, uint32_t, ObjIndexHash> vertexLookup{};
+
+        const auto beginMesh{ [&](const std::string& name) {
+            // Don't leave empty meshes behind for back to back o/g records
+            if (!meshes.empty() && meshes.back().Lods[0].Indices.empty()) {
+                meshes.back().Name = name;
+                return;
+            }
+            meshes.emplace_back();
+            meshes.back().Name = name;
+            meshes.back().Lods.emplace_back();
+            vertexLookup.clear();
+        }};
+
+        std::string line{};
+        std::vector<uint32_t> polygon{};
+
+        while (std::getline(file, line)) {
+            std::istringstream record(line);
+            std::string type{};
+            record >> type;
+
+            if (type == "v") {
+                glm::vec3 p{};
+                record >> p.x >> p.y >> p.z;
+                positions.emplace_back(p);
+            }
+            else if (type == "vn") {
+                glm::vec3 n{};
+                record >> n.x >> n.y >> n.z;
+                normals.emplace_back(n);
+            }
+            else if (type == "vt") {
+                glm::vec2 t{};
+                record >> t.x >> t.y;
+                uvs.emplace_back(t);
+            }
+            else if (type == "o" || type == "g") {
+                std::string name{};
+                record >> name;
+                beginMesh(name);
+            }
+            else if (type == "f") {
+                if (meshes.empty()) beginMesh("default");
+
+                auto& mesh{ meshes.back() };
+                polygon.clear();
+
+                std::string token{};
+                while (record >> token) {
+                    const auto raw{ ParseCorner(token) };
+                    const auto p{ Resolve(raw.Position, positions.size()) };
+                    const auto t{ Resolve(raw.UV,       uvs.size()) };
+                    const auto n{ Resolve(raw.Normal,   normals.size()) };
+
+                    if (p < 0 || p >= static_cast<int>(positions.size())) {
+                        throw std::runtime_error("Bad position index in " + path);
+                    }
+
+                    const ObjIndex corner{ p, t, n };
+                    const auto found{ vertexLookup.find(corner) };
+
+                    if (found != vertexLookup.end()) {
+                        polygon.emplace_back(found->second);
+                        continue;
+                    }
+
+                    SourceVertex vertex{};
+                    vertex.Position = positions[p];
+                    if (t >= 0 && t < static_cast<int>(uvs.size()))     vertex.UV = uvs[t];
+                    if (n >= 0 && n < static_cast<int>(normals.size())) {
+                        vertex.Normal = normals[n];
+                        mesh.HasNormals = true;
+                    }
+
+                    const auto index{ static_cast<uint32_t>(mesh.Vertices.size()) };
+                    mesh.Vertices.emplace_back(vertex);
+                    vertexLookup.emplace(corner, index);
+                    polygon.emplace_back(index);
+                }
+
+                for (size_t i = 2; i < polygon.size(); ++i) {
+                    mesh.Lods[0].Indices.insert(mesh.Lods[0].Indices.end(), { polygon[0], polygon[i - 1], polygon[i] });
+                }
+            }
+        }
+
+        if (!meshes.empty() && meshes.back().Lods[0].Indices.empty()) {
+            meshes.pop_back();
+        }
+
+        return meshes;
+    }
+}
@@ -0,0 +1,13 @@
+#ifndef TOOLS_MESHCONV_OBJ_READER_HPP
+#define TOOLS_MESHCONV_OBJ_READER_HPP
+
+#include "SourceMesh.hpp"
+
+namespace Engine::Tools::MeshConverter {
+
+    // Reads v/vt/vn/f records, polygons are fan triangulated and every
+    // 'o' or 'g' record starts a new mesh. Materials are ignored.
+    std::vector<SourceMesh> ReadObj(const std::string& path);
+}
+
+#endif // !TOOLS_MESHCONV_OBJ_READER_HPP
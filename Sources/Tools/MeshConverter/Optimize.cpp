@@ -0,0 +1,214 @@
+#include "Optimize.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Engine::Tools::MeshConverter {
+
+    namespace {
+
+        constexpr int   MaxCacheSize        { 32 };
+        constexpr float CacheDecayPower     { 1.5f };
+        constexpr float LastTriangleScore   { 0.75f };
+        constexpr float ValenceBoostScale   { 2.0f };
+        constexpr float ValenceBoostPower   { 0.5f };
+
+        struct VertexState {
+            int     CachePosition   { -1 };
+            int     Remaining       { 0 };
+            float   Score           { 0.0f };
+            size_t  FirstTriangle   { 0 };     // Into the adjacency list
+        };
+
+        float ScoreVertex(const VertexState& v) {
+            if (v.Remaining == 0) return -1.0f;
+
+            float score{ 0.0f };
+
+            if (v.CachePosition >= 0) {
+                // The last triangle's vertices get a fixed score so the
+                // next triangle doesn't just reuse all three
+                if (v.CachePosition < 3) {
+                    score = LastTriangleScore;
+                }
+                else {
+                    const float scaler{ 1.0f / (MaxCacheSize - 3) };
+                    score = std::pow(1.0f - (v.CachePosition - 3) * scaler, CacheDecayPower);
+                }
+            }
+
+            // Favour vertices with few triangles left, they finish sooner
+            return score + ValenceBoostScale * std::pow(static_cast<float>(v.Remaining), -ValenceBoostPower);
+        }
+    }
+
+    void OptimizeVertexCache(std::vector<uint32_t>& indices, const size_t vertexCount) {
+
+        const auto triangleCount{ indices.size() / 3 };
+        if (triangleCount == 0) return;
+
+        std::vector<VertexState> vertices(vertexCount);
+
+        for (const auto i : indices) {
+            ++vertices[i].Remaining;
+        }
+
+        // Flattened vertex -> triangles adjacency
+        std::vector<uint32_t> adjacency(indices.size());
+        {
+            size_t offset{ 0 };
+            for (auto& v : vertices) {
+                v.FirstTriangle = offset;
+                offset += v.Remaining;
+            }
+
+            std::vector<size_t> fill(vertexCount, 0);
+            for (size_t t = 0; t < triangleCount; ++t) {
+                for (size_t c = 0; c < 3; ++c) {
+                    const auto vertex{ indices[t * 3 + c] };
+                    adjacency[vertices[vertex].FirstTriangle + fill[vertex]++] = static_cast<uint32_t>(t);
+                }
+            }
+        }
+
+        for (auto& v : vertices) {
+            v.Score = ScoreVertex(v);
+        }
+
+        std::vector<float> triangleScores(triangleCount);
+        std::vector<bool>  emitted(triangleCount, false);
+
+        for (size_t t = 0; t < triangleCount; ++t) {
+            triangleScores[t] = vertices[indices[t * 3]].Score + vertices[indices[t * 3 + 1]].Score + vertices[indices[t * 3 + 2]].Score;
+        }
+
+        // Removes an emitted triangle from a vertex' live adjacency range
+        const auto removeTriangle{ [&](const uint32_t vertex, const uint32_t triangle) {
+            auto& v{ vertices[vertex] };
+            const auto begin{ adjacency.begin() + v.FirstTriangle };
+            const auto end  { begin + v.Remaining };
+            std::iter_swap(std::find(begin, end, triangle), end - 1);
+            --v.Remaining;
+        }};
+
+        std::vector<uint32_t> output{};
+        output.reserve(indices.size());
+
+        std::vector<uint32_t> cache{};
+        std::vector<uint32_t> nextCache{};
+        cache.reserve(MaxCacheSize + 3);
+        nextCache.reserve(MaxCacheSize + 3);
+
+        size_t bestTriangle{ 0 };
+        size_t scanCursor  { 0 };
+
+        for (size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount) {
+
+            emitted[bestTriangle] = true;
+
+            const uint32_t corners[]{
+                indices[bestTriangle * 3],
+                indices[bestTriangle * 3 + 1],
+                indices[bestTriangle * 3 + 2]
+            };
+
+            for (const auto c : corners) {
+                output.emplace_back(c);
+                removeTriangle(c, static_cast<uint32_t>(bestTriangle));
+            }
+
+            // New LRU order: this triangle first, then whatever was cached
+            nextCache.assign(std::begin(corners), std::end(corners));
+            for (const auto v : cache) {
+                if (v != corners[0] && v != corners[1] && v != corners[2]) {
+                    nextCache.emplace_back(v);
+                }
+            }
+
+            // Evicted vertices drop out of the cache
+            for (size_t i = MaxCacheSize; i < nextCache.size(); ++i) {
+                vertices[nextCache[i]].CachePosition = -1;
+                vertices[nextCache[i]].Score = ScoreVertex(vertices[nextCache[i]]);
+            }
+            nextCache.resize(std::min<size_t>(nextCache.size(), MaxCacheSize));
+            std::swap(cache, nextCache);
+
+            for (size_t i = 0; i < cache.size(); ++i) {
+                vertices[cache[i]].CachePosition = static_cast<int>(i);
+                vertices[cache[i]].Score = ScoreVertex(vertices[cache[i]]);
+            }
+
+            // Only triangles touching the cache changed score
+            float bestScore{ -1.0f };
+            bool  found    { false };
+
+            for (const auto v : cache) {
+                const auto& state{ vertices[v] };
+
+                for (int i = 0; i < state.Remaining; ++i) {
+                    const auto t{ adjacency[state.FirstTriangle + i] };
+
+                    triangleScores[t] = vertices[indices[t * 3]].Score + vertices[indices[t * 3 + 1]].Score + vertices[indices[t * 3 + 2]].Score;
+
+                    if (triangleScores[t] > bestScore) {
+                        bestScore       = triangleScores[t];
+                        bestTriangle    = t;
+                        found           = true;
+                    }
+                }
+            }
+
+            // Cache ran dry, pick up the next untouched triangle
+            if (!found && emittedCount + 1 < triangleCount) {
+                while (emitted[scanCursor]) ++scanCursor;
+                bestTriangle = scanCursor;
+            }
+        }
+
+        indices = std::move(output);
+    }
+
+    void OptimizeVertexFetch(SourceMesh& mesh) {
+
+        constexpr auto unused{ std::numeric_limits<uint32_t>::max() };
+
+        std::vector<uint32_t> remap(mesh.Vertices.size(), unused);
+        std::vector<SourceVertex> reordered{};
+        reordered.reserve(mesh.Vertices.size());
+
+        for (auto& i : mesh.Lods[0].Indices) {
+            if (remap[i] == unused) {
+                remap[i] = static_cast<uint32_t>(reordered.size());
+                reordered.emplace_back(mesh.Vertices[i]);
+            }
+            i = remap[i];
+        }
+
+        // Coarser LODs only reference vertices LOD 0 uses
+        for (size_t lod = 1; lod < mesh.Lods.size(); ++lod) {
+            for (auto& i : mesh.Lods[lod].Indices) {
+                i = remap[i];
+            }
+        }
+
+        mesh.Vertices = std::move(reordered);
+    }
+
+    float AverageCacheMissRatio(const std::vector<uint32_t>& indices, const size_t vertexCount, const uint32_t cacheSize) {
+
+        if (indices.size() < 3) return 0.0f;
+
+        // Timestamp FIFO: a vertex is cached if it went in less than cacheSize misses ago
+        std::vector<size_t> insertedAt(vertexCount, std::numeric_limits<size_t>::max());
+        size_t misses{ 0 };
+
+        for (const auto i : indices) {
+            if (insertedAt[i] == std::numeric_limits<size_t>::max() || misses - insertedAt[i] >= cacheSize) {
+                insertedAt[i] = misses++;
+            }
+        }
+
+        return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+    }
+}
@@ -0,0 +1,21 @@
+#ifndef TOOLS_MESHCONV_OPTIMIZE_HPP
+#define TOOLS_MESHCONV_OPTIMIZE_HPP
+
+#include "SourceMesh.hpp"
+
+namespace Engine::Tools::MeshConverter {
+
+    // Reorders triangles for post-transform vertex cache hits
+    // (Tom Forsyth's linear-speed vertex cache optimisation)
+    void OptimizeVertexCache(std::vector<uint32_t>& indices, const size_t vertexCount);
+
+    // Reorders vertices in first-use order of LOD 0 so fetches walk memory
+    // forwards, all LOD index lists are remapped. Unused vertices are dropped.
+    void OptimizeVertexFetch(SourceMesh& mesh);
+
+    // Average transformed vertices per triangle for a FIFO cache
+    // of the given size. 0.5 is ideal, 3 is the worst case.
+    float AverageCacheMissRatio(const std::vector<uint32_t>& indices, const size_t vertexCount, const uint32_t cacheSize);
+}
+
+#endif // !TOOLS_MESHCONV_OPTIMIZE_HPP
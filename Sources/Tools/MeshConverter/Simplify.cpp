@@ -0,0 +1,71 @@
+#include "Simplify.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace Engine::Tools::MeshConverter {
+
+    namespace {
+
+        // Snap every vertex to a grid cell, the first vertex that lands in a
+        // cell represents it. Triangles that collapse are dropped.
+        SourceLod Cluster(const SourceMesh& mesh, const glm::vec3& minBound, const glm::vec3& cellSize, const uint32_t cells) {
+
+            std::unordered_map<uint64_t, uint32_t> representative{};
+            std::vector<uint32_t> remap(mesh.Vertices.size());
+
+            for (uint32_t i = 0; i < mesh.Vertices.size(); ++i) {
+                const auto cell{ glm::min(glm::uvec3((mesh.Vertices[i].Position - minBound) / cellSize), glm::uvec3(cells - 1)) };
+                const auto key { (uint64_t{ cell.x } << 42) | (uint64_t{ cell.y } << 21) | uint64_t{ cell.z } };
+                remap[i] = representative.emplace(key, i).first->second;
+            }
+
+            SourceLod lod{};
+            const auto& source{ mesh.Lods[0].Indices };
+
+            for (size_t i = 0; i + 2 < source.size(); i += 3) {
+                const auto a{ remap[source[i]] };
+                const auto b{ remap[source[i + 1]] };
+                const auto c{ remap[source[i + 2]] };
+
+                if (a == b || b == c || a == c) continue;
+                lod.Indices.insert(lod.Indices.end(), { a, b, c });
+            }
+
+            lod.Error = glm::length(cellSize);
+            return lod;
+        }
+    }
+
+    void BuildLods(SourceMesh& mesh, const uint32_t maxLods) {
+
+        if (mesh.Vertices.empty()) return;
+
+        glm::vec3 minBound{ mesh.Vertices[0].Position };
+        glm::vec3 maxBound{ mesh.Vertices[0].Position };
+
+        for (const auto& v : mesh.Vertices) {
+            minBound = glm::min(minBound, v.Position);
+            maxBound = glm::max(maxBound, v.Position);
+        }
+
+        const auto extent{ glm::max(maxBound - minBound, glm::vec3(1e-6f)) };
+
+        // 64^3 cells for LOD 1, halving every level after that
+        uint32_t cells{ 64 };
+
+        while (mesh.Lods.size() < maxLods && cells >= 2) {
+            auto lod{ Cluster(mesh, minBound, extent / static_cast<float>(cells), cells) };
+
+            // Less than 10% fewer triangles is not worth a level
+            const auto previous{ mesh.Lods.back().Indices.size() };
+            if (lod.Indices.empty() || lod.Indices.size() * 10 > previous * 9) {
+                cells /= 2;
+                continue;
+            }
+
+            mesh.Lods.emplace_back(std::move(lod));
+            cells /= 2;
+        }
+    }
+}
@@ -0,0 +1,14 @@
+#ifndef TOOLS_MESHCONV_SIMPLIFY_HPP
+#define TOOLS_MESHCONV_SIMPLIFY_HPP
+
+#include "SourceMesh.hpp"
+
+namespace Engine::Tools::MeshConverter {
+
+    // Appends coarser LODs to mesh.Lods by vertex clustering. LODs reuse the
+    // vertices of LOD 0, only the index lists differ, so the runtime needs
+    // one vertex blob per mesh. Stops early when a level stops paying off.
+    void BuildLods(SourceMesh& mesh, const uint32_t maxLods);
+}
+
+#endif // !TOOLS_MESHCONV_SIMPLIFY_HPP
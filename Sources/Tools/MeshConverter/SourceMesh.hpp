@@ -0,0 +1,42 @@
+#ifndef TOOLS_MESHCONV_SOURCE_MESH_HPP
+#define TOOLS_MESHCONV_SOURCE_MESH_HPP
+
+#include "Assets/Mesh/MeshFormat.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Engine::Tools::MeshConverter {
+
+    // Deduplicated, triangulated mesh as read from a source file
+    struct SourceVertex {
+        glm::vec3 Position;
+        glm::vec3 Normal;
+        glm::vec2 UV;
+    };
+
+    struct SourceLod {
+        std::vector<uint32_t>   Indices;
+        float                   Error{ 0.0f };
+    };
+
+    // Laid out as in the file, see Assets::Mesh::Meshlet
+    struct SourceMeshlets {
+        std::vector<Engine::Assets::Mesh::Meshlet>  Meshlets;
+        std::vector<uint32_t>                       Vertices;
+        std::vector<uint32_t>                       Triangles;
+    };
+
+    struct SourceMesh {
+        std::string                 Name;
+        std::vector<SourceVertex>   Vertices;
+        std::vector<SourceLod>      Lods;      // Lods[0] is the full mesh
+        SourceMeshlets              Meshlets;  // Of Lods[0]
+        bool                        HasNormals{ false };
+    };
+}
+
+#endif // !TOOLS_MESHCONV_SOURCE_MESH_HPP
@@ -0,0 +1,74 @@
+#include "ObjReader.hpp"
+#include "Simplify.hpp"
+#include "Optimize.hpp"
+#include "Meshlets.hpp"
+#include "MeshWriter.hpp"
+#include "Assets/Mesh/MeshFormat.hpp"
+#include "Jobs/Scheduler.hpp"
+
+#include <iostream>
+#include <string>
+
+using namespace Engine::Tools::MeshConverter;
+
+namespace EAM = Engine::Assets::Mesh;
+
+int main(int argc, char* argv[]) {
+
+    // Cache size typical of current GPUs, only used for reporting
+    constexpr uint32_t ReportCacheSize{ 16 };
+
+    if (argc != 3) {
+        std::cerr << "Usage: MeshConverter <input.obj> <output.vmesh>\n";
+        return EXIT_FAILURE;
+    }
+
+    try {
+        auto meshes{ ReadObj(argv[1]) };
+
+        if (meshes.empty()) {
+            std::cerr << "No geometry in " << argv[1] << '\n';
+            return EXIT_FAILURE;
+        }
+
+        Engine::Jobs::Scheduler scheduler{};
+        std::vector<std::pair<float, float>> cacheMissRatios(meshes.size());
+
+        // Meshes are independent, process them on every core
+        scheduler.ParallelFor(0, static_cast<uint32_t>(meshes.size()), 1, [&](const uint32_t begin, const uint32_t end) {
+            for (auto i = begin; i < end; ++i) {
+                auto& mesh{ meshes[i] };
+
+                BuildLods(mesh, EAM::MaxLods);
+
+                cacheMissRatios[i].first = AverageCacheMissRatio(mesh.Lods[0].Indices, mesh.Vertices.size(), ReportCacheSize);
+
+                for (auto& lod : mesh.Lods) {
+                    OptimizeVertexCache(lod.Indices, mesh.Vertices.size());
+                }
+                OptimizeVertexFetch(mesh);
+                BuildMeshlets(mesh, true);
+
+                cacheMissRatios[i].second = AverageCacheMissRatio(mesh.Lods[0].Indices, mesh.Vertices.size(), ReportCacheSize);
+            }
+        });
+
+        for (size_t i = 0; i < meshes.size(); ++i) {
+            const auto& mesh{ meshes[i] };
+
+            std::cerr << mesh.Name << ": " << mesh.Vertices.size() << " vertices, LODs";
+            for (const auto& lod : mesh.Lods) {
+                std::cerr << ' ' << lod.Indices.size() / 3;
+            }
+            std::cerr << " triangles, " << mesh.Meshlets.Meshlets.size() << " meshlets, ACMR " << cacheMissRatios[i].first << " -> " << cacheMissRatios[i].second << '\n';
+        }
+
+        WriteMeshFile(argv[2], meshes);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Exception " << e.what() << " was raised.\n";
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,143 @@
+#include "SourceImage.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+
+namespace Engine::Tools::TextureConverter {
+
+    namespace {
+
+        // Header fields are whitespace separated, '#' starts a comment
+        uint32_t ReadField(std::ifstream& file) {
+            char c{};
+            while (file.get(c)) {
+                if (c == '#') {
+                    while (file.get(c) && c != '\n') {}
+                }
+                else if (!std::isspace(static_cast<unsigned char>(c))) {
+                    break;
+                }
+            }
+
+            uint32_t value{ 0 };
+            bool any{ false };
+            while (file && std::isdigit(static_cast<unsigned char>(c))) {
+                value = value * 10 + static_cast<uint32_t>(c - '0');
+                any = true;
+                file.get(c);
+            }
+
+            if (!any) throw std::runtime_error("Bad PPM header");
+            return value;
+        }
+
+        const std::array<float, 256>& SrgbToLinearTable() {
+            static const auto table{ [] {
+                std::array<float, 256> t{};
+                for (size_t i = 0; i < t.size(); ++i) {
+                    const auto c{ static_cast<float>(i) / 255.0f };
+                    t[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+                }
+                return t;
+            }() };
+            return table;
+        }
+
+        uint8_t LinearToSrgb(const float linear) {
+            const auto c{ linear <= 0.0031308f ? linear * 12.92f : 1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f };
+            return static_cast<uint8_t>(std::clamp(c * 255.0f + 0.5f, 0.0f, 255.0f));
+        }
+
+        SourceImage Downsample(const SourceImage& source, const bool srgb) {
+            SourceImage mip{};
+            mip.Width  = std::max(source.Width  / 2, 1u);
+            mip.Height = std::max(source.Height / 2, 1u);
+            mip.Texels.resize(size_t{ mip.Width } * mip.Height * 4);
+
+            const auto& toLinear{ SrgbToLinearTable() };
+
+            for (uint32_t y = 0; y < mip.Height; ++y) {
+                for (uint32_t x = 0; x < mip.Width; ++x) {
+                    // Odd edges clamp, the last row / column is reused
+                    const uint32_t xs[2]{ std::min(x * 2, source.Width - 1),  std::min(x * 2 + 1, source.Width - 1) };
+                    const uint32_t ys[2]{ std::min(y * 2, source.Height - 1), std::min(y * 2 + 1, source.Height - 1) };
+
+                    for (uint32_t c = 0; c < 4; ++c) {
+                        // Alpha is always linear
+                        const bool gamma{ srgb && c < 3 };
+                        float sum{ 0.0f };
+
+                        for (const auto sy : ys) {
+                            for (const auto sx : xs) {
+                                const auto v{ source.At(sx, sy)[c] };
+                                sum += gamma ? toLinear[v] : static_cast<float>(v);
+                            }
+                        }
+
+                        sum *= 0.25f;
+                        mip.At(x, y)[c] = gamma ? LinearToSrgb(sum) : static_cast<uint8_t>(sum + 0.5f);
+                    }
+                }
+            }
+
+            return mip;
+        }
+    }
+
+    SourceImage ReadPpm(const std::string& path) {
+
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open file " + path);
+        }
+
+        char magic[2]{};
+        file.read(magic, 2);
+        if (magic[0] != 'P' || magic[1] != '6') {
+            throw std::runtime_error("Only binary PPM (P6) is supported: " + path);
+        }
+
+        SourceImage image{};
+        image.Width  = ReadField(file);
+        image.Height = ReadField(file);
+
+        // ReadField consumed the single whitespace byte after maxval
+        if (ReadField(file) != 255) {
+            throw std::runtime_error("Only 8 bit PPM is supported: " + path);
+        }
+        if (image.Width == 0 || image.Height == 0) {
+            throw std::runtime_error("Empty image: " + path);
+        }
+
+        std::vector<uint8_t> rgb(size_t{ image.Width } * image.Height * 3);
+        file.read(reinterpret_cast<char*>(rgb.data()), static_cast<std::streamsize>(rgb.size()));
+        if (!file) {
+            throw std::runtime_error("Truncated PPM: " + path);
+        }
+
+        image.Texels.resize(size_t{ image.Width } * image.Height * 4);
+        for (size_t i = 0, count = size_t{ image.Width } * image.Height; i < count; ++i) {
+            image.Texels[i * 4 + 0] = rgb[i * 3 + 0];
+            image.Texels[i * 4 + 1] = rgb[i * 3 + 1];
+            image.Texels[i * 4 + 2] = rgb[i * 3 + 2];
+            image.Texels[i * 4 + 3] = 255;
+        }
+
+        return image;
+    }
+
+    std::vector<SourceImage> BuildMips(SourceImage&& source, const bool srgb) {
+        std::vector<SourceImage> mips{};
+        mips.emplace_back(std::move(source));
+
+        while (mips.back().Width > 1 || mips.back().Height > 1) {
+            mips.emplace_back(Downsample(mips.back(), srgb));
+        }
+
+        return mips;
+    }
+}
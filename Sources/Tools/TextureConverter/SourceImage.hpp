@@ -0,0 +1,28 @@
+#ifndef TOOLS_TEXCONV_SOURCE_IMAGE_HPP
+#define TOOLS_TEXCONV_SOURCE_IMAGE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Engine::Tools::TextureConverter {
+
+    // 8 bit RGBA, rows top to bottom
+    struct SourceImage {
+        uint32_t                Width   { 0 };
+        uint32_t                Height  { 0 };
+        std::vector<uint8_t>    Texels  {};
+
+        const uint8_t* At(const uint32_t x, const uint32_t y) const { return Texels.data() + (size_t{ y } * Width + x) * 4; }
+        uint8_t*       At(const uint32_t x, const uint32_t y)       { return Texels.data() + (size_t{ y } * Width + x) * 4; }
+    };
+
+    // Binary PPM (P6, 8 bit). Alpha is set to opaque.
+    SourceImage ReadPpm(const std::string& path);
+
+    // Full chain down to 1x1 with a 2x2 box filter, the source is mip 0.
+    // sRGB data is filtered in linear space.
+    std::vector<SourceImage> BuildMips(SourceImage&& source, const bool srgb);
+}
+
+#endif // !TOOLS_TEXCONV_SOURCE_IMAGE_HPP
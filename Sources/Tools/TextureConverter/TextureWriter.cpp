@@ -0,0 +1,110 @@
+#include "TextureWriter.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+namespace Engine::Tools::TextureConverter {
+
+    namespace EAT = Engine::Assets::Texture;
+
+    namespace {
+
+        void Pad(std::ofstream& out, const uint64_t to) {
+            static const char zeros[EAT::TileAlignment]{};
+            const auto at{ static_cast<uint64_t>(out.tellp()) };
+            out.write(zeros, static_cast<std::streamsize>(to - at));
+        }
+    }
+
+    void WriteTextureFile(const std::string& path, const std::vector<SourceImage>& mips, const EAT::TexelFormat format, const uint32_t tileSize) {
+
+        if (mips.empty() || mips.size() > EAT::MaxMips) {
+            throw std::runtime_error("Unsupported mip count");
+        }
+
+        const auto texelSize{ EAT::BytesPerTexel(format) };
+
+        // Lay out both tables first so they can be written in one go
+        std::vector<EAT::MipEntry>  mipTable(mips.size());
+        std::vector<EAT::TileEntry> tileTable{};
+
+        for (size_t m = 0; m < mips.size(); ++m) {
+            auto& entry{ mipTable[m] };
+            entry.Width     = mips[m].Width;
+            entry.Height    = mips[m].Height;
+            entry.TilesX    = EAT::TileCount(entry.Width, tileSize);
+            entry.TilesY    = EAT::TileCount(entry.Height, tileSize);
+            entry.FirstTile = static_cast<uint32_t>(tileTable.size());
+            tileTable.resize(tileTable.size() + size_t{ entry.TilesX } * entry.TilesY);
+        }
+
+        const auto mipTableOffset { uint64_t{ sizeof(EAT::TextureHeader) } };
+        const auto tileTableOffset{ mipTableOffset + sizeof(EAT::MipEntry) * mipTable.size() };
+
+        uint64_t offset{ EAT::AlignTile(tileTableOffset + sizeof(EAT::TileEntry) * tileTable.size()) };
+
+        for (const auto& entry : mipTable) {
+            for (uint32_t y = 0; y < entry.TilesY; ++y) {
+                for (uint32_t x = 0; x < entry.TilesX; ++x) {
+                    const auto width { std::min(tileSize, entry.Width  - x * tileSize) };
+                    const auto height{ std::min(tileSize, entry.Height - y * tileSize) };
+
+                    auto& tile{ tileTable[entry.FirstTile + y * entry.TilesX + x] };
+                    tile.Offset = offset;
+                    tile.Size   = width * height * texelSize;
+
+                    offset = EAT::AlignTile(offset + tile.Size);
+                }
+            }
+        }
+
+        EAT::TextureHeader header{};
+        header.Magic            = EAT::TextureMagic;
+        header.Version          = EAT::TextureVersion;
+        header.Width            = mips[0].Width;
+        header.Height           = mips[0].Height;
+        header.MipCount         = static_cast<uint32_t>(mips.size());
+        header.TileWidth        = tileSize;
+        header.TileHeight       = tileSize;
+        header.Format           = format;
+        header.MipTableOffset   = mipTableOffset;
+        header.TileTableOffset  = tileTableOffset;
+        header.FileSize         = offset;
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            throw std::runtime_error("Could not open file " + path);
+        }
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(mipTable.data()),  static_cast<std::streamsize>(sizeof(EAT::MipEntry)  * mipTable.size()));
+        out.write(reinterpret_cast<const char*>(tileTable.data()), static_cast<std::streamsize>(sizeof(EAT::TileEntry) * tileTable.size()));
+
+        for (size_t m = 0; m < mips.size(); ++m) {
+            const auto& image{ mips[m] };
+            const auto& entry{ mipTable[m] };
+
+            for (uint32_t y = 0; y < entry.TilesY; ++y) {
+                for (uint32_t x = 0; x < entry.TilesX; ++x) {
+                    const auto& tile  { tileTable[entry.FirstTile + y * entry.TilesX + x] };
+                    const auto  left  { x * tileSize };
+                    const auto  top   { y * tileSize };
+                    const auto  width { std::min(tileSize, entry.Width - left) };
+                    const auto  height{ std::min(tileSize, entry.Height - top) };
+
+                    Pad(out, tile.Offset);
+                    for (uint32_t row = 0; row < height; ++row) {
+                        out.write(reinterpret_cast<const char*>(image.At(left, top + row)), static_cast<std::streamsize>(width * texelSize));
+                    }
+                }
+            }
+        }
+
+        Pad(out, offset);
+
+        if (!out.good()) {
+            throw std::runtime_error("Failed writing " + path);
+        }
+    }
+}
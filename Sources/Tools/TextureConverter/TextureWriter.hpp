@@ -0,0 +1,13 @@
+#ifndef TOOLS_TEXCONV_TEXTURE_WRITER_HPP
+#define TOOLS_TEXCONV_TEXTURE_WRITER_HPP
+
+#include "SourceImage.hpp"
+#include "Assets/Texture/TextureFormat.hpp"
+
+namespace Engine::Tools::TextureConverter {
+
+    // Cuts every mip into tileSize x tileSize tiles and writes a .vtex file
+    void WriteTextureFile(const std::string& path, const std::vector<SourceImage>& mips, const Engine::Assets::Texture::TexelFormat format, const uint32_t tileSize);
+}
+
+#endif // !TOOLS_TEXCONV_TEXTURE_WRITER_HPP
@@ -0,0 +1,44 @@
+#include "SourceImage.hpp"
+#include "TextureWriter.hpp"
+#include "Assets/Texture/TextureFormat.hpp"
+
+#include <iostream>
+#include <string>
+
+using namespace Engine::Tools::TextureConverter;
+
+namespace EAT = Engine::Assets::Texture;
+
+int main(int argc, char* argv[]) {
+
+    auto     format  { EAT::TexelFormat::Rgba8Unorm };
+    uint32_t tileSize{ EAT::DefaultTileSize };
+    std::vector<std::string> paths{};
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg{ argv[i] };
+        if (arg == "--srgb")                        format   = EAT::TexelFormat::Rgba8Srgb;
+        else if (arg == "--tile" && i + 1 < argc)   tileSize = static_cast<uint32_t>(std::stoul(argv[++i]));
+        else                                        paths.emplace_back(arg);
+    }
+
+    if (paths.size() != 2 || tileSize == 0) {
+        std::cerr << "Usage: TextureConverter [--srgb] [--tile <texels>] <input.ppm> <output.vtex>\n";
+        return EXIT_FAILURE;
+    }
+
+    try {
+        auto mips{ BuildMips(ReadPpm(paths[0]), format == EAT::TexelFormat::Rgba8Srgb) };
+
+        std::cerr << paths[0] << ": " << mips[0].Width << "x" << mips[0].Height << ", " << mips.size() << " mips, "
+                  << tileSize << "x" << tileSize << " tiles\n";
+
+        WriteTextureFile(paths[1], mips, format, tileSize);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Exception " << e.what() << " was raised.\n";
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -37,6 +37,10 @@ namespace Engine::Window {
         glfwSetCharCallback(windowHandle, GLFW_Window_wrapper::char_callback);
         glfwSetScrollCallback(windowHandle, GLFW_Window_wrapper::scroll_callback);
         glfwSetFramebufferSizeCallback(windowHandle, GLFW_Window_wrapper::framebuffer_resize_callback);
+        glfwSetKeyCallback(windowHandle, GLFW_Window_wrapper::key_callback);
+        glfwSetMouseButtonCallback(windowHandle, GLFW_Window_wrapper::mouse_button_callback);
+        glfwSetCursorPosCallback(windowHandle, GLFW_Window_wrapper::cursor_position_callback);
+        glfwSetWindowRefreshCallback(windowHandle, GLFW_Window_wrapper::refresh_callback);
 
     } catch (const std::exception&) {}
 
@@ -78,6 +82,10 @@ namespace Engine::Window {
         glfwWaitEventsTimeout(t);
     }
 
+    void GLFW_Window_wrapper::PostEmptyEvent() {
+        glfwPostEmptyEvent();
+    }
+
     void Engine::Window::GLFW_Window_wrapper::UpdateTitle(const std::string& new_title) {
         glfwSetWindowTitle(windowHandle, new_title.c_str());
     }
@@ -99,6 +107,12 @@ namespace Engine::Window {
     void GLFW_Window_wrapper::WindowResized(int new_width, int new_height) {
     }
 
+    void GLFW_Window_wrapper::ProcessInput() {
+    }
+
+    void GLFW_Window_wrapper::WindowRefresh() {
+    }
+
     void GLFW_Window_wrapper::WindowLoop() {
     }
 
@@ -121,6 +135,22 @@ namespace Engine::Window {
         GetInstance(wd)->WindowResized(w, h);
     }
 
+    void GLFW_Window_wrapper::key_callback(WindowHandle* wd, int key, int scancode, int action, int mods) {
+        GetInstance(wd)->ProcessInput();
+    }
+
+    void GLFW_Window_wrapper::mouse_button_callback(WindowHandle* wd, int button, int action, int mods) {
+        GetInstance(wd)->ProcessInput();
+    }
+
+    void GLFW_Window_wrapper::cursor_position_callback(WindowHandle* wd, double x, double y) {
+        GetInstance(wd)->ProcessInput();
+    }
+
+    void GLFW_Window_wrapper::refresh_callback(WindowHandle* wd) {
+        GetInstance(wd)->WindowRefresh();
+    }
+
     GLFW_Window_wrapper* GLFW_Window_wrapper::GetInstance(WindowHandle* handle) {
         return reinterpret_cast<GLFW_Window_wrapper*>(glfwGetWindowUserPointer(handle));
     }
@@ -29,6 +29,10 @@ namespace Engine::Window {
         static void scroll_callback(WindowHandle* window, double xoffset, double yoffset);
         static void char_callback(WindowHandle* window, unsigned int codepoint);
         static void framebuffer_resize_callback(WindowHandle *w, int width, int height);
+        static void key_callback(WindowHandle* window, int key, int scancode, int action, int mods);
+        static void mouse_button_callback(WindowHandle* window, int button, int action, int mods);
+        static void cursor_position_callback(WindowHandle* window, double x, double y);
+        static void refresh_callback(WindowHandle* window);
 
         static GLFW_Window_wrapper* GetInstance(WindowHandle* ptr);
 
@@ -50,6 +54,8 @@ namespace Engine::Window {
         bool KeepWindowOpen();
         void SetWindowShouldClose();
         void WaitEventsTimeout(double t);
+        // Wakes up WaitEvents, from any thread
+        void PostEmptyEvent();
         void UpdateTitle(const std::string& new_title);
 
         virtual void WindowLoop();
@@ -57,6 +63,10 @@ namespace Engine::Window {
         virtual void ProcessScroll(double x, double y);
         virtual void ProcessTextInput(unsigned int codepoint);
         virtual void WindowResized(int new_width, int new_height);
+        // Keys, mouse buttons and cursor movement, anything that isn't text or scroll
+        virtual void ProcessInput();
+        // The window contents were damaged and have to be drawn again
+        virtual void WindowRefresh();
 
     };
 }